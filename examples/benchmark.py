@@ -6,6 +6,7 @@
 
 
 import argparse
+import multiprocessing
 
 import numpy as np
 
@@ -39,6 +40,18 @@ parser.add_argument(
     action="store_true",
     help="Whether to enable benchmarking of semantic sensor.",
 )
+parser.add_argument(
+    "--software_rendering",
+    action="store_true",
+    help="Render on the CPU with Mesa llvmpipe instead of the GPU.",
+)
+parser.add_argument(
+    "--num_render_threads",
+    type=int,
+    default=0,
+    help="Rasterizer threads per process for software rendering"
+    " (0 uses every core).",
+)
 parser.add_argument("--seed", type=int, default=1)
 args = parser.parse_args()
 
@@ -54,6 +67,17 @@ default_settings["compute_shortest_path"] = False
 default_settings["compute_action_shortest_path"] = False
 
 default_settings["max_frames"] = args.max_frames
+default_settings["software_rendering"] = args.software_rendering
+default_settings["num_render_threads"] = args.num_render_threads
+
+
+def num_cores_used(nprocs):
+    # with software rendering every process rasterizes on its own thread pool,
+    # otherwise each process keeps one core busy feeding the GPU
+    threads = 1
+    if args.software_rendering:
+        threads = args.num_render_threads or multiprocessing.cpu_count()
+    return min(nprocs * threads, multiprocessing.cpu_count())
 
 
 benchmark_items = {
@@ -82,8 +106,14 @@ for nprocs in nprocs_tests:
             settings.update(value)
             perf[key] = demo_runner.benchmark(settings).get("fps")
             print(
-                " ====== FPS (%d x %d, %s): %0.1f ======"
-                % (settings["width"], settings["height"], key, perf[key])
+                " ====== FPS (%d x %d, %s): %0.1f (%0.1f per core) ======"
+                % (
+                    settings["width"],
+                    settings["height"],
+                    key,
+                    perf[key],
+                    perf[key] / num_cores_used(nprocs),
+                )
             )
         performance.append(perf)
 
@@ -104,6 +134,15 @@ for nproc, performance in performance_all.items():
         for key, value in performance[idx].items():
             row += "\t%-8.1f" % value
         print(row)
+    print(
+        " ---------------- FPS per core (%d cores) ----------------"
+        % num_cores_used(nproc)
+    )
+    for idx in range(len(performance)):
+        row = "%d x %d" % (resolutions[idx], resolutions[idx])
+        for key, value in performance[idx].items():
+            row += "\t%-8.2f" % (value / num_cores_used(nproc))
+        print(row)
     print(
         " =============================================================================="
     )
@@ -29,6 +29,8 @@ default_sim_settings = {
     "goal_position": [5.047, 0.199, 11.145],
     "goal_headings": [[0, -0.980_785, 0, 0.195_090], [0.0, 1.0, 0.0, 0.0]],
     "enable_physics": False,
+    "software_rendering": False,  # render on the CPU with Mesa llvmpipe
+    "num_render_threads": 0,  # llvmpipe threads per process, 0 for all cores
 }
 
 # build SimulatorConfiguration
@@ -39,6 +41,8 @@ def make_cfg(settings):
     else:
         sim_cfg.enable_physics = False
     sim_cfg.gpu_device_id = 0
+    sim_cfg.software_rendering = settings.get("software_rendering", False)
+    sim_cfg.num_render_threads = settings.get("num_render_threads", 0)
     sim_cfg.scene.id = settings["scene"]
 
     # define default sensor parameters (see src/esp/Sensor/Sensor.h)
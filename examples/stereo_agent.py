@@ -11,6 +11,9 @@ This can be done by giving the agent two sensors (be it RGB, depth, or semantic)
 with different positions.
 
 Note that the cameras must have different uuid's
+
+Alternatively, a single "multiview" sensor renders both views of the pair in
+one pass and returns them stacked along the first axis of its observation.
 """
 
 import random
@@ -28,7 +31,13 @@ def _render(sim, display, depth=False):
         # Just spin in a circle
         obs = sim.step("turn_right")
         # Put the two stereo observations next to eachother
-        stereo_pair = np.concatenate([obs["left_sensor"], obs["right_sensor"]], axis=1)
+        if "stereo_sensor" in obs:
+            views = obs["stereo_sensor"]
+            stereo_pair = np.concatenate([views[0], views[1]], axis=1)
+        else:
+            stereo_pair = np.concatenate(
+                [obs["left_sensor"], obs["right_sensor"]], axis=1
+            )
 
         # If it is a depth pair, manually normalize into [0, 1]
         # so that images are always consistent
@@ -117,6 +126,25 @@ def main(display=True):
     sim.close()
     del sim
 
+    # Finally, render the RGB pair with a single multiview sensor, which draws
+    # both views in one pass instead of traversing the scene once per sensor
+    stereo_rgb_sensor = habitat_sim.SensorSpec()
+    stereo_rgb_sensor.uuid = "stereo_sensor"
+    stereo_rgb_sensor.resolution = [512, 512]
+    stereo_rgb_sensor.position = 1.5 * habitat_sim.geo.UP
+    stereo_rgb_sensor.sensor_subtype = "multiview"
+    # The views are 0.25 meters to the left and right of the sensor
+    stereo_rgb_sensor.parameters["stereo_baseline"] = "0.5"
+
+    agent_config = habitat_sim.AgentConfiguration()
+    agent_config.sensor_specifications = [stereo_rgb_sensor]
+
+    sim = habitat_sim.Simulator(habitat_sim.Configuration(backend_cfg, [agent_config]))
+
+    _render(sim, display)
+    sim.close()
+    del sim
+
 
 if __name__ == "__main__":
     main(display=True)
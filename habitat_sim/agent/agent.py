@@ -131,9 +131,27 @@ class Agent(object):
         if reconfigure_sensors:
             self.sensors.clear()
             for spec in self.agent_config.sensor_specifications:
-                self.sensors.add(
-                    hsim.PinholeCamera(self.scene_node.create_child(), spec)
-                )
+                if spec.parent_uuid:
+                    continue
+                if spec.sensor_subtype == "raycast":
+                    sensor_type = hsim.RaycastCamera
+                elif spec.sensor_subtype == "panoramic":
+                    sensor_type = hsim.PanoramicCamera
+                elif spec.sensor_subtype == "multiview":
+                    sensor_type = hsim.MultiviewCamera
+                else:
+                    sensor_type = hsim.PinholeCamera
+                self.sensors.add(sensor_type(self.scene_node.create_child(), spec))
+            # derived sensors downsample the render of a parent created above
+            for spec in self.agent_config.sensor_specifications:
+                if spec.parent_uuid:
+                    self.sensors.add(
+                        hsim.DerivedCamera(
+                            self.scene_node.create_child(),
+                            spec,
+                            self.sensors[spec.parent_uuid],
+                        )
+                    )
 
     def act(self, action_id: Any) -> bool:
         r"""Take the action specified by action_id
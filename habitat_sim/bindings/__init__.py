@@ -11,6 +11,7 @@ modules = [
     "MultiGoalShortestPath",
     "PathFinder",
     "PinholeCamera",
+    "RaycastCamera",
     "SceneGraph",
     "SceneNode",
     "Sensor",
@@ -113,9 +113,19 @@ class Simulator:
         agent_cfg = config.agents[config.sim_cfg.default_agent_id]
         self._sensors = {}
         for spec in agent_cfg.sensor_specifications:
-            self._sensors[spec.uuid] = Sensor(
-                sim=self._sim, agent=self._default_agent, sensor_id=spec.uuid
-            )
+            if not spec.parent_uuid:
+                self._sensors[spec.uuid] = Sensor(
+                    sim=self._sim, agent=self._default_agent, sensor_id=spec.uuid
+                )
+        # derived sensors downsample the observations of their parent
+        for spec in agent_cfg.sensor_specifications:
+            if spec.parent_uuid:
+                self._sensors[spec.uuid] = Sensor(
+                    sim=self._sim,
+                    agent=self._default_agent,
+                    sensor_id=spec.uuid,
+                    parent=self._sensors[spec.parent_uuid],
+                )
 
         for i in range(len(self.agents)):
             self.initialize_agent(i)
@@ -138,17 +148,48 @@ class Simulator:
         self._last_state = agent.state
         return agent
 
+    def prefetch_scene(self, scene_cfg):
+        r"""Start loading the scene of the next episode in the background, so
+        that reconfiguring to it later mostly waits on the GPU upload.
+
+        :param scene_cfg: the :py:class:`SceneConfiguration` of the scene
+        :return: a :py:class:`PrefetchFuture`
+        """
+        return self._sim.prefetch_scene(scene_cfg)
+
     def sample_random_agent_state(self, state_to_return):
         return self._sim.sample_random_agent_state(state_to_return)
 
+    def get_sensor(self, sensor_uuid):
+        return self._sensors[sensor_uuid]
+
     @property
     def semantic_scene(self):
         return self._sim.semantic_scene
 
-    def get_sensor_observations(self):
+    def get_sensor_observations(self, ring_slot=None):
+        r"""Observations of all sensors by uuid.
+
+        :param ring_slot: slot of the ring to read the observations of sensors
+            with a ring field into, see :py:meth:`Sensor.set_ring_field`.
+            Observations derived from one read into the ring are bottom row
+            first as well.
+        """
+        profiler = self._sim.renderer.profiler
+        start_ns = hsim.Profiler.now() if profiler.enabled else 0
+
         observations = {}
         for sensor_uuid, sensor in self._sensors.items():
-            observations[sensor_uuid] = sensor.get_observation()
+            if sensor.parent is None:
+                observations[sensor_uuid] = sensor.get_observation(ring_slot)
+        for sensor_uuid, sensor in self._sensors.items():
+            if sensor.parent is not None:
+                observations[sensor_uuid] = sensor.derive_observation(
+                    observations[sensor.parent._spec.uuid], ring_slot
+                )
+
+        if profiler.enabled:
+            profiler.record("frame", start_ns, hsim.Profiler.now() - start_ns)
         return observations
 
     def last_state(self):
@@ -227,33 +268,78 @@ class Sensor:
     TODO(MS) define entire Sensor class in python, reducing complexity
     """
 
-    def __init__(self, sim, agent, sensor_id):
+    def __init__(self, sim, agent, sensor_id, parent=None):
         self._sim = sim
         self._agent = agent
+        self.parent = parent
 
         # sensor is an attached object to the scene node
         # store such "attached object" in _sensor_object
         self._sensor_object = self._agent.sensors.get(sensor_id)
 
         self._spec = self._sensor_object.specification()
+        # the encoding of the spec may pick compact RGB or half float depth
+        space = self._sensor_object.get_observation_space()
+        # multiview sensors prepend the number of views to the shape and are
+        # read back as views stacked vertically
+        self._num_views = space.shape[0] if len(space.shape) > 3 else None
+        shape = space.shape[1:] if self._num_views else space.shape
+        self._channels = shape[2] if len(shape) > 2 else self._spec.channels
+        rows = self._spec.resolution[0] * (self._num_views or 1)
         if self._spec.sensor_type == hsim.SensorType.SEMANTIC:
-            self._buffer = np.empty(
-                (self._spec.resolution[0], self._spec.resolution[1]), dtype=np.uint32
-            )
+            self._buffer = np.empty((rows, self._spec.resolution[1]), dtype=np.uint32)
         elif self._spec.sensor_type == hsim.SensorType.DEPTH:
             self._buffer = np.empty(
-                (self._spec.resolution[0], self._spec.resolution[1]), dtype=np.float32
+                (rows, self._spec.resolution[1]),
+                dtype=np.float16
+                if space.data_type == hsim.DataType.FLOAT16
+                else np.float32,
             )
         else:
             self._buffer = np.empty(
-                (
-                    self._spec.resolution[0],
-                    self._spec.resolution[1] * self._spec.channels,
-                ),
-                dtype=np.uint8,
+                (rows, self._spec.resolution[1] * self._channels), dtype=np.uint8
+            )
+        self._ring = None
+        self._ring_field = None
+
+    def set_ring_field(self, ring, field_name):
+        r"""Read observations back straight into a field of the slots of a
+        shared memory ring instead of a buffer of the sensor, so the consumer
+        of the ring gets them without any copy.
+
+        :param ring: the :py:class:`ObservationRingBuffer` written by this process
+        :param field_name: name of the field, with the shape and data type of
+            the observation space of the sensor
+
+        Observations read into the ring are left bottom row first, as read
+        back from the GPU, see :py:meth:`get_observation`.
+        """
+        field = next((f for f in ring.fields if f.name == field_name), None)
+        if field is None:
+            raise KeyError(field_name)
+        space = self._sensor_object.get_observation_space()
+        if list(field.shape) != list(space.shape) or field.data_type != space.data_type:
+            raise ValueError(
+                f"Field {field_name} does not match the observation space of "
+                f"sensor {self._spec.uuid}"
             )
+        self._ring = ring
+        self._ring_field = field_name
+
+    def _ring_buffer(self, ring_slot):
+        # a view of the field in shared memory, in the layout of _buffer
+        return self._ring.field(ring_slot, self._ring_field).reshape(
+            self._buffer.shape
+        )
 
-    def get_observation(self):
+    def get_observation(self, ring_slot=None):
+        r"""Render an observation.
+
+        :param ring_slot: if the sensor has a ring field, see
+            :py:meth:`set_ring_field`, the slot to read the observation into.
+            The returned observation is then that field, bottom row first, and
+            no copy is made.
+        """
         # sanity check:
         # see if the sensor is attached to a scene graph, otherwise it is invalid,
         # and cannot make any observation
@@ -263,6 +349,11 @@ class Sensor:
                  (has it been detached from a scene node?)"
             )
 
+        if self.parent is not None:
+            return self.derive_observation(
+                self.parent.get_observation(ring_slot), ring_slot
+            )
+
         # get the correct scene graph based on application
         if self._spec.sensor_type == hsim.SensorType.SEMANTIC:
             if self._sim.semantic_scene is None:
@@ -283,6 +374,37 @@ class Sensor:
         agent_node = self._agent.scene_node
         agent_node.parent = scene.get_root_node()
 
+        if ring_slot is not None and self._ring is not None:
+            buffer = self._ring_buffer(ring_slot)
+            self._read_observation(scene, buffer)
+            self._apply_noise(buffer)
+            return buffer
+
+        self._read_observation(scene, self._buffer)
+        return self._copy_observation()
+
+    def _read_observation(self, scene, buffer):
+        self._render_observation(scene, buffer)
+        if self._spec.sensor_type == hsim.SensorType.SEMANTIC:
+            # object ids become category ids if the spec asks for it
+            self._sensor_object.remap_semantic_observation(self._sim, buffer)
+
+    def _render_observation(self, scene, buffer):
+        if isinstance(self._sensor_object, hsim.RaycastCamera):
+            # depth and semantic observations are ray cast on the CPU
+            self._sensor_object.raycast(self._sim, buffer)
+            return
+
+        if isinstance(self._sensor_object, hsim.PanoramicCamera):
+            # cube faces are rendered and resampled to the panorama in C++
+            self._sensor_object.render(scene, buffer)
+            return
+
+        if isinstance(self._sensor_object, hsim.MultiviewCamera):
+            # all views are drawn in one pass, noise is applied per view in C++
+            self._sensor_object.render(self._sim.renderer, scene, buffer)
+            return
+
         # draw the scene with the visual sensor:
         # it asserts the sensor is a visual sensor;
         # internally it will set the camera parameters (from the sensor) to the
@@ -291,20 +413,79 @@ class Sensor:
         self._sim.renderer.draw(self._sensor_object, scene)
 
         if self._spec.sensor_type == hsim.SensorType.SEMANTIC:
-            self._sim.renderer.readFrameObjectId(self._buffer)
-            return np.flip(self._buffer, axis=0).copy()
+            self._sim.renderer.readFrameObjectId(buffer)
         elif self._spec.sensor_type == hsim.SensorType.DEPTH:
-            self._sim.renderer.readFrameDepth(self._buffer)
-            return np.flip(self._buffer, axis=0).copy()
+            if buffer.dtype == np.float16:
+                self._sim.renderer.readFrameDepthHalf(buffer.view(np.uint16))
+            else:
+                self._sim.renderer.readFrameDepth(buffer)
+        elif self._channels == 3:
+            self._sim.renderer.readFrameRgb(buffer)
         else:
-            self._sim.renderer.readFrameRgba(self._buffer)
-            return np.flip(
+            self._sim.renderer.readFrameRgba(buffer)
+
+    def derive_observation(self, parent_observation, ring_slot=None):
+        # downsampling commutes with the vertical flip of the parent
+        # observation, so the result needs no flip of its own
+        if ring_slot is not None and self._ring is not None:
+            buffer = self._ring_buffer(ring_slot)
+            self._sensor_object.derive(parent_observation, buffer)
+            return buffer
+        self._sensor_object.derive(parent_observation, self._buffer)
+        if self._spec.sensor_type == hsim.SensorType.COLOR:
+            return self._buffer.reshape(
+                (self._spec.resolution[0], self._spec.resolution[1], self._channels)
+            ).copy()
+        return self._buffer.copy()
+
+    def _apply_noise(self, buffer):
+        if (
+            self._sensor_object.has_noise_model
+            and not self._num_views
+            and self._spec.sensor_type
+            in (hsim.SensorType.COLOR, hsim.SensorType.DEPTH)
+        ):
+            if buffer.dtype == np.float16:
+                self._sensor_object.apply_noise(buffer.view(np.uint16))
+            else:
+                self._sensor_object.apply_noise(buffer)
+
+    def _copy_observation(self):
+        self._apply_noise(self._buffer)
+
+        profiler = self._sim.renderer.profiler
+        start_ns = hsim.Profiler.now() if profiler.enabled else 0
+
+        if self._num_views:
+            shape = (
+                self._num_views,
+                self._spec.resolution[0],
+                self._spec.resolution[1],
+            )
+            if self._spec.sensor_type == hsim.SensorType.COLOR:
+                shape += (self._channels,)
+            obs = np.flip(self._buffer.reshape(shape), axis=1).copy()
+        elif self._spec.sensor_type in (
+            hsim.SensorType.SEMANTIC,
+            hsim.SensorType.DEPTH,
+        ):
+            obs = np.flip(self._buffer, axis=0).copy()
+        else:
+            obs = np.flip(
                 self._buffer.reshape(
                     (
                         self._spec.resolution[0],
                         self._spec.resolution[1],
-                        self._spec.channels,
+                        self._channels,
                     )
                 ),
                 axis=0,
             ).copy()
+
+        if profiler.enabled:
+            profiler.record(
+                self._spec.uuid + "/python_copy",
+                start_ns,
+                hsim.Profiler.now() - start_ns,
+            )
+        return obs
@@ -0,0 +1,169 @@
+// Copyright (c) Facebook, Inc. and its affiliates.
+// This source code is licensed under the MIT license found in the
+// LICENSE file in the root directory of this source tree.
+
+// Times Mp3dInstanceMeshData::loadMp3dPLY against the per field ifstream
+// reads it replaced, on a synthetic segmentation PLY in the MP3D layout.
+//
+// Usage: Mp3dPLYBenchmark [numVertices] [repetitions]
+
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <Corrade/Utility/Directory.h>
+
+#include "esp/assets/Mp3dInstanceMeshData.h"
+#include "esp/core/esp.h"
+
+namespace Cr = Corrade;
+
+using namespace esp;
+
+namespace {
+
+// exposes what Mp3dInstanceMeshData parses
+class Mp3dMesh : public esp::assets::Mp3dInstanceMeshData {
+ public:
+  const std::vector<vec3f>& positions() const { return cpu_vbo_; }
+  const std::vector<vec3uc>& colors() const { return cpu_cbo_; }
+  const std::vector<vec3ui>& indices() const { return cpu_ibo_; }
+  const std::vector<int>& segmentIds() const { return segmentIds_; }
+};
+
+// Write a binary PLY in the layout of MP3D house segmentations
+std::string writeMp3dPLY(const std::string& name,
+                         uint32_t numVertices,
+                         uint32_t numFaces) {
+  const std::string filename =
+      Cr::Utility::Directory::join(Cr::Utility::Directory::tmp(), name);
+  std::ofstream file(filename, std::ios::binary);
+  file << "ply\nformat binary_little_endian 1.0\n"
+       << "element vertex " << numVertices << "\n"
+       << "property float x\nproperty float y\nproperty float z\n"
+       << "property float nx\nproperty float ny\nproperty float nz\n"
+       << "property float tex_u\nproperty float tex_v\n"
+       << "property uchar red\nproperty uchar green\nproperty uchar blue\n"
+       << "element face " << numFaces << "\n"
+       << "property list uchar int vertex_indices\n"
+       << "property int material_id\nproperty int segment_id\n"
+       << "property int category_id\nend_header\n";
+  for (uint32_t i = 0; i < numVertices; ++i) {
+    const float floats[] = {float(i), i + 0.5f, -float(i), 0, 0, 1, 0, 0};
+    const uint8_t rgb[] = {uint8_t(i), uint8_t(i >> 8), 7};
+    file.write(reinterpret_cast<const char*>(floats), sizeof(floats));
+    file.write(reinterpret_cast<const char*>(rgb), sizeof(rgb));
+  }
+  for (uint32_t i = 0; i < numFaces; ++i) {
+    const uint8_t numIndices = 3;
+    const uint32_t indices[] = {i % numVertices, (i + 1) % numVertices,
+                                (i + 2) % numVertices};
+    const int32_t ids[] = {int32_t(i % 97) - 1, int32_t(i % 1013),
+                           int32_t(i % 41)};
+    file.write(reinterpret_cast<const char*>(&numIndices), 1);
+    file.write(reinterpret_cast<const char*>(indices), sizeof(indices));
+    file.write(reinterpret_cast<const char*>(ids), sizeof(ids));
+  }
+  return filename;
+}
+
+// The per field reads loadMp3dPLY did before, into the same buffers
+void oldLoadMp3dPLY(const std::string& filename,
+                    std::vector<vec3f>& positions,
+                    std::vector<vec3uc>& colors,
+                    std::vector<vec3ui>& indices,
+                    std::vector<int>& segmentIds) {
+  std::ifstream ifs(filename, std::ios::binary);
+  std::string line;
+  size_t numVertices = 0, numFaces = 0;
+  do {
+    std::getline(ifs, line);
+    if (line.compare(0, 15, "element vertex ") == 0) {
+      numVertices = std::stoul(line.substr(15));
+    } else if (line.compare(0, 13, "element face ") == 0) {
+      numFaces = std::stoul(line.substr(13));
+    }
+  } while (line != "end_header" && !ifs.eof());
+  for (size_t i = 0; i < numVertices; ++i) {
+    vec3f position, normal;
+    vec2f texCoords;
+    vec3uc rgb;
+    ifs.read(reinterpret_cast<char*>(position.data()), 3 * sizeof(float));
+    ifs.read(reinterpret_cast<char*>(normal.data()), 3 * sizeof(float));
+    ifs.read(reinterpret_cast<char*>(texCoords.data()), 2 * sizeof(float));
+    ifs.read(reinterpret_cast<char*>(rgb.data()), 3 * sizeof(uint8_t));
+    positions.emplace_back(position);
+    colors.emplace_back(rgb);
+  }
+  for (size_t i = 0; i < numFaces; ++i) {
+    uint8_t nIndices;
+    vec3ui face;
+    int32_t materialId, segmentId, categoryId;
+    ifs.read(reinterpret_cast<char*>(&nIndices), sizeof(nIndices));
+    ifs.read(reinterpret_cast<char*>(face.data()), 3 * sizeof(int));
+    ifs.read(reinterpret_cast<char*>(&materialId), sizeof(materialId));
+    ifs.read(reinterpret_cast<char*>(&segmentId), sizeof(segmentId));
+    ifs.read(reinterpret_cast<char*>(&categoryId), sizeof(categoryId));
+    indices.emplace_back(face);
+    segmentIds.emplace_back(segmentId);
+  }
+}
+
+// Median wall time in milliseconds of repetitions calls of load
+template <class Load>
+double medianMilliseconds(int repetitions, Load load) {
+  std::vector<double> times;
+  for (int i = 0; i < repetitions; ++i) {
+    const auto start = std::chrono::steady_clock::now();
+    load();
+    times.push_back(std::chrono::duration<double, std::milli>(
+                        std::chrono::steady_clock::now() - start)
+                        .count());
+  }
+  std::sort(times.begin(), times.end());
+  return times[times.size() / 2];
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+  // about the size of a full MP3D house by default
+  const uint32_t numVertices = argc > 1 ? std::atoi(argv[1]) : 1 << 20;
+  const int repetitions = argc > 2 ? std::atoi(argv[2]) : 5;
+  const uint32_t numFaces = 2 * numVertices;
+  const std::string filename =
+      writeMp3dPLY("Mp3dPLYBenchmark.ply", numVertices, numFaces);
+
+  std::vector<vec3f> positions;
+  std::vector<vec3uc> colors;
+  std::vector<vec3ui> indices;
+  std::vector<int> segmentIds;
+  const double oldTime = medianMilliseconds(repetitions, [&]() {
+    positions = {};
+    colors = {};
+    indices = {};
+    segmentIds = {};
+    oldLoadMp3dPLY(filename, positions, colors, indices, segmentIds);
+  });
+  bool loaded = true;
+  std::unique_ptr<Mp3dMesh> mesh;
+  const double newTime = medianMilliseconds(repetitions, [&]() {
+    mesh = std::make_unique<Mp3dMesh>();
+    loaded = mesh->loadMp3dPLY(filename) && loaded;
+  });
+  Cr::Utility::Directory::rm(filename);
+
+  const bool same = loaded && mesh->positions() == positions &&
+                    mesh->colors() == colors && mesh->indices() == indices &&
+                    mesh->segmentIds() == segmentIds;
+  std::cout << numVertices << " vertices, " << numFaces << " faces: old "
+            << oldTime << " ms, new " << newTime << " ms, "
+            << oldTime / newTime << "x" << (same ? "" : " (MISMATCH)")
+            << std::endl;
+  return same ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -0,0 +1,140 @@
+// Copyright (c) Facebook, Inc. and its affiliates.
+// This source code is licensed under the MIT license found in the
+// LICENSE file in the root directory of this source tree.
+
+// Times PTexMeshData::calculateAdjacency against the hash map of edges it
+// replaced, on a grid of quads with random winding and starting vertex, some
+// of them duplicated to make non-manifold edges and some degenerate.
+//
+// Usage: PTexAdjacencyBenchmark [gridSize] [repetitions]
+
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <random>
+#include <unordered_map>
+#include <vector>
+
+#include "esp/assets/PTexMeshData.h"
+#include "esp/core/esp.h"
+
+using esp::assets::PTexMeshData;
+
+namespace {
+
+PTexMeshData::MeshData createQuadGrid(int gridSize) {
+  std::mt19937 generator(5);
+  PTexMeshData::MeshData mesh;
+  for (int y = 0; y < gridSize; ++y) {
+    for (int x = 0; x < gridSize; ++x) {
+      uint32_t quad[] = {uint32_t(y * (gridSize + 1) + x),
+                         uint32_t(y * (gridSize + 1) + x + 1),
+                         uint32_t((y + 1) * (gridSize + 1) + x + 1),
+                         uint32_t((y + 1) * (gridSize + 1) + x)};
+      if (generator() % 2) {
+        std::reverse(quad, quad + 4);
+      }
+      const int start = generator() % 4;
+      for (int i = 0; i < 4; ++i) {
+        mesh.ibo.push_back(quad[(start + i) % 4]);
+      }
+      if (generator() % 50 == 0) {
+        for (int i = 0; i < 4; ++i) {
+          mesh.ibo.push_back(quad[(i + 1) % 4]);
+        }
+      }
+      if (generator() % 70 == 0) {
+        mesh.ibo.insert(mesh.ibo.end(), {quad[0], quad[0], quad[1], quad[2]});
+      }
+    }
+  }
+  return mesh;
+}
+
+// The previous calculateAdjacency, keeping every edge in a hash map
+void oldCalculateAdjacency(const PTexMeshData::MeshData& mesh,
+                           std::vector<uint32_t>& adjFaces) {
+  struct EdgeData {
+    int face;
+    int edge;
+  };
+  std::unordered_map<uint64_t, std::vector<EdgeData>> edgeMap;
+  const int numFaces = mesh.ibo.size() / 4;
+  std::vector<uint64_t> edgeKeys(numFaces * 4);
+  for (int f = 0; f < numFaces; f++) {
+    for (int e = 0; e < 4; e++) {
+      const uint32_t i0 = mesh.ibo[f * 4 + e];
+      const uint32_t i1 = mesh.ibo[f * 4 + ((e + 1) % 4)];
+      const uint64_t key =
+          (uint64_t)std::min(i0, i1) << 32 | (uint32_t)std::max(i0, i1);
+      edgeMap[key].push_back({f, e});
+      edgeKeys[f * 4 + e] = key;
+    }
+  }
+
+  adjFaces.resize(numFaces * 4);
+  for (int f = 0; f < numFaces; f++) {
+    for (int e = 0; e < 4; e++) {
+      const std::vector<EdgeData>& adj = edgeMap[edgeKeys[f * 4 + e]];
+      int adjFace = -1;
+      for (size_t i = 0; i < adj.size(); i++) {
+        if (adj[i].face != f)
+          adjFace = adj[i].face;
+      }
+      int rot = 0;
+      if (adj.size() == 2) {
+        int edge0 = 0, edge1 = 0;
+        if (adj[0].edge == e) {
+          edge0 = adj[0].edge;
+          edge1 = adj[1].edge;
+        } else if (adj[1].edge == e) {
+          edge0 = adj[1].edge;
+          edge1 = adj[0].edge;
+        }
+        rot = (edge0 - edge1 + 2) & 3;
+      }
+      adjFaces[f * 4 + e] = (rot << 30) | (adjFace & 0x3FFFFFFF);
+    }
+  }
+}
+
+// Median wall time in milliseconds of repetitions calls of calculate
+template <class Calculate>
+double medianMilliseconds(int repetitions, Calculate calculate) {
+  std::vector<double> times;
+  for (int i = 0; i < repetitions; ++i) {
+    const auto start = std::chrono::steady_clock::now();
+    calculate();
+    times.push_back(std::chrono::duration<double, std::milli>(
+                        std::chrono::steady_clock::now() - start)
+                        .count());
+  }
+  std::sort(times.begin(), times.end());
+  return times[times.size() / 2];
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+  // about a million quads by default, the size of a Replica scene
+  const int gridSize = argc > 1 ? std::atoi(argv[1]) : 1024;
+  const int repetitions = argc > 2 ? std::atoi(argv[2]) : 5;
+  const PTexMeshData::MeshData mesh = createQuadGrid(gridSize);
+
+  std::vector<uint32_t> oldAdjacency, newAdjacency;
+  const double oldTime = medianMilliseconds(repetitions, [&]() {
+    oldAdjacency = {};
+    oldCalculateAdjacency(mesh, oldAdjacency);
+  });
+  const double newTime = medianMilliseconds(repetitions, [&]() {
+    newAdjacency = {};
+    PTexMeshData::calculateAdjacency(mesh, newAdjacency);
+  });
+
+  const bool same = oldAdjacency == newAdjacency;
+  std::cout << mesh.ibo.size() / 4 << " quads: old " << oldTime
+            << " ms, new " << newTime << " ms, " << oldTime / newTime << "x"
+            << (same ? "" : " (MISMATCH)") << std::endl;
+  return same ? EXIT_SUCCESS : EXIT_FAILURE;
+}
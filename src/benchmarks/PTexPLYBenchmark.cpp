@@ -0,0 +1,226 @@
+// Copyright (c) Facebook, Inc. and its affiliates.
+// This source code is licensed under the MIT license found in the
+// LICENSE file in the root directory of this source tree.
+
+// Times PTexMeshData::parsePLY against the parser it replaced, which read
+// the header through an ifstream, opened the file again for its size and
+// mapped it a third time to unpack vertices and faces one at a time.
+//
+// Usage: PTexPLYBenchmark [numVertices] [repetitions]
+
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include <Corrade/Containers/Array.h>
+#include <Corrade/Utility/Directory.h>
+
+#include "esp/assets/PTexMeshData.h"
+#include "esp/core/esp.h"
+#include "esp/io/io.h"
+
+namespace Cr = Corrade;
+
+using esp::assets::PTexMeshData;
+
+namespace {
+
+// Write a binary PLY with numVertices vertices of the given properties, each
+// property value being its vertex index, and numFaces faces of faceSize
+// consecutive indices
+std::string writePLY(const std::string& name,
+                     const std::vector<std::string>& vertexProperties,
+                     uint32_t numVertices,
+                     uint32_t numFaces,
+                     uint8_t faceSize) {
+  const std::string filename =
+      Cr::Utility::Directory::join(Cr::Utility::Directory::tmp(), name);
+  std::ofstream file(filename, std::ios::binary);
+  file << "ply\nformat binary_little_endian 1.0\n"
+       << "element vertex " << numVertices << "\n";
+  for (const std::string& property : vertexProperties) {
+    file << "property " << property << "\n";
+  }
+  file << "element face " << numFaces << "\n"
+       << "property list uchar int vertex_indices\nend_header\n";
+
+  for (uint32_t i = 0; i < numVertices; ++i) {
+    for (const std::string& property : vertexProperties) {
+      if (property.compare(0, 5, "float") == 0) {
+        const float value = i;
+        file.write(reinterpret_cast<const char*>(&value), sizeof(value));
+      } else {
+        const uint8_t value = i % 256;
+        file.write(reinterpret_cast<const char*>(&value), sizeof(value));
+      }
+    }
+  }
+  for (uint32_t i = 0; i < numFaces; ++i) {
+    file.write(reinterpret_cast<const char*>(&faceSize), sizeof(faceSize));
+    for (uint32_t j = 0; j < faceSize; ++j) {
+      const uint32_t index = (i + j) % numVertices;
+      file.write(reinterpret_cast<const char*>(&index), sizeof(index));
+    }
+  }
+  return filename;
+}
+
+// The previous parsePLY, without the validation of the header, which costs
+// the same in both
+void oldParsePLY(const std::string& filename,
+                 PTexMeshData::MeshData& meshData) {
+  size_t numVertices = 0;
+  size_t numFaces = 0;
+  size_t positionBytes = 0, normalBytes = 0, colorBytes = 0;
+  size_t positionOffset = 0, normalOffset = 0, colorOffset = 0;
+  size_t vertexPacketSize = 0;
+
+  std::ifstream file(filename, std::ios::binary);
+  std::string line;
+  while (std::getline(file, line)) {
+    std::istringstream ls(line);
+    std::string token, type, name;
+    ls >> token;
+    if (token == "element") {
+      size_t size;
+      ls >> name >> size;
+      (name == "vertex" ? numVertices : numFaces) = size;
+    } else if (token == "property") {
+      ls >> type >> name;
+      if (type == "list") {
+        continue;
+      }
+      if (name == "x") {
+        positionOffset = vertexPacketSize;
+      } else if (name == "nx") {
+        normalOffset = vertexPacketSize;
+      } else if (name == "red") {
+        colorOffset = vertexPacketSize;
+      }
+      const size_t bytes = type == "float" ? sizeof(float) : sizeof(uint8_t);
+      if (name == "x" || name == "y" || name == "z" || name == "w") {
+        positionBytes += bytes;
+      } else if (name == "nx" || name == "ny" || name == "nz") {
+        normalBytes += bytes;
+      } else {
+        colorBytes += bytes;
+      }
+      vertexPacketSize += bytes;
+    } else if (token == "end_header") {
+      break;
+    }
+  }
+  const size_t postHeader = file.tellg();
+  file.close();
+
+  Cr::Containers::Array<const char, Cr::Utility::Directory::MapDeleter>
+      mmappedData = Cr::Utility::Directory::mapRead(filename);
+  const size_t fileSize = esp::io::fileSize(filename);
+
+  meshData.vbo.resize(numVertices, esp::vec4f(0, 0, 0, 1));
+  if (normalBytes) {
+    meshData.nbo.resize(numVertices, esp::vec4f(0, 0, 0, 1));
+  }
+  if (colorBytes) {
+    meshData.cbo.resize(numVertices, esp::vec4uc(0, 0, 0, 255));
+  }
+  const char* bytes = mmappedData + postHeader;
+  for (size_t i = 0; i < numVertices; i++) {
+    const char* nextBytes = bytes + vertexPacketSize * i;
+    std::memcpy(meshData.vbo[i].data(), &nextBytes[positionOffset],
+                positionBytes);
+    if (normalBytes)
+      std::memcpy(meshData.nbo[i].data(), &nextBytes[normalOffset],
+                  normalBytes);
+    if (colorBytes)
+      std::memcpy(meshData.cbo[i].data(), &nextBytes[colorOffset],
+                  colorBytes);
+  }
+
+  const size_t bytesSoFar = postHeader + vertexPacketSize * numVertices;
+  bytes = mmappedData + bytesSoFar;
+  const uint8_t faceDimensions = *bytes;
+  const size_t faceBytes = faceDimensions * sizeof(uint32_t);
+  const size_t facePacketSize = 1 + faceBytes;
+  numFaces = std::min(numFaces, (fileSize - bytesSoFar) / facePacketSize);
+  meshData.ibo.resize(numFaces * faceDimensions);
+  for (size_t i = 0; i < numFaces; i++) {
+    std::memcpy(&meshData.ibo[i * faceDimensions],
+                bytes + facePacketSize * i + 1, faceBytes);
+  }
+}
+
+// Median wall time in milliseconds of repetitions calls of parse
+template <class Parse>
+double medianMilliseconds(int repetitions, Parse parse) {
+  std::vector<double> times;
+  for (int i = 0; i < repetitions; ++i) {
+    const auto start = std::chrono::steady_clock::now();
+    parse();
+    times.push_back(std::chrono::duration<double, std::milli>(
+                        std::chrono::steady_clock::now() - start)
+                        .count());
+  }
+  std::sort(times.begin(), times.end());
+  return times[times.size() / 2];
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+  const uint32_t numVertices = argc > 1 ? std::atoi(argv[1]) : 1 << 20;
+  const int repetitions = argc > 2 ? std::atoi(argv[2]) : 5;
+
+  struct Layout {
+    const char* name;
+    std::vector<std::string> properties;
+    uint32_t numFaces;
+    uint8_t faceSize;
+  };
+  // ReplicaCAD style quads of plain positions, which are copied in one go,
+  // and triangles with interleaved normals and colors
+  const Layout layouts[] = {
+      {"xyzw quads", {"float x", "float y", "float z", "float w"},
+       numVertices / 2, 4},
+      {"interleaved triangles",
+       {"float x", "float y", "float z", "float nx", "float ny", "float nz",
+        "uchar red", "uchar green", "uchar blue"},
+       2 * numVertices, 3},
+  };
+
+  int result = EXIT_SUCCESS;
+  for (const Layout& layout : layouts) {
+    const std::string filename =
+        writePLY("PTexPLYBenchmark.ply", layout.properties, numVertices,
+                 layout.numFaces, layout.faceSize);
+
+    PTexMeshData::MeshData oldMesh, newMesh;
+    const double oldTime = medianMilliseconds(repetitions, [&]() {
+      oldMesh = {};
+      oldParsePLY(filename, oldMesh);
+    });
+    const double newTime = medianMilliseconds(repetitions, [&]() {
+      newMesh = {};
+      PTexMeshData::parsePLY(filename, newMesh);
+    });
+    Cr::Utility::Directory::rm(filename);
+
+    const bool same = oldMesh.vbo == newMesh.vbo &&
+                      oldMesh.nbo == newMesh.nbo &&
+                      oldMesh.cbo == newMesh.cbo && oldMesh.ibo == newMesh.ibo;
+    if (!same) {
+      result = EXIT_FAILURE;
+    }
+    std::cout << layout.name << ", " << numVertices << " vertices, "
+              << layout.numFaces << " faces: old " << oldTime << " ms, new "
+              << newTime << " ms, " << oldTime / newTime << "x"
+              << (same ? "" : " (MISMATCH)") << std::endl;
+  }
+  return result;
+}
@@ -17,6 +17,8 @@ find_package(Corrade REQUIRED Utility)
 
 # OpenMP
 find_package(OpenMP)
+# Threads, for loading assets in the background
+find_package(Threads REQUIRED)
 # We don't find_package(OpenGL REQUIRED) here, but let Magnum do that instead
 # as it sets up various things related to GLVND.
 
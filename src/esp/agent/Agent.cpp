@@ -8,7 +8,11 @@
 #include <Magnum/EigenIntegration/Integration.h>
 
 #include "esp/scene/ObjectControls.h"
+#include "esp/sensor/DerivedCamera.h"
+#include "esp/sensor/MultiviewCamera.h"
+#include "esp/sensor/PanoramicCamera.h"
 #include "esp/sensor/PinholeCamera.h"
+#include "esp/sensor/RaycastCamera.h"
 #include "esp/sensor/Sensor.h"
 
 using Magnum::EigenIntegration::cast;
@@ -32,10 +36,35 @@ Agent::Agent(scene::SceneNode& agentNode, const AgentConfiguration& cfg)
   for (sensor::SensorSpec::ptr spec : cfg.sensorSpecifications) {
     // TODO: this should take type into account to create appropriate
     // sensor
+    if (!spec->parentUuid.empty()) {
+      continue;
+    }
 
     auto& sensorNode = agentNode.createChild();
-    sensors_.add(
-        sensor::PinholeCamera::create(sensorNode, spec));  // transformed within
+    if (spec->sensorSubtype == "raycast") {
+      sensors_.add(sensor::RaycastCamera::create(sensorNode, spec));
+    } else if (spec->sensorSubtype == "panoramic") {
+      sensors_.add(sensor::PanoramicCamera::create(sensorNode, spec));
+    } else if (spec->sensorSubtype == "multiview") {
+      sensors_.add(sensor::MultiviewCamera::create(sensorNode, spec));
+    } else {
+      sensors_.add(sensor::PinholeCamera::create(
+          sensorNode, spec));  // transformed within
+    }
+  }
+  // derived sensors share the render of a parent created above
+  for (sensor::SensorSpec::ptr spec : cfg.sensorSpecifications) {
+    if (spec->parentUuid.empty()) {
+      continue;
+    }
+    const auto& sensors = sensors_.getSensors();
+    const auto parent = sensors.find(spec->parentUuid);
+    CHECK(parent != sensors.end() &&
+          parent->second->specification()->parentUuid.empty())
+        << "Parent " << spec->parentUuid << " of sensor " << spec->uuid
+        << " is not a rendered sensor of the agent";
+    sensors_.add(sensor::DerivedCamera::create(agentNode.createChild(), spec,
+                                               parent->second));
   }
 }
 
@@ -19,5 +19,13 @@ bool BaseMesh::setMeshType(SupportedMeshType type) {
   return true;
 }
 
+size_t BaseMesh::getMemoryUsage() {
+  // positions and indices, once on the CPU and once on the GPU; other vertex
+  // attributes are not counted
+  const CollisionMeshData& meshData = getCollisionMeshData();
+  return 2 * (meshData.positions.size() * sizeof(Magnum::Vector3) +
+              meshData.indices.size() * sizeof(Magnum::UnsignedInt));
+}
+
 }  // namespace assets
 }  // namespace esp
@@ -46,6 +46,9 @@ class BaseMesh {
     return collisionMeshData_;
   }
 
+  //! Approximate CPU and GPU memory held by the mesh, in bytes
+  virtual size_t getMemoryUsage();
+
   // any transformations applied to the original mesh after load are stored
   // here.
   Magnum::Matrix4 meshTransform_;
@@ -0,0 +1,126 @@
+// Copyright (c) Facebook, Inc. and its affiliates.
+// This source code is licensed under the MIT license found in the
+// LICENSE file in the root directory of this source tree.
+
+#include "CollisionHulls.h"
+
+#include <Corrade/Containers/Optional.h>
+#include <Corrade/Utility/String.h>
+#include <Magnum/EigenIntegration/Integration.h>
+#include <Magnum/Mesh.h>
+#include <Magnum/Trade/AbstractImporter.h>
+#include <Magnum/Trade/MeshData3D.h>
+
+#include "MeshCache.h"
+
+namespace Cr = Corrade;
+
+namespace esp {
+namespace assets {
+
+namespace {
+// "EHUL" and format version of collision hull files
+constexpr uint32_t kCollisionHullsMagic = 0x4c554845;
+constexpr uint32_t kCollisionHullsVersion = 1;
+}  // namespace
+
+std::string collisionHullsFilename(const std::string& objPhysConfigFilename) {
+  const std::string suffix = ".phys_properties.json";
+  std::string stem = objPhysConfigFilename;
+  if (Cr::Utility::String::endsWith(stem, suffix)) {
+    stem = Cr::Utility::String::stripSuffix(stem, suffix);
+  }
+  return stem + ".collision_hulls";
+}
+
+std::vector<CollisionHull> computeCollisionHulls(
+    Magnum::Trade::AbstractImporter& importer,
+    const geo::ConvexDecompositionSettings& settings /* = {} */) {
+  std::vector<CollisionHull> hulls;
+  for (uint32_t iMesh = 0; iMesh < importer.mesh3DCount(); ++iMesh) {
+    Cr::Containers::Optional<Magnum::Trade::MeshData3D> mesh =
+        importer.mesh3D(iMesh);
+    if (!mesh || !mesh->isIndexed() || mesh->positionArrayCount() == 0 ||
+        mesh->primitive() != Magnum::MeshPrimitive::Triangles) {
+      LOG(WARNING) << "Skipping mesh " << iMesh
+                   << ", which is not an indexed triangle mesh";
+      continue;
+    }
+    std::vector<vec3f> positions;
+    positions.reserve(mesh->positions(0).size());
+    for (const Magnum::Vector3& p : mesh->positions(0)) {
+      positions.emplace_back(Magnum::EigenIntegration::cast<vec3f>(p));
+    }
+    for (const std::vector<vec3f>& points :
+         geo::decomposeConvex(positions, mesh->indices(), settings)) {
+      hulls.emplace_back();
+      hulls.back().meshIndex = iMesh;
+      for (const vec3f& p : points) {
+        hulls.back().points.emplace_back(p);
+      }
+    }
+  }
+  return hulls;
+}
+
+bool saveCollisionHulls(const std::string& hullsFile,
+                        const std::string& meshFile,
+                        const std::vector<CollisionHull>& hulls) {
+  MeshCacheHeader header;
+  if (!meshCacheHeader(meshFile, kCollisionHullsMagic, kCollisionHullsVersion,
+                       0.0f, header)) {
+    return false;
+  }
+  header.count = hulls.size();
+  MeshCacheWriter writer;
+  if (!writer.open(hullsFile, header)) {
+    return false;
+  }
+  // mesh index and number of points of each hull, then all points
+  std::vector<uint32_t> sizes;
+  std::vector<Magnum::Vector3> points;
+  for (const CollisionHull& hull : hulls) {
+    sizes.push_back(hull.meshIndex);
+    sizes.push_back(hull.points.size());
+    points.insert(points.end(), hull.points.begin(), hull.points.end());
+  }
+  writer.write(sizes);
+  writer.write(points);
+  return writer.commit();
+}
+
+bool loadCollisionHulls(const std::string& hullsFile,
+                        const std::string& meshFile,
+                        std::vector<CollisionHull>& hulls) {
+  MeshCacheHeader expected;
+  MeshCacheReader reader;
+  if (!meshCacheHeader(meshFile, kCollisionHullsMagic, kCollisionHullsVersion,
+                       0.0f, expected) ||
+      !reader.open(hullsFile, expected)) {
+    return false;
+  }
+
+  std::vector<uint32_t> sizes;
+  std::vector<Magnum::Vector3> points;
+  bool valid = reader.read(2 * uint64_t(reader.header().count), sizes);
+  uint64_t numPoints = 0;
+  for (size_t i = 1; i < sizes.size(); i += 2) {
+    numPoints += sizes[i];
+  }
+  if (!valid || !reader.read(numPoints, points) || !reader.atEnd()) {
+    LOG(WARNING) << "Ignoring truncated collision hulls " << hullsFile;
+    return false;
+  }
+
+  hulls.resize(reader.header().count);
+  auto point = points.begin();
+  for (size_t i = 0; i < hulls.size(); ++i) {
+    hulls[i].meshIndex = sizes[2 * i];
+    hulls[i].points.assign(point, point + sizes[2 * i + 1]);
+    point += sizes[2 * i + 1];
+  }
+  return true;
+}
+
+}  // namespace assets
+}  // namespace esp
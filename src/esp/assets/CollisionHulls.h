@@ -0,0 +1,50 @@
+// Copyright (c) Facebook, Inc. and its affiliates.
+// This source code is licensed under the MIT license found in the
+// LICENSE file in the root directory of this source tree.
+
+#pragma once
+
+#include <string>
+#include <vector>
+
+#include <Magnum/Math/Vector3.h>
+#include <Magnum/Trade/Trade.h>
+
+#include "esp/core/esp.h"
+#include "esp/geo/ConvexDecomposition.h"
+
+namespace esp {
+namespace assets {
+
+//! Convex hull of a part of a mesh of a collision mesh file
+struct CollisionHull {
+  //! Index of the mesh in the file
+  uint32_t meshIndex = 0;
+  std::vector<Magnum::Vector3> points;
+};
+
+//! File of the convex decomposition of the collision mesh of an object, next
+//! to its physics properties file: "cheezit.phys_properties.json" ->
+//! "cheezit.collision_hulls"
+std::string collisionHullsFilename(const std::string& objPhysConfigFilename);
+
+//! Decompose every triangle mesh of the file open in importer into convex
+//! hulls, in the coordinates of the file
+std::vector<CollisionHull> computeCollisionHulls(
+    Magnum::Trade::AbstractImporter& importer,
+    const geo::ConvexDecompositionSettings& settings =
+        geo::ConvexDecompositionSettings{});
+
+//! Write the hulls decomposing meshFile to hullsFile
+bool saveCollisionHulls(const std::string& hullsFile,
+                        const std::string& meshFile,
+                        const std::vector<CollisionHull>& hulls);
+
+//! Read the hulls decomposing meshFile from hullsFile. Returns false if it is
+//! missing, or was not written for meshFile as it is now.
+bool loadCollisionHulls(const std::string& hullsFile,
+                        const std::string& meshFile,
+                        std::vector<CollisionHull>& hulls);
+
+}  // namespace assets
+}  // namespace esp
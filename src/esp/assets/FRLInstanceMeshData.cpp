@@ -214,13 +214,6 @@ void FRLInstanceMeshData::to_ply(const std::string& ply_file) const {
           sizeof(float) * grav_size);
 }
 
-Magnum::GL::Mesh* FRLInstanceMeshData::getMagnumGLMesh() {
-  if (renderingBuffer_ == nullptr) {
-    return nullptr;
-  }
-  return &(renderingBuffer_->mesh);
-}
-
 void FRLInstanceMeshData::uploadBuffersToGPU(bool forceReload) {
   if (forceReload) {
     buffersOnGPU_ = false;
@@ -229,44 +222,14 @@ void FRLInstanceMeshData::uploadBuffersToGPU(bool forceReload) {
     return;
   }
 
-  renderingBuffer_.reset();
-  renderingBuffer_ = std::make_unique<FRLInstanceMeshData::RenderingBuffer>();
-
-  const size_t numQuads = cpu_vbo_.size() / 4;
-
-  cbo_float_ = new std::vector<float>(cpu_cbo_.size() * 3);
-  for (int iVert = 0; iVert < cpu_cbo_.size(); ++iVert) {
-    const uint32_t idx = 3 * iVert;
-    (*cbo_float_)[idx + 0] = cpu_cbo_[iVert][0] / 255.0f;
-    (*cbo_float_)[idx + 1] = cpu_cbo_[iVert][1] / 255.0f;
-    (*cbo_float_)[idx + 2] = cpu_cbo_[iVert][2] / 255.0f;
-  }
-
-  // See code for GenericInstanceMeshData::uploadBuffersToGPU for comments about
-  // what's going on with this image/texture
-  const size_t numTris = numQuads * 2;
-  const int texSize = std::pow(2, std::ceil(std::log2(std::sqrt(numTris))));
-  obj_id_tex_data_ = new float[texSize * texSize]();
-
-  for (size_t i = 0; i < numQuads; ++i) {
-    obj_id_tex_data_[2 * i] = cpu_vbo_[4 * i][3];
-    obj_id_tex_data_[2 * i + 1] = cpu_vbo_[4 * i][3];
+  // every quad is two triangles with the id of its first vertex
+  std::vector<float> objectIds(tri_ibo_->size() / 3);
+  for (size_t i = 0; i < objectIds.size(); ++i) {
+    objectIds[i] = cpu_vbo_[4 * (i / 2)][3];
   }
-
-  renderingBuffer_->tex = createInstanceTexture(obj_id_tex_data_, texSize);
-  renderingBuffer_->vbo.setData(*cpu_vbo_3_,
-                                Magnum::GL::BufferUsage::StaticDraw);
-  renderingBuffer_->cbo.setData(*cbo_float_,
-                                Magnum::GL::BufferUsage::StaticDraw);
-  renderingBuffer_->ibo.setData(*tri_ibo_, Magnum::GL::BufferUsage::StaticDraw);
-  renderingBuffer_->mesh.setPrimitive(Magnum::GL::MeshPrimitive::Triangles)
-      .setCount(tri_ibo_->size())  // Set vertex/index count (numQuads * 6)
-      .addVertexBuffer(renderingBuffer_->vbo, 0,
-                       Magnum::GL::Attribute<0, Magnum::Vector3>{})
-      .addVertexBuffer(renderingBuffer_->cbo, 0,
-                       Magnum::GL::Attribute<1, Magnum::Color3>{})
-      .setIndexBuffer(renderingBuffer_->ibo, 0,
-                      Magnum::GL::MeshIndexType::UnsignedInt);
+  uploadCompactMesh(Corrade::Containers::arrayView(*cpu_vbo_3_),
+                    Corrade::Containers::arrayView(cpu_cbo_),
+                    Corrade::Containers::arrayView(*tri_ibo_), objectIds);
 
   buffersOnGPU_ = true;
 }
@@ -7,6 +7,7 @@
 #include <Corrade/Containers/Array.h>
 #include <Corrade/Containers/ArrayView.h>
 #include <Corrade/Containers/ArrayViewStl.h>
+#include <Magnum/EigenIntegration/Integration.h>
 #include <Magnum/GL/Texture.h>
 #include <Magnum/GL/TextureFormat.h>
 #include <Magnum/Image.h>
@@ -23,7 +24,9 @@
 #include <unordered_map>
 #include <vector>
 
+#include "MeshCache.h"
 #include "esp/core/esp.h"
+#include "esp/geo/MeshCompaction.h"
 #include "esp/geo/geo.h"
 #include "esp/io/io.h"
 #include "esp/io/json.h"
@@ -32,6 +35,10 @@ namespace esp {
 namespace assets {
 
 namespace {
+// "EIMC" and format version of instance mesh cache files
+constexpr uint32_t kInstanceCacheMagic = 0x434d4945;
+constexpr uint32_t kInstanceCacheVersion = 1;
+
 template <typename T>
 void copyTo(std::shared_ptr<tinyply::PlyData> data, std::vector<T>& dst) {
   dst.resize(data->count);
@@ -199,21 +206,113 @@ bool GenericInstanceMeshData::loadPLY(const std::string& plyFile) {
     xyz = T_esp_scene * xyz;
   }
 
+  viewBuffers();
+  return true;
+}
+
+bool GenericInstanceMeshData::loadSharedPLY(const std::string& plyFile,
+                                            const std::string& cacheDir) {
+  const std::string cacheFile =
+      meshCacheFilename(cacheDir, plyFile, "instance");
+  if (loadCache(cacheFile, plyFile)) {
+    VLOG(1) << "Mapped mesh from cache " << cacheFile;
+    return true;
+  }
+  if (!loadPLY(plyFile)) {
+    return false;
+  }
+  if (!saveCache(cacheFile, plyFile)) {
+    LOG(WARNING) << "Cannot write mesh cache " << cacheFile;
+    return true;
+  }
+  // drop the private copy for the one shared with other processes
+  loadCache(cacheFile, plyFile);
+  return true;
+}
+
+void GenericInstanceMeshData::viewBuffers() {
+  mappedCache_ = nullptr;
+  vboView_ = cpu_vbo_;
+  cboView_ = cpu_cbo_;
+  iboView_ = cpu_ibo_;
+  objectIdsView_ = objectIds_;
+  updateCollisionMeshData();
+}
+
+void GenericInstanceMeshData::updateCollisionMeshData() {
   // Construct vertices for collsion meshData
   // Store indices, facd_ids in Magnum MeshData3D format such that
   // later they can be accessed.
-  // Note that normal and texture data are not stored
+  // Note that normal and texture data are not stored. The buffers are never
+  // written through it, so it can point into a read-only mapping.
   collisionMeshData_.primitive = Magnum::MeshPrimitive::Triangles;
   collisionMeshData_.positions =
       Corrade::Containers::arrayCast<Magnum::Vector3>(
-          Corrade::Containers::arrayView(cpu_vbo_.data(), cpu_vbo_.size()));
+          Corrade::Containers::arrayView(const_cast<vec3f*>(vboView_.data()),
+                                         vboView_.size()));
   collisionMeshData_.indices =
       Corrade::Containers::arrayCast<Magnum::UnsignedInt>(
-          Corrade::Containers::arrayView(cpu_ibo_.data(), cpu_ibo_.size()));
+          Corrade::Containers::arrayView(const_cast<vec3ui*>(iboView_.data()),
+                                         iboView_.size()));
+}
+
+bool GenericInstanceMeshData::loadCache(const std::string& cacheFile,
+                                        const std::string& plyFile) {
+  MeshCacheHeader expected;
+  MeshCacheReader reader;
+  if (!meshCacheHeader(plyFile, kInstanceCacheMagic, kInstanceCacheVersion,
+                       0.0f, expected) ||
+      !reader.open(cacheFile, expected)) {
+    return false;
+  }
+
+  uint64_t counts[4]{};
+  Corrade::Containers::ArrayView<const vec3f> vbo;
+  Corrade::Containers::ArrayView<const vec3uc> cbo;
+  Corrade::Containers::ArrayView<const vec3ui> ibo;
+  Corrade::Containers::ArrayView<const uint32_t> objectIds;
+  if (!reader.read(4, counts) || !reader.view(counts[0], vbo) ||
+      !reader.view(counts[1], cbo) || !reader.view(counts[2], ibo) ||
+      !reader.view(counts[3], objectIds) || !reader.atEnd()) {
+    LOG(WARNING) << "Ignoring truncated mesh cache " << cacheFile;
+    return false;
+  }
 
+  cpu_vbo_ = std::vector<vec3f>{};
+  cpu_cbo_ = std::vector<vec3uc>{};
+  cpu_ibo_ = std::vector<vec3ui>{};
+  objectIds_ = std::vector<uint32_t>{};
+  mappedCache_ = reader.release();
+  vboView_ = vbo;
+  cboView_ = cbo;
+  iboView_ = ibo;
+  objectIdsView_ = objectIds;
+  updateCollisionMeshData();
   return true;
 }
 
+bool GenericInstanceMeshData::saveCache(const std::string& cacheFile,
+                                        const std::string& plyFile) const {
+  MeshCacheHeader header;
+  if (!meshCacheHeader(plyFile, kInstanceCacheMagic, kInstanceCacheVersion,
+                       0.0f, header)) {
+    return false;
+  }
+  header.count = 1;
+  MeshCacheWriter writer;
+  if (!writer.open(cacheFile, header)) {
+    return false;
+  }
+  const uint64_t counts[] = {vboView_.size(), cboView_.size(),
+                             iboView_.size(), objectIdsView_.size()};
+  writer.write(counts, 4);
+  writer.write(vboView_);
+  writer.write(cboView_);
+  writer.write(iboView_);
+  writer.write(objectIdsView_);
+  return writer.commit();
+}
+
 void GenericInstanceMeshData::uploadBuffersToGPU(bool forceReload) {
   if (forceReload) {
     buffersOnGPU_ = false;
@@ -222,56 +321,87 @@ void GenericInstanceMeshData::uploadBuffersToGPU(bool forceReload) {
     return;
   }
 
+  std::vector<float> objectIds(objectIdsView_.begin(), objectIdsView_.end());
+  uploadCompactMesh(
+      vboView_, cboView_,
+      Corrade::Containers::arrayCast<const uint32_t>(iboView_), objectIds);
+
+  buffersOnGPU_ = true;
+}
+
+void GenericInstanceMeshData::uploadCompactMesh(
+    Corrade::Containers::ArrayView<const vec3f> positions,
+    Corrade::Containers::ArrayView<const vec3uc> colors,
+    Corrade::Containers::ArrayView<const uint32_t> indices,
+    const std::vector<float>& objectIds) {
+  typedef Magnum::GL::Attribute<0, Magnum::Vector3> Position;
+  typedef Magnum::GL::Attribute<1, Magnum::Color3> Color;
+
+  const geo::CompactMesh compact = geo::compactMesh(positions, colors, indices);
+
   renderingBuffer_.reset();
   renderingBuffer_ =
       std::make_unique<GenericInstanceMeshData::RenderingBuffer>();
 
-  // convert uchar rgb to float rgb
-  std::vector<vec3f> cbo_float_;
-  cbo_float_.reserve(cpu_cbo_.size());
-  for (const auto& c : cpu_cbo_) {
-    cbo_float_.emplace_back(c.cast<float>() / 255.0f);
-  }
-
   /*
    * Textures in OpenGL must be square and must have a sizes that are powers of
    * 2, so first compute the size of the smallest texture that can contain our
    * array.  Then copy the object id's buffer into the texture data buffer as
-   * floats.
+   * floats, in the order the compacted triangles are drawn in.
    */
-  const int nPrims = cpu_ibo_.size();
+  const int nPrims = compact.triangles.size();
   const int texSize = std::pow(2, std::ceil(std::log2(std::sqrt(nPrims))));
   // The image takes ownership over the obj_id_tex_data array, so there is no
   // delete
   float* obj_id_tex_data = new float[texSize * texSize]();
   for (size_t i = 0; i < nPrims; ++i) {
-    obj_id_tex_data[i] = static_cast<float>(objectIds_[i]);
+    obj_id_tex_data[i] = objectIds[compact.triangles[i]];
   }
 
   // Takes ownership of the data pointer
   renderingBuffer_->tex = createInstanceTexture(obj_id_tex_data, texSize);
 
-  renderingBuffer_->vbo.setData(cpu_vbo_, Magnum::GL::BufferUsage::StaticDraw);
-  renderingBuffer_->cbo.setData(cbo_float_,
+  // the vertex fetch normalizes the quantized positions and the colors, the
+  // drawable scales the positions back with positionDecode
+  renderingBuffer_->positionDecode =
+      Magnum::Matrix4::translation(Magnum::Vector3{compact.positionOffset}) *
+      Magnum::Matrix4::scaling(Magnum::Vector3{compact.positionScale});
+  renderingBuffer_->vbo.setData(compact.vertices,
+                                Magnum::GL::BufferUsage::StaticDraw);
+  renderingBuffer_->ibo.setData(compact.indices,
                                 Magnum::GL::BufferUsage::StaticDraw);
-  renderingBuffer_->ibo.setData(cpu_ibo_, Magnum::GL::BufferUsage::StaticDraw);
-  renderingBuffer_->mesh.setPrimitive(Magnum::GL::MeshPrimitive::Triangles)
-      .setCount(nPrims * 3)
-      .addVertexBuffer(renderingBuffer_->vbo, 0,
-                       Magnum::GL::Attribute<0, Magnum::Vector3>{})
-      .addVertexBuffer(renderingBuffer_->cbo, 0,
-                       Magnum::GL::Attribute<1, Magnum::Color3>{})
-      .setIndexBuffer(renderingBuffer_->ibo, 0,
-                      Magnum::GL::MeshIndexType::UnsignedInt);
 
-  buffersOnGPU_ = true;
+  // every chunk starts its vertices and indices at an offset into the shared
+  // buffers, and its primitive ids at 0
+  for (const geo::CompactMeshChunk& chunk : compact.chunks) {
+    Magnum::GL::Mesh mesh;
+    mesh.setPrimitive(Magnum::GL::MeshPrimitive::Triangles)
+        .setCount(chunk.numTriangles * 3)
+        .addVertexBuffer(
+            renderingBuffer_->vbo,
+            chunk.firstVertex * sizeof(geo::CompactVertex),
+            Position{Position::DataType::Short,
+                     Position::DataOption::Normalized},
+            sizeof(geo::CompactVertex::positionPadding),
+            Color{Color::DataType::UnsignedByte, Color::DataOption::Normalized},
+            sizeof(geo::CompactVertex::colorPadding))
+        .setIndexBuffer(renderingBuffer_->ibo,
+                        chunk.firstTriangle * 3 * sizeof(uint16_t),
+                        Magnum::GL::MeshIndexType::UnsignedShort);
+    renderingBuffer_->chunks.push_back(
+        {std::move(mesh), static_cast<int>(chunk.firstTriangle)});
+  }
 }
 
 Magnum::GL::Mesh* GenericInstanceMeshData::getMagnumGLMesh() {
-  if (renderingBuffer_ == nullptr) {
+  return getMagnumGLMesh(0);
+}
+
+Magnum::GL::Mesh* GenericInstanceMeshData::getMagnumGLMesh(int chunkID) {
+  if (chunkID >= getNumChunks()) {
     return nullptr;
   }
-  return &(renderingBuffer_->mesh);
+  return &(renderingBuffer_->chunks[chunkID].mesh);
 }
 
 }  // namespace assets
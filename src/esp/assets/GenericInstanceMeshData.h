@@ -4,10 +4,14 @@
 
 #pragma once
 
+#include <Corrade/Containers/Array.h>
+#include <Corrade/Containers/ArrayView.h>
 #include <Corrade/Containers/Optional.h>
+#include <Corrade/Utility/Directory.h>
 #include <Magnum/GL/Buffer.h>
 #include <Magnum/GL/Mesh.h>
 #include <Magnum/GL/Texture.h>
+#include <Magnum/Math/Matrix4.h>
 #include <Magnum/Trade/MeshData3D.h>
 #include <memory>
 #include <string>
@@ -28,11 +32,22 @@ Magnum::GL::Texture2D createInstanceTexture(float* data, const int texSize);
 class GenericInstanceMeshData : public BaseMesh {
  public:
   struct RenderingBuffer {
-    Magnum::GL::Mesh mesh;
+    // a chunk of the compacted mesh, see geo::CompactMeshChunk
+    struct Chunk {
+      Magnum::GL::Mesh mesh;
+      // texel of tex holding the object id of the first triangle
+      int primitiveIdOffset;
+    };
+
+    // interleaved quantized positions and colors, see geo::compactMesh()
     Magnum::GL::Buffer vbo;
-    Magnum::GL::Buffer cbo;
+    // 16 bit indices, relative to the first vertex of their chunk
     Magnum::GL::Buffer ibo;
     Magnum::GL::Texture2D tex;
+    // drawn with one draw call each, from vbo and ibo
+    std::vector<Chunk> chunks;
+    // transformation from the normalized positions in vbo to mesh space
+    Magnum::Matrix4 positionDecode;
   };
 
   explicit GenericInstanceMeshData(SupportedMeshType type) : BaseMesh{type} {};
@@ -43,6 +58,12 @@ class GenericInstanceMeshData : public BaseMesh {
 
   virtual bool loadPLY(const std::string& plyFile);
 
+  //! Load plyFile through its cache file in cacheDir, writing the cache
+  //! first if it is missing or outdated. The buffers are used in place from
+  //! a read-only mapping of the cache file, shared by all processes loading
+  //! the mesh.
+  bool loadSharedPLY(const std::string& plyFile, const std::string& cacheDir);
+
   virtual Magnum::GL::Texture2D* getSemanticTexture() {
     return &renderingBuffer_->tex;
   };
@@ -51,27 +72,76 @@ class GenericInstanceMeshData : public BaseMesh {
   virtual void uploadBuffersToGPU(bool forceReload = false) override;
   RenderingBuffer* getRenderingBuffer() { return renderingBuffer_.get(); }
 
+  //! Mesh of the first chunk, the only one unless the mesh has more than
+  //! geo::kMaxChunkVertices vertices
   virtual Magnum::GL::Mesh* getMagnumGLMesh() override;
+  //! Mesh of a chunk, see getNumChunks()
+  virtual Magnum::GL::Mesh* getMagnumGLMesh(int chunkID) override;
+
+  //! Number of chunks the mesh is drawn in, once uploaded
+  int getNumChunks() const {
+    return renderingBuffer_ == nullptr ? 0 : renderingBuffer_->chunks.size();
+  }
 
-  const std::vector<vec3f>& getVertexBufferObjectCPU() const {
-    return cpu_vbo_;
+  Corrade::Containers::ArrayView<const vec3f> getVertexBufferObjectCPU()
+      const {
+    return vboView_;
+  }
+  Corrade::Containers::ArrayView<const vec3uc> getColorBufferObjectCPU()
+      const {
+    return cboView_;
   }
-  const std::vector<vec3uc>& getColorBufferObjectCPU() const {
-    return cpu_cbo_;
+
+  Corrade::Containers::ArrayView<const vec3ui> getIndexBufferObjectCPU()
+      const {
+    return iboView_;
   }
 
-  const std::vector<vec3ui>& getIndexBufferObjectCPU() const {
-    return cpu_ibo_;
+  //! Object id of each triangle, as looked up by the instance mesh shader
+  const Corrade::Containers::ArrayView<const uint32_t>& getObjectIdsCPU()
+      const {
+    return objectIdsView_;
   }
 
  protected:
+  //! Point the buffer views and the collision mesh data at the buffers
+  void viewBuffers();
+
+  //! Map the buffers from cacheFile. Returns false if it is missing or was
+  //! not written for the current plyFile.
+  bool loadCache(const std::string& cacheFile, const std::string& plyFile);
+
+  //! Write the buffers loaded from plyFile to cacheFile
+  bool saveCache(const std::string& cacheFile,
+                 const std::string& plyFile) const;
+
+  //! Point the collision mesh data at the buffer views
+  void updateCollisionMeshData();
+
+  //! Compact the triangle mesh with geo::compactMesh() and upload it,
+  //! together with the texture of the object ids of its triangles
+  void uploadCompactMesh(Corrade::Containers::ArrayView<const vec3f> positions,
+                         Corrade::Containers::ArrayView<const vec3uc> colors,
+                         Corrade::Containers::ArrayView<const uint32_t> indices,
+                         const std::vector<float>& objectIds);
+
   // ==== rendering ====
   std::unique_ptr<RenderingBuffer> renderingBuffer_ = nullptr;
 
+  // buffers as loaded, empty if they are mapped from a cache file
   std::vector<vec3f> cpu_vbo_;
   std::vector<vec3uc> cpu_cbo_;
   std::vector<vec3ui> cpu_ibo_;
   std::vector<uint32_t> objectIds_;
+
+  // views of the buffers, on the vectors above or on the mapped cache file
+  Corrade::Containers::ArrayView<const vec3f> vboView_;
+  Corrade::Containers::ArrayView<const vec3uc> cboView_;
+  Corrade::Containers::ArrayView<const vec3ui> iboView_;
+  Corrade::Containers::ArrayView<const uint32_t> objectIdsView_;
+  Corrade::Containers::Array<const char,
+                             Corrade::Utility::Directory::MapDeleter>
+      mappedCache_;
 };
 }  // namespace assets
 }  // namespace esp
@@ -3,11 +3,25 @@
 // LICENSE file in the root directory of this source tree.
 
 #include "GltfMeshData.h"
+
+#include <algorithm>
+#include <fstream>
+
 #include <Corrade/Containers/ArrayViewStl.h>
+#include <Magnum/Math/Functions.h>
 #include <Magnum/MeshTools/Compile.h>
 
+#include "esp/geo/MeshSimplification.h"
+
 namespace esp {
 namespace assets {
+
+namespace {
+// "ELOD" and format version of LOD cache files
+constexpr uint32_t kLodCacheMagic = 0x444f4c45;
+constexpr uint32_t kLodCacheVersion = 1;
+}  // namespace
+
 void GltfMeshData::uploadBuffersToGPU(bool forceReload) {
   if (forceReload) {
     buffersOnGPU_ = false;
@@ -20,6 +34,13 @@ void GltfMeshData::uploadBuffersToGPU(bool forceReload) {
   renderingBuffer_ = std::make_unique<GltfMeshData::RenderingBuffer>();
   // position, normals, uv, colors are bound to corresponding attributes
   renderingBuffer_->mesh = Magnum::MeshTools::compile(*meshData_);
+  if (!lodLevels_.empty()) {
+    renderingBuffer_->lodIndexBuffer = Magnum::GL::Buffer{};
+    renderingBuffer_->lodIndexBuffer.setData(
+        lodIndices_, Magnum::GL::BufferUsage::StaticDraw);
+    currentLod_ = lodLevels_.size();
+    setLod(0);
+  }
   buffersOnGPU_ = true;
 }
 
@@ -41,5 +62,172 @@ void GltfMeshData::setMeshData(Magnum::Trade::AbstractImporter& importer,
   collisionMeshData_.indices = meshData_->indices();
 }
 
+bool GltfMeshData::setupLods(int numLevels, const std::string& cacheFile) {
+  lodIndices_.clear();
+  lodLevels_.clear();
+  if (numLevels <= 0 || !meshData_ || !meshData_->isIndexed() ||
+      meshData_->primitive() != Magnum::MeshPrimitive::Triangles) {
+    return false;
+  }
+
+  const std::vector<Magnum::Vector3>& positions = meshData_->positions(0);
+  if (positions.empty()) {
+    return false;
+  }
+  Magnum::Vector3 min = positions[0];
+  Magnum::Vector3 max = positions[0];
+  for (const Magnum::Vector3& p : positions) {
+    min = Magnum::Math::min(min, p);
+    max = Magnum::Math::max(max, p);
+  }
+  lodCenter_ = (min + max) * 0.5f;
+  lodRadius_ = (max - min).length() * 0.5f;
+
+  if (loadLods(cacheFile)) {
+    return true;
+  }
+
+  const std::vector<Magnum::UnsignedInt>& indices = meshData_->indices();
+  std::vector<vec3f> points;
+  points.reserve(positions.size());
+  for (const Magnum::Vector3& p : positions) {
+    points.emplace_back(p.x(), p.y(), p.z());
+  }
+
+  lodIndices_ = indices;
+  lodLevels_.push_back({0, static_cast<uint32_t>(indices.size()), 0.0f});
+  std::vector<uint32_t> levelIndices = indices;
+  for (int i = 0; i < numLevels; ++i) {
+    // simplify the previous level, which is cheaper and keeps levels nested
+    float error = 0.0f;
+    std::vector<uint32_t> simplified = geo::simplifyMesh(
+        points, levelIndices, levelIndices.size() / 2, &error);
+    if (simplified.size() >= levelIndices.size() * 9 / 10) {
+      // locked borders and seams prevent further simplification
+      break;
+    }
+    error = std::max(error, lodLevels_.back().error);
+    lodLevels_.push_back({static_cast<uint32_t>(lodIndices_.size()),
+                          static_cast<uint32_t>(simplified.size()), error});
+    lodIndices_.insert(lodIndices_.end(), simplified.begin(), simplified.end());
+    levelIndices = std::move(simplified);
+  }
+
+  if (lodLevels_.size() == 1) {
+    lodIndices_.clear();
+    lodLevels_.clear();
+    return false;
+  }
+  if (!saveLods(cacheFile)) {
+    LOG(WARNING) << "Could not write level of detail cache " << cacheFile;
+  }
+  return true;
+}
+
+bool GltfMeshData::loadLods(const std::string& cacheFile) {
+  std::ifstream file(cacheFile, std::ios::binary);
+  if (!file.good()) {
+    return false;
+  }
+
+  uint32_t header[2];
+  uint64_t numVertices = 0, numIndices = 0, numLevels = 0;
+  file.read(reinterpret_cast<char*>(header), sizeof(header));
+  file.read(reinterpret_cast<char*>(&numVertices), sizeof(numVertices));
+  file.read(reinterpret_cast<char*>(&numIndices), sizeof(numIndices));
+  file.read(reinterpret_cast<char*>(&numLevels), sizeof(numLevels));
+  const std::vector<Magnum::UnsignedInt>& indices = meshData_->indices();
+  if (!file.good() || header[0] != kLodCacheMagic ||
+      header[1] != kLodCacheVersion ||
+      numVertices != meshData_->positions(0).size() ||
+      numIndices < indices.size() || numLevels < 2) {
+    LOG(WARNING) << "Ignoring outdated level of detail cache " << cacheFile;
+    return false;
+  }
+
+  lodLevels_.resize(numLevels);
+  lodIndices_.resize(numIndices);
+  file.read(reinterpret_cast<char*>(lodLevels_.data()),
+            lodLevels_.size() * sizeof(LodLevel));
+  file.read(reinterpret_cast<char*>(lodIndices_.data()),
+            lodIndices_.size() * sizeof(uint32_t));
+
+  // level 0 is the mesh itself, so a changed mesh is detected
+  bool valid = file.good() && lodLevels_[0].indexOffset == 0 &&
+               lodLevels_[0].indexCount == indices.size() &&
+               std::equal(indices.begin(), indices.end(), lodIndices_.begin());
+  for (const LodLevel& level : lodLevels_) {
+    valid = valid && uint64_t(level.indexOffset) + level.indexCount <=
+                         lodIndices_.size();
+  }
+  if (!valid) {
+    LOG(WARNING) << "Ignoring outdated level of detail cache " << cacheFile;
+    lodIndices_.clear();
+    lodLevels_.clear();
+    return false;
+  }
+  return true;
+}
+
+bool GltfMeshData::saveLods(const std::string& cacheFile) const {
+  std::ofstream file(cacheFile, std::ios::binary | std::ios::trunc);
+  if (!file.good()) {
+    return false;
+  }
+  const uint32_t header[] = {kLodCacheMagic, kLodCacheVersion};
+  const uint64_t numVertices = meshData_->positions(0).size();
+  const uint64_t numIndices = lodIndices_.size();
+  const uint64_t numLevels = lodLevels_.size();
+  file.write(reinterpret_cast<const char*>(header), sizeof(header));
+  file.write(reinterpret_cast<const char*>(&numVertices), sizeof(numVertices));
+  file.write(reinterpret_cast<const char*>(&numIndices), sizeof(numIndices));
+  file.write(reinterpret_cast<const char*>(&numLevels), sizeof(numLevels));
+  file.write(reinterpret_cast<const char*>(lodLevels_.data()),
+             lodLevels_.size() * sizeof(LodLevel));
+  file.write(reinterpret_cast<const char*>(lodIndices_.data()),
+             lodIndices_.size() * sizeof(uint32_t));
+  return file.good();
+}
+
+size_t GltfMeshData::selectLod(const Magnum::Matrix4& transformationMatrix,
+                               const Magnum::Matrix4& projectionMatrix,
+                               int viewportHeight,
+                               float maxPixelError /* = 1.0f */) const {
+  if (lodLevels_.size() < 2) {
+    return 0;
+  }
+  const float scale = transformationMatrix.scaling().max();
+  const float distance =
+      transformationMatrix.transformPoint(lodCenter_).length() -
+      lodRadius_ * scale;
+  if (distance <= 0.0f) {
+    return 0;
+  }
+  // projectionMatrix[1][1] is 1 / tan(vertical fov / 2)
+  const float pixelsPerUnit =
+      0.5f * viewportHeight * projectionMatrix[1][1] / distance;
+  for (size_t level = lodLevels_.size() - 1; level > 0; --level) {
+    if (lodLevels_[level].error * scale * pixelsPerUnit <= maxPixelError) {
+      return level;
+    }
+  }
+  return 0;
+}
+
+void GltfMeshData::setLod(size_t level) {
+  if (renderingBuffer_ == nullptr || lodLevels_.empty() ||
+      level == currentLod_) {
+    return;
+  }
+  ASSERT(level < lodLevels_.size());
+  const LodLevel& lod = lodLevels_[level];
+  renderingBuffer_->mesh
+      .setIndexBuffer(renderingBuffer_->lodIndexBuffer,
+                      lod.indexOffset * sizeof(uint32_t),
+                      Magnum::MeshIndexType::UnsignedInt)
+      .setCount(lod.indexCount);
+  currentLod_ = level;
+}
+
 }  // namespace assets
 }  // namespace esp
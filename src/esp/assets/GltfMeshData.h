@@ -3,7 +3,11 @@
 // LICENSE file in the root directory of this source tree.
 
 #pragma once
+#include <string>
+#include <vector>
+
 #include <Corrade/Containers/Optional.h>
+#include <Magnum/GL/Buffer.h>
 #include <Magnum/GL/Mesh.h>
 #include <Magnum/Trade/AbstractImporter.h>
 #include <Magnum/Trade/MeshData3D.h>
@@ -17,6 +21,16 @@ class GltfMeshData : public BaseMesh {
  public:
   struct RenderingBuffer {
     Magnum::GL::Mesh mesh;
+    //! indices of all levels of detail, if any, which mesh draws from
+    Magnum::GL::Buffer lodIndexBuffer{Magnum::NoCreate};
+  };
+
+  //! A level of detail, i.e. a range of the concatenated LOD indices
+  struct LodLevel {
+    uint32_t indexOffset;
+    uint32_t indexCount;
+    //! Estimated geometric error of the level in mesh space, 0 for level 0
+    float error;
   };
   GltfMeshData() : BaseMesh(SupportedMeshType::GLTF_MESH){};
 
@@ -32,7 +46,47 @@ class GltfMeshData : public BaseMesh {
 
   virtual Magnum::GL::Mesh* getMagnumGLMesh() override;
 
+  /**
+   * @brief Set up numLevels coarser levels of detail for this mesh.
+   *
+   * Levels are read from cacheFile if it holds levels for this mesh,
+   * otherwise they are generated with quadric error simplification, each
+   * level having about half the triangles of the previous one, and saved to
+   * cacheFile. Levels share the vertices of the full resolution mesh and only
+   * add indices. Must be called before @ref uploadBuffersToGPU().
+   *
+   * @return Whether levels of detail are available
+   */
+  bool setupLods(int numLevels, const std::string& cacheFile);
+
+  //! Number of levels of detail, including the full resolution level 0
+  size_t getNumLods() const { return lodLevels_.size(); }
+
+  /**
+   * @brief Coarsest level of detail whose error projects to at most
+   * maxPixelError pixels when drawn with the given camera space
+   * transformation, projection matrix and viewport height.
+   */
+  size_t selectLod(const Magnum::Matrix4& transformationMatrix,
+                   const Magnum::Matrix4& projectionMatrix,
+                   int viewportHeight,
+                   float maxPixelError = 1.0f) const;
+
+  //! Make the GL mesh draw the given level of detail
+  void setLod(size_t level);
+
  protected:
+  bool loadLods(const std::string& cacheFile);
+  bool saveLods(const std::string& cacheFile) const;
+
+  // concatenated indices of all levels of detail
+  std::vector<uint32_t> lodIndices_;
+  std::vector<LodLevel> lodLevels_;
+  size_t currentLod_ = 0;
+  // bounding sphere of the mesh, for the projected size
+  Magnum::Vector3 lodCenter_;
+  float lodRadius_ = 0.0f;
+
   // we will have to use smart pointer here since each item within the structure
   // (e.g., Magnum::GL::Mesh) does NOT have copy constructor
   std::unique_ptr<RenderingBuffer> renderingBuffer_ = nullptr;
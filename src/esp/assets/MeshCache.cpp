@@ -0,0 +1,128 @@
+// Copyright (c) Facebook, Inc. and its affiliates.
+// This source code is licensed under the MIT license found in the
+// LICENSE file in the root directory of this source tree.
+
+#include "MeshCache.h"
+
+#include <sys/stat.h>
+#include <unistd.h>
+#include <algorithm>
+#include <cstdio>
+#include <utility>
+
+namespace Cr = Corrade;
+
+namespace esp {
+namespace assets {
+
+std::string meshCacheFilename(const std::string& cacheDir,
+                              const std::string& meshFile,
+                              const std::string& extension) {
+  // 64 bit FNV-1a of the absolute mesh path
+  const std::string path = Cr::Utility::Directory::join(
+      Cr::Utility::Directory::current(), meshFile);
+  uint64_t hash = 0xcbf29ce484222325ull;
+  for (const char c : path) {
+    hash = (hash ^ uint8_t(c)) * 0x100000001b3ull;
+  }
+  char name[32];
+  std::snprintf(name, sizeof(name), "%016llx.",
+                static_cast<unsigned long long>(hash));
+  return Cr::Utility::Directory::join(cacheDir, name + extension);
+}
+
+bool meshCacheHeader(const std::string& meshFile,
+                     uint32_t magic,
+                     uint32_t version,
+                     float parameter,
+                     MeshCacheHeader& header) {
+  struct stat status;
+  if (stat(meshFile.c_str(), &status) != 0) {
+    return false;
+  }
+  header = {magic, version, uint64_t(status.st_size), int64_t(status.st_mtime),
+            parameter, 0};
+  return true;
+}
+
+bool MeshCacheReader::open(const std::string& cacheFile,
+                           const MeshCacheHeader& expected) {
+  if (!Cr::Utility::Directory::exists(cacheFile)) {
+    return false;
+  }
+  data_ = Cr::Utility::Directory::mapRead(cacheFile);
+  if (data_.size() < sizeof(header_)) {
+    LOG(WARNING) << "Ignoring truncated mesh cache " << cacheFile;
+    return false;
+  }
+  std::memcpy(&header_, data_.data(), sizeof(header_));
+  if (header_.magic != expected.magic || header_.version != expected.version ||
+      header_.sourceSize != expected.sourceSize ||
+      header_.sourceTime != expected.sourceTime ||
+      header_.parameter != expected.parameter) {
+    LOG(WARNING) << "Ignoring outdated mesh cache " << cacheFile;
+    return false;
+  }
+  cursor_ = data_.data() + sizeof(header_);
+  return true;
+}
+
+Cr::Containers::Array<const char, Cr::Utility::Directory::MapDeleter>
+MeshCacheReader::release() {
+  cursor_ = nullptr;
+  return std::move(data_);
+}
+
+const char* MeshCacheReader::next(uint64_t count, size_t size) {
+  const char* end = data_.end();
+  if (cursor_ == nullptr || uint64_t(end - cursor_) / size < count) {
+    return nullptr;
+  }
+  const char* array = cursor_;
+  // skip the padding up to the next array
+  const size_t bytes = count * size;
+  const size_t padded = (bytes + kMeshCacheAlignment - 1) /
+                        kMeshCacheAlignment * kMeshCacheAlignment;
+  cursor_ += std::min<size_t>(padded, end - cursor_);
+  return array;
+}
+
+MeshCacheWriter::~MeshCacheWriter() {
+  if (!tmpFile_.empty()) {
+    out_.close();
+    std::remove(tmpFile_.c_str());
+  }
+}
+
+bool MeshCacheWriter::open(const std::string& cacheFile,
+                           const MeshCacheHeader& header) {
+  if (!Cr::Utility::Directory::mkpath(
+          Cr::Utility::Directory::path(cacheFile))) {
+    return false;
+  }
+  cacheFile_ = cacheFile;
+  tmpFile_ = cacheFile + "." + std::to_string(getpid()) + ".tmp";
+  out_.open(tmpFile_, std::ios::binary | std::ios::trunc);
+  write(&header, 1);
+  return out_.good();
+}
+
+void MeshCacheWriter::pad() {
+  static const char zeros[kMeshCacheAlignment]{};
+  const size_t remainder = size_t(out_.tellp()) % kMeshCacheAlignment;
+  if (remainder != 0) {
+    out_.write(zeros, kMeshCacheAlignment - remainder);
+  }
+}
+
+bool MeshCacheWriter::commit() {
+  out_.close();
+  if (out_.fail() || std::rename(tmpFile_.c_str(), cacheFile_.c_str()) != 0) {
+    return false;
+  }
+  tmpFile_.clear();
+  return true;
+}
+
+}  // namespace assets
+}  // namespace esp
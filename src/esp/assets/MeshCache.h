@@ -0,0 +1,156 @@
+// Copyright (c) Facebook, Inc. and its affiliates.
+// This source code is licensed under the MIT license found in the
+// LICENSE file in the root directory of this source tree.
+
+#pragma once
+
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <string>
+#include <vector>
+
+#include <Corrade/Containers/Array.h>
+#include <Corrade/Containers/ArrayView.h>
+#include <Corrade/Utility/Directory.h>
+
+#include "esp/core/esp.h"
+
+namespace esp {
+namespace assets {
+
+//! Arrays of mesh cache files start at multiples of this many bytes
+constexpr size_t kMeshCacheAlignment = 16;
+
+/**
+ * @brief Header of a cache file of data computed from a mesh file at load
+ * time.
+ *
+ * It identifies the mesh file by size and modification time and is followed
+ * by arrays, each starting at a multiple of @ref kMeshCacheAlignment bytes so
+ * that they can be used in place from a mapping of the file. Read-only
+ * mappings of a file share its memory among all processes mapping it.
+ */
+struct MeshCacheHeader {
+  uint32_t magic;
+  uint32_t version;
+  // size and modification time of the mesh file the cache was built from
+  uint64_t sourceSize;
+  int64_t sourceTime;
+  // what the data was computed with, e.g. the PTex split size
+  float parameter;
+  // number of parts, e.g. PTex submeshes, following the header
+  uint32_t count;
+};
+
+//! Cache file of meshFile in cacheDir, named by a hash of its absolute path
+std::string meshCacheFilename(const std::string& cacheDir,
+                              const std::string& meshFile,
+                              const std::string& extension);
+
+//! Header of a cache of meshFile as it is now, with a count of 0. Returns
+//! false if meshFile does not exist.
+bool meshCacheHeader(const std::string& meshFile,
+                     uint32_t magic,
+                     uint32_t version,
+                     float parameter,
+                     MeshCacheHeader& header);
+
+//! Reads the arrays of a mapped cache file in the order they were written
+class MeshCacheReader {
+ public:
+  //! Map cacheFile and check its header against expected, all but the count.
+  //! Returns false if it is missing, truncated or outdated.
+  bool open(const std::string& cacheFile, const MeshCacheHeader& expected);
+
+  const MeshCacheHeader& header() const { return header_; }
+
+  //! Copy the next array, of count values, into data
+  template <typename T>
+  bool read(uint64_t count, T* data) {
+    const char* array = next(count, sizeof(T));
+    if (array == nullptr) {
+      return false;
+    }
+    std::memcpy(data, array, count * sizeof(T));
+    return true;
+  }
+
+  template <typename T, typename Allocator>
+  bool read(uint64_t count, std::vector<T, Allocator>& data) {
+    const char* array = next(count, sizeof(T));
+    if (array == nullptr) {
+      return false;
+    }
+    data.resize(count);
+    std::memcpy(data.data(), array, count * sizeof(T));
+    return true;
+  }
+
+  //! View the next array, of count values, in the mapping. The view stays
+  //! valid as long as the mapping, see @ref release().
+  template <typename T>
+  bool view(uint64_t count, Corrade::Containers::ArrayView<const T>& data) {
+    const char* array = next(count, sizeof(T));
+    if (array == nullptr) {
+      return false;
+    }
+    data = {reinterpret_cast<const T*>(array), size_t(count)};
+    return true;
+  }
+
+  //! Whether all arrays were read
+  bool atEnd() const { return cursor_ == data_.end(); }
+
+  //! Take the mapping
+  Corrade::Containers::Array<const char,
+                             Corrade::Utility::Directory::MapDeleter>
+  release();
+
+ protected:
+  //! Start of the next array of count values of the given size, advancing
+  //! past it, or nullptr if the file is truncated
+  const char* next(uint64_t count, size_t size);
+
+  Corrade::Containers::Array<const char,
+                             Corrade::Utility::Directory::MapDeleter>
+      data_;
+  const char* cursor_ = nullptr;
+  MeshCacheHeader header_{};
+};
+
+//! Writes a cache file, into a temporary file first so that concurrent loads
+//! never see a partially written cache
+class MeshCacheWriter {
+ public:
+  //! Remove the temporary file unless committed
+  ~MeshCacheWriter();
+
+  bool open(const std::string& cacheFile, const MeshCacheHeader& header);
+
+  //! Append an array of count values
+  template <typename T>
+  void write(const T* data, size_t count) {
+    out_.write(reinterpret_cast<const char*>(data), count * sizeof(T));
+    pad();
+  }
+
+  template <typename Container>
+  void write(const Container& data) {
+    write(data.data(), data.size());
+  }
+
+  //! Move the written file into place
+  bool commit();
+
+ protected:
+  //! Pad the file to the start of the next array
+  void pad();
+
+  std::string cacheFile_;
+  std::string tmpFile_;
+  std::ofstream out_;
+};
+
+}  // namespace assets
+}  // namespace esp
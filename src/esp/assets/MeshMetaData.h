@@ -4,11 +4,28 @@
 
 #pragma once
 
+#include <vector>
+
+#include <Magnum/Math/Matrix4.h>
+
 #include "esp/core/esp.h"
 
 namespace esp {
 namespace assets {
 
+// an object of the scene hierarchy of a mesh file, kept from its import so
+// that instantiating the file again does not need the importer
+struct MeshTransformNode {
+  // object ID in the file, the drawables of the object get it as object ID
+  int componentID = ID_UNDEFINED;
+  // transformation relative to the parent object
+  Magnum::Matrix4 transformation;
+  // mesh and material indices local to the file, if the object has a mesh
+  int meshIDLocal = ID_UNDEFINED;
+  int materialIDLocal = ID_UNDEFINED;
+  std::vector<MeshTransformNode> children;
+};
+
 // for each scene (mesh file),
 // we store the data based on the resource type: 'mesh', 'texture', and
 // 'material'. each type may contain a few items;
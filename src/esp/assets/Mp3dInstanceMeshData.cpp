@@ -4,6 +4,8 @@
 
 #include "Mp3dInstanceMeshData.h"
 
+#include <algorithm>
+#include <cstring>
 #include <fstream>
 #include <sstream>
 #include <vector>
@@ -13,6 +15,7 @@
 #include <Corrade/Containers/Array.h>
 #include <Corrade/Containers/ArrayView.h>
 #include <Corrade/Containers/ArrayViewStl.h>
+#include <Corrade/Utility/Directory.h>
 #include <Magnum/GL/Texture.h>
 #include <Magnum/GL/TextureFormat.h>
 #include <Magnum/Image.h>
@@ -28,94 +31,107 @@ namespace esp {
 namespace assets {
 
 bool Mp3dInstanceMeshData::loadMp3dPLY(const std::string& plyFile) {
-  std::ifstream ifs(plyFile);
-  if (!ifs.good()) {
+  if (!io::exists(plyFile)) {
     LOG(ERROR) << "Cannot open file at " << plyFile;
     return false;
   }
 
+  // Map the file once, parse the header from the mapped bytes and decode the
+  // fixed size vertex and face packets from them in parallel
+  const Corrade::Containers::Array<const char,
+                                   Corrade::Utility::Directory::MapDeleter>
+      data = Corrade::Utility::Directory::mapRead(plyFile);
+  const std::string endHeader = "\nend_header\n";
+  const char* headerEnd = std::search(data.begin(), data.end(),
+                                      endHeader.begin(), endHeader.end());
+  if (headerEnd == data.end()) {
+    LOG(ERROR) << "Invalid ply file header";
+    return false;
+  }
+
+  std::istringstream header(std::string(data.begin(), headerEnd + 1));
   std::string line, token;
-  std::istringstream iss;
-  std::getline(ifs, line);
+  std::getline(header, line);
   if (line != "ply") {
     LOG(ERROR) << "Invalid ply file header";
     return false;
   }
-  std::getline(ifs, line);
+  std::getline(header, line);
   if (line != "format binary_little_endian 1.0") {
     LOG(ERROR) << "Invalid ply file header";
     return false;
   }
 
   // element vertex nVertex
-  std::getline(ifs, line);
-  iss.str(line);
+  std::getline(header, line);
+  std::istringstream iss(line);
   iss >> token;
   if (token != "element") {
     LOG(ERROR) << "Invalid element vertex header line";
     return false;
   }
-  int nVertex;
+  int nVertex = 0;
   iss >> token >> nVertex;
 
   // we know the header is fixed so skip until face count
   do {
-    std::getline(ifs, line);
-  } while ((line.substr(0, 12) != "element face") && !ifs.eof());
-  std::stringstream iss2;
-  iss2.str(line);
+    std::getline(header, line);
+  } while ((line.substr(0, 12) != "element face") && header);
+  std::istringstream iss2(line);
   iss2 >> token;
   if (token != "element") {
     LOG(ERROR) << "Invalid element face header line";
     return false;
   }
-  int nFace;
+  int nFace = 0;
   iss2 >> token >> nFace;
 
-  // ignore rest of header
-  do {
-    std::getline(ifs, line);
-  } while ((line != "end_header") && !ifs.eof());
-
-  cpu_cbo_.clear();
-  cpu_cbo_.reserve(nVertex);
-  cpu_vbo_.clear();
-  cpu_vbo_.reserve(nVertex);
-  cpu_ibo_.clear();
-  cpu_ibo_.reserve(nFace);
+  // vertices are position, normal, texture coordinates and color, faces are
+  // index count, indices, material, segment and category
+  constexpr size_t kVertexBytes = 8 * sizeof(float) + 3 * sizeof(uint8_t);
+  constexpr size_t kColorOffset = 8 * sizeof(float);
+  constexpr size_t kFaceBytes =
+      sizeof(uint8_t) + 3 * sizeof(uint32_t) + 3 * sizeof(int32_t);
+  const char* vertices = headerEnd + endHeader.size();
+  const char* faces = vertices + size_t(nVertex) * kVertexBytes;
+  if (nVertex < 0 || nFace < 0 ||
+      size_t(data.end() - vertices) <
+          size_t(nVertex) * kVertexBytes + size_t(nFace) * kFaceBytes) {
+    LOG(ERROR) << "Truncated ply file " << plyFile;
+    return false;
+  }
 
+  cpu_vbo_.resize(nVertex);
+  cpu_cbo_.resize(nVertex);
+#pragma omp parallel for
   for (int i = 0; i < nVertex; ++i) {
-    vec3f position;
-    vec3f normal;
-    vec2f texCoords;
-    vec3uc rgb;
-
-    ifs.read(reinterpret_cast<char*>(position.data()), 3 * sizeof(float));
-    ifs.read(reinterpret_cast<char*>(normal.data()), 3 * sizeof(float));
-    ifs.read(reinterpret_cast<char*>(texCoords.data()), 2 * sizeof(float));
-    ifs.read(reinterpret_cast<char*>(rgb.data()), 3 * sizeof(uint8_t));
-    cpu_vbo_.emplace_back(position);
-    cpu_cbo_.emplace_back(rgb);
+    const char* packet = vertices + size_t(i) * kVertexBytes;
+    std::memcpy(cpu_vbo_[i].data(), packet, 3 * sizeof(float));
+    std::memcpy(cpu_cbo_[i].data(), packet + kColorOffset,
+                3 * sizeof(uint8_t));
   }
 
+  cpu_ibo_.resize(nFace);
+  materialIds_.resize(nFace);
+  segmentIds_.resize(nFace);
+  categoryIds_.resize(nFace);
+  bool triangles = true;
+#pragma omp parallel for reduction(&& : triangles)
   for (int i = 0; i < nFace; ++i) {
-    uint8_t nIndices;
-    vec3ui indices;
-    int32_t materialId;
-    int32_t segmentId;
-    int32_t categoryId;
-
-    ifs.read(reinterpret_cast<char*>(&nIndices), sizeof(nIndices));
-    ASSERT(nIndices == 3);
-    ifs.read(reinterpret_cast<char*>(indices.data()), 3 * sizeof(int));
-    ifs.read(reinterpret_cast<char*>(&materialId), sizeof(materialId));
-    ifs.read(reinterpret_cast<char*>(&segmentId), sizeof(segmentId));
-    ifs.read(reinterpret_cast<char*>(&categoryId), sizeof(categoryId));
-    cpu_ibo_.emplace_back(indices);
-    materialIds_.emplace_back(materialId);
-    segmentIds_.emplace_back(segmentId);
-    categoryIds_.emplace_back(categoryId);
+    const char* packet = faces + size_t(i) * kFaceBytes;
+    triangles = triangles && uint8_t(packet[0]) == 3;
+    std::memcpy(cpu_ibo_[i].data(), packet + 1, 3 * sizeof(uint32_t));
+    const char* ids = packet + 1 + 3 * sizeof(uint32_t);
+    std::memcpy(&materialIds_[i], ids, sizeof(int32_t));
+    std::memcpy(&segmentIds_[i], ids + sizeof(int32_t), sizeof(int32_t));
+    std::memcpy(&categoryIds_[i], ids + 2 * sizeof(int32_t), sizeof(int32_t));
   }
+  if (!triangles) {
+    LOG(ERROR) << "Faces of " << plyFile << " have to be triangles";
+    return false;
+  }
+
+  viewBuffers();
 
   // Construct vertices for meshData
   // Store indices, facd_ids in Magnum MeshData3D format such that
@@ -4,9 +4,9 @@
 
 #include "PTexMeshData.h"
 
-#include <fstream>
+#include <algorithm>
+#include <cstring>
 #include <sstream>
-#include <unordered_map>
 #include <vector>
 
 #include <Corrade/Containers/Array.h>
@@ -17,6 +17,8 @@
 #include <Magnum/ImageView.h>
 #include <Magnum/PixelFormat.h>
 
+#include "MeshCache.h"
+#include "esp/core/RadixSort.h"
 #include "esp/core/esp.h"
 #include "esp/gfx/PTexMeshShader.h"
 #include "esp/io/io.h"
@@ -30,8 +32,16 @@ namespace Cr = Corrade;
 namespace esp {
 namespace assets {
 
+namespace {
+// "EPTC" and format version of mesh cache files
+constexpr uint32_t kMeshCacheMagic = 0x43545045;
+constexpr uint32_t kMeshCacheVersion = 2;
+}  // namespace
+
 void PTexMeshData::load(const std::string& meshFile,
-                        const std::string& atlasFolder) {
+                        const std::string& atlasFolder,
+                        const std::string& cacheDir,
+                        bool shareCache) {
   ASSERT(io::exists(meshFile));
   ASSERT(io::exists(atlasFolder));
 
@@ -43,7 +53,7 @@ void PTexMeshData::load(const std::string& meshFile,
   tileSize_ = json["tileSize"].GetInt();
   atlasFolder_ = atlasFolder;
 
-  loadMeshData(meshFile);
+  loadMeshData(meshFile, cacheDir, shareCache);
 }
 
 float PTexMeshData::exposure() const {
@@ -62,8 +72,8 @@ std::string PTexMeshData::atlasFolder() const {
   return atlasFolder_;
 }
 
-std::vector<PTexMeshData::MeshData> splitMesh(
-    const PTexMeshData::MeshData& mesh,
+std::vector<PTexMeshData::MeshData> PTexMeshData::splitMesh(
+    const MeshData& mesh,
     const float splitSize) {
   std::vector<uint32_t> verts;
   verts.resize(mesh.vbo.size());
@@ -84,8 +94,15 @@ std::vector<PTexMeshData::MeshData> splitMesh(
 
   box3f boundingBox;
 
-  for (size_t i = 0; i < mesh.vbo.size(); i++) {
-    boundingBox.extend(mesh.vbo[i].head<3>());
+#pragma omp parallel
+  {
+    box3f threadBoundingBox;
+#pragma omp for nowait
+    for (int64_t i = 0; i < mesh.vbo.size(); i++) {
+      threadBoundingBox.extend(mesh.vbo[i].head<3>());
+    }
+#pragma omp critical
+    boundingBox.extend(threadBoundingBox);
   }
 
 // calculate vertex grid position and code
@@ -96,100 +113,84 @@ std::vector<PTexMeshData::MeshData> splitMesh(
     verts[i] = EncodeMorton3(pi.cast<int>());
   }
 
-  // data structure for sorting faces
-  struct SortFace {
-    uint32_t index[4];
-    uint32_t code;
-    size_t originalFace;
-  };
-
-  // fill per-face data structures (including codes)
+  // per-face code in the upper and face index in the lower 32 bits; face
+  // code is minimum of referenced vertices codes
   size_t numFaces = mesh.ibo.size() / 4;
-  std::vector<SortFace> faces;
+  std::vector<uint64_t> faces;
   faces.resize(numFaces);
 
 #pragma omp parallel for
   for (int32_t i = 0; i < numFaces; i++) {
-    faces[i].originalFace = i;
-    faces[i].code = std::numeric_limits<uint32_t>::max();
+    uint32_t code = std::numeric_limits<uint32_t>::max();
     for (int j = 0; j < 4; j++) {
-      faces[i].index[j] = mesh.ibo[i * 4 + j];
-
-      // face code is minimum of referenced vertices codes
-      faces[i].code = std::min(faces[i].code, verts[faces[i].index[j]]);
+      code = std::min(code, verts[mesh.ibo[i * 4 + j]]);
     }
+    faces[i] = uint64_t(code) << 32 | i;
   }
 
-  // sort faces by code
-  std::sort(faces.begin(), faces.end(),
-            [](const SortFace& f1, const SortFace& f2) -> bool {
-              return (f1.code < f2.code);
-            });
+  // sort faces by code. This stays std::sort: the PTex atlas of a submesh is
+  // laid out in the order it gives faces of the same code, which a stable
+  // (e.g. radix) sort would not reproduce. Comparing codes only, sorting
+  // these pairs permutes them as sorting whole faces did, moving less data.
+  std::sort(faces.begin(), faces.end(), [](uint64_t f1, uint64_t f2) -> bool {
+    return (f1 >> 32) < (f2 >> 32);
+  });
 
   // find face chunk start indices
   std::vector<uint32_t> chunkStart;
   chunkStart.push_back(0);
-  uint32_t prevCode = faces[0].code;
   for (size_t i = 1; i < faces.size(); i++) {
-    if (faces[i].code != prevCode) {
+    if ((faces[i] >> 32) != (faces[i - 1] >> 32)) {
       chunkStart.push_back(i);
-      prevCode = faces[i].code;
     }
   }
 
   chunkStart.push_back(faces.size());
   size_t numChunks = chunkStart.size() - 1;
 
-  size_t maxFaces = 0;
-  for (size_t i = 0; i < numChunks; i++) {
-    uint32_t chunkSize = chunkStart[i + 1] - chunkStart[i];
-    if (chunkSize > maxFaces)
-      maxFaces = chunkSize;
-  }
-
   // create new mesh for each chunk of faces
-  std::vector<PTexMeshData::MeshData> subMeshes;
-
-  for (size_t i = 0; i < numChunks; i++) {
-    subMeshes.emplace_back();
-  }
+  std::vector<PTexMeshData::MeshData> subMeshes(numChunks);
 
-#pragma omp parallel for
+  // chunks differ a lot in size, hand them out dynamically
+#pragma omp parallel for schedule(dynamic)
   for (int32_t i = 0; i < numChunks; i++) {
-    uint32_t chunkSize = chunkStart[i + 1] - chunkStart[i];
-
-    std::vector<uint32_t> refdVerts;
-    std::unordered_map<uint32_t, uint32_t> refdVertsMap;
-    subMeshes[i].ibo.resize(chunkSize * 4);
-
-    for (size_t j = 0; j < chunkSize; j++) {
-      size_t faceIdx = chunkStart[i] + j;
-      for (int k = 0; k < 4; k++) {
-        uint32_t vertIndex = faces[faceIdx].index[k];
-        uint32_t newIndex = 0;
-
-        auto it = refdVertsMap.find(vertIndex);
+    const uint32_t numRefs = (chunkStart[i + 1] - chunkStart[i]) * 4;
+    PTexMeshData::MeshData& subMesh = subMeshes[i];
+
+    // vertex references of the chunk, vertex index in the upper and position
+    // in the lower 32 bits, sorted to find the first reference of every
+    // referenced vertex
+    subMesh.ibo.resize(numRefs);
+    std::vector<uint64_t> refs(numRefs);
+    for (uint32_t j = 0; j < numRefs; j++) {
+      const uint32_t face = static_cast<uint32_t>(faces[chunkStart[i] + j / 4]);
+      subMesh.ibo[j] = mesh.ibo[face * 4 + j % 4];
+      refs[j] = uint64_t(subMesh.ibo[j]) << 32 | j;
+    }
+    std::sort(refs.begin(), refs.end());
 
-        if (it == refdVertsMap.end()) {
-          // vertex not found, add
-          newIndex = refdVerts.size();
-          refdVerts.push_back(vertIndex);
-          refdVertsMap[vertIndex] = newIndex;
-        } else {
-          // found, use existing index
-          newIndex = it->second;
-        }
-        subMeshes[i].ibo[j * 4 + k] = newIndex;
+    std::vector<uint32_t> firstRef(numRefs);
+    for (uint32_t j = 0, run = 0; j < numRefs; j++) {
+      if ((refs[j] >> 32) != (refs[run] >> 32)) {
+        run = j;
       }
+      firstRef[static_cast<uint32_t>(refs[j])] =
+          static_cast<uint32_t>(refs[run]);
     }
 
-    // add referenced vertices to submesh
-    subMeshes[i].vbo.resize(refdVerts.size());
-    subMeshes[i].nbo.resize(refdVerts.size());
-    for (size_t j = 0; j < refdVerts.size(); j++) {
-      uint32_t index = refdVerts[j];
-      subMeshes[i].vbo[j] = mesh.vbo[index];
-      subMeshes[i].nbo[j] = mesh.nbo[index];
+    // number and add referenced vertices in the order they are first
+    // referenced in
+    for (uint32_t j = 0; j < numRefs; j++) {
+      if (firstRef[j] == j) {
+        const uint32_t index = subMesh.ibo[j];
+        subMesh.ibo[j] = subMesh.vbo.size();
+        subMesh.vbo.push_back(mesh.vbo[index]);
+        if (!mesh.nbo.empty()) {
+          subMesh.nbo.push_back(mesh.nbo[index]);
+        }
+      } else {
+        subMesh.ibo[j] = subMesh.ibo[firstRef[j]];
+      }
     }
   }
 
@@ -198,83 +199,68 @@ std::vector<PTexMeshData::MeshData> splitMesh(
 
 void PTexMeshData::calculateAdjacency(const PTexMeshData::MeshData& mesh,
                                       std::vector<uint32_t>& adjFaces) {
-  struct EdgeData {
-    int face;
-    int edge;
-  };
-
-  std::unordered_map<uint64_t, std::vector<EdgeData>> edgeMap;
-
-  size_t numFaces = mesh.ibo.size() / 4;
+  const int64_t numEdges = mesh.ibo.size() / 4 * 4;
 
-  typedef std::unordered_map<uint64_t, std::vector<EdgeData>>::iterator
-      EdgeIter;
-  std::vector<EdgeIter> edgeIterators(numFaces * 4);
-
-  // for each face
-  for (int f = 0; f < numFaces; f++) {
-    // for each edge
-    for (int e = 0; e < 4; e++) {
-      // add to edge to face map
-      const int e_index = f * 4 + e;
-      const uint32_t i0 = mesh.ibo[e_index];
-      const uint32_t i1 = mesh.ibo[f * 4 + ((e + 1) % 4)];
-      const uint64_t key =
-          (uint64_t)std::min(i0, i1) << 32 | (uint32_t)std::max(i0, i1);
-
-      const EdgeData edgeData{f, e};
-
-      auto it = edgeMap.find(key);
-
-      if (it == edgeMap.end()) {
-        it = edgeMap.emplace(key, std::vector<EdgeData>()).first;
-        it->second.reserve(4);
-        it->second.push_back(edgeData);
-      } else {
-        it->second.push_back(edgeData);
-      }
-
-      edgeIterators[e_index] = it;
-    }
+  // key every edge of every face by its vertices and sort the edge indices
+  // by key, so that the edges shared between faces end up next to each
+  // other, in the order of their index
+  std::vector<uint64_t> keys(numEdges);
+  std::vector<uint32_t> edges(numEdges);
+#pragma omp parallel for
+  for (int64_t i = 0; i < numEdges; i++) {
+    const uint32_t i0 = mesh.ibo[i];
+    const uint32_t i1 = mesh.ibo[i / 4 * 4 + (i + 1) % 4];
+    keys[i] = (uint64_t)std::min(i0, i1) << 32 | (uint32_t)std::max(i0, i1);
+    edges[i] = i;
   }
+  core::radixSortPairs(keys, edges);
 
-  adjFaces.resize(numFaces * 4);
-
-  for (int f = 0; f < numFaces; f++) {
-    for (int e = 0; e < 4; e++) {
-      const int e_index = f * 4 + e;
-      auto it = edgeIterators[e_index];
-      const std::vector<EdgeData>& adj = it->second;
+  adjFaces.resize(numEdges);
 
-      // find adjacent face
-      int adjFace = -1;
-      for (size_t i = 0; i < adj.size(); i++) {
-        if (adj[i].face != (int)f)
-          adjFace = adj[i].face;
-      }
+#pragma omp parallel for
+  for (int64_t i = 0; i < numEdges; i++) {
+    // the run of edges with the same vertices
+    int64_t begin = i;
+    int64_t end = i + 1;
+    while (begin > 0 && keys[begin - 1] == keys[i]) {
+      begin--;
+    }
+    while (end < numEdges && keys[end] == keys[i]) {
+      end++;
+    }
 
-      // find number of 90 degree rotation steps between faces
-      int rot = 0;
-      if (adj.size() == 2) {
-        int edge0 = 0, edge1 = 0;
-        if (adj[0].edge == e) {
-          edge0 = adj[0].edge;
-          edge1 = adj[1].edge;
-        } else if (adj[1].edge == e) {
-          edge0 = adj[1].edge;
-          edge1 = adj[0].edge;
-        }
+    const int f = edges[i] / 4;
+    const int e = edges[i] % 4;
 
-        rot = (edge0 - edge1 + 2) & 3;
-      }
+    // find adjacent face, the last one other than f
+    int adjFace = -1;
+    for (int64_t j = begin; j < end; j++) {
+      if (edges[j] / 4 != f)
+        adjFace = edges[j] / 4;
+    }
 
-      // pack adjacent face and rotation into 32-bit int
-      adjFaces[f * 4 + e] = (rot << ROTATION_SHIFT) | (adjFace & FACE_MASK);
+    // find number of 90 degree rotation steps between faces
+    int rot = 0;
+    if (end - begin == 2) {
+      const int otherEdge = edges[i == begin ? end - 1 : begin] % 4;
+      rot = (e - otherEdge + 2) & 3;
     }
+
+    // pack adjacent face and rotation into 32-bit int
+    adjFaces[edges[i]] = (rot << ROTATION_SHIFT) | (adjFace & FACE_MASK);
   }
 }
 
-void PTexMeshData::loadMeshData(const std::string& meshFile) {
+void PTexMeshData::loadMeshData(const std::string& meshFile,
+                                const std::string& cacheDir,
+                                bool shareCache) {
+  const std::string cacheFile =
+      cacheDir.empty() ? "" : cacheFilename(cacheDir, meshFile);
+  if (!cacheFile.empty() && loadCache(cacheFile, meshFile, shareCache)) {
+    LOG(INFO) << "Loaded mesh from cache " << cacheFile;
+    return;
+  }
+
   PTexMeshData::MeshData originalMesh;
   parsePLY(meshFile, originalMesh);
 
@@ -286,6 +272,131 @@ void PTexMeshData::loadMeshData(const std::string& meshFile) {
   } else {
     submeshes_.emplace_back(std::move(originalMesh));
   }
+
+  LOG(INFO) << "Calculating mesh adjacency... ";
+  adjacency_.clear();
+  adjacency_.resize(submeshes_.size());
+  submeshBounds_.assign(submeshes_.size(), box3f{});
+#pragma omp parallel for
+  for (int iMesh = 0; iMesh < submeshes_.size(); ++iMesh) {
+    calculateAdjacency(submeshes_[iMesh], adjacency_[iMesh]);
+    for (const vec4f& position : submeshes_[iMesh].vbo) {
+      submeshBounds_[iMesh].extend(position.head<3>());
+    }
+  }
+  LOG(INFO) << "done" << std::endl;
+  mappedCache_ = nullptr;
+  viewSubmeshes();
+
+  if (cacheFile.empty()) {
+    return;
+  }
+  if (!saveCache(cacheFile, meshFile)) {
+    LOG(WARNING) << "Cannot write mesh cache " << cacheFile;
+  } else if (shareCache) {
+    // drop the private copy for the one shared with other processes
+    loadCache(cacheFile, meshFile, true);
+  }
+}
+
+void PTexMeshData::viewSubmeshes() {
+  submeshViews_.resize(submeshes_.size());
+  for (size_t iMesh = 0; iMesh < submeshes_.size(); ++iMesh) {
+    const MeshData& mesh = submeshes_[iMesh];
+    submeshViews_[iMesh] = {mesh.vbo, mesh.nbo, mesh.cbo, mesh.ibo,
+                            adjacency_[iMesh]};
+  }
+}
+
+std::string PTexMeshData::cacheFilename(const std::string& cacheDir,
+                                        const std::string& meshFile) {
+  return meshCacheFilename(cacheDir, meshFile, "ptex");
+}
+
+bool PTexMeshData::loadCache(const std::string& cacheFile,
+                             const std::string& meshFile,
+                             bool shared /* = false */) {
+  MeshCacheHeader expected;
+  MeshCacheReader reader;
+  if (!meshCacheHeader(meshFile, kMeshCacheMagic, kMeshCacheVersion,
+                       splitSize_, expected) ||
+      !reader.open(cacheFile, expected)) {
+    return false;
+  }
+
+  const uint32_t numSubmeshes = reader.header().count;
+  std::vector<MeshData> submeshes(shared ? 0 : numSubmeshes);
+  std::vector<std::vector<uint32_t>> adjacency(shared ? 0 : numSubmeshes);
+  std::vector<MeshView> views(numSubmeshes);
+  std::vector<box3f> bounds(numSubmeshes);
+  bool valid = true;
+  for (uint32_t i = 0; valid && i < numSubmeshes; ++i) {
+    uint64_t counts[5]{};
+    float box[6]{};
+    valid = reader.read(5, counts) && reader.read(6, box);
+    if (valid && shared) {
+      valid = reader.view(counts[0], views[i].vbo) &&
+              reader.view(counts[1], views[i].nbo) &&
+              reader.view(counts[2], views[i].cbo) &&
+              reader.view(counts[3], views[i].ibo) &&
+              reader.view(counts[4], views[i].adjacency);
+    } else if (valid) {
+      valid = reader.read(counts[0], submeshes[i].vbo) &&
+              reader.read(counts[1], submeshes[i].nbo) &&
+              reader.read(counts[2], submeshes[i].cbo) &&
+              reader.read(counts[3], submeshes[i].ibo) &&
+              reader.read(counts[4], adjacency[i]);
+    }
+    bounds[i] = box3f{vec3f{box[0], box[1], box[2]},
+                      vec3f{box[3], box[4], box[5]}};
+  }
+  if (!valid || !reader.atEnd()) {
+    LOG(WARNING) << "Ignoring truncated mesh cache " << cacheFile;
+    return false;
+  }
+
+  submeshes_ = std::move(submeshes);
+  adjacency_ = std::move(adjacency);
+  submeshBounds_ = std::move(bounds);
+  if (shared) {
+    mappedCache_ = reader.release();
+    submeshViews_ = std::move(views);
+  } else {
+    mappedCache_ = nullptr;
+    viewSubmeshes();
+  }
+  return true;
+}
+
+bool PTexMeshData::saveCache(const std::string& cacheFile,
+                             const std::string& meshFile) const {
+  MeshCacheHeader header;
+  if (!meshCacheHeader(meshFile, kMeshCacheMagic, kMeshCacheVersion,
+                       splitSize_, header)) {
+    return false;
+  }
+  header.count = submeshViews_.size();
+  MeshCacheWriter writer;
+  if (!writer.open(cacheFile, header)) {
+    return false;
+  }
+  for (size_t i = 0; i < submeshViews_.size(); ++i) {
+    const MeshView& mesh = submeshViews_[i];
+    const uint64_t counts[] = {mesh.vbo.size(), mesh.nbo.size(),
+                               mesh.cbo.size(), mesh.ibo.size(),
+                               mesh.adjacency.size()};
+    const box3f& bounds = submeshBounds_[i];
+    const float box[] = {bounds.min().x(), bounds.min().y(), bounds.min().z(),
+                         bounds.max().x(), bounds.max().y(), bounds.max().z()};
+    writer.write(counts, 5);
+    writer.write(box, 6);
+    writer.write(mesh.vbo);
+    writer.write(mesh.nbo);
+    writer.write(mesh.cbo);
+    writer.write(mesh.ibo);
+    writer.write(mesh.adjacency);
+  }
+  return writer.commit();
 }
 
 void PTexMeshData::parsePLY(const std::string& filename,
@@ -308,10 +419,24 @@ void PTexMeshData::parsePLY(const std::string& filename,
 
   size_t numFaces = 0;
 
-  std::ifstream file(filename, std::ios::binary);
+  // Map the file once, parse the header from the mapped bytes and unpack the
+  // vertex and face blocks from them in parallel
+  const Cr::Containers::Array<const char, Cr::Utility::Directory::MapDeleter>
+      mmappedData = Cr::Utility::Directory::mapRead(filename);
+  const size_t fileSize = mmappedData.size();
+  ASSERT(fileSize > 0, "Can't read (%)", filename);
+
+  const std::string endHeader = "\nend_header";
+  const char* headerEnd =
+      std::search(mmappedData.begin(), mmappedData.end(), endHeader.begin(),
+                  endHeader.end());
+  headerEnd = std::find(headerEnd, mmappedData.end(), '\n');
+  ASSERT(headerEnd != mmappedData.end(), "No end of header in (%)", filename);
+  const size_t postHeader = headerEnd + 1 - mmappedData.begin();
 
   // Header parsing
   {
+    std::istringstream file(std::string(mmappedData.begin(), postHeader));
     std::string line;
 
     while (std::getline(file, line)) {
@@ -497,36 +622,36 @@ void PTexMeshData::parsePLY(const std::string& filename,
     }
   }
 
-  // Close after parsing header and re-open memory mapped
-  const size_t postHeader = file.tellg();
-
-  file.close();
-
-  Cr::Containers::Array<const char, Cr::Utility::Directory::MapDeleter>
-      mmappedData = Cr::Utility::Directory::mapRead(filename);
-
-  const size_t fileSize = io::fileSize(filename);
-
   // Parse each vertex packet and unpack
   const char* bytes = mmappedData + postHeader;
+  const size_t vertexBlockBytes = vertexPacketSizeBytes * numVertices;
+  ASSERT(postHeader + vertexBlockBytes < fileSize,
+         "Truncated vertex data in (%)", filename);
 
-  for (size_t i = 0; i < numVertices; i++) {
-    const char* nextBytes = bytes + vertexPacketSizeBytes * i;
+  if (vertexLayout.size() == 1 && positionDimensions == 4) {
+    // Packets are laid out exactly like our positions, copy them at once
+    memcpy(meshData.vbo.data(), bytes, vertexBlockBytes);
+  } else {
+#pragma omp parallel for
+    for (int64_t i = 0; i < int64_t(numVertices); i++) {
+      const char* nextBytes = bytes + vertexPacketSizeBytes * i;
 
-    memcpy(meshData.vbo[i].data(), &nextBytes[positionOffsetBytes],
-           positionBytes);
+      memcpy(meshData.vbo[i].data(), &nextBytes[positionOffsetBytes],
+             positionBytes);
 
-    if (normalDimensions)
-      memcpy(meshData.nbo[i].data(), &nextBytes[normalOffsetBytes],
-             normalBytes);
+      if (normalDimensions)
+        memcpy(meshData.nbo[i].data(), &nextBytes[normalOffsetBytes],
+               normalBytes);
 
-    if (colorDimensions)
-      memcpy(meshData.cbo[i].data(), &nextBytes[colorOffsetBytes], colorBytes);
+      if (colorDimensions)
+        memcpy(meshData.cbo[i].data(), &nextBytes[colorOffsetBytes],
+               colorBytes);
+    }
   }
 
-  const size_t bytesSoFar = postHeader + vertexPacketSizeBytes * numVertices;
+  const size_t bytesSoFar = postHeader + vertexBlockBytes;
 
-  bytes = mmappedData + postHeader + vertexPacketSizeBytes * numVertices;
+  bytes = mmappedData + bytesSoFar;
 
   // Read first face to get number of indices;
   const uint8_t faceDimensions = *bytes;
@@ -555,12 +680,18 @@ void PTexMeshData::parsePLY(const std::string& filename,
 
   meshData.ibo.resize(numFaces * faceDimensions);
 
-  for (size_t i = 0; i < numFaces; i++) {
+  // All faces have to have the size of the first one for the packets to be
+  // found by their index
+  bool uniformFaces = true;
+#pragma omp parallel for reduction(&& : uniformFaces)
+  for (int64_t i = 0; i < int64_t(numFaces); i++) {
     const char* nextBytes = bytes + facePacketSizeBytes * i;
 
+    uniformFaces = uniformFaces && uint8_t(nextBytes[0]) == faceDimensions;
     memcpy(&meshData.ibo[i * faceDimensions], &nextBytes[countBytes],
            faceBytes);
   }
+  ASSERT(uniformFaces, "Faces of (%) have to have the same size", filename);
 }
 
 void PTexMeshData::uploadBuffersToGPU(bool forceReload) {
@@ -571,36 +702,27 @@ void PTexMeshData::uploadBuffersToGPU(bool forceReload) {
     return;
   }
 
-  for (int iMesh = 0; iMesh < submeshes_.size(); ++iMesh) {
-    LOG(INFO) << "\rLoading mesh " << iMesh + 1 << "/" << submeshes_.size()
+  for (int iMesh = 0; iMesh < submeshViews_.size(); ++iMesh) {
+    LOG(INFO) << "\rLoading mesh " << iMesh + 1 << "/" << submeshViews_.size()
               << "... ";
 
     renderingBuffers_.emplace_back(
         std::make_unique<PTexMeshData::RenderingBuffer>());
 
     auto& currentMesh = renderingBuffers_.back();
-    currentMesh->vbo.setData(submeshes_[iMesh].vbo,
+    currentMesh->vbo.setData(submeshViews_[iMesh].vbo,
                              Magnum::GL::BufferUsage::StaticDraw);
-    currentMesh->ibo.setData(submeshes_[iMesh].ibo,
+    currentMesh->ibo.setData(submeshViews_[iMesh].ibo,
                              Magnum::GL::BufferUsage::StaticDraw);
   }
   LOG(INFO) << "... done" << std::endl;
 
-  LOG(INFO) << "Calculating mesh adjacency... ";
-
-  std::vector<std::vector<uint32_t>> adjFaces(submeshes_.size());
-
-#pragma omp parallel for
-  for (int iMesh = 0; iMesh < submeshes_.size(); ++iMesh) {
-    calculateAdjacency(submeshes_[iMesh], adjFaces[iMesh]);
-  }
-
-  for (int iMesh = 0; iMesh < submeshes_.size(); ++iMesh) {
+  for (int iMesh = 0; iMesh < submeshViews_.size(); ++iMesh) {
     auto& currentMesh = renderingBuffers_[iMesh];
 
     currentMesh->adjTex.setBuffer(Magnum::GL::BufferTextureFormat::R32UI,
                                   currentMesh->abo);
-    currentMesh->abo.setData(adjFaces[iMesh],
+    currentMesh->abo.setData(submeshViews_[iMesh].adjacency,
                              Magnum::GL::BufferUsage::StaticDraw);
     currentMesh->mesh.setPrimitive(Magnum::GL::MeshPrimitive::LinesAdjacency)
         .setCount(currentMesh->ibo.size() / 2)
@@ -623,6 +745,7 @@ void PTexMeshData::uploadBuffersToGPU(bool forceReload) {
         Cr::Utility::Directory::mapRead(rgbFile);
     const int dim = static_cast<int>(std::sqrt(data.size() / 3));  // square
     Magnum::ImageView2D image(Magnum::PixelFormat::RGB8UI, {dim, dim}, data);
+    atlasBytes_ += data.size();
     renderingBuffers_[iMesh]
         ->tex.setWrapping(Magnum::GL::SamplerWrapping::ClampToEdge)
         .setMagnificationFilter(Magnum::GL::SamplerFilter::Linear)
@@ -645,5 +768,18 @@ Magnum::GL::Mesh* PTexMeshData::getMagnumGLMesh(int submeshID) {
   return &(renderingBuffers_[submeshID]->mesh);
 }
 
+size_t PTexMeshData::getMemoryUsage() {
+  // submeshes and adjacency are kept on the CPU and uploaded to the GPU, the
+  // atlas only lives on the GPU
+  size_t bytes = 0;
+  for (const MeshView& mesh : submeshViews_) {
+    bytes += mesh.vbo.size() * sizeof(vec4f) + mesh.nbo.size() * sizeof(vec4f) +
+             mesh.cbo.size() * sizeof(vec4uc) +
+             mesh.ibo.size() * sizeof(uint32_t) +
+             mesh.adjacency.size() * sizeof(uint32_t);
+  }
+  return 2 * bytes + atlasBytes_;
+}
+
 }  // namespace assets
 }  // namespace esp
@@ -8,6 +8,9 @@
 #include <string>
 #include <vector>
 
+#include <Corrade/Containers/Array.h>
+#include <Corrade/Containers/ArrayView.h>
+#include <Corrade/Utility/Directory.h>
 #include <Magnum/GL/Buffer.h>
 #include <Magnum/GL/BufferTexture.h>
 #include <Magnum/GL/Mesh.h>
@@ -28,6 +31,16 @@ class PTexMeshData : public BaseMesh {
     std::vector<uint32_t> ibo;
   };
 
+  //! Read-only view of a submesh and its adjacency, on the data computed at
+  //! load time or on a mapped cache file
+  struct MeshView {
+    Corrade::Containers::ArrayView<const vec4f> vbo;
+    Corrade::Containers::ArrayView<const vec4f> nbo;
+    Corrade::Containers::ArrayView<const vec4uc> cbo;
+    Corrade::Containers::ArrayView<const uint32_t> ibo;
+    Corrade::Containers::ArrayView<const uint32_t> adjacency;
+  };
+
   struct RenderingBuffer {
     Magnum::GL::Mesh mesh;
     Magnum::GL::Texture2D tex;
@@ -41,39 +54,93 @@ class PTexMeshData : public BaseMesh {
   virtual ~PTexMeshData(){};
 
   // ==== geometry ====
-  void load(const std::string& meshFile, const std::string& atlasFolder);
+  //! Load meshFile with the atlas in atlasFolder. With a non-empty cacheDir,
+  //! the split submeshes, their adjacency and bounds are read from the
+  //! cache file of meshFile in it, or written there after computing them.
+  //! With shareCache, they are used in place from a read-only mapping of the
+  //! cache file instead, shared by all processes loading the mesh.
+  void load(const std::string& meshFile,
+            const std::string& atlasFolder,
+            const std::string& cacheDir = "",
+            bool shareCache = false);
   float exposure() const;
   void setExposure(const float& val);
   uint32_t tileSize() const { return tileSize_; }
 
+  //! Submeshes as computed or read from the cache, empty if they are mapped
+  //! from a shared cache
   const std::vector<MeshData>& meshes() const;
   std::string atlasFolder() const;
   void resize(size_t n) { submeshes_.resize(n); }
 
-  int getSize() { return submeshes_.size(); }
+  int getSize() const { return submeshViews_.size(); }
+
+  const MeshView& getSubmesh(int submeshID) const {
+    return submeshViews_[submeshID];
+  }
+
+  //! Bounding box of the positions of a submesh
+  const box3f& getSubmeshBounds(int submeshID) const {
+    return submeshBounds_[submeshID];
+  }
+
+  //! Cache file of meshFile in cacheDir
+  static std::string cacheFilename(const std::string& cacheDir,
+                                   const std::string& meshFile);
+
+  //! Read the submeshes, adjacency and bounds from cacheFile, or with shared
+  //! map them in place. Returns false if it is missing or was not written
+  //! for the current meshFile and split size.
+  bool loadCache(const std::string& cacheFile,
+                 const std::string& meshFile,
+                 bool shared = false);
+
+  //! Write the submeshes, adjacency and bounds computed from meshFile to
+  //! cacheFile
+  bool saveCache(const std::string& cacheFile,
+                 const std::string& meshFile) const;
 
   static void parsePLY(const std::string& filename, MeshData& meshData);
   static void calculateAdjacency(const MeshData& mesh,
                                  std::vector<uint32_t>& adjFaces);
+  //! Split a quad mesh into submeshes of the faces whose smallest vertex
+  //! Morton code, on a grid of splitSize cells, is the same
+  static std::vector<MeshData> splitMesh(const MeshData& mesh,
+                                         float splitSize);
 
   // ==== rendering ====
   RenderingBuffer* getRenderingBuffer(int submeshID);
   virtual void uploadBuffersToGPU(bool forceReload = false) override;
   virtual Magnum::GL::Mesh* getMagnumGLMesh(int submeshID) override;
+  virtual size_t getMemoryUsage() override;
 
  protected:
-  void loadMeshData(const std::string& meshFile);
+  void loadMeshData(const std::string& meshFile,
+                    const std::string& cacheDir,
+                    bool shareCache);
+
+  //! Point the submesh views at submeshes_ and adjacency_
+  void viewSubmeshes();
 
   float splitSize_ = 0.0f;
   uint32_t tileSize_ = 0;
   float exposure_ = 1.0f;
   std::string atlasFolder_;
   std::vector<MeshData> submeshes_;
+  // per submesh, computed at load time so they can be cached
+  std::vector<std::vector<uint32_t>> adjacency_;
+  std::vector<box3f> submeshBounds_;
+  std::vector<MeshView> submeshViews_;
+  // cache file the views point into, if it is shared
+  Corrade::Containers::Array<const char,
+                             Corrade::Utility::Directory::MapDeleter>
+      mappedCache_;
 
   // ==== rendering ====
   // we will have to use smart pointer here since each item within the structure
   // (e.g., Magnum::GL::Mesh) does NOT have copy constructor
   std::vector<std::unique_ptr<RenderingBuffer>> renderingBuffers_;
+  size_t atlasBytes_ = 0;
 };
 
 }  // namespace assets
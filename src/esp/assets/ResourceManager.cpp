@@ -3,6 +3,9 @@
 // LICENSE file in the root directory of this source tree.
 
 #include <functional>
+#include <mutex>
+#include <set>
+#include <thread>
 
 #include <Corrade/Containers/ArrayViewStl.h>
 #include <Corrade/PluginManager/Manager.h>
@@ -27,6 +30,7 @@
 #include "esp/gfx/GenericDrawable.h"
 #include "esp/gfx/PrimitiveIDTexturedDrawable.h"
 #include "esp/gfx/PrimitiveIDTexturedShader.h"
+#include "esp/gfx/RaycastMesh.h"
 #include "esp/io/io.h"
 #include "esp/io/json.h"
 #include "esp/scene/SceneConfiguration.h"
@@ -39,6 +43,7 @@
 #include "MeshData.h"
 #include "Mp3dInstanceMeshData.h"
 #include "ResourceManager.h"
+#include "TextureCache.h"
 #include "esp/physics/PhysicsManager.h"
 
 #ifdef PHYSICS_WITH_BULLET
@@ -56,6 +61,375 @@ namespace Cr = Corrade;
 namespace esp {
 namespace assets {
 
+namespace {
+// bounding sphere around the bounding box of the first three components of
+// positions, for visibility culling of drawable
+template <typename Positions>
+void setBoundingSphere(gfx::Drawable& drawable, const Positions& positions) {
+  if (positions.size() == 0) {
+    return;
+  }
+  Magnum::Vector3 min{positions[0][0], positions[0][1], positions[0][2]};
+  Magnum::Vector3 max = min;
+  for (const auto& p : positions) {
+    const Magnum::Vector3 position{p[0], p[1], p[2]};
+    min = Magnum::Math::min(min, position);
+    max = Magnum::Math::max(max, position);
+  }
+  drawable.setBoundingSphere((min + max) * 0.5f, (max - min).length() * 0.5f);
+}
+
+void setBoundingSphere(gfx::Drawable& drawable, const box3f& bounds) {
+  if (bounds.isEmpty()) {
+    return;
+  }
+  drawable.setBoundingSphere(Magnum::Vector3{vec3f{bounds.center()}},
+                             bounds.diagonal().norm() * 0.5f);
+}
+
+// Loading and unloading plugins (creating and destroying managers, and
+// opening files, for which AnySceneImporter loads the importer of the format)
+// changes process-wide state that is not thread-safe, so it holds this lock
+// once prefetch() runs imports in the background. Anything else an importer
+// does only touches its own manager, which one thread uses at a time, and
+// runs without the lock: the plugins decoding images are loaded beforehand.
+std::mutex& pluginMutex() {
+  static std::mutex mutex;
+  return mutex;
+}
+
+std::unique_ptr<Magnum::Trade::AbstractImporter> createImporter(
+    Magnum::PluginManager::Manager<Magnum::Trade::AbstractImporter>&
+        manager) {
+  std::unique_ptr<Magnum::Trade::AbstractImporter> importer =
+      manager.loadAndInstantiate("AnySceneImporter");
+  manager.setPreferredPlugins("GltfImporter", {"TinyGltfImporter"});
+#ifdef ESP_BUILD_ASSIMP_SUPPORT
+  manager.setPreferredPlugins("ObjImporter", {"AssimpImporter"});
+#endif
+  // importers ask for these for every image they decode
+  for (const char* plugin :
+       {"AnyImageImporter", "PngImporter", "JpegImporter"}) {
+    manager.load(plugin);
+  }
+  return importer;
+}
+
+// load an instance mesh, through its cache in cacheDir if it is shared
+bool loadInstanceMeshPLY(GenericInstanceMeshData& mesh,
+                         const AssetInfo& info,
+                         const std::string& cacheDir,
+                         bool shareMeshMemory) {
+  // FRL quad meshes keep buffers of their own, which are not shared
+  if (shareMeshMemory && !cacheDir.empty() &&
+      info.type == AssetType::INSTANCE_MESH) {
+    return mesh.loadSharedPLY(info.filepath, cacheDir);
+  }
+  return mesh.loadPLY(info.filepath);
+}
+
+#ifdef ESP_BUILD_PTEX_SUPPORT
+std::string ptexAtlasDir(const std::string& meshFile) {
+  return Corrade::Utility::String::stripSuffix(meshFile,
+                                               "ptex_quad_mesh.ply") +
+         "ptex_textures";
+}
+#endif
+}  // namespace
+
+struct ResourceManager::PrefetchedAsset {
+  ~PrefetchedAsset() {
+    // unloading the plugins changes the plugin registry as well
+    std::lock_guard<std::mutex> lock{pluginMutex()};
+    importer = nullptr;
+    manager = nullptr;
+  }
+
+  // general meshes: the importer, created on the main thread, with the file
+  // open and its images decoded
+  std::unique_ptr<Magnum::PluginManager::Manager<Importer>> manager;
+  std::unique_ptr<Importer> importer;
+  std::vector<Corrade::Containers::Optional<Magnum::Trade::ImageData2D>> images;
+  // PTex and instance meshes, loaded but not uploaded to the GPU
+  std::unique_ptr<BaseMesh> mesh;
+};
+
+void ResourceManager::textureCacheDir(const std::string& directory) {
+  if (directory.empty()) {
+    textureCache_ = nullptr;
+  } else if (textureCache_ == nullptr ||
+             textureCache_->directory() != directory) {
+    textureCache_ = TextureCache::create(directory);
+  }
+}
+
+void ResourceManager::assetMemoryBudget(size_t bytes) {
+  assetMemoryBudget_ = bytes;
+  evictAssets();
+}
+
+void ResourceManager::releaseScene(DrawableGroup& drawables) {
+  // the drawables, and raycast meshes on their nodes, refer to the assets
+  while (!drawables.isEmpty()) {
+    Magnum::SceneGraph::Drawable3D& drawable = drawables[0];
+    std::vector<Magnum::SceneGraph::AbstractFeature3D*> features;
+    for (auto& feature : drawable.object().features()) {
+      if (&feature == &drawable ||
+          dynamic_cast<gfx::RaycastMesh*>(&feature) != nullptr) {
+        features.push_back(&feature);
+      }
+    }
+    for (auto* feature : features) {
+      delete feature;
+    }
+  }
+
+  auto sceneAssets = sceneAssets_.find(&drawables);
+  if (sceneAssets != sceneAssets_.end()) {
+    for (const std::string& filename : sceneAssets->second) {
+      AssetUsage& usage = assetUsage_.at(filename);
+      --usage.sceneCount;
+      usage.lastUse = ++assetUseTick_;
+    }
+    sceneAssets_.erase(sceneAssets);
+  }
+  evictAssets();
+}
+
+void ResourceManager::useAsset(const std::string& filename,
+                               DrawableGroup* drawables) {
+  if (drawables == nullptr) {
+    return;
+  }
+  AssetUsage& usage = assetUsage_[filename];
+  usage.lastUse = ++assetUseTick_;
+  if (sceneAssets_[drawables].insert(filename).second) {
+    ++usage.sceneCount;
+  }
+}
+
+size_t ResourceManager::getAssetMemoryUsage(const MeshMetaData& metaData) {
+  // materials are too small to count
+  size_t bytes = 0;
+  if (metaData.meshIndex.first != ID_UNDEFINED) {
+    for (int i = metaData.meshIndex.first; i <= metaData.meshIndex.second;
+         ++i) {
+      if (meshes_[i]) {
+        bytes += meshes_[i]->getMemoryUsage();
+      }
+    }
+  }
+  if (metaData.textureIndex.first != ID_UNDEFINED) {
+    for (int i = metaData.textureIndex.first; i <= metaData.textureIndex.second;
+         ++i) {
+      bytes += textureSizes_[i];
+    }
+  }
+  return bytes;
+}
+
+bool ResourceManager::isPhysicsObjectAsset(const std::string& filename) {
+  // the collision mesh groups refer to the meshes of physics objects
+  for (auto& object : physicsObjectLibrary_) {
+    if (object.second.getString("renderMeshHandle") == filename ||
+        object.second.getString("collisionMeshHandle") == filename) {
+      return true;
+    }
+  }
+  return false;
+}
+
+void ResourceManager::evictAssets() {
+  if (assetMemoryBudget_ == 0) {
+    return;
+  }
+  size_t memoryUsage = 0;
+  for (const auto& asset : resourceDict_) {
+    memoryUsage += getAssetMemoryUsage(asset.second);
+  }
+
+  while (memoryUsage > assetMemoryBudget_) {
+    auto lru = assetUsage_.end();
+    for (auto it = assetUsage_.begin(); it != assetUsage_.end(); ++it) {
+      if (it->second.sceneCount == 0 &&
+          (lru == assetUsage_.end() ||
+           it->second.lastUse < lru->second.lastUse) &&
+          !isPhysicsObjectAsset(it->first)) {
+        lru = it;
+      }
+    }
+    if (lru == assetUsage_.end()) {
+      // everything else is in use
+      break;
+    }
+
+    // slots of unloaded assets stay empty, keeping the indices of the others
+    const std::string filename = lru->first;
+    const MeshMetaData& metaData = resourceDict_.at(filename);
+    memoryUsage -= getAssetMemoryUsage(metaData);
+    LOG(INFO) << "Unloading " << filename;
+    if (metaData.meshIndex.first != ID_UNDEFINED) {
+      for (int i = metaData.meshIndex.first; i <= metaData.meshIndex.second;
+           ++i) {
+        meshes_[i] = nullptr;
+      }
+    }
+    if (metaData.textureIndex.first != ID_UNDEFINED) {
+      for (int i = metaData.textureIndex.first;
+           i <= metaData.textureIndex.second; ++i) {
+        textures_[i] = nullptr;
+        textureSizes_[i] = 0;
+      }
+    }
+    if (metaData.materialIndex.first != ID_UNDEFINED) {
+      for (int i = metaData.materialIndex.first;
+           i <= metaData.materialIndex.second; ++i) {
+        materials_[i] = nullptr;
+      }
+    }
+    resourceDict_.erase(filename);
+    magnumMeshDict_.erase(filename);
+    assetUsage_.erase(lru);
+  }
+}
+
+std::shared_future<bool> ResourceManager::prefetch(
+    const std::vector<AssetInfo>& infos) {
+  // assets of an earlier prefetch that were never loaded were meant for an
+  // episode that did not happen, they would stay outside of the asset memory
+  // budget forever. A background import still running finishes on its own.
+  std::set<std::string> filenames;
+  for (const AssetInfo& info : infos) {
+    filenames.insert(info.filepath);
+  }
+  for (auto it = prefetched_.begin(); it != prefetched_.end();) {
+    if (filenames.count(it->first) == 0) {
+      LOG(INFO) << "Dropping unused prefetched asset " << it->first;
+      it = prefetched_.erase(it);
+    } else {
+      ++it;
+    }
+  }
+
+  std::vector<std::pair<AssetInfo, std::shared_ptr<PrefetchedAsset>>> assets;
+  for (const AssetInfo& info : infos) {
+    // the objects of a SUNCG house are only known once the house is parsed
+    if (resourceDict_.count(info.filepath) == 0 &&
+        prefetched_.count(info.filepath) == 0 &&
+        info.type != AssetType::SUNCG_SCENE) {
+      auto asset = std::make_shared<PrefetchedAsset>();
+      // general meshes get their importer plugin here, only opening the file
+      // is left to the background thread
+      if (info.type != AssetType::FRL_PTEX_MESH &&
+          info.type != AssetType::FRL_INSTANCE_MESH &&
+          info.type != AssetType::INSTANCE_MESH) {
+        std::lock_guard<std::mutex> lock{pluginMutex()};
+        asset->manager =
+            std::make_unique<Magnum::PluginManager::Manager<Importer>>();
+        asset->importer = createImporter(*asset->manager);
+      }
+      assets.emplace_back(info, std::move(asset));
+    }
+  }
+
+  // The detached worker owns its promise, so that neither dropping a
+  // prefetch nor destroying the ResourceManager waits for the import to finish
+  // the way the last future of std::async does. It lets go of the assets
+  // before the future becomes ready, so they are destroyed by whoever holds
+  // them last, which is safe on either thread, see ~PrefetchedAsset().
+  const std::string sceneCacheDir = sceneCacheDir_;
+  const bool shareMeshMemory = shareMeshMemory_;
+  auto promise = std::make_shared<std::promise<bool>>();
+  std::shared_future<bool> ready = promise->get_future().share();
+  for (const auto& asset : assets) {
+    prefetched_[asset.first.filepath] = {asset.second, ready};
+  }
+  std::thread([assets, sceneCacheDir, shareMeshMemory, promise]() mutable {
+    try {
+      bool success = true;
+      for (const auto& asset : assets) {
+        success = prefetchAsset(asset.first, sceneCacheDir, shareMeshMemory,
+                                *asset.second) &&
+                  success;
+      }
+      assets.clear();
+      promise->set_value(success);
+    } catch (...) {
+      assets.clear();
+      promise->set_exception(std::current_exception());
+    }
+  }).detach();
+  return ready;
+}
+
+bool ResourceManager::prefetchAsset(const AssetInfo& info,
+                                    const std::string& sceneCacheDir,
+                                    bool shareMeshMemory,
+                                    PrefetchedAsset& asset) {
+  const std::string& filename = info.filepath;
+  if (!io::exists(filename)) {
+    LOG(ERROR) << "Cannot prefetch from file " << filename;
+    return false;
+  }
+
+  if (info.type == AssetType::FRL_PTEX_MESH) {
+#ifdef ESP_BUILD_PTEX_SUPPORT
+    auto pTexMeshData = std::make_unique<PTexMeshData>();
+    pTexMeshData->load(filename, ptexAtlasDir(filename), sceneCacheDir,
+                       shareMeshMemory);
+    asset.mesh = std::move(pTexMeshData);
+    return true;
+#else
+    return false;
+#endif
+  }
+
+  if (info.type == AssetType::FRL_INSTANCE_MESH ||
+      info.type == AssetType::INSTANCE_MESH) {
+    std::unique_ptr<GenericInstanceMeshData> instanceMeshData;
+    if (info.type == AssetType::FRL_INSTANCE_MESH) {
+      instanceMeshData = std::make_unique<FRLInstanceMeshData>();
+    } else {
+      instanceMeshData = std::make_unique<GenericInstanceMeshData>();
+    }
+    if (!loadInstanceMeshPLY(*instanceMeshData, info, sceneCacheDir,
+                             shareMeshMemory)) {
+      return false;
+    }
+    asset.mesh = std::move(instanceMeshData);
+    return true;
+  }
+
+  // opening may load the importer of the format, see pluginMutex()
+  bool opened = false;
+  {
+    std::lock_guard<std::mutex> lock{pluginMutex()};
+    opened = asset.importer != nullptr && asset.importer->openFile(filename);
+  }
+  if (!opened) {
+    LOG(ERROR) << "Cannot prefetch from file " << filename;
+    return false;
+  }
+  // the importer only decodes images when asked to
+  for (unsigned int iImage = 0; iImage < asset.importer->image2DCount();
+       ++iImage) {
+    asset.images.emplace_back(asset.importer->image2D(iImage));
+  }
+  return true;
+}
+
+std::shared_ptr<ResourceManager::PrefetchedAsset>
+ResourceManager::takePrefetchedAsset(const std::string& filename) {
+  auto prefetch = prefetched_.find(filename);
+  if (prefetch == prefetched_.end()) {
+    return nullptr;
+  }
+  prefetch->second.ready.wait();
+  std::shared_ptr<PrefetchedAsset> asset = std::move(prefetch->second.asset);
+  prefetched_.erase(prefetch);
+  return asset;
+}
+
 bool ResourceManager::loadScene(const AssetInfo& info,
                                 scene::SceneNode* parent, /* = nullptr */
                                 DrawableGroup* drawables /* = nullptr */) {
@@ -346,16 +720,10 @@ int ResourceManager::loadObject(const std::string& objPhysConfigFilename,
         physicsObjectAttributes.getString("renderMeshHandle");
 
     MeshMetaData meshMetaData = resourceDict_[filename];
+    useAsset(filename, drawables);
     scene::SceneNode& newNode = parent->createChild();
-    AssetInfo renderMeshinfo = AssetInfo::fromPath(filename);
-    Magnum::PluginManager::Manager<Importer> manager;
-    std::unique_ptr<Importer> importer =
-        manager.loadAndInstantiate("AnySceneImporter");
-    manager.setPreferredPlugins("GltfImporter", {"TinyGltfImporter"});
-    manager.setPreferredPlugins("ObjImporter", {"AssimpImporter"});
-    for (auto componentID : magnumMeshDict_[filename]) {
-      addComponent(*importer, renderMeshinfo, meshMetaData, newNode, drawables,
-                   componentID);
+    for (const MeshTransformNode& root : magnumMeshDict_[filename]) {
+      addComponent(meshMetaData, root, newNode, drawables);
     }
   }
 
@@ -609,6 +977,44 @@ const std::vector<assets::CollisionMeshData>& ResourceManager::getCollisionMesh(
   return collisionMeshGroups_[configFile];
 }
 
+const std::vector<CollisionHull>& ResourceManager::getCollisionHulls(
+    const std::string& configFile) {
+  auto found = collisionHullGroups_.find(configFile);
+  if (found != collisionHullGroups_.end()) {
+    return found->second;
+  }
+  std::vector<CollisionHull>& hulls = collisionHullGroups_[configFile];
+  if (physicsObjectLibrary_.count(configFile) == 0) {
+    return hulls;
+  }
+  const std::string& meshFile =
+      physicsObjectLibrary_.at(configFile).getString("collisionMeshHandle");
+  const std::string hullsFile = collisionHullsFilename(configFile);
+  if (!Cr::Utility::Directory::exists(hullsFile) ||
+      !loadCollisionHulls(hullsFile, meshFile, hulls)) {
+    hulls.clear();
+    return hulls;
+  }
+
+  // the hulls are in the coordinates of the file, move them with their
+  // meshes, e.g. to the center of mass
+  const MeshMetaData& metaData = resourceDict_.at(meshFile);
+  for (CollisionHull& hull : hulls) {
+    const int meshID = metaData.meshIndex.first + hull.meshIndex;
+    if (meshID > metaData.meshIndex.second) {
+      LOG(WARNING) << "Ignoring collision hulls " << hullsFile
+                   << " of more meshes than " << meshFile << " has";
+      hulls.clear();
+      break;
+    }
+    const Magnum::Matrix4& transform = meshes_[meshID]->meshTransform_;
+    for (Magnum::Vector3& point : hull.points) {
+      point = transform.transformPoint(point);
+    }
+  }
+  return hulls;
+}
+
 int ResourceManager::getObjectID(const std::string& configFile) {
   std::vector<std::string>::iterator itr =
       std::find(physicsObjectConfigList_.begin(),
@@ -693,14 +1099,18 @@ bool ResourceManager::loadPTexMeshData(const AssetInfo& info,
   // if this is a new file, load it and add it to the dictionary
   const std::string& filename = info.filepath;
   if (resourceDict_.count(filename) == 0) {
-    const std::string atlasDir =
-        Corrade::Utility::String::stripSuffix(filename, "ptex_quad_mesh.ply") +
-        "ptex_textures";
-
-    meshes_.emplace_back(std::make_unique<PTexMeshData>());
+    // parsed and preprocessed on a background thread, if prefetched
+    std::shared_ptr<PrefetchedAsset> prefetched = takePrefetchedAsset(filename);
+    if (prefetched != nullptr && prefetched->mesh != nullptr) {
+      meshes_.emplace_back(std::move(prefetched->mesh));
+      ++numPrefetchedLoads_;
+    } else {
+      auto pTexMeshData = std::make_unique<PTexMeshData>();
+      pTexMeshData->load(filename, ptexAtlasDir(filename), sceneCacheDir_,
+                         shareMeshMemory_);
+      meshes_.emplace_back(std::move(pTexMeshData));
+    }
     int index = meshes_.size() - 1;
-    auto* pTexMeshData = dynamic_cast<PTexMeshData*>(meshes_[index].get());
-    pTexMeshData->load(filename, atlasDir);
 
     // update the dictionary
     resourceDict_.emplace(filename, MeshMetaData(index, index));
@@ -714,6 +1124,7 @@ bool ResourceManager::loadPTexMeshData(const AssetInfo& info,
     auto indexPair = resourceDict_.at(filename).meshIndex;
     int start = indexPair.first;
     int end = indexPair.second;
+    useAsset(filename, drawables);
 
     for (int iMesh = start; iMesh <= end; ++iMesh) {
       auto* pTexMeshData = dynamic_cast<PTexMeshData*>(meshes_[iMesh].get());
@@ -722,8 +1133,10 @@ bool ResourceManager::loadPTexMeshData(const AssetInfo& info,
 
       for (int jSubmesh = 0; jSubmesh < pTexMeshData->getSize(); ++jSubmesh) {
         scene::SceneNode& node = parent->createChild();
-        new gfx::PTexMeshDrawable{node, *ptexShader, *pTexMeshData, jSubmesh,
-                                  drawables};
+        auto* drawable = new gfx::PTexMeshDrawable{
+            node, *ptexShader, *pTexMeshData, jSubmesh, drawables};
+        setBoundingSphere(*drawable,
+                          pTexMeshData->getSubmeshBounds(jSubmesh));
       }
     }
   }
@@ -744,19 +1157,28 @@ bool ResourceManager::loadInstanceMeshData(const AssetInfo& info,
   // and add it to the shaderPrograms_
   const std::string& filename = info.filepath;
   if (resourceDict_.count(filename) == 0) {
-    if (info.type == AssetType::FRL_INSTANCE_MESH) {
-      meshes_.emplace_back(std::make_unique<FRLInstanceMeshData>());
-    } else if (info.type == AssetType::INSTANCE_MESH) {
-      meshes_.emplace_back(std::make_unique<GenericInstanceMeshData>());
+    // parsed on a background thread, if prefetched
+    std::shared_ptr<PrefetchedAsset> prefetched = takePrefetchedAsset(filename);
+    if (prefetched != nullptr && prefetched->mesh != nullptr) {
+      meshes_.emplace_back(std::move(prefetched->mesh));
+      ++numPrefetchedLoads_;
+    } else {
+      if (info.type == AssetType::FRL_INSTANCE_MESH) {
+        meshes_.emplace_back(std::make_unique<FRLInstanceMeshData>());
+      } else if (info.type == AssetType::INSTANCE_MESH) {
+        meshes_.emplace_back(std::make_unique<GenericInstanceMeshData>());
+      }
+      loadInstanceMeshPLY(
+          *dynamic_cast<GenericInstanceMeshData*>(meshes_.back().get()), info,
+          sceneCacheDir_, shareMeshMemory_);
     }
     int index = meshes_.size() - 1;
     auto* instanceMeshData =
         dynamic_cast<GenericInstanceMeshData*>(meshes_[index].get());
 
-    instanceMeshData->loadPLY(filename);
     instanceMeshData->uploadBuffersToGPU(false);
 
-    instance_mesh_ = &(instanceMeshData->getRenderingBuffer()->mesh);
+    instance_mesh_ = instanceMeshData->getMagnumGLMesh();
     // update the dictionary
     resourceDict_.emplace(filename, MeshMetaData(index, index));
   }
@@ -766,13 +1188,28 @@ bool ResourceManager::loadInstanceMeshData(const AssetInfo& info,
     auto indexPair = resourceDict_.at(filename).meshIndex;
     int start = indexPair.first;
     int end = indexPair.second;
+    useAsset(filename, drawables);
 
     for (int iMesh = start; iMesh <= end; ++iMesh) {
       auto* instanceMeshData =
           dynamic_cast<GenericInstanceMeshData*>(meshes_[iMesh].get());
       scene::SceneNode& node = parent->createChild();
-      createDrawable(INSTANCE_MESH_SHADER, *instanceMeshData->getMagnumGLMesh(),
-                     node, drawables, instanceMeshData->getSemanticTexture());
+      // one drawable per chunk, each looking up the object ids of its
+      // triangles from its own offset into the shared texture
+      const GenericInstanceMeshData::RenderingBuffer& renderingBuffer =
+          *instanceMeshData->getRenderingBuffer();
+      for (int jChunk = 0; jChunk < instanceMeshData->getNumChunks();
+           ++jChunk) {
+        auto& drawable = static_cast<gfx::PrimitiveIDTexturedDrawable&>(
+            createDrawable(INSTANCE_MESH_SHADER,
+                           *instanceMeshData->getMagnumGLMesh(jChunk), node,
+                           drawables, instanceMeshData->getSemanticTexture()));
+        drawable.setPositionDecode(renderingBuffer.positionDecode);
+        drawable.setPrimitiveIdOffset(
+            renderingBuffer.chunks[jChunk].primitiveIdOffset);
+      }
+      new gfx::RaycastMesh{node, instanceMeshData->getCollisionMeshData(),
+                           &instanceMeshData->getObjectIdsCPU()};
     }
   }
 
@@ -791,27 +1228,33 @@ bool ResourceManager::loadGeneralMeshData(
 
   // Mesh & metaData container
   MeshMetaData metaData;
-  std::vector<Magnum::UnsignedInt> magnumData;
-
-  Magnum::PluginManager::Manager<Importer> manager;
-  std::unique_ptr<Importer> importer =
-      manager.loadAndInstantiate("AnySceneImporter");
-  manager.setPreferredPlugins("GltfImporter", {"TinyGltfImporter"});
-#ifdef ESP_BUILD_ASSIMP_SUPPORT
-  manager.setPreferredPlugins("ObjImporter", {"AssimpImporter"});
-#endif
+  std::vector<MeshTransformNode> magnumData;
 
-  // Optional File loading
+  // Optional File loading, the only time the file is opened
   if (!fileIsLoaded) {
-    if (!importer->openFile(filename)) {
-      LOG(ERROR) << "Cannot open file " << filename;
-      return false;
+    // opened, with its images decoded, on a background thread if prefetched
+    std::shared_ptr<PrefetchedAsset> asset = takePrefetchedAsset(filename);
+    if (asset != nullptr && asset->importer != nullptr &&
+        asset->importer->isOpened()) {
+      ++numPrefetchedLoads_;
+    } else {
+      asset = std::make_shared<PrefetchedAsset>();
+      // see pluginMutex()
+      std::lock_guard<std::mutex> lock{pluginMutex()};
+      asset->manager =
+          std::make_unique<Magnum::PluginManager::Manager<Importer>>();
+      asset->importer = createImporter(*asset->manager);
+      if (!asset->importer->openFile(filename)) {
+        LOG(ERROR) << "Cannot open file " << filename;
+        return false;
+      }
     }
+    Importer* importer = asset->importer.get();
 
     // if this is a new file, load it and add it to the dictionary
-    loadTextures(*importer, &metaData);
+    loadTextures(*importer, filename, &metaData, &asset->images);
     loadMaterials(*importer, &metaData);
-    loadMeshes(*importer, &metaData, shiftOrigin, translation);
+    loadMeshes(*importer, filename, &metaData, shiftOrigin, translation);
     resourceDict_.emplace(filename, metaData);
 
     // Register magnum mesh
@@ -823,18 +1266,24 @@ bool ResourceManager::loadGeneralMeshData(
         return false;
       }
       for (unsigned int sceneDataID : sceneData->children3D()) {
-        magnumData.emplace_back(sceneDataID);
+        magnumData.emplace_back();
+        if (!loadMeshHierarchy(*importer, sceneDataID, magnumData.back())) {
+          magnumData.pop_back();
+        }
       }
     } else if (importer->mesh3DCount() && meshes_[metaData.meshIndex.first]) {
       // no default scene --- standalone OBJ/PLY files, for example
       // take a wild guess and load the first mesh with the first material
       // addMeshToDrawables(metaData, *parent, drawables, ID_UNDEFINED, 0, 0);
-      magnumData.emplace_back(0);
+      magnumData.emplace_back();
+      if (!loadMeshHierarchy(*importer, 0, magnumData.back())) {
+        magnumData.pop_back();
+      }
     } else {
       LOG(ERROR) << "No default scene available and no meshes found, exiting";
       return false;
     }
-    magnumMeshDict_.emplace(filename, magnumData);
+    magnumMeshDict_.emplace(filename, std::move(magnumData));
   } else {
     metaData = resourceDict_[filename];
   }
@@ -850,6 +1299,7 @@ bool ResourceManager::loadGeneralMeshData(
 
     //! Do instantiate object
     MeshMetaData& metaData = resourceDict_[filename];
+    useAsset(filename, drawables);
     const bool forceReload = false;
     // re-bind position, normals, uv, colors etc. to the corresponding buffers
     // under *current* gl context
@@ -866,8 +1316,8 @@ bool ResourceManager::loadGeneralMeshData(
     const quatf transform = info.frame.rotationFrameToWorld();
     newNode.setRotation(Magnum::Quaternion(transform));
     // Recursively add all children
-    for (auto sceneDataID : magnumMeshDict_[filename]) {
-      addComponent(*importer, info, metaData, newNode, drawables, sceneDataID);
+    for (const MeshTransformNode& root : magnumMeshDict_[filename]) {
+      addComponent(metaData, root, newNode, drawables);
     }
     return true;
   }
@@ -904,6 +1354,7 @@ void ResourceManager::loadMaterials(Importer& importer,
 }
 
 void ResourceManager::loadMeshes(Importer& importer,
+                                 const std::string& filename,
                                  MeshMetaData* metaData,
                                  bool shiftOrigin /*=false*/,
                                  Magnum::Vector3 offset /* [0,0,0] */
@@ -929,17 +1380,29 @@ void ResourceManager::loadMeshes(Importer& importer,
     }
 
     CollisionMeshData& meshData = gltfMeshData->getCollisionMeshData();
+    if (meshLodLevels_ > 0) {
+      gltfMeshData->setupLods(meshLodLevels_,
+                              filename + "." + std::to_string(iMesh) + ".lod");
+    }
     gltfMeshData->uploadBuffersToGPU(false);
   }
 }
 
-void ResourceManager::loadTextures(Importer& importer, MeshMetaData* metaData) {
+void ResourceManager::loadTextures(
+    Importer& importer,
+    const std::string& filename,
+    MeshMetaData* metaData,
+    const std::vector<Corrade::Containers::Optional<
+        Magnum::Trade::ImageData2D>>* images /* = nullptr */) {
   int textureStart = textures_.size();
   int textureEnd = textureStart + importer.textureCount() - 1;
   metaData->setTextureIndices(textureStart, textureEnd);
+  // the files the images are stored in do not change while loading
+  TextureCache::FileHashes fileHashes;
 
   for (int iTexture = 0; iTexture < importer.textureCount(); ++iTexture) {
     textures_.emplace_back(std::make_shared<Magnum::GL::Texture2D>());
+    textureSizes_.emplace_back(0);
     auto& currentTexture = textures_.back();
 
     auto textureData = importer.texture(iTexture);
@@ -953,8 +1416,38 @@ void ResourceManager::loadTextures(Importer& importer, MeshMetaData* metaData) {
     // TODO:
     // it seems we have a way to just load the image once in this case,
     // as long as the image2DName include the full path to the image
-    Corrade::Containers::Optional<Magnum::Trade::ImageData2D> imageData =
-        importer.image2D(textureData->image());
+    const unsigned int imageID = textureData->image();
+
+    // Configure the texture
+    Magnum::GL::Texture2D& texture =
+        *(textures_[textureStart + iTexture].get());
+    texture.setMagnificationFilter(textureData->magnificationFilter())
+        .setMinificationFilter(textureData->minificationFilter(),
+                               textureData->mipmapFilter())
+        .setWrapping(textureData->wrapping().xy());
+
+    // reuse the mip chain compressed by an earlier load, if there is one,
+    // without decoding the image
+    uint64_t cacheKey = 0;
+    const bool useCache = compressTextures_ && textureCache_ != nullptr &&
+                          TextureCache::key(filename, imageID, cacheKey,
+                                            &fileHashes);
+    Magnum::Vector2i cachedSize;
+    if (useCache && textureCache_->load(cacheKey, texture, cachedSize)) {
+      // mip chains take a third more than the image, DXT1 compresses to half
+      // a byte per pixel
+      textureSizes_[textureStart + iTexture] = cachedSize.product() / 2 * 4 / 3;
+      continue;
+    }
+
+    // decoded already if prefetched, an empty image if decoding failed
+    const bool prefetched = images != nullptr && imageID < images->size();
+    Corrade::Containers::Optional<Magnum::Trade::ImageData2D> importedImage;
+    if (!prefetched) {
+      importedImage = importer.image2D(imageID);
+    }
+    const Corrade::Containers::Optional<Magnum::Trade::ImageData2D>&
+        imageData = prefetched ? (*images)[imageID] : importedImage;
     Magnum::GL::TextureFormat format;
     if (imageData && imageData->format() == Magnum::PixelFormat::RGB8Unorm)
       format = compressTextures_
@@ -971,58 +1464,78 @@ void ResourceManager::loadTextures(Importer& importer, MeshMetaData* metaData) {
       continue;
     }
 
-    // Configure the texture
-    Magnum::GL::Texture2D& texture =
-        *(textures_[textureStart + iTexture].get());
-    texture.setMagnificationFilter(textureData->magnificationFilter())
-        .setMinificationFilter(textureData->minificationFilter(),
-                               textureData->mipmapFilter())
-        .setWrapping(textureData->wrapping().xy())
+    // mip chains take a third more than the image, DXT1 compresses to half a
+    // byte per pixel
+    textureSizes_[textureStart + iTexture] =
+        (compressTextures_ ? imageData->size().product() / 2
+                           : imageData->data().size()) *
+        4 / 3;
+
+    texture
         .setStorage(Magnum::Math::log2(imageData->size().max()) + 1, format,
                     imageData->size())
         .setSubImage(0, {}, *imageData)
         .generateMipmap();
+    if (useCache) {
+      textureCache_->store(cacheKey, format, texture);
+    }
   }
 }
 
-//! Add component to rendering stack, based on importer loading
-//! TODO (JH): decouple importer part, so that objects can be
-//! instantiated any time after initial loading
-void ResourceManager::addComponent(Importer& importer,
-                                   const AssetInfo& info,
-                                   const MeshMetaData& metaData,
-                                   scene::SceneNode& parent,
-                                   DrawableGroup* drawables,
-                                   int componentID) {
-  importer.openFile(info.filepath);
+bool ResourceManager::loadMeshHierarchy(Importer& importer,
+                                        int objectID,
+                                        MeshTransformNode& node) {
   std::unique_ptr<Magnum::Trade::ObjectData3D> objectData =
-      importer.object3D(componentID);
+      importer.object3D(objectID);
   if (!objectData) {
-    LOG(ERROR) << "Cannot import object " << importer.object3DName(componentID)
+    LOG(ERROR) << "Cannot import object " << importer.object3DName(objectID)
                << ", skipping";
-    return;
+    return false;
+  }
+
+  node.componentID = objectID;
+  node.transformation = objectData->transformation();
+  if (objectData->instanceType() == Magnum::Trade::ObjectInstanceType3D::Mesh &&
+      objectData->instance() != ID_UNDEFINED) {
+    node.meshIDLocal = objectData->instance();
+    node.materialIDLocal =
+        static_cast<Magnum::Trade::MeshObjectData3D*>(objectData.get())
+            ->material();
   }
 
+  for (auto childObjectID : objectData->children()) {
+    node.children.emplace_back();
+    if (!loadMeshHierarchy(importer, childObjectID, node.children.back())) {
+      node.children.pop_back();
+    }
+  }
+  return true;
+}
+
+//! Add component to rendering stack, based on the object hierarchy imported
+//! with the file, so that objects can be instantiated any time after initial
+//! loading without the importer
+void ResourceManager::addComponent(const MeshMetaData& metaData,
+                                   const MeshTransformNode& meshTransformNode,
+                                   scene::SceneNode& parent,
+                                   DrawableGroup* drawables) {
   // Add the object to the scene and set its transformation
   scene::SceneNode& node = parent.createChild();
-  node.MagnumObject::setTransformation(objectData->transformation());
+  node.MagnumObject::setTransformation(meshTransformNode.transformation);
 
-  const int meshIDLocal = objectData->instance();
+  const int meshIDLocal = meshTransformNode.meshIDLocal;
   const int meshID = metaData.meshIndex.first + meshIDLocal;
 
   // Add a drawable if the object has a mesh and the mesh is loaded
-  if (objectData->instanceType() == Magnum::Trade::ObjectInstanceType3D::Mesh &&
-      meshIDLocal != ID_UNDEFINED && meshes_[meshID]) {
-    const int materialIDLocal =
-        static_cast<Magnum::Trade::MeshObjectData3D*>(objectData.get())
-            ->material();
-    addMeshToDrawables(metaData, node, drawables, componentID, meshIDLocal,
-                       materialIDLocal);
+  if (meshIDLocal != ID_UNDEFINED && meshes_[meshID]) {
+    addMeshToDrawables(metaData, node, drawables,
+                       meshTransformNode.componentID, meshIDLocal,
+                       meshTransformNode.materialIDLocal);
   }
 
   // Recursively add children
-  for (auto childObjectID : objectData->children()) {
-    addComponent(importer, info, metaData, node, drawables, childObjectID);
+  for (const MeshTransformNode& child : meshTransformNode.children) {
+    addComponent(metaData, child, node, drawables);
   }
 }
 
@@ -1035,16 +1548,19 @@ void ResourceManager::addMeshToDrawables(const MeshMetaData& metaData,
   const int meshStart = metaData.meshIndex.first;
   const int meshID = meshStart + meshIDLocal;
   Magnum::GL::Mesh& mesh = *meshes_[meshID]->getMagnumGLMesh();
+  new gfx::RaycastMesh{node, meshes_[meshID]->getCollisionMeshData()};
 
   const int materialStart = metaData.materialIndex.first;
   const int materialID = materialStart + materialIDLocal;
 
   Magnum::GL::Texture2D* texture = nullptr;
+  gfx::Drawable* drawable = nullptr;
   // Material not set / not available / not loaded, use a default material
   if (materialIDLocal == ID_UNDEFINED ||
       metaData.materialIndex.second == ID_UNDEFINED ||
       !materials_[materialID]) {
-    createDrawable(COLORED_SHADER, mesh, node, drawables, texture, componentID);
+    drawable = &createDrawable(COLORED_SHADER, mesh, node, drawables, texture,
+                               componentID);
   } else {
     if (materials_[materialID]->flags() &
         Magnum::Trade::PhongMaterialData::Flag::DiffuseTexture) {
@@ -1054,19 +1570,30 @@ void ResourceManager::addMeshToDrawables(const MeshMetaData& metaData,
       const int textureIndex = materials_[materialID]->diffuseTexture();
       texture = textures_[textureStart + textureIndex].get();
       if (texture) {
-        createDrawable(TEXTURED_SHADER, mesh, node, drawables, texture,
-                       componentID);
+        drawable = &createDrawable(TEXTURED_SHADER, mesh, node, drawables,
+                                   texture, componentID);
       } else {
         // Color-only material
-        createDrawable(COLORED_SHADER, mesh, node, drawables, texture,
-                       componentID, materials_[materialID]->diffuseColor());
+        drawable = &createDrawable(COLORED_SHADER, mesh, node, drawables,
+                                   texture, componentID,
+                                   materials_[materialID]->diffuseColor());
       }
     } else {
       // Color-only material
-      createDrawable(COLORED_SHADER, mesh, node, drawables, texture,
-                     componentID, materials_[materialID]->diffuseColor());
+      drawable = &createDrawable(COLORED_SHADER, mesh, node, drawables,
+                                 texture, componentID,
+                                 materials_[materialID]->diffuseColor());
     }
   }  // else
+
+  // draw the level of detail that suits the projected size, if there are any
+  auto* gltfMeshData = dynamic_cast<GltfMeshData*>(meshes_[meshID].get());
+  if (gltfMeshData != nullptr && gltfMeshData->getNumLods() > 1) {
+    static_cast<gfx::GenericDrawable*>(drawable)->setLodMeshData(gltfMeshData);
+  }
+
+  setBoundingSphere(*drawable,
+                    meshes_[meshID]->getCollisionMeshData().positions);
 }
 
 gfx::Drawable& ResourceManager::createDrawable(
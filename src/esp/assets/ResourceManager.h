@@ -4,8 +4,10 @@
 
 #pragma once
 
+#include <future>
 #include <map>
 #include <memory>
+#include <set>
 #include <string>
 #include <vector>
 
@@ -14,10 +16,12 @@
 #include <Magnum/MeshTools/Compile.h>
 #include <Magnum/MeshTools/Transform.h>
 #include <Magnum/SceneGraph/MatrixTransformation3D.h>
+#include <Magnum/Trade/Trade.h>
 
 #include "Asset.h"
 #include "Attributes.h"
 #include "BaseMesh.h"
+#include "CollisionHulls.h"
 #include "CollisionMeshData.h"
 #include "GltfMeshData.h"
 #include "MeshData.h"
@@ -46,6 +50,7 @@ class PhysicsManager;
 class RigidObject;
 }  // namespace physics
 namespace assets {
+class TextureCache;
 
 class ResourceManager {
  public:
@@ -63,6 +68,48 @@ class ResourceManager {
 
   inline void compressTextures(bool newVal) { compressTextures_ = newVal; };
 
+  //! Directory keeping compressed textures across loads and processes, so
+  //! they are only compressed once. Empty disables the cache.
+  void textureCacheDir(const std::string& directory);
+
+  //! Directory keeping preprocessed PTex meshes (split submeshes, adjacency
+  //! and bounds), and instance meshes if shared, across loads and processes.
+  //! Empty disables the cache.
+  inline void sceneCacheDir(const std::string& directory) {
+    sceneCacheDir_ = directory;
+  };
+
+  //! Use the CPU-side data of PTex and instance meshes in place from their
+  //! cache files in sceneCacheDir, mapped read-only, instead of copying it.
+  //! All processes loading a mesh then share one copy, kept in shared memory
+  //! if the directory is on a tmpfs such as /dev/shm.
+  inline void shareMeshMemory(bool newVal) { shareMeshMemory_ = newVal; };
+
+  //! Number of coarser levels of detail to set up for meshes of general
+  //! (e.g. glTF) assets, cached next to the asset. 0 disables them.
+  inline void meshLodLevels(int newVal) { meshLodLevels_ = newVal; };
+
+  //! Memory, in bytes, loaded assets may take before those no scene uses
+  //! anymore are unloaded, least recently used first. Until then, scenes
+  //! using released assets again load instantly. 0 keeps all assets loaded.
+  void assetMemoryBudget(size_t bytes);
+
+  //! Delete the drawables added to drawables, and the raycast meshes next to
+  //! them, and release the assets they use, which may unload them. The scene
+  //! nodes stay.
+  void releaseScene(DrawableGroup& drawables);
+
+  //! Start importing the CPU side of assets (parsing, image decoding, PTex
+  //! preprocessing) on a background thread, so that loading them later only
+  //! waits for what is left and uploads to the GPU. The future becomes ready
+  //! once they are imported, with whether all imports succeeded. Assets
+  //! loaded or prefetched already, and SUNCG houses, are skipped. Assets of
+  //! earlier calls that are neither loaded yet nor in infos are dropped.
+  std::shared_future<bool> prefetch(const std::vector<AssetInfo>& infos);
+
+  //! Number of assets loaded so far whose import was done by prefetch()
+  size_t getNumPrefetchedLoads() const { return numPrefetchedLoads_; }
+
   //! Load Scene data + instantiate scene
   //! Both load + instantiate scene
   bool loadScene(const AssetInfo& info,
@@ -116,6 +163,12 @@ class ResourceManager {
   const std::vector<assets::CollisionMeshData>& getCollisionMesh(
       const int objectID);
 
+  //! Convex hulls of the collision mesh of an object, read on first use from
+  //! the file next to its config file, see collisionHullsFilename(). Empty if
+  //! there is no such file for the collision mesh as it is now.
+  const std::vector<CollisionHull>& getCollisionHulls(
+      const std::string& configFile);
+
   int getObjectID(const std::string& configFile);
   std::string getObjectConfig(const int objectID);
 
@@ -130,22 +183,35 @@ class ResourceManager {
 
  protected:
   //======== Scene Functions ========
+  //! Import the object objectID of the file open in importer and its
+  //! children into node. Returns false if the object cannot be imported.
+  bool loadMeshHierarchy(Importer& importer,
+                         int objectID,
+                         MeshTransformNode& node);
+
   //! Instantiate Scene:
   //! (1) create scene node
   //! (2) upload mesh to gpu and drawables
   //! (optional reload of GPU-side assets)
-  void addComponent(Importer& importer,
-                    const AssetInfo& info,
-                    const MeshMetaData& metaData,
+  void addComponent(const MeshMetaData& metaData,
+                    const MeshTransformNode& meshTransformNode,
                     scene::SceneNode& parent,
-                    DrawableGroup* drawables,
-                    int objectID);
-
-  //! Load textures from importer into assets, and update metaData
-  void loadTextures(Importer& importer, MeshMetaData* metaData);
-
-  //! Load meshes from importer into assets, and update metaData
+                    DrawableGroup* drawables);
+
+  //! Load textures from importer, which opened filename, into assets, and
+  //! update metaData. Images decoded already, by image ID, are taken from
+  //! images if given.
+  void loadTextures(
+      Importer& importer,
+      const std::string& filename,
+      MeshMetaData* metaData,
+      const std::vector<Corrade::Containers::Optional<
+          Magnum::Trade::ImageData2D>>* images = nullptr);
+
+  //! Load meshes from importer into assets, and update metaData. filename is
+  //! the asset the importer opened, next to which mesh LODs are cached.
   void loadMeshes(Importer& importer,
+                  const std::string& filename,
                   MeshMetaData* metaData,
                   bool shiftOrigin = false,
                   Magnum::Vector3 offset = Magnum::Vector3(0, 0, 0));
@@ -199,9 +265,61 @@ class ResourceManager {
   // a dictionary to check if a mesh has been loaded
   // maps: absolutePath -> meshMetaData
   std::map<std::string, MeshMetaData> resourceDict_;  // meshes
-  std::map<std::string, std::vector<Magnum::UnsignedInt>>
-      magnumMeshDict_;  // IDs for object mesh hierarchies NOTE: needed? to
-                        // bypass "importer" reload
+  // maps: absolutePath -> root objects of the imported object hierarchy
+  std::map<std::string, std::vector<MeshTransformNode>> magnumMeshDict_;
+
+  // ======== Asset lifetime ========
+  //! Record that the scene of drawables instantiates the asset filename
+  void useAsset(const std::string& filename, DrawableGroup* drawables);
+
+  //! Approximate CPU and GPU memory held by a loaded asset, in bytes
+  size_t getAssetMemoryUsage(const MeshMetaData& metaData);
+
+  //! Whether an object of the physics object library uses asset filename
+  bool isPhysicsObjectAsset(const std::string& filename);
+
+  //! Unload assets no scene uses, least recently used first, until all
+  //! loaded assets fit the memory budget
+  void evictAssets();
+
+  struct AssetUsage {
+    // number of scenes instantiating the asset
+    int sceneCount = 0;
+    // tick of the last instantiation or release, for LRU eviction
+    size_t lastUse = 0;
+  };
+  // maps: absolutePath -> usage, for assets ever instantiated in a scene
+  std::map<std::string, AssetUsage> assetUsage_;
+  // assets instantiated in each scene, by the drawables of the scene
+  std::map<const DrawableGroup*, std::set<std::string>> sceneAssets_;
+  size_t assetUseTick_ = 0;
+  size_t assetMemoryBudget_ = 0;
+  // approximate memory of each of textures_
+  std::vector<size_t> textureSizes_;
+
+  // ======== Prefetching ========
+  //! CPU side of an asset, see prefetch()
+  struct PrefetchedAsset;
+
+  //! Import the CPU side of info into asset, on a background thread. The
+  //! importer of general meshes is created by prefetch() beforehand.
+  static bool prefetchAsset(const AssetInfo& info,
+                            const std::string& sceneCacheDir,
+                            bool shareMeshMemory,
+                            PrefetchedAsset& asset);
+
+  //! Take the prefetched asset filename, waiting for its import to finish.
+  //! nullptr if it was not prefetched.
+  std::shared_ptr<PrefetchedAsset> takePrefetchedAsset(
+      const std::string& filename);
+
+  struct Prefetch {
+    std::shared_ptr<PrefetchedAsset> asset;
+    std::shared_future<bool> ready;
+  };
+  // maps: absolutePath -> asset being prefetched
+  std::map<std::string, Prefetch> prefetched_;
+  size_t numPrefetchedLoads_ = 0;
 
   // ======== Physical geometry data ========
   // library of physics object parameters mapped from config filename (used by
@@ -217,6 +335,9 @@ class ResourceManager {
   // maps: "data/objects/cheezit.phys_properties.json" -> collesionMesh group
   std::map<std::string, std::vector<CollisionMeshData>>
       collisionMeshGroups_;  // meshes for the object hierarchies
+  // maps: "data/objects/cheezit.phys_properties.json" -> convex hulls of the
+  // collision mesh group, read from "data/objects/cheezit.collision_hulls"
+  std::map<std::string, std::vector<CollisionHull>> collisionHullGroups_;
   // vector of "data/objects/cheezit.phys_properties.json"
   std::vector<std::string>
       physicsObjectConfigList_;  // NOTE: can't get keys from the map (easily),
@@ -266,6 +387,10 @@ class ResourceManager {
       const Magnum::Color4& color = Magnum::Color4{1});
 
   bool compressTextures_ = false;
+  std::shared_ptr<TextureCache> textureCache_ = nullptr;
+  int meshLodLevels_ = 0;
+  std::string sceneCacheDir_;
+  bool shareMeshMemory_ = false;
 };
 
 }  // namespace assets
@@ -0,0 +1,319 @@
+// Copyright (c) Facebook, Inc. and its affiliates.
+// This source code is licensed under the MIT license found in the
+// LICENSE file in the root directory of this source tree.
+
+#include "TextureCache.h"
+
+#include <unistd.h>
+#include <cctype>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <vector>
+
+#include <Corrade/Containers/Array.h>
+#include <Corrade/Utility/Directory.h>
+#include <Corrade/Utility/String.h>
+#include <Magnum/GL/PixelFormat.h>
+#include <Magnum/GL/Texture.h>
+#include <Magnum/GL/TextureFormat.h>
+#include <Magnum/Image.h>
+#include <Magnum/ImageView.h>
+#include <Magnum/Math/Functions.h>
+
+#include "esp/io/json.h"
+
+namespace Cr = Corrade;
+
+namespace esp {
+namespace assets {
+
+namespace {
+// "ETEX" and format version of texture cache files
+constexpr uint32_t kTextureCacheMagic = 0x58455445;
+constexpr uint32_t kTextureCacheVersion = 3;
+
+struct CacheHeader {
+  uint32_t magic;
+  uint32_t version;
+  uint32_t format;
+  uint32_t numLevels;
+  int32_t width;
+  int32_t height;
+};
+
+// 64 bit FNV-1a, consuming a word at a time
+constexpr uint64_t kFnvOffset = 0xcbf29ce484222325ull;
+constexpr uint64_t kFnvPrime = 0x100000001b3ull;
+
+uint64_t hashBytes(uint64_t hash, const char* data, size_t size) {
+  size_t i = 0;
+  for (; i + sizeof(uint64_t) <= size; i += sizeof(uint64_t)) {
+    uint64_t word;
+    std::memcpy(&word, data + i, sizeof(word));
+    hash = (hash ^ word) * kFnvPrime;
+  }
+  for (; i < size; ++i) {
+    hash = (hash ^ uint8_t(data[i])) * kFnvPrime;
+  }
+  return hash;
+}
+
+Magnum::Vector2i levelSize(const Magnum::Vector2i& size, int level) {
+  return Magnum::Math::max(size >> level, Magnum::Vector2i{1});
+}
+
+// Hash the contents of file, false if it cannot be read
+bool hashFile(const std::string& file,
+              uint64_t& hash,
+              TextureCache::FileHashes* fileHashes) {
+  if (fileHashes != nullptr) {
+    auto found = fileHashes->find(file);
+    if (found != fileHashes->end()) {
+      hash = found->second;
+      return true;
+    }
+  }
+  if (!Cr::Utility::Directory::exists(file)) {
+    return false;
+  }
+  const Cr::Containers::Array<const char, Cr::Utility::Directory::MapDeleter>
+      data = Cr::Utility::Directory::mapRead(file);
+  hash = hashBytes(kFnvOffset, data.data(), data.size());
+  if (fileHashes != nullptr) {
+    (*fileHashes)[file] = hash;
+  }
+  return true;
+}
+
+// Resolve the percent escapes of a glTF URI
+std::string decodeUri(const std::string& uri) {
+  std::string decoded;
+  for (size_t i = 0; i < uri.size(); ++i) {
+    if (uri[i] == '%' && i + 2 < uri.size() &&
+        std::isxdigit(static_cast<unsigned char>(uri[i + 1])) &&
+        std::isxdigit(static_cast<unsigned char>(uri[i + 2]))) {
+      decoded += char(std::strtol(uri.substr(i + 1, 2).c_str(), nullptr, 16));
+      i += 2;
+    } else {
+      decoded += uri[i];
+    }
+  }
+  return decoded;
+}
+
+// The file the encoded bytes of an image are stored in, and where in it if
+// the file holds other data as well
+struct ImageSource {
+  std::string file;
+  std::vector<uint64_t> location;
+};
+
+// Find image imageId of the asset file filename. Images of .gltf files may
+// be stored in a file of their own or in an external buffer; in all other
+// cases the image is somewhere in filename, at its index.
+ImageSource findImage(const std::string& filename, unsigned int imageId) {
+  const ImageSource inAsset{filename, {imageId}};
+  if (!Cr::Utility::String::endsWith(filename, ".gltf")) {
+    return inAsset;
+  }
+  io::JsonDocument gltf;
+  gltf.Parse(Cr::Utility::Directory::readString(filename).c_str());
+  if (gltf.HasParseError() || !gltf.IsObject() || !gltf.HasMember("images") ||
+      !gltf["images"].IsArray() || imageId >= gltf["images"].Size()) {
+    return inAsset;
+  }
+  const std::string path = Cr::Utility::Directory::path(filename);
+  auto isFile = [](const rapidjson::Value& value) {
+    return value.IsObject() && value.HasMember("uri") &&
+           value["uri"].IsString() &&
+           !Cr::Utility::String::beginsWith(value["uri"].GetString(), "data:");
+  };
+  auto getFile = [&](const rapidjson::Value& value) {
+    return Cr::Utility::Directory::join(path,
+                                        decodeUri(value["uri"].GetString()));
+  };
+
+  const rapidjson::Value& image = gltf["images"][imageId];
+  if (isFile(image)) {
+    return {getFile(image), {}};
+  }
+  // a view into a buffer, which may be a file of its own
+  if (!image.IsObject() || !image.HasMember("bufferView") ||
+      !image["bufferView"].IsUint() || !gltf.HasMember("bufferViews") ||
+      !gltf["bufferViews"].IsArray() || !gltf.HasMember("buffers") ||
+      !gltf["buffers"].IsArray()) {
+    return inAsset;
+  }
+  const rapidjson::Value& views = gltf["bufferViews"];
+  const unsigned int viewId = image["bufferView"].GetUint();
+  if (viewId >= views.Size() || !views[viewId].IsObject() ||
+      !views[viewId].HasMember("buffer") ||
+      !views[viewId]["buffer"].IsUint() ||
+      views[viewId]["buffer"].GetUint() >= gltf["buffers"].Size()) {
+    return inAsset;
+  }
+  const rapidjson::Value& view = views[viewId];
+  const rapidjson::Value& buffer = gltf["buffers"][view["buffer"].GetUint()];
+  if (!isFile(buffer)) {
+    return inAsset;
+  }
+  auto getUint = [&](const char* name) -> uint64_t {
+    return view.HasMember(name) && view[name].IsUint64()
+               ? view[name].GetUint64()
+               : 0;
+  };
+  return {getFile(buffer), {getUint("byteOffset"), getUint("byteLength")}};
+}
+}  // namespace
+
+TextureCache::TextureCache(const std::string& directory)
+    : directory_(directory) {
+  if (!Cr::Utility::Directory::mkpath(directory_)) {
+    LOG(WARNING) << "Cannot create texture cache directory " << directory_;
+  }
+}
+
+bool TextureCache::key(const std::string& filename,
+                       unsigned int imageId,
+                       uint64_t& key,
+                       FileHashes* fileHashes /* = nullptr */) {
+  // An image file of its own gets the same key in every asset referencing
+  // it. Any other image gets a new key whenever anything in the file holding
+  // it changes.
+  const ImageSource source = findImage(filename, imageId);
+  if (!hashFile(source.file, key, fileHashes)) {
+    return false;
+  }
+  key = hashBytes(key, reinterpret_cast<const char*>(source.location.data()),
+                  source.location.size() * sizeof(uint64_t));
+  return true;
+}
+
+std::string TextureCache::filename(uint64_t key) const {
+  char name[32];
+  std::snprintf(name, sizeof(name), "%016llx.tex",
+                static_cast<unsigned long long>(key));
+  return Cr::Utility::Directory::join(directory_, name);
+}
+
+#ifndef MAGNUM_TARGET_GLES
+
+bool TextureCache::load(uint64_t key,
+                        Magnum::GL::Texture2D& texture,
+                        Magnum::Vector2i& size) const {
+  const std::string file = filename(key);
+  if (!Cr::Utility::Directory::exists(file)) {
+    return false;
+  }
+  const Cr::Containers::Array<const char, Cr::Utility::Directory::MapDeleter>
+      data = Cr::Utility::Directory::mapRead(file);
+  if (data.size() < sizeof(CacheHeader)) {
+    LOG(WARNING) << "Ignoring truncated texture cache file " << file;
+    return false;
+  }
+
+  CacheHeader header;
+  std::memcpy(&header, data.data(), sizeof(header));
+  const size_t levelTableSize = header.numLevels * sizeof(uint64_t);
+  if (header.magic != kTextureCacheMagic ||
+      header.version != kTextureCacheVersion || header.numLevels == 0 ||
+      header.width <= 0 || header.height <= 0 ||
+      data.size() < sizeof(header) + levelTableSize) {
+    LOG(WARNING) << "Ignoring outdated texture cache file " << file;
+    return false;
+  }
+  std::vector<uint64_t> levelSizes(header.numLevels);
+  std::memcpy(levelSizes.data(), data.data() + sizeof(header),
+              levelTableSize);
+  uint64_t totalSize = sizeof(header) + levelTableSize;
+  for (uint64_t levelSize : levelSizes) {
+    totalSize += levelSize;
+  }
+  if (totalSize != data.size()) {
+    LOG(WARNING) << "Ignoring truncated texture cache file " << file;
+    return false;
+  }
+
+  // the format was chosen from the decoded image when the entry was stored
+  const auto format = Magnum::GL::TextureFormat(header.format);
+  size = {header.width, header.height};
+  texture.setStorage(header.numLevels, format, size);
+  const char* levelData = data.data() + sizeof(header) + levelTableSize;
+  for (int level = 0; level < int(header.numLevels); ++level) {
+    texture.setCompressedSubImage(
+        level, {},
+        Magnum::CompressedImageView2D{
+            Magnum::GL::CompressedPixelFormat(Magnum::UnsignedInt(format)),
+            levelSize(size, level),
+            {levelData, std::size_t(levelSizes[level])}});
+    levelData += levelSizes[level];
+  }
+  return true;
+}
+
+bool TextureCache::store(uint64_t key,
+                         Magnum::GL::TextureFormat format,
+                         Magnum::GL::Texture2D& texture) const {
+  const Magnum::Vector2i size = texture.imageSize(0);
+  const int numLevels = Magnum::Math::log2(size.max()) + 1;
+
+  std::vector<Magnum::CompressedImage2D> levels;
+  levels.reserve(numLevels);
+  for (int level = 0; level < numLevels; ++level) {
+    levels.emplace_back(texture.compressedImage(level, {}));
+  }
+
+  const CacheHeader header{kTextureCacheMagic, kTextureCacheVersion,
+                           uint32_t(format), uint32_t(numLevels), size.x(),
+                           size.y()};
+  std::vector<uint64_t> levelSizes;
+  for (const Magnum::CompressedImage2D& image : levels) {
+    levelSizes.push_back(image.data().size());
+  }
+
+  // write to a temporary file first so that concurrent loads never see a
+  // partially written entry
+  const std::string file = filename(key);
+  const std::string tmpFile = file + "." + std::to_string(getpid()) + ".tmp";
+  {
+    std::ofstream out(tmpFile, std::ios::binary | std::ios::trunc);
+    out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    out.write(reinterpret_cast<const char*>(levelSizes.data()),
+              levelSizes.size() * sizeof(uint64_t));
+    for (const Magnum::CompressedImage2D& image : levels) {
+      out.write(image.data().data(), image.data().size());
+    }
+    if (!out.good()) {
+      LOG(WARNING) << "Cannot write texture cache file " << tmpFile;
+      std::remove(tmpFile.c_str());
+      return false;
+    }
+  }
+  if (std::rename(tmpFile.c_str(), file.c_str()) != 0) {
+    LOG(WARNING) << "Cannot write texture cache file " << file;
+    std::remove(tmpFile.c_str());
+    return false;
+  }
+  return true;
+}
+
+#else  // MAGNUM_TARGET_GLES
+
+bool TextureCache::load(uint64_t,
+                        Magnum::GL::Texture2D&,
+                        Magnum::Vector2i&) const {
+  return false;
+}
+
+bool TextureCache::store(uint64_t,
+                         Magnum::GL::TextureFormat,
+                         Magnum::GL::Texture2D&) const {
+  return false;
+}
+
+#endif
+
+}  // namespace assets
+}  // namespace esp
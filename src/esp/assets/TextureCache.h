@@ -0,0 +1,82 @@
+// Copyright (c) Facebook, Inc. and its affiliates.
+// This source code is licensed under the MIT license found in the
+// LICENSE file in the root directory of this source tree.
+
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+
+#include <Magnum/GL/GL.h>
+#include <Magnum/Magnum.h>
+
+#include "esp/core/esp.h"
+
+namespace esp {
+namespace assets {
+
+/**
+ * @brief On-disk cache of GPU-compressed texture mip chains.
+ *
+ * Compressing a texture on upload is expensive and was repeated at every
+ * scene load in every process. The driver-compressed mip chain of a texture
+ * is instead read back once and stored in directory, keyed by the contents
+ * of the file the encoded image is stored in: the image file referenced by a
+ * glTF file, or else the asset file itself together with the index of the
+ * image in it. The key is known before the image is decoded, so later loads
+ * skip decoding as well: they map the cache file and upload the stored blocks
+ * as they are.
+ *
+ * Compressed image readback needs desktop OpenGL; on OpenGL ES and WebGL
+ * @ref load() always misses and @ref store() does nothing.
+ */
+class TextureCache {
+ public:
+  //! Cache files are kept in directory, which is created if needed
+  explicit TextureCache(const std::string& directory);
+
+  //! Hashes of the files read by key(), by path
+  typedef std::unordered_map<std::string, uint64_t> FileHashes;
+
+  /**
+   * @brief Compute the key of image imageId of the asset file filename
+   *
+   * Returns false if the file holding the image cannot be read. Files are
+   * hashed once per fileHashes, if given, so it should only be kept while
+   * the files cannot change, e.g. while loading one asset.
+   */
+  static bool key(const std::string& filename,
+                  unsigned int imageId,
+                  uint64_t& key,
+                  FileHashes* fileHashes = nullptr);
+
+  /**
+   * @brief Allocate storage of texture and upload the cached mip chain of key
+   * to it, setting size to the size of its first level. Returns false without
+   * touching texture if there is no valid cache entry.
+   */
+  bool load(uint64_t key,
+            Magnum::GL::Texture2D& texture,
+            Magnum::Vector2i& size) const;
+
+  /**
+   * @brief Read back all mip levels of texture, which has to have compressed
+   * format, and store them under key.
+   */
+  bool store(uint64_t key,
+             Magnum::GL::TextureFormat format,
+             Magnum::GL::Texture2D& texture) const;
+
+  const std::string& directory() const { return directory_; }
+
+ protected:
+  std::string filename(uint64_t key) const;
+
+  std::string directory_;
+
+  ESP_SMART_POINTERS(TextureCache)
+};
+
+}  // namespace assets
+}  // namespace esp
@@ -20,7 +20,11 @@ using namespace py::literals;
 #include "esp/scene/SceneNode.h"
 #include "esp/scene/SemanticScene.h"
 #include "esp/scene/SuncgSemanticScene.h"
+#include "esp/sensor/DerivedCamera.h"
+#include "esp/sensor/MultiviewCamera.h"
+#include "esp/sensor/PanoramicCamera.h"
 #include "esp/sensor/PinholeCamera.h"
+#include "esp/sensor/RaycastCamera.h"
 #include "esp/sensor/Sensor.h"
 
 #include <Magnum/SceneGraph/Python.h>
@@ -36,6 +40,7 @@ using namespace esp::physics;
 
 void initShortestPathBindings(py::module& m);
 void initGeoBindings(py::module& m);
+void initCoreBindings(py::module& m);
 
 namespace {
 template <class T>
@@ -44,10 +49,25 @@ SceneNode* nodeGetter(T& self) {
     throw py::value_error{"feature not valid"};
   return &self.node();
 };
+
+// the readFrame* functions write a whole framebuffer, img must hold exactly
+// that many pixels of the given number of channels
+template <class T>
+void checkFrameSize(Renderer& renderer, const T& img, int channels) {
+  const vec3i size = renderer.getSize();
+  if (img.rows() != size[1] || img.cols() != size[0] * channels) {
+    throw py::value_error{"img has shape (" + std::to_string(img.rows()) +
+                          ", " + std::to_string(img.cols()) +
+                          ") but the framebuffer needs (" +
+                          std::to_string(size[1]) + ", " +
+                          std::to_string(size[0] * channels) + ")"};
+  }
+}
 }  // namespace
 
 PYBIND11_MODULE(habitat_sim_bindings, m) {
   initGeoBindings(m);
+  initCoreBindings(m);
 
   py::bind_map<std::map<std::string, std::string>>(m, "MapStringString");
 
@@ -98,6 +118,17 @@ PYBIND11_MODULE(habitat_sim_bindings, m) {
       .def_property_readonly("absolute_translation",
                              &SceneNode::absoluteTranslation);
 
+  // ==== RenderQueueStats ====
+  py::class_<RenderQueueStats>(m, "RenderQueueStats")
+      .def_readonly("draw_calls", &RenderQueueStats::drawCalls)
+      .def_readonly("instanced_draw_calls",
+                    &RenderQueueStats::instancedDrawCalls)
+      .def_readonly("shader_transitions",
+                    &RenderQueueStats::shaderTransitions)
+      .def_readonly("texture_transitions",
+                    &RenderQueueStats::textureTransitions)
+      .def_readonly("mesh_transitions", &RenderQueueStats::meshTransitions);
+
   // ==== RenderCamera ====
   py::class_<RenderCamera, Magnum::SceneGraph::PyFeature<RenderCamera>,
              Magnum::SceneGraph::AbstractFeature3D,
@@ -117,6 +148,11 @@ PYBIND11_MODULE(habitat_sim_bindings, m) {
       .def("getCameraMatrix", &RenderCamera::getCameraMatrix, R"(
         Get this :py:class:`Camera`'s camera matrix.
       )")
+      .def_property_readonly("render_stats", &RenderCamera::getRenderStats,
+                             R"(
+        Draw calls of the last frame drawn with this :py:class:`Camera`, and
+        how often consecutive ones differ in shader, texture or mesh.
+      )")
       .def_property_readonly("node", nodeGetter<RenderCamera>,
                              "Node this object is attached to")
       .def_property_readonly("object", nodeGetter<RenderCamera>,
@@ -268,6 +304,12 @@ PYBIND11_MODULE(habitat_sim_bindings, m) {
       .def_property_readonly("obb", &SuncgSemanticObject::obb)
       .def_property_readonly("category", &SuncgSemanticObject::category);
 
+  // ==== enum SemanticRemap ====
+  py::enum_<SemanticRemap>(m, "SemanticRemap")
+      .value("SEGMENT_TO_OBJECT", SemanticRemap::SEGMENT_TO_OBJECT)
+      .value("SEGMENT_TO_CATEGORY", SemanticRemap::SEGMENT_TO_CATEGORY)
+      .value("OBJECT_TO_CATEGORY", SemanticRemap::OBJECT_TO_CATEGORY);
+
   // ==== SemanticScene ====
   py::class_<SemanticScene, SemanticScene::ptr>(m, "SemanticScene")
       .def(py::init(&SemanticScene::create<>))
@@ -292,7 +334,21 @@ PYBIND11_MODULE(habitat_sim_bindings, m) {
       .def_property_readonly("semantic_index_map",
                              &SemanticScene::getSemanticIndexMap)
       .def("semantic_index_to_object_index",
-           &SemanticScene::semanticIndexToObjectIndex);
+           &SemanticScene::semanticIndexToObjectIndex)
+      .def(
+          "remap",
+          [](SemanticScene& self,
+             Eigen::Ref<Eigen::Matrix<uint32_t, Eigen::Dynamic, Eigen::Dynamic,
+                                      Eigen::RowMajor>>& ids,
+             SemanticRemap mapping) {
+            self.remap(ids.data(), ids.data(), ids.size(), mapping);
+          },
+          py::arg("ids").noconvert(), "mapping"_a,
+          py::call_guard<py::gil_scoped_release>(),
+          R"(
+      Converts ids, e.g. a semantic observation, in place as given by mapping
+      using lookup tables built when the house was loaded. Ids that are not
+      mapped become 0xffffffff.)");
 
   // ==== ObjectControls ====
   py::class_<ObjectControls, ObjectControls::ptr>(m, "ObjectControls")
@@ -302,8 +358,37 @@ PYBIND11_MODULE(habitat_sim_bindings, m) {
       )",
            "object"_a, "name"_a, "amount"_a, "apply_filter"_a = true);
 
+  // ==== ProfilerStats ====
+  py::class_<core::ProfilerStats>(m, "ProfilerStats")
+      .def_readonly("count", &core::ProfilerStats::count)
+      .def_readonly("mean", &core::ProfilerStats::mean)
+      .def_readonly("p50", &core::ProfilerStats::p50)
+      .def_readonly("p99", &core::ProfilerStats::p99);
+
+  // ==== Profiler ====
+  py::class_<core::Profiler, core::Profiler::ptr>(m, "Profiler")
+      .def(py::init(&core::Profiler::create<>))
+      .def_property("enabled", &core::Profiler::isEnabled,
+                    &core::Profiler::setEnabled)
+      .def_static("now", &core::Profiler::now,
+                  R"(Current time in nanoseconds on the profiler clock)")
+      .def("record", &core::Profiler::record,
+           R"(Record a sample of a section, e.g. timed in Python)", "name"_a,
+           "start_ns"_a, "duration_ns"_a, "track"_a = "cpu")
+      .def("stats", &core::Profiler::stats,
+           R"(Count, mean, p50 and p99 in milliseconds of a section)",
+           "name"_a)
+      .def("section_names", &core::Profiler::sectionNames)
+      .def("reset", &core::Profiler::reset)
+      .def("write_chrome_trace", &core::Profiler::writeChromeTrace,
+           R"(Write the kept samples as a Chrome trace event JSON file)",
+           "filename"_a);
+
   // ==== Renderer ====
   py::class_<Renderer, Renderer::ptr>(m, "Renderer")
+      .def_property_readonly("profiler", &Renderer::getProfiler,
+                             py::return_value_policy::reference_internal,
+                             R"(Draw, GPU and readback timings per sensor)")
       .def(py::init(&Renderer::create<int, int>))
       .def("set_size", &Renderer::setSize, R"(Set the size of the canvas)",
            "width"_a, "height"_a)
@@ -312,6 +397,7 @@ PYBIND11_MODULE(habitat_sim_bindings, m) {
           [](Renderer& self,
              Eigen::Ref<Eigen::Matrix<uint8_t, Eigen::Dynamic, Eigen::Dynamic,
                                       Eigen::RowMajor>>& img) {
+            checkFrameSize(self, img, 4);
             self.readFrameRgba(img.data());
           },
           py::arg("img").noconvert(),
@@ -339,14 +425,40 @@ PYBIND11_MODULE(habitat_sim_bindings, m) {
           [](Renderer& self,
              Eigen::Ref<Eigen::Matrix<float, Eigen::Dynamic, Eigen::Dynamic,
                                       Eigen::RowMajor>>& img) {
+            checkFrameSize(self, img, 1);
             self.readFrameDepth(img.data());
           },
           py::arg("img").noconvert(), R"()")
+      .def(
+          "readFrameRgb",
+          [](Renderer& self,
+             Eigen::Ref<Eigen::Matrix<uint8_t, Eigen::Dynamic, Eigen::Dynamic,
+                                      Eigen::RowMajor>>& img) {
+            checkFrameSize(self, img, 3);
+            self.readFrameRgb(img.data());
+          },
+          py::arg("img").noconvert(),
+          R"(
+      Reads RGB frame without alpha into passed img, with ``m = height`` and
+      ``n = width * 3``.)")
+      .def(
+          "readFrameDepthHalf",
+          [](Renderer& self,
+             Eigen::Ref<Eigen::Matrix<uint16_t, Eigen::Dynamic, Eigen::Dynamic,
+                                      Eigen::RowMajor>>& img) {
+            checkFrameSize(self, img, 1);
+            self.readFrameDepthHalf(img.data());
+          },
+          py::arg("img").noconvert(),
+          R"(
+      Reads depth as half floats into passed img, a uint16 view of a float16
+      array.)")
       .def(
           "readFrameObjectId",
           [](Renderer& self,
              Eigen::Ref<Eigen::Matrix<uint32_t, Eigen::Dynamic, Eigen::Dynamic,
                                       Eigen::RowMajor>>& img) {
+            checkFrameSize(self, img, 1);
             self.readFrameObjectId(img.data());
           },
           py::arg("img").noconvert(), R"()");
@@ -366,6 +478,7 @@ PYBIND11_MODULE(habitat_sim_bindings, m) {
       .def_readwrite("sensor_type", &SensorSpec::sensorType)
       .def_readwrite("sensor_subtype", &SensorSpec::sensorSubtype)
       .def_readwrite("parameters", &SensorSpec::parameters)
+      .def_readwrite("parent_uuid", &SensorSpec::parentUuid)
       .def_readwrite("position", &SensorSpec::position)
       .def_readwrite("orientation", &SensorSpec::orientation)
       .def_readwrite("resolution", &SensorSpec::resolution)
@@ -384,6 +497,11 @@ PYBIND11_MODULE(habitat_sim_bindings, m) {
   // ==== Observation ====
   py::class_<Observation, Observation::ptr>(m, "Observation");
 
+  // ==== ObservationSpace ====
+  py::class_<ObservationSpace, ObservationSpace::ptr>(m, "ObservationSpace")
+      .def_readonly("data_type", &ObservationSpace::dataType)
+      .def_readonly("shape", &ObservationSpace::shape);
+
   // ==== Sensor ====
   sensor
       .def(py::init_alias<std::reference_wrapper<scene::SceneNode>,
@@ -392,6 +510,74 @@ PYBIND11_MODULE(habitat_sim_bindings, m) {
       .def("set_transformation_from_spec", &Sensor::setTransformationFromSpec)
       .def("is_visual_sensor", &Sensor::isVisualSensor)
       .def("get_observation", &Sensor::getObservation)
+      .def(
+          "apply_noise",
+          [](Sensor& self,
+             Eigen::Ref<Eigen::Matrix<uint8_t, Eigen::Dynamic, Eigen::Dynamic,
+                                      Eigen::RowMajor>>& img) {
+            // the encoding decides between RGBA and RGB, which the spec's
+            // channels do not reflect
+            ObservationSpace space;
+            self.getObservationSpace(space);
+            const size_t channels =
+                space.shape.size() > 2 ? space.shape.back() : 1;
+            if (size_t(img.cols()) % channels != 0) {
+              throw py::value_error{
+                  "img has to hold whole pixels of the observation space"};
+            }
+            core::Buffer buffer{{size_t(img.rows()), img.cols() / channels,
+                                 channels},
+                                core::DataType::DT_UINT8,
+                                img.data()};
+            py::gil_scoped_release release;
+            self.applyNoise(buffer);
+          },
+          py::arg("img").noconvert(),
+          R"(
+      Apply the noise model of the sensor, if any, in place to a color
+      observation laid out like Renderer.readFrameRgba, or like
+      Renderer.readFrameRgb for the rgb_uint8 encoding.)")
+      .def(
+          "apply_noise",
+          [](Sensor& self,
+             Eigen::Ref<Eigen::Matrix<float, Eigen::Dynamic, Eigen::Dynamic,
+                                      Eigen::RowMajor>>& img) {
+            core::Buffer buffer{{size_t(img.rows()), size_t(img.cols())},
+                                core::DataType::DT_FLOAT,
+                                img.data()};
+            py::gil_scoped_release release;
+            self.applyNoise(buffer);
+          },
+          py::arg("img").noconvert(),
+          R"(
+      Apply the noise model of the sensor, if any, in place to a depth
+      observation.)")
+      .def(
+          "apply_noise",
+          [](Sensor& self,
+             Eigen::Ref<Eigen::Matrix<uint16_t, Eigen::Dynamic, Eigen::Dynamic,
+                                      Eigen::RowMajor>>& img) {
+            core::Buffer buffer{{size_t(img.rows()), size_t(img.cols())},
+                                core::DataType::DT_FLOAT16,
+                                img.data()};
+            py::gil_scoped_release release;
+            self.applyNoise(buffer);
+          },
+          py::arg("img").noconvert(),
+          R"(
+      Apply the noise model of the sensor, if any, in place to a half float
+      depth observation, passed as a uint16 view.)")
+      .def(
+          "get_observation_space",
+          [](Sensor& self) {
+            ObservationSpace space;
+            self.getObservationSpace(space);
+            return space;
+          },
+          R"(Shape and data type of the observations of the sensor)")
+      .def_property_readonly(
+          "has_noise_model",
+          [](Sensor& self) { return self.getNoiseModel() != nullptr; })
       .def_property_readonly("node", nodeGetter<Sensor>,
                              "Node this object is attached to")
       .def_property_readonly("object", nodeGetter<Sensor>, "Alias to node");
@@ -407,7 +593,186 @@ PYBIND11_MODULE(habitat_sim_bindings, m) {
                           const sensor::SensorSpec::ptr&>())
       .def("set_projection_matrix", &sensor::PinholeCamera::setProjectionMatrix,
            R"(Set the width, height, near, far, and hfov,
-          stored in pinhole camera to the render camera.)");
+          stored in pinhole camera to the render camera.)")
+      .def(
+          "remap_semantic_observation",
+          [](PinholeCamera& self, Simulator& sim,
+             Eigen::Ref<Eigen::Matrix<uint32_t, Eigen::Dynamic, Eigen::Dynamic,
+                                      Eigen::RowMajor>>& img) {
+            if (self.specification()->sensorType != SensorType::SEMANTIC) {
+              throw py::type_error{"remapping needs a semantic sensor"};
+            }
+            py::gil_scoped_release release;
+            self.remapSemanticObservation(sim, img.data(), img.size());
+          },
+          "sim"_a, py::arg("img").noconvert(),
+          R"(
+      Converts the object ids of passed img, a semantic observation, in place
+      to category ids if the sensor has the "semantic_remap": "category" spec
+      parameter, using the semantic scene of sim.)");
+
+  // ==== MultiviewCamera (subclass of PinholeCamera) ====
+  py::class_<sensor::MultiviewCamera,
+             Magnum::SceneGraph::PyFeature<sensor::MultiviewCamera>,
+             sensor::PinholeCamera,
+             Magnum::SceneGraph::PyFeatureHolder<MultiviewCamera>>(
+      m, "MultiviewCamera")
+      .def(py::init_alias<std::reference_wrapper<scene::SceneNode>,
+                          const sensor::SensorSpec::ptr&>())
+      .def_property_readonly("num_views", &MultiviewCamera::getNumViews)
+      .def(
+          "render",
+          [](MultiviewCamera& self, Renderer& renderer,
+             scene::SceneGraph& scene, py::array img) {
+            if (!(img.flags() & py::array::c_style) || !img.writeable() ||
+                size_t(img.nbytes()) != self.getFrameBytes()) {
+              throw py::value_error{
+                  "img has to be a writeable contiguous array of the size of "
+                  "all views"};
+            }
+            self.render(renderer, scene, img.mutable_data());
+          },
+          "renderer"_a, "scene"_a, "img"_a,
+          R"(
+      Renders all views of scene into passed img in one pass. The views are
+      stored one after the other, each laid out like the Renderer.readFrame*
+      output of the observation type.)");
+
+  // ==== DerivedCamera (subclass of Sensor) ====
+  py::class_<sensor::DerivedCamera,
+             Magnum::SceneGraph::PyFeature<sensor::DerivedCamera>, Sensor,
+             Magnum::SceneGraph::PyFeatureHolder<DerivedCamera>>(
+      m, "DerivedCamera")
+      .def(py::init_alias<std::reference_wrapper<scene::SceneNode>,
+                          const sensor::SensorSpec::ptr&, const Sensor::ptr&>())
+      .def_property_readonly("parent", &DerivedCamera::getParent)
+      .def(
+          "derive",
+          [](DerivedCamera& self, py::array parent, py::array out) {
+            ObservationSpace parentSpace, space;
+            self.getParent()->getObservationSpace(parentSpace);
+            self.getObservationSpace(space);
+            // depth and object ids have a single channel per pixel
+            const size_t channels =
+                self.specification()->sensorType == SensorType::COLOR
+                    ? space.shape[2]
+                    : 1;
+            const size_t pixelSize =
+                channels * core::getDataTypeByteSize(space.dataType);
+            if (!(parent.flags() & py::array::c_style) ||
+                !(out.flags() & py::array::c_style) || !out.writeable() ||
+                size_t(parent.nbytes()) !=
+                    parentSpace.shape[0] * parentSpace.shape[1] * pixelSize ||
+                size_t(out.nbytes()) !=
+                    space.shape[0] * space.shape[1] * pixelSize) {
+              throw py::value_error{
+                  "parent and out have to be contiguous observations of the "
+                  "parent and the derived sensor"};
+            }
+            core::Buffer parentBuffer{
+                {parentSpace.shape[0], parentSpace.shape[1], channels},
+                space.dataType,
+                const_cast<void*>(parent.data())};
+            core::Buffer outBuffer{{space.shape[0], space.shape[1], channels},
+                                   space.dataType,
+                                   out.mutable_data()};
+            py::gil_scoped_release release;
+            self.derive(parentBuffer, outBuffer);
+            self.applyNoise(outBuffer);
+          },
+          "parent"_a, "out"_a,
+          R"(
+      Downsamples parent, an observation of the parent sensor, into out and
+      applies the noise model of the sensor, if any.)");
+
+  // ==== PanoramicCamera (subclass of PinholeCamera) ====
+  py::class_<sensor::PanoramicCamera,
+             Magnum::SceneGraph::PyFeature<sensor::PanoramicCamera>,
+             sensor::PinholeCamera,
+             Magnum::SceneGraph::PyFeatureHolder<PanoramicCamera>>(
+      m, "PanoramicCamera")
+      .def(py::init_alias<std::reference_wrapper<scene::SceneNode>,
+                          const sensor::SensorSpec::ptr&>())
+      .def(
+          "render",
+          [](PanoramicCamera& self, scene::SceneGraph& scene,
+             Eigen::Ref<Eigen::Matrix<uint8_t, Eigen::Dynamic, Eigen::Dynamic,
+                                      Eigen::RowMajor>>& img) {
+            if (self.specification()->sensorType == SensorType::DEPTH ||
+                self.specification()->sensorType == SensorType::SEMANTIC) {
+              throw py::type_error{"uint8 output needs a color sensor"};
+            }
+            self.render(scene, img.data());
+          },
+          "scene"_a, py::arg("img").noconvert(),
+          R"(
+      Renders the panorama of scene into passed img, with the same layout as
+      Renderer.readFrameRgba.)")
+      .def(
+          "render",
+          [](PanoramicCamera& self, scene::SceneGraph& scene,
+             Eigen::Ref<Eigen::Matrix<float, Eigen::Dynamic, Eigen::Dynamic,
+                                      Eigen::RowMajor>>& img) {
+            if (self.specification()->sensorType != SensorType::DEPTH) {
+              throw py::type_error{"float32 output needs a depth sensor"};
+            }
+            self.render(scene, img.data());
+          },
+          "scene"_a, py::arg("img").noconvert(),
+          R"(
+      Renders the distance along each ray of the panorama of scene into
+      passed img, with the same layout as Renderer.readFrameDepth.)")
+      .def(
+          "render",
+          [](PanoramicCamera& self, scene::SceneGraph& scene,
+             Eigen::Ref<Eigen::Matrix<uint32_t, Eigen::Dynamic, Eigen::Dynamic,
+                                      Eigen::RowMajor>>& img) {
+            if (self.specification()->sensorType != SensorType::SEMANTIC) {
+              throw py::type_error{"uint32 output needs a semantic sensor"};
+            }
+            self.render(scene, img.data());
+          },
+          "scene"_a, py::arg("img").noconvert(),
+          R"(
+      Renders the panorama of scene into passed img, with the same layout as
+      Renderer.readFrameObjectId.)");
+
+  // ==== RaycastCamera (subclass of PinholeCamera) ====
+  py::class_<sensor::RaycastCamera,
+             Magnum::SceneGraph::PyFeature<sensor::RaycastCamera>,
+             sensor::PinholeCamera,
+             Magnum::SceneGraph::PyFeatureHolder<RaycastCamera>>(
+      m, "RaycastCamera")
+      .def(py::init_alias<std::reference_wrapper<scene::SceneNode>,
+                          const sensor::SensorSpec::ptr&>())
+      .def(
+          "raycast",
+          [](RaycastCamera& self, Simulator& sim,
+             Eigen::Ref<Eigen::Matrix<float, Eigen::Dynamic, Eigen::Dynamic,
+                                      Eigen::RowMajor>>& img) {
+            if (self.specification()->sensorType != SensorType::DEPTH) {
+              throw py::type_error{"float32 output needs a depth sensor"};
+            }
+            self.raycast(sim, img.data());
+          },
+          "sim"_a, py::arg("img").noconvert(),
+          R"(
+      Ray casts the scene of sim into passed img, with the same layout as
+      Renderer.readFrameDepth.)")
+      .def(
+          "raycast",
+          [](RaycastCamera& self, Simulator& sim,
+             Eigen::Ref<Eigen::Matrix<uint32_t, Eigen::Dynamic, Eigen::Dynamic,
+                                      Eigen::RowMajor>>& img) {
+            if (self.specification()->sensorType != SensorType::SEMANTIC) {
+              throw py::type_error{"uint32 output needs a semantic sensor"};
+            }
+            self.raycast(sim, img.data());
+          },
+          "sim"_a, py::arg("img").noconvert(),
+          R"(
+      Ray casts the scene of sim into passed img, with the same layout as
+      Renderer.readFrameObjectId.)");
 
   // ==== SensorSuite ====
   py::class_<SensorSuite, SensorSuite::ptr>(m, "SensorSuite")
@@ -443,10 +808,22 @@ PYBIND11_MODULE(habitat_sim_bindings, m) {
       .def_readwrite("default_camera_uuid",
                      &SimulatorConfiguration::defaultCameraUuid)
       .def_readwrite("gpu_device_id", &SimulatorConfiguration::gpuDeviceId)
+      .def_readwrite("software_rendering",
+                     &SimulatorConfiguration::softwareRendering)
+      .def_readwrite("num_render_threads",
+                     &SimulatorConfiguration::numRenderThreads)
       .def_readwrite("width", &SimulatorConfiguration::width)
       .def_readwrite("height", &SimulatorConfiguration::height)
       .def_readwrite("compress_textures",
                      &SimulatorConfiguration::compressTextures)
+      .def_readwrite("texture_cache_dir",
+                     &SimulatorConfiguration::textureCacheDir)
+      .def_readwrite("scene_cache_dir", &SimulatorConfiguration::sceneCacheDir)
+      .def_readwrite("share_mesh_memory",
+                     &SimulatorConfiguration::shareMeshMemory)
+      .def_readwrite("mesh_lod_levels", &SimulatorConfiguration::meshLodLevels)
+      .def_readwrite("asset_memory_budget",
+                     &SimulatorConfiguration::assetMemoryBudget)
       .def_readwrite("create_renderer", &SimulatorConfiguration::createRenderer)
       .def_readwrite("enable_physics", &SimulatorConfiguration::enablePhysics)
       .def("__eq__",
@@ -463,6 +840,18 @@ PYBIND11_MODULE(habitat_sim_bindings, m) {
   initShortestPathBindings(m);
 
   // ==== Simulator ====
+  py::class_<std::shared_future<bool>>(m, "PrefetchFuture")
+      .def("ready",
+           [](const std::shared_future<bool>& self) {
+             return self.wait_for(std::chrono::seconds(0)) ==
+                    std::future_status::ready;
+           },
+           R"(Whether the scene is loaded in the background.)")
+      .def("wait", &std::shared_future<bool>::get,
+           R"(Wait for the scene to be loaded in the background, returns
+           whether it loaded successfully.)",
+           py::call_guard<py::gil_scoped_release>());
+
   py::class_<Simulator, Simulator::ptr>(m, "Simulator")
       .def(py::init(&Simulator::create<const SimulatorConfiguration&>))
       .def("get_active_scene_graph", &Simulator::getActiveSceneGraph,
@@ -476,6 +865,9 @@ PYBIND11_MODULE(habitat_sim_bindings, m) {
       .def_property_readonly("renderer", &Simulator::getRenderer)
       .def("seed", &Simulator::seed, R"()", "new_seed"_a)
       .def("reconfigure", &Simulator::reconfigure, R"()", "configuration"_a)
+      .def("prefetch_scene", &Simulator::prefetchScene,
+           R"(Start loading a scene in the background, see PrefetchFuture.)",
+           "scene_config"_a)
       .def("reset", &Simulator::reset, R"()")
       /* --- Physics functions --- */
       .def("add_object", &Simulator::addObject, "R()", "object_lib_index"_a,
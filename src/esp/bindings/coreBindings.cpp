@@ -0,0 +1,148 @@
+// Copyright (c) Facebook, Inc. and its affiliates.
+// This source code is licensed under the MIT license found in the
+// LICENSE file in the root directory of this source tree.
+
+#include "esp/bindings/OpaqueTypes.h"
+
+#include <pybind11/numpy.h>
+
+namespace py = pybind11;
+using namespace py::literals;
+
+#include "esp/core/Buffer.h"
+#include "esp/core/ObservationRingBuffer.h"
+
+using namespace esp::core;
+
+namespace {
+py::dtype toNumpyDtype(DataType dataType) {
+  switch (dataType) {
+    case DataType::DT_INT8:
+      return py::dtype::of<int8_t>();
+    case DataType::DT_UINT8:
+      return py::dtype::of<uint8_t>();
+    case DataType::DT_INT16:
+      return py::dtype::of<int16_t>();
+    case DataType::DT_UINT16:
+      return py::dtype::of<uint16_t>();
+    case DataType::DT_INT32:
+      return py::dtype::of<int32_t>();
+    case DataType::DT_UINT32:
+      return py::dtype::of<uint32_t>();
+    case DataType::DT_INT64:
+      return py::dtype::of<int64_t>();
+    case DataType::DT_UINT64:
+      return py::dtype::of<uint64_t>();
+    case DataType::DT_FLOAT:
+      return py::dtype::of<float>();
+    case DataType::DT_DOUBLE:
+      return py::dtype::of<double>();
+    case DataType::DT_FLOAT16:
+      return py::dtype("float16");
+    default:
+      throw py::value_error{"unsupported data type"};
+  }
+}
+
+// the ring CHECKs slot arguments, which would abort the interpreter
+void checkSlotIndex(const ObservationRingBuffer& ring, int slot) {
+  if (slot < 0 || slot >= ring.numSlots()) {
+    throw py::index_error{"no slot " + std::to_string(slot) + " in the ring"};
+  }
+}
+
+// slots are committed and released in the order they were acquired
+void checkPendingSlot(int slot, int pendingSlot, const std::string& action) {
+  if (pendingSlot == esp::ID_UNDEFINED) {
+    throw py::value_error{"no acquired slot to " + action};
+  }
+  if (slot != pendingSlot) {
+    throw py::value_error{"slot " + std::to_string(pendingSlot) +
+                          " has to be the next to " + action + ", not " +
+                          std::to_string(slot)};
+  }
+}
+}  // namespace
+
+void initCoreBindings(py::module& m) {
+  // ==== enum DataType ====
+  py::enum_<DataType>(m, "DataType")
+      .value("INT8", DataType::DT_INT8)
+      .value("UINT8", DataType::DT_UINT8)
+      .value("INT16", DataType::DT_INT16)
+      .value("UINT16", DataType::DT_UINT16)
+      .value("INT32", DataType::DT_INT32)
+      .value("UINT32", DataType::DT_UINT32)
+      .value("INT64", DataType::DT_INT64)
+      .value("UINT64", DataType::DT_UINT64)
+      .value("FLOAT", DataType::DT_FLOAT)
+      .value("DOUBLE", DataType::DT_DOUBLE)
+      .value("FLOAT16", DataType::DT_FLOAT16);
+
+  // ==== RingBufferField ====
+  py::class_<RingBufferField>(m, "RingBufferField")
+      .def(py::init<>())
+      .def(py::init([](const std::string& name, DataType dataType,
+                       const std::vector<size_t>& shape) {
+             return RingBufferField{name, dataType, shape};
+           }),
+           "name"_a, "data_type"_a, "shape"_a)
+      .def_readwrite("name", &RingBufferField::name)
+      .def_readwrite("data_type", &RingBufferField::dataType)
+      .def_readwrite("shape", &RingBufferField::shape);
+
+  // ==== ObservationRingBuffer ====
+  py::class_<ObservationRingBuffer, ObservationRingBuffer::ptr>(
+      m, "ObservationRingBuffer", R"(
+      Single-producer / single-consumer ring of observation slots in POSIX
+      shared memory. The simulator worker creates it and renders directly into
+      slot fields, the trainer attaches by name and reads them zero-copy.)")
+      .def_static("create", &ObservationRingBuffer::createRing, "name"_a,
+                  "fields"_a, "num_slots"_a)
+      .def_static("attach", &ObservationRingBuffer::attachRing, "name"_a)
+      .def_property_readonly("name", &ObservationRingBuffer::name)
+      .def_property_readonly("num_slots", &ObservationRingBuffer::numSlots)
+      .def_property_readonly("num_ready_slots",
+                             &ObservationRingBuffer::numReadySlots)
+      .def_property_readonly("fields", &ObservationRingBuffer::fields)
+      .def("acquire_write_slot", &ObservationRingBuffer::acquireWriteSlot,
+           R"(Claim the next slot for writing, -1 on timeout.)",
+           "timeout_ms"_a = -1, py::call_guard<py::gil_scoped_release>())
+      .def(
+          "commit_write_slot",
+          [](ObservationRingBuffer& self, int slot) {
+            checkSlotIndex(self, slot);
+            checkPendingSlot(slot, self.pendingWriteSlot(), "commit");
+            self.commitWriteSlot(slot);
+          },
+          "slot"_a)
+      .def("acquire_read_slot", &ObservationRingBuffer::acquireReadSlot,
+           R"(Claim the oldest published slot for reading, -1 on timeout.)",
+           "timeout_ms"_a = -1, py::call_guard<py::gil_scoped_release>())
+      .def(
+          "release_read_slot",
+          [](ObservationRingBuffer& self, int slot) {
+            checkSlotIndex(self, slot);
+            checkPendingSlot(slot, self.pendingReadSlot(), "release");
+            self.releaseReadSlot(slot);
+          },
+          "slot"_a)
+      .def(
+          "field",
+          [](py::object self, int slot, const std::string& fieldName) {
+            auto& ring = self.cast<ObservationRingBuffer&>();
+            checkSlotIndex(ring, slot);
+            const int index = ring.fieldIndex(fieldName);
+            if (index == esp::ID_UNDEFINED) {
+              throw py::key_error{fieldName};
+            }
+            const RingBufferField& field = ring.fields()[index];
+            // the array aliases the shared memory and keeps the ring alive
+            return py::array(toNumpyDtype(field.dataType), field.shape,
+                             ring.slotFieldData(slot, index), self);
+          },
+          R"(
+      Numpy view of a field of the given slot. No data is copied; the view is
+      only valid while the slot is held by the caller.)",
+          "slot"_a, "name"_a);
+}
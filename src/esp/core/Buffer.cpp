@@ -14,6 +14,7 @@ size_t getDataTypeByteSize(DataType dt) {
       return 1;
     case DataType::DT_INT16:
     case DataType::DT_UINT16:
+    case DataType::DT_FLOAT16:
       return 2;
     case DataType::DT_INT32:
     case DataType::DT_UINT32:
@@ -30,6 +31,20 @@ size_t getDataTypeByteSize(DataType dt) {
   }
 }
 
+Buffer::Buffer(const std::vector<size_t> shape,
+               const DataType dataType,
+               void* externalData) {
+  this->shape = shape;
+  this->dataType = dataType;
+  this->ownsData_ = false;
+  this->totalSize = 1;
+  for (size_t i = 0; i < this->shape.size(); i++) {
+    this->totalSize *= this->shape[i];
+  }
+  this->totalBytes = this->totalSize * getDataTypeByteSize(this->dataType);
+  this->data = externalData;
+}
+
 void Buffer::clear() {
   if (this->data != nullptr) {
     memset(this->data, 0, this->totalBytes);
@@ -53,7 +68,10 @@ void Buffer::alloc() {
 
 void Buffer::dealloc() {
   if (this->data != nullptr) {
-    free(this->data);
+    if (this->ownsData_) {
+      free(this->data);
+    }
+    this->ownsData_ = true;
     this->data = nullptr;
     this->totalSize = 0;
     this->totalBytes = 0;
@@ -22,8 +22,13 @@ enum class DataType {
   DT_UINT64 = 8,
   DT_FLOAT = 9,
   DT_DOUBLE = 10,
+  //! IEEE 754 half precision float, stored as uint16_t
+  DT_FLOAT16 = 11,
 };
 
+//! Return the size in bytes of a single element of the given DataType
+size_t getDataTypeByteSize(DataType dt);
+
 class Buffer {
  public:
   explicit Buffer(){};
@@ -32,6 +37,11 @@ class Buffer {
     this->dataType = dataType;
     alloc();
   };
+  //! Wrap externally owned memory (e.g. a slot of a shared memory segment)
+  //! without copying; the memory is not freed when the Buffer is destroyed
+  explicit Buffer(const std::vector<size_t> shape,
+                  const DataType dataType,
+                  void* externalData);
   void clear();
   virtual ~Buffer() { dealloc(); }
 
@@ -46,6 +56,9 @@ class Buffer {
   DataType dataType = DataType::DT_UINT8;
   std::vector<size_t> shape;
 
+ protected:
+  bool ownsData_ = true;
+
   ESP_SMART_POINTERS(Buffer)
 };
 
@@ -0,0 +1,310 @@
+// Copyright (c) Facebook, Inc. and its affiliates.
+// This source code is licensed under the MIT license found in the
+// LICENSE file in the root directory of this source tree.
+
+#include "ObservationRingBuffer.h"
+
+#include <atomic>
+#include <chrono>
+#include <cstring>
+#include <new>
+#include <thread>
+
+#if defined(__linux__)
+#include <linux/futex.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#include <climits>
+#include <ctime>
+#endif
+
+namespace esp {
+namespace core {
+
+namespace {
+constexpr uint32_t kRingMagic = 0x52494e47;  // "RING"
+constexpr uint32_t kRingVersion = 1;
+constexpr int kMaxFields = 16;
+constexpr int kMaxDims = 4;
+constexpr int kMaxFieldName = 64;
+constexpr size_t kFieldAlignment = 64;
+constexpr size_t kPageSize = 4096;
+
+size_t alignUp(size_t value, size_t alignment) {
+  return (value + alignment - 1) / alignment * alignment;
+}
+
+struct FieldDescriptor {
+  char name[kMaxFieldName];
+  int32_t dataType;
+  uint32_t ndim;
+  uint64_t shape[kMaxDims];
+  uint64_t offset;
+};
+
+using Clock = std::chrono::steady_clock;
+
+// Block until *word != expected or the deadline passes. Spurious wakeups are
+// fine, callers re-check their condition.
+void waitWhileEqual(std::atomic<uint32_t>& word,
+                    uint32_t expected,
+                    int timeoutMs,
+                    Clock::time_point deadline) {
+#if defined(__linux__)
+  struct timespec ts;
+  struct timespec* tsPtr = nullptr;
+  if (timeoutMs >= 0) {
+    const auto remaining = std::chrono::duration_cast<std::chrono::nanoseconds>(
+        deadline - Clock::now());
+    if (remaining.count() <= 0) {
+      return;
+    }
+    ts.tv_sec = remaining.count() / 1000000000;
+    ts.tv_nsec = remaining.count() % 1000000000;
+    tsPtr = &ts;
+  }
+  // not FUTEX_PRIVATE_FLAG: the word is shared with other processes
+  syscall(SYS_futex, reinterpret_cast<uint32_t*>(&word), FUTEX_WAIT, expected,
+          tsPtr, nullptr, 0);
+#else
+  if (word.load(std::memory_order_acquire) == expected) {
+    std::this_thread::sleep_for(std::chrono::microseconds(100));
+  }
+#endif
+}
+
+void wakeAll(std::atomic<uint32_t>& word) {
+#if defined(__linux__)
+  syscall(SYS_futex, reinterpret_cast<uint32_t*>(&word), FUTEX_WAKE, INT_MAX,
+          nullptr, nullptr, 0);
+#endif
+}
+}  // namespace
+
+struct ObservationRingBuffer::Header {
+  uint32_t magic;
+  uint32_t version;
+  uint32_t numSlots;
+  uint32_t numFields;
+  uint64_t slotBytes;
+  uint64_t dataOffset;
+  // total number of slots committed by the producer
+  std::atomic<uint32_t> committed;
+  // total number of slots released by the consumer
+  std::atomic<uint32_t> released;
+  FieldDescriptor fields[kMaxFields];
+};
+
+ObservationRingBuffer::ObservationRingBuffer(
+    SharedMemory::ptr memory,
+    const std::vector<RingBufferField>& fields)
+    : memory_(memory), fields_(fields) {
+  const Header& h = header();
+  for (uint32_t i = 0; i < h.numFields; ++i) {
+    fieldOffsets_.push_back(h.fields[i].offset);
+  }
+}
+
+ObservationRingBuffer::Header& ObservationRingBuffer::header() const {
+  return *static_cast<Header*>(memory_->data());
+}
+
+ObservationRingBuffer::ptr ObservationRingBuffer::createRing(
+    const std::string& name,
+    const std::vector<RingBufferField>& fields,
+    int numSlots) {
+  if (numSlots <= 0 || fields.empty() || fields.size() > kMaxFields) {
+    LOG(ERROR) << "ObservationRingBuffer needs at least one slot and at most "
+               << kMaxFields << " fields";
+    return nullptr;
+  }
+
+  // lay out the fields of one slot, each one cache line aligned
+  std::vector<uint64_t> offsets;
+  size_t slotBytes = 0;
+  for (const auto& field : fields) {
+    if (field.shape.size() > kMaxDims || field.name.size() >= kMaxFieldName) {
+      LOG(ERROR) << "Unsupported ring buffer field " << field.name;
+      return nullptr;
+    }
+    size_t bytes = getDataTypeByteSize(field.dataType);
+    for (size_t dim : field.shape) {
+      bytes *= dim;
+    }
+    offsets.push_back(slotBytes);
+    slotBytes = alignUp(slotBytes + bytes, kFieldAlignment);
+  }
+
+  const size_t dataOffset = alignUp(sizeof(Header), kPageSize);
+  const size_t totalBytes = dataOffset + slotBytes * numSlots;
+  SharedMemory::ptr memory = SharedMemory::createSegment(name, totalBytes);
+  if (memory == nullptr) {
+    return nullptr;
+  }
+
+  std::memset(memory->data(), 0, sizeof(Header));
+  Header* h = new (memory->data()) Header;
+  h->magic = kRingMagic;
+  h->version = kRingVersion;
+  h->numSlots = numSlots;
+  h->numFields = fields.size();
+  h->slotBytes = slotBytes;
+  h->dataOffset = dataOffset;
+  h->committed.store(0);
+  h->released.store(0);
+  for (size_t i = 0; i < fields.size(); ++i) {
+    FieldDescriptor& desc = h->fields[i];
+    std::memset(&desc, 0, sizeof(desc));
+    std::strncpy(desc.name, fields[i].name.c_str(), kMaxFieldName - 1);
+    desc.dataType = static_cast<int32_t>(fields[i].dataType);
+    desc.ndim = fields[i].shape.size();
+    for (size_t d = 0; d < fields[i].shape.size(); ++d) {
+      desc.shape[d] = fields[i].shape[d];
+    }
+    desc.offset = offsets[i];
+  }
+  std::atomic_thread_fence(std::memory_order_release);
+
+  return ObservationRingBuffer::create(memory, fields);
+}
+
+ObservationRingBuffer::ptr ObservationRingBuffer::attachRing(
+    const std::string& name) {
+  SharedMemory::ptr memory = SharedMemory::attachSegment(name);
+  if (memory == nullptr) {
+    LOG(ERROR) << "Cannot attach to observation ring " << name;
+    return nullptr;
+  }
+  const Header& h = *static_cast<const Header*>(memory->data());
+  if (memory->size() < sizeof(Header) || h.magic != kRingMagic ||
+      h.version != kRingVersion) {
+    LOG(ERROR) << "Shared memory segment " << name
+               << " is not a compatible observation ring";
+    return nullptr;
+  }
+
+  std::vector<RingBufferField> fields;
+  for (uint32_t i = 0; i < h.numFields; ++i) {
+    RingBufferField field;
+    field.name = h.fields[i].name;
+    field.dataType = static_cast<DataType>(h.fields[i].dataType);
+    field.shape.assign(h.fields[i].shape, h.fields[i].shape + h.fields[i].ndim);
+    fields.push_back(field);
+  }
+  return ObservationRingBuffer::create(memory, fields);
+}
+
+int ObservationRingBuffer::numSlots() const {
+  return header().numSlots;
+}
+
+int ObservationRingBuffer::numReadySlots() const {
+  const Header& h = header();
+  return h.committed.load(std::memory_order_acquire) -
+         h.released.load(std::memory_order_acquire);
+}
+
+int ObservationRingBuffer::pendingWriteSlot() const {
+  const Header& h = header();
+  const uint32_t committed = h.committed.load(std::memory_order_relaxed);
+  const uint32_t released = h.released.load(std::memory_order_acquire);
+  return committed - released < h.numSlots ? committed % h.numSlots
+                                           : ID_UNDEFINED;
+}
+
+int ObservationRingBuffer::pendingReadSlot() const {
+  const Header& h = header();
+  const uint32_t released = h.released.load(std::memory_order_relaxed);
+  const uint32_t committed = h.committed.load(std::memory_order_acquire);
+  return committed != released ? released % h.numSlots : ID_UNDEFINED;
+}
+
+int ObservationRingBuffer::acquireWriteSlot(int timeoutMs /* = -1 */) {
+  Header& h = header();
+  const auto deadline = Clock::now() + std::chrono::milliseconds(timeoutMs);
+  const uint32_t committed = h.committed.load(std::memory_order_relaxed);
+  while (true) {
+    const uint32_t released = h.released.load(std::memory_order_acquire);
+    // unsigned arithmetic keeps this correct across counter wrap-around
+    if (committed - released < h.numSlots) {
+      return committed % h.numSlots;
+    }
+    if (timeoutMs >= 0 && Clock::now() >= deadline) {
+      return ID_UNDEFINED;
+    }
+    waitWhileEqual(h.released, released, timeoutMs, deadline);
+  }
+}
+
+void ObservationRingBuffer::commitWriteSlot(int slot) {
+  Header& h = header();
+  const uint32_t committed = h.committed.load(std::memory_order_relaxed);
+  CHECK_EQ(slot, committed % h.numSlots)
+      << "Slots must be committed in acquisition order";
+  h.committed.store(committed + 1, std::memory_order_release);
+  wakeAll(h.committed);
+}
+
+int ObservationRingBuffer::acquireReadSlot(int timeoutMs /* = -1 */) {
+  Header& h = header();
+  const auto deadline = Clock::now() + std::chrono::milliseconds(timeoutMs);
+  const uint32_t released = h.released.load(std::memory_order_relaxed);
+  while (true) {
+    const uint32_t committed = h.committed.load(std::memory_order_acquire);
+    if (committed != released) {
+      return released % h.numSlots;
+    }
+    if (timeoutMs >= 0 && Clock::now() >= deadline) {
+      return ID_UNDEFINED;
+    }
+    waitWhileEqual(h.committed, committed, timeoutMs, deadline);
+  }
+}
+
+void ObservationRingBuffer::releaseReadSlot(int slot) {
+  Header& h = header();
+  const uint32_t released = h.released.load(std::memory_order_relaxed);
+  CHECK_EQ(slot, released % h.numSlots)
+      << "Slots must be released in acquisition order";
+  h.released.store(released + 1, std::memory_order_release);
+  wakeAll(h.released);
+}
+
+void* ObservationRingBuffer::slotFieldData(int slot, int fieldIndex) {
+  const Header& h = header();
+  CHECK(slot >= 0 && slot < h.numSlots);
+  CHECK(fieldIndex >= 0 && fieldIndex < fieldOffsets_.size());
+  char* base = static_cast<char*>(memory_->data());
+  return base + h.dataOffset + h.slotBytes * slot + fieldOffsets_[fieldIndex];
+}
+
+Buffer::ptr ObservationRingBuffer::slotField(int slot, int fieldIndex) {
+  void* data = slotFieldData(slot, fieldIndex);
+  const RingBufferField& field = fields_[fieldIndex];
+  // the deleter holds on to the mapping so the view can outlive the ring
+  SharedMemory::ptr memory = memory_;
+  return Buffer::ptr(new Buffer(field.shape, field.dataType, data),
+                     [memory](Buffer* buffer) { delete buffer; });
+}
+
+Buffer::ptr ObservationRingBuffer::slotField(int slot,
+                                             const std::string& fieldName) {
+  const int index = fieldIndex(fieldName);
+  if (index == ID_UNDEFINED) {
+    LOG(ERROR) << "No field " << fieldName << " in observation ring " << name();
+    return nullptr;
+  }
+  return slotField(slot, index);
+}
+
+int ObservationRingBuffer::fieldIndex(const std::string& fieldName) const {
+  for (size_t i = 0; i < fields_.size(); ++i) {
+    if (fields_[i].name == fieldName) {
+      return i;
+    }
+  }
+  return ID_UNDEFINED;
+}
+
+}  // namespace core
+}  // namespace esp
@@ -0,0 +1,104 @@
+// Copyright (c) Facebook, Inc. and its affiliates.
+// This source code is licensed under the MIT license found in the
+// LICENSE file in the root directory of this source tree.
+
+#pragma once
+
+#include <string>
+#include <vector>
+
+#include "esp/core/Buffer.h"
+#include "esp/core/SharedMemory.h"
+#include "esp/core/esp.h"
+
+namespace esp {
+namespace core {
+
+//! Layout of one observation inside a ring buffer slot, e.g. one sensor
+struct RingBufferField {
+  std::string name;
+  DataType dataType = DataType::DT_UINT8;
+  std::vector<size_t> shape;
+};
+
+/**
+ * @brief Single-producer / single-consumer ring of observation slots living in
+ * POSIX shared memory.
+ *
+ * One slot holds every field (typically one per sensor) of a single
+ * environment step, so a step is published or consumed as one batch. The
+ * simulator process creates the ring and renders directly into the buffers
+ * returned by @ref slotField(); the trainer process attaches by name and reads
+ * the same memory without any pickling or pipe copies.
+ *
+ * Slots are handed over through two monotonically increasing counters (slots
+ * committed by the producer, slots released by the consumer) stored in the
+ * segment header. Waiting uses a futex on those counters on Linux and falls
+ * back to polling elsewhere.
+ */
+class ObservationRingBuffer {
+ public:
+  //! Create a new ring in shared memory, owned by the calling process
+  static std::shared_ptr<ObservationRingBuffer> createRing(
+      const std::string& name,
+      const std::vector<RingBufferField>& fields,
+      int numSlots);
+
+  //! Attach to a ring created by another process
+  static std::shared_ptr<ObservationRingBuffer> attachRing(
+      const std::string& name);
+
+  int numSlots() const;
+  const std::vector<RingBufferField>& fields() const { return fields_; }
+  const std::string& name() const { return memory_->name(); }
+
+  //! Producer: claim the next slot for writing. Blocks up to timeoutMs
+  //! (negative waits forever) and returns ID_UNDEFINED on timeout.
+  int acquireWriteSlot(int timeoutMs = -1);
+  //! Producer: publish a slot previously returned by acquireWriteSlot()
+  void commitWriteSlot(int slot);
+
+  //! Consumer: claim the oldest published slot for reading. Blocks up to
+  //! timeoutMs (negative waits forever) and returns ID_UNDEFINED on timeout.
+  int acquireReadSlot(int timeoutMs = -1);
+  //! Consumer: hand a slot previously returned by acquireReadSlot() back to
+  //! the producer
+  void releaseReadSlot(int slot);
+
+  //! Number of committed slots not yet acquired by the consumer
+  int numReadySlots() const;
+
+  //! Slot the next commitWriteSlot() has to publish, ID_UNDEFINED if the
+  //! producer holds none because the ring is full
+  int pendingWriteSlot() const;
+  //! Slot the next releaseReadSlot() has to hand back, ID_UNDEFINED if no
+  //! slot has been published
+  int pendingReadSlot() const;
+
+  //! Buffer aliasing field fieldIndex of the given slot. The returned Buffer
+  //! does not own its memory and keeps the ring alive.
+  Buffer::ptr slotField(int slot, int fieldIndex);
+  Buffer::ptr slotField(int slot, const std::string& fieldName);
+
+  //! Raw pointer to field fieldIndex of the given slot
+  void* slotFieldData(int slot, int fieldIndex);
+
+  //! Index of the field with the given name or ID_UNDEFINED
+  int fieldIndex(const std::string& fieldName) const;
+
+  ObservationRingBuffer(SharedMemory::ptr memory,
+                        const std::vector<RingBufferField>& fields);
+
+ protected:
+  struct Header;
+  Header& header() const;
+
+  SharedMemory::ptr memory_ = nullptr;
+  std::vector<RingBufferField> fields_;
+  std::vector<size_t> fieldOffsets_;
+
+  ESP_SMART_POINTERS(ObservationRingBuffer)
+};
+
+}  // namespace core
+}  // namespace esp
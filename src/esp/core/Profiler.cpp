@@ -0,0 +1,152 @@
+// Copyright (c) Facebook, Inc. and its affiliates.
+// This source code is licensed under the MIT license found in the
+// LICENSE file in the root directory of this source tree.
+
+#include "Profiler.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <fstream>
+#include <iomanip>
+
+namespace esp {
+namespace core {
+
+namespace {
+// value at fraction q of sorted values, with the nearest rank method
+double percentile(const std::vector<int64_t>& sorted, double q) {
+  const size_t rank = static_cast<size_t>(std::ceil(q * sorted.size()));
+  return sorted[std::max<size_t>(rank, 1) - 1] * 1e-6;
+}
+
+std::string escapeJson(const std::string& s) {
+  std::string escaped;
+  for (const char c : s) {
+    if (c == '"' || c == '\\') {
+      escaped += '\\';
+    }
+    escaped += c;
+  }
+  return escaped;
+}
+}  // namespace
+
+Profiler::Profiler(size_t maxSamples) : maxSamples_(maxSamples) {
+  CHECK_GT(maxSamples_, 0);
+}
+
+int64_t Profiler::now() {
+  return std::chrono::duration_cast<std::chrono::nanoseconds>(
+             std::chrono::steady_clock::now().time_since_epoch())
+      .count();
+}
+
+void Profiler::record(const std::string& name,
+                      int64_t startNs,
+                      int64_t durationNs,
+                      const std::string& track) {
+  if (!enabled_) {
+    return;
+  }
+  std::lock_guard<std::mutex> lock(mutex_);
+  auto trackIt = std::find(tracks_.begin(), tracks_.end(), track);
+  if (trackIt == tracks_.end()) {
+    trackIt = tracks_.insert(tracks_.end(), track);
+  }
+  std::deque<Sample>& samples = sections_[name];
+  if (samples.size() == maxSamples_) {
+    samples.pop_front();
+  }
+  samples.push_back(
+      {startNs, durationNs, static_cast<int>(trackIt - tracks_.begin())});
+}
+
+ProfilerStats Profiler::stats(const std::string& name) const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  ProfilerStats stats;
+  const auto it = sections_.find(name);
+  if (it == sections_.end() || it->second.empty()) {
+    return stats;
+  }
+  std::vector<int64_t> durations;
+  durations.reserve(it->second.size());
+  for (const Sample& sample : it->second) {
+    durations.push_back(sample.durationNs);
+  }
+  std::sort(durations.begin(), durations.end());
+
+  double total = 0.0;
+  for (const int64_t duration : durations) {
+    total += duration;
+  }
+  stats.count = durations.size();
+  stats.mean = total * 1e-6 / durations.size();
+  stats.p50 = percentile(durations, 0.5);
+  stats.p99 = percentile(durations, 0.99);
+  return stats;
+}
+
+std::vector<std::string> Profiler::sectionNames() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  std::vector<std::string> names;
+  for (const auto& section : sections_) {
+    if (!section.second.empty()) {
+      names.push_back(section.first);
+    }
+  }
+  return names;
+}
+
+void Profiler::reset() {
+  std::lock_guard<std::mutex> lock(mutex_);
+  sections_.clear();
+}
+
+bool Profiler::writeChromeTrace(const std::string& filename) const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  std::ofstream out(filename);
+  if (!out) {
+    LOG(ERROR) << "Cannot write Chrome trace " << filename;
+    return false;
+  }
+
+  // complete ("X") events with microsecond timestamps, one thread per track
+  out << std::fixed << std::setprecision(3) << "{\"traceEvents\":[";
+  bool first = true;
+  for (size_t track = 0; track < tracks_.size(); ++track) {
+    out << (first ? "" : ",") << "\n{\"name\":\"thread_name\",\"ph\":\"M\","
+        << "\"pid\":0,\"tid\":" << track << ",\"args\":{\"name\":\""
+        << escapeJson(tracks_[track]) << "\"}}";
+    first = false;
+  }
+  for (const auto& section : sections_) {
+    const std::string name = escapeJson(section.first);
+    for (const Sample& sample : section.second) {
+      out << (first ? "" : ",") << "\n{\"name\":\"" << name
+          << "\",\"ph\":\"X\",\"pid\":0,\"tid\":" << sample.track
+          << ",\"ts\":" << sample.startNs / 1000.0
+          << ",\"dur\":" << sample.durationNs / 1000.0 << "}";
+      first = false;
+    }
+  }
+  out << "\n]}\n";
+  return out.good();
+}
+
+ProfilerScope::ProfilerScope(Profiler& profiler, const std::string& name) {
+  if (profiler.isEnabled()) {
+    profiler_ = &profiler;
+    name_ = name;
+    startNs_ = Profiler::now();
+  }
+}
+
+ProfilerScope::~ProfilerScope() {
+  if (profiler_ != nullptr) {
+    profiler_->record(name_, startNs_, Profiler::now() - startNs_);
+  }
+}
+
+}  // namespace core
+}  // namespace esp
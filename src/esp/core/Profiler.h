@@ -0,0 +1,100 @@
+// Copyright (c) Facebook, Inc. and its affiliates.
+// This source code is licensed under the MIT license found in the
+// LICENSE file in the root directory of this source tree.
+
+#pragma once
+
+#include <atomic>
+#include <deque>
+#include <map>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include "esp/core/esp.h"
+
+namespace esp {
+namespace core {
+
+//! Summary of the samples of one profiled section, in milliseconds
+struct ProfilerStats {
+  size_t count = 0;
+  double mean = 0.0;
+  double p50 = 0.0;
+  double p99 = 0.0;
+};
+
+/**
+ * @brief Collects timings of named sections, e.g. the draw submission, GPU
+ * execution and readback of each sensor.
+ *
+ * Sections are recorded on tracks ("cpu" for scoped CPU timers, "gpu" for
+ * timer queries) and summarized by @ref stats(). The last maxSamples samples
+ * of every section are kept, so memory stays bounded over long runs, and can
+ * be exported as a Chrome trace (chrome://tracing, Perfetto).
+ *
+ * Disabled by default; recording is a no-op then.
+ */
+class Profiler {
+ public:
+  explicit Profiler(size_t maxSamples = 4096);
+
+  void setEnabled(bool enabled) { enabled_ = enabled; }
+  bool isEnabled() const { return enabled_; }
+
+  //! Current time in nanoseconds on the clock all samples are taken with
+  static int64_t now();
+
+  //! Record a sample of section name that started at startNs and took
+  //! durationNs
+  void record(const std::string& name,
+              int64_t startNs,
+              int64_t durationNs,
+              const std::string& track = "cpu");
+
+  //! Statistics over the kept samples of section name, all zero if there are
+  //! none
+  ProfilerStats stats(const std::string& name) const;
+
+  //! Names of all sections with samples, sorted
+  std::vector<std::string> sectionNames() const;
+
+  //! Drop all samples
+  void reset();
+
+  //! Write the kept samples as a Chrome trace event JSON file
+  bool writeChromeTrace(const std::string& filename) const;
+
+ protected:
+  struct Sample {
+    int64_t startNs;
+    int64_t durationNs;
+    int track;
+  };
+
+  size_t maxSamples_;
+  std::atomic<bool> enabled_{false};
+  std::map<std::string, std::deque<Sample>> sections_;
+  std::vector<std::string> tracks_;
+  mutable std::mutex mutex_;
+
+  ESP_SMART_POINTERS(Profiler)
+};
+
+/**
+ * @brief Records the lifetime of the scope as a sample of section name on
+ * the "cpu" track, if profiler is enabled.
+ */
+class ProfilerScope {
+ public:
+  ProfilerScope(Profiler& profiler, const std::string& name);
+  ~ProfilerScope();
+
+ protected:
+  Profiler* profiler_ = nullptr;
+  std::string name_;
+  int64_t startNs_ = 0;
+};
+
+}  // namespace core
+}  // namespace esp
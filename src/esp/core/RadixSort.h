@@ -0,0 +1,83 @@
+// Copyright (c) Facebook, Inc. and its affiliates.
+// This source code is licensed under the MIT license found in the
+// LICENSE file in the root directory of this source tree.
+
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+#include <vector>
+
+namespace esp {
+namespace core {
+
+/**
+ * @brief Stable sort of keys, an array of unsigned integers, permuting values
+ * of the same size along.
+ *
+ * Least significant digit radix sort over bytes. The input is split into
+ * blocks which are counted and scattered in parallel (with OpenMP enabled);
+ * bytes in which all keys agree are skipped, so e.g. 64 bit keys made of two
+ * small vertex indices take only a few passes.
+ */
+template <typename Key, typename Value>
+void radixSortPairs(std::vector<Key>& keys, std::vector<Value>& values) {
+  static_assert(std::is_unsigned<Key>::value, "keys have to be unsigned");
+  constexpr int kNumBuckets = 256;
+  const size_t size = keys.size();
+  // enough blocks to keep all threads busy, few enough for the block
+  // histograms to stay small
+  const int numBlocks =
+      static_cast<int>(std::max<size_t>(1, std::min<size_t>(64, size >> 12)));
+  const size_t blockSize = (size + numBlocks - 1) / numBlocks;
+
+  std::vector<Key> sortedKeys(size);
+  std::vector<Value> sortedValues(size);
+  std::vector<size_t> offsets(numBlocks * kNumBuckets);
+  for (size_t shift = 0; shift < 8 * sizeof(Key); shift += 8) {
+    std::fill(offsets.begin(), offsets.end(), 0);
+#pragma omp parallel for
+    for (int block = 0; block < numBlocks; ++block) {
+      size_t* counts = offsets.data() + block * kNumBuckets;
+      const size_t end = std::min(size, (block + 1) * blockSize);
+      for (size_t i = block * blockSize; i < end; ++i) {
+        ++counts[(keys[i] >> shift) & 0xff];
+      }
+    }
+
+    // each block scatters its keys of a bucket after those of the blocks
+    // before it, which keeps the sort stable
+    size_t offset = 0;
+    bool allInOneBucket = false;
+    for (int bucket = 0; bucket < kNumBuckets; ++bucket) {
+      const size_t bucketStart = offset;
+      for (int block = 0; block < numBlocks; ++block) {
+        const size_t count = offsets[block * kNumBuckets + bucket];
+        offsets[block * kNumBuckets + bucket] = offset;
+        offset += count;
+      }
+      allInOneBucket = allInOneBucket || offset - bucketStart == size;
+    }
+    if (allInOneBucket) {
+      continue;
+    }
+
+#pragma omp parallel for
+    for (int block = 0; block < numBlocks; ++block) {
+      size_t* blockOffsets = offsets.data() + block * kNumBuckets;
+      const size_t end = std::min(size, (block + 1) * blockSize);
+      for (size_t i = block * blockSize; i < end; ++i) {
+        const size_t target = blockOffsets[(keys[i] >> shift) & 0xff]++;
+        sortedKeys[target] = keys[i];
+        sortedValues[target] = values[i];
+      }
+    }
+    keys.swap(sortedKeys);
+    values.swap(sortedValues);
+  }
+}
+
+}  // namespace core
+}  // namespace esp
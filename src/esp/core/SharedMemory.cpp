@@ -0,0 +1,107 @@
+// Copyright (c) Facebook, Inc. and its affiliates.
+// This source code is licensed under the MIT license found in the
+// LICENSE file in the root directory of this source tree.
+
+#include "SharedMemory.h"
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <cerrno>
+#include <cstring>
+
+namespace esp {
+namespace core {
+
+namespace {
+// shm_open requires a single leading slash and no other slashes
+std::string normalizeName(const std::string& name) {
+  std::string normalized = name;
+  for (char& c : normalized) {
+    if (c == '/') {
+      c = '_';
+    }
+  }
+  return "/" + normalized;
+}
+}  // namespace
+
+SharedMemory::SharedMemory(const std::string& name,
+                           void* data,
+                           size_t size,
+                           bool isOwner)
+    : name_(name), data_(data), size_(size), isOwner_(isOwner) {}
+
+SharedMemory::ptr SharedMemory::createSegment(const std::string& name,
+                                              size_t size) {
+  const std::string shmName = normalizeName(name);
+  int fd = shm_open(shmName.c_str(), O_CREAT | O_EXCL | O_RDWR, 0600);
+  if (fd == -1 && errno == EEXIST) {
+    // left behind by an owner that crashed, its contents are stale. Those
+    // still attached to it keep their mapping of the old segment.
+    LOG(WARNING) << "Replacing existing shared memory segment " << shmName;
+    shm_unlink(shmName.c_str());
+    fd = shm_open(shmName.c_str(), O_CREAT | O_EXCL | O_RDWR, 0600);
+  }
+  if (fd == -1) {
+    LOG(ERROR) << "Cannot create shared memory segment " << shmName << ": "
+               << std::strerror(errno);
+    return nullptr;
+  }
+  if (ftruncate(fd, size) == -1) {
+    LOG(ERROR) << "Cannot resize shared memory segment " << shmName << " to "
+               << size << " bytes: " << std::strerror(errno);
+    close(fd);
+    shm_unlink(shmName.c_str());
+    return nullptr;
+  }
+  void* data = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+  close(fd);
+  if (data == MAP_FAILED) {
+    LOG(ERROR) << "Cannot map shared memory segment " << shmName << ": "
+               << std::strerror(errno);
+    shm_unlink(shmName.c_str());
+    return nullptr;
+  }
+  return SharedMemory::create(name, data, size, true);
+}
+
+SharedMemory::ptr SharedMemory::attachSegment(const std::string& name,
+                                              bool readOnly /* = false */) {
+  const std::string shmName = normalizeName(name);
+  const int fd = shm_open(shmName.c_str(), readOnly ? O_RDONLY : O_RDWR, 0600);
+  if (fd == -1) {
+    VLOG(1) << "Cannot open shared memory segment " << shmName << ": "
+            << std::strerror(errno);
+    return nullptr;
+  }
+  struct stat st;
+  if (fstat(fd, &st) == -1 || st.st_size == 0) {
+    LOG(ERROR) << "Cannot stat shared memory segment " << shmName;
+    close(fd);
+    return nullptr;
+  }
+  const size_t size = static_cast<size_t>(st.st_size);
+  const int protection = readOnly ? PROT_READ : PROT_READ | PROT_WRITE;
+  void* data = mmap(nullptr, size, protection, MAP_SHARED, fd, 0);
+  close(fd);
+  if (data == MAP_FAILED) {
+    LOG(ERROR) << "Cannot map shared memory segment " << shmName << ": "
+               << std::strerror(errno);
+    return nullptr;
+  }
+  return SharedMemory::create(name, data, size, false);
+}
+
+SharedMemory::~SharedMemory() {
+  if (data_ != nullptr) {
+    munmap(data_, size_);
+  }
+  if (isOwner_) {
+    shm_unlink(normalizeName(name_).c_str());
+  }
+}
+
+}  // namespace core
+}  // namespace esp
@@ -0,0 +1,58 @@
+// Copyright (c) Facebook, Inc. and its affiliates.
+// This source code is licensed under the MIT license found in the
+// LICENSE file in the root directory of this source tree.
+
+#pragma once
+
+#include <string>
+
+#include "esp/core/esp.h"
+
+namespace esp {
+namespace core {
+
+/**
+ * @brief A named POSIX shared memory segment mapped into this process.
+ *
+ * The creating process owns the name and unlinks it on destruction; other
+ * processes attach to the same name and only unmap their view. The mapping
+ * stays valid in every attached process until it is destroyed there, even if
+ * the owner has already unlinked the name.
+ */
+class SharedMemory {
+ public:
+  //! Create a new, zero filled segment of the given size. An existing
+  //! segment of the same name is unlinked first. Returns nullptr on failure.
+  static std::shared_ptr<SharedMemory> createSegment(const std::string& name,
+                                                     size_t size);
+
+  //! Attach to an existing segment. Returns nullptr if it does not exist.
+  static std::shared_ptr<SharedMemory> attachSegment(const std::string& name,
+                                                     bool readOnly = false);
+
+  ~SharedMemory();
+
+  const std::string& name() const { return name_; }
+  size_t size() const { return size_; }
+  void* data() const { return data_; }
+  bool isOwner() const { return isOwner_; }
+
+  SharedMemory(const SharedMemory&) = delete;
+  SharedMemory& operator=(const SharedMemory&) = delete;
+
+  SharedMemory(const std::string& name,
+               void* data,
+               size_t size,
+               bool isOwner);
+
+ protected:
+  std::string name_;
+  void* data_ = nullptr;
+  size_t size_ = 0;
+  bool isOwner_ = false;
+
+  ESP_SMART_POINTERS(SharedMemory)
+};
+
+}  // namespace core
+}  // namespace esp
@@ -0,0 +1,399 @@
+// Copyright (c) Facebook, Inc. and its affiliates.
+// This source code is licensed under the MIT license found in the
+// LICENSE file in the root directory of this source tree.
+
+#include "BVH.h"
+
+#include <algorithm>
+
+namespace esp {
+namespace geo {
+
+namespace {
+constexpr uint32_t kMaxLeafSize = 4;
+constexpr int kMaxDepth = 64;
+constexpr int kNumBins = 16;
+constexpr float kDetEpsilon = 1e-12f;
+constexpr float kInfinity = std::numeric_limits<float>::infinity();
+
+typedef Eigen::Array<int, kRayPacketSize, 1> PacketInt;
+
+float surfaceArea(const box3f& box) {
+  if (box.isEmpty()) {
+    return 0.0f;
+  }
+  const vec3f d = box.sizes();
+  return 2.0f * (d.x() * d.y() + d.y() * d.z() + d.z() * d.x());
+}
+
+// 1 / d with zero components nudged away from zero so that the slab test
+// never computes 0 * inf
+float safeInverse(float d) {
+  return 1.0f / (std::abs(d) > kDetEpsilon ? d : std::copysign(kDetEpsilon, d));
+}
+
+PacketFloat safeInverse(const PacketFloat& d) {
+  return (d.abs() > kDetEpsilon)
+      .select(d, PacketFloat::Constant(kDetEpsilon))
+      .inverse();
+}
+}  // namespace
+
+TriangleBVH::TriangleBVH(bool cullBackFaces /* = true */)
+    : cullBackFaces_(cullBackFaces) {}
+
+void TriangleBVH::reserve(size_t numTriangles) {
+  triangles_.reserve(numTriangles);
+  objectIds_.reserve(numTriangles);
+}
+
+void TriangleBVH::addTriangle(const vec3f& a,
+                              const vec3f& b,
+                              const vec3f& c,
+                              uint32_t objectId) {
+  triangles_.push_back(Triangle{a, b - a, c - a});
+  objectIds_.push_back(objectId);
+}
+
+void TriangleBVH::build() {
+  nodes_.clear();
+  const uint32_t numTriangles = triangles_.size();
+  if (numTriangles == 0) {
+    return;
+  }
+
+  std::vector<box3f> bounds(numTriangles);
+  std::vector<vec3f> centroids(numTriangles);
+  std::vector<uint32_t> order(numTriangles);
+  for (uint32_t i = 0; i < numTriangles; ++i) {
+    const Triangle& tri = triangles_[i];
+    bounds[i] = box3f(tri.v0);
+    bounds[i].extend(vec3f(tri.v0 + tri.e1));
+    bounds[i].extend(vec3f(tri.v0 + tri.e2));
+    centroids[i] = bounds[i].center();
+    order[i] = i;
+  }
+
+  nodes_.reserve(2 * numTriangles / kMaxLeafSize + 1);
+  nodes_.push_back(Node{vec3f::Zero(), vec3f::Zero(), 0, numTriangles});
+  subdivide(0, 0, order, bounds, centroids);
+
+  // index each triangle was added with, a previous build may have moved it
+  std::vector<uint32_t> addedIndices(numTriangles);
+  for (uint32_t i = 0; i < numTriangles; ++i) {
+    addedIndices[i] = i;
+  }
+  for (uint32_t i = 0; i < leafIndices_.size(); ++i) {
+    addedIndices[leafIndices_[i]] = i;
+  }
+
+  // store triangles in leaf order so leaves address a contiguous range
+  std::vector<Triangle> triangles(numTriangles);
+  std::vector<uint32_t> objectIds(numTriangles);
+  std::vector<uint32_t> leafIndices(numTriangles);
+  for (uint32_t i = 0; i < numTriangles; ++i) {
+    triangles[i] = triangles_[order[i]];
+    objectIds[i] = objectIds_[order[i]];
+    leafIndices[addedIndices[order[i]]] = i;
+  }
+  triangles_.swap(triangles);
+  objectIds_.swap(objectIds);
+  leafIndices_.swap(leafIndices);
+
+  VLOG(1) << "TriangleBVH: " << numTriangles << " triangles, "
+          << nodes_.size() << " nodes";
+}
+
+void TriangleBVH::setTriangle(size_t i,
+                              const vec3f& a,
+                              const vec3f& b,
+                              const vec3f& c) {
+  ASSERT(i < triangles_.size());
+  const size_t index = i < leafIndices_.size() ? leafIndices_[i] : i;
+  triangles_[index] = Triangle{a, b - a, c - a};
+}
+
+void TriangleBVH::refit() {
+  // children are always stored after their parent
+  for (size_t n = nodes_.size(); n-- > 0;) {
+    Node& node = nodes_[n];
+    box3f bounds;
+    if (node.count > 0) {
+      for (uint32_t i = node.offset; i < node.offset + node.count; ++i) {
+        const Triangle& tri = triangles_[i];
+        bounds.extend(tri.v0);
+        bounds.extend(vec3f(tri.v0 + tri.e1));
+        bounds.extend(vec3f(tri.v0 + tri.e2));
+      }
+    } else {
+      for (uint32_t child = node.offset; child < node.offset + 2; ++child) {
+        bounds.extend(box3f(nodes_[child].min, nodes_[child].max));
+      }
+    }
+    node.min = bounds.min();
+    node.max = bounds.max();
+  }
+}
+
+void TriangleBVH::subdivide(uint32_t nodeIndex,
+                            int depth,
+                            std::vector<uint32_t>& order,
+                            const std::vector<box3f>& bounds,
+                            const std::vector<vec3f>& centroids) {
+  // nodes_ grows below, so never hold a reference across push_back
+  const uint32_t begin = nodes_[nodeIndex].offset;
+  const uint32_t count = nodes_[nodeIndex].count;
+
+  box3f nodeBounds;
+  box3f centroidBounds;
+  for (uint32_t i = begin; i < begin + count; ++i) {
+    nodeBounds.extend(bounds[order[i]]);
+    centroidBounds.extend(centroids[order[i]]);
+  }
+  nodes_[nodeIndex].min = nodeBounds.min();
+  nodes_[nodeIndex].max = nodeBounds.max();
+
+  if (count <= kMaxLeafSize || depth >= kMaxDepth) {
+    return;
+  }
+
+  int axis;
+  const vec3f extent = centroidBounds.sizes();
+  extent.maxCoeff(&axis);
+  if (extent[axis] <= 0.0f) {
+    // all centroids coincide, no split can separate them
+    return;
+  }
+
+  // bin triangles by centroid along the widest axis
+  const float binScale = kNumBins / extent[axis];
+  const float binStart = centroidBounds.min()[axis];
+  auto binOf = [&](uint32_t tri) {
+    return std::min(kNumBins - 1,
+                    static_cast<int>((centroids[tri][axis] - binStart) *
+                                     binScale));
+  };
+  box3f binBounds[kNumBins];
+  uint32_t binCounts[kNumBins] = {0};
+  for (uint32_t i = begin; i < begin + count; ++i) {
+    const int bin = binOf(order[i]);
+    binBounds[bin].extend(bounds[order[i]]);
+    ++binCounts[bin];
+  }
+
+  // sweep from the right to get the cost of every split plane
+  float rightAreas[kNumBins];
+  uint32_t rightCounts[kNumBins];
+  box3f accumulated;
+  uint32_t accumulatedCount = 0;
+  for (int bin = kNumBins - 1; bin > 0; --bin) {
+    accumulated.extend(binBounds[bin]);
+    accumulatedCount += binCounts[bin];
+    rightAreas[bin] = surfaceArea(accumulated);
+    rightCounts[bin] = accumulatedCount;
+  }
+  accumulated.setEmpty();
+  accumulatedCount = 0;
+  float bestCost = kInfinity;
+  int bestSplit = ID_UNDEFINED;
+  for (int split = 1; split < kNumBins; ++split) {
+    accumulated.extend(binBounds[split - 1]);
+    accumulatedCount += binCounts[split - 1];
+    if (accumulatedCount == 0 || rightCounts[split] == 0) {
+      continue;
+    }
+    const float cost = accumulatedCount * surfaceArea(accumulated) +
+                       rightCounts[split] * rightAreas[split];
+    if (cost < bestCost) {
+      bestCost = cost;
+      bestSplit = split;
+    }
+  }
+  if (bestSplit == ID_UNDEFINED) {
+    return;
+  }
+  // splitting is not worth it, unless the leaf would get unreasonably big
+  const float leafCost = count * surfaceArea(nodeBounds);
+  if (bestCost >= leafCost && count <= 16 * kMaxLeafSize) {
+    return;
+  }
+
+  const auto middle =
+      std::partition(order.begin() + begin, order.begin() + begin + count,
+                     [&](uint32_t tri) { return binOf(tri) < bestSplit; });
+  const uint32_t leftCount = (middle - order.begin()) - begin;
+
+  const uint32_t leftIndex = nodes_.size();
+  nodes_.push_back(Node{vec3f::Zero(), vec3f::Zero(), begin, leftCount});
+  nodes_.push_back(Node{vec3f::Zero(), vec3f::Zero(), begin + leftCount,
+                        count - leftCount});
+  nodes_[nodeIndex].offset = leftIndex;
+  nodes_[nodeIndex].count = 0;
+
+  subdivide(leftIndex, depth + 1, order, bounds, centroids);
+  subdivide(leftIndex + 1, depth + 1, order, bounds, centroids);
+}
+
+RayHit TriangleBVH::intersect(
+    const vec3f& origin,
+    const vec3f& direction,
+    float tMin /* = 0.0f */,
+    float tMax /* = std::numeric_limits<float>::infinity() */) const {
+  RayHit hit;
+  hit.t = tMax;
+  if (nodes_.empty()) {
+    return hit;
+  }
+
+  const vec3f invDir(safeInverse(direction.x()), safeInverse(direction.y()),
+                     safeInverse(direction.z()));
+  // entry distance into a node or infinity if the ray misses it
+  auto entry = [&](const Node& node) {
+    const vec3f t0 = (node.min - origin).cwiseProduct(invDir);
+    const vec3f t1 = (node.max - origin).cwiseProduct(invDir);
+    const float tEnter = std::max(t0.cwiseMin(t1).maxCoeff(), tMin);
+    const float tExit = std::min(t0.cwiseMax(t1).minCoeff(), hit.t);
+    return tEnter <= tExit ? tEnter : kInfinity;
+  };
+
+  uint32_t stack[kMaxDepth + 2];
+  int stackSize = 0;
+  stack[stackSize++] = 0;
+  while (stackSize > 0) {
+    const Node& node = nodes_[stack[--stackSize]];
+    if (entry(node) == kInfinity) {
+      continue;
+    }
+
+    if (node.count == 0) {
+      // visit the nearer child first so the far one is likely culled
+      const float left = entry(nodes_[node.offset]);
+      const float right = entry(nodes_[node.offset + 1]);
+      const uint32_t nearChild = left <= right ? node.offset : node.offset + 1;
+      const uint32_t farChild = left <= right ? node.offset + 1 : node.offset;
+      if (std::max(left, right) != kInfinity) {
+        stack[stackSize++] = farChild;
+      }
+      if (std::min(left, right) != kInfinity) {
+        stack[stackSize++] = nearChild;
+      }
+      continue;
+    }
+
+    for (uint32_t i = node.offset; i < node.offset + node.count; ++i) {
+      const Triangle& tri = triangles_[i];
+      const vec3f pvec = direction.cross(tri.e2);
+      const float det = tri.e1.dot(pvec);
+      if (cullBackFaces_ ? det <= kDetEpsilon : std::abs(det) <= kDetEpsilon) {
+        continue;
+      }
+      const float invDet = 1.0f / det;
+      const vec3f tvec = origin - tri.v0;
+      const float u = tvec.dot(pvec) * invDet;
+      if (u < 0.0f || u > 1.0f) {
+        continue;
+      }
+      const vec3f qvec = tvec.cross(tri.e1);
+      const float v = direction.dot(qvec) * invDet;
+      if (v < 0.0f || u + v > 1.0f) {
+        continue;
+      }
+      const float t = tri.e2.dot(qvec) * invDet;
+      if (t >= tMin && t < hit.t) {
+        hit.t = t;
+        hit.triangle = i;
+      }
+    }
+  }
+  return hit;
+}
+
+void TriangleBVH::intersect(const RayPacket& packet, PacketHit& hit) const {
+  hit.t = packet.tMax;
+  hit.triangle.setConstant(ID_UNDEFINED);
+  if (nodes_.empty()) {
+    return;
+  }
+
+  const auto& origin = packet.origin;
+  const auto& dir = packet.direction;
+  PacketVec3 invDir;
+  for (int c = 0; c < 3; ++c) {
+    invDir.col(c) = safeInverse(PacketFloat(dir.col(c)));
+  }
+
+  // per-ray entry distance into a node, infinity for rays that miss it
+  auto entry = [&](const Node& node) -> PacketFloat {
+    PacketFloat tEnter = packet.tMin;
+    PacketFloat tExit = hit.t;
+    for (int c = 0; c < 3; ++c) {
+      const PacketFloat t0 = (node.min[c] - origin.col(c)) * invDir.col(c);
+      const PacketFloat t1 = (node.max[c] - origin.col(c)) * invDir.col(c);
+      tEnter = tEnter.max(t0.min(t1));
+      tExit = tExit.min(t0.max(t1));
+    }
+    return (tEnter <= tExit).select(tEnter, PacketFloat::Constant(kInfinity));
+  };
+
+  uint32_t stack[kMaxDepth + 2];
+  int stackSize = 0;
+  stack[stackSize++] = 0;
+  while (stackSize > 0) {
+    const Node& node = nodes_[stack[--stackSize]];
+    if (entry(node).minCoeff() == kInfinity) {
+      continue;
+    }
+
+    if (node.count == 0) {
+      // the packet visits first the child the closest of its rays enters
+      const float left = entry(nodes_[node.offset]).minCoeff();
+      const float right = entry(nodes_[node.offset + 1]).minCoeff();
+      const uint32_t nearChild = left <= right ? node.offset : node.offset + 1;
+      const uint32_t farChild = left <= right ? node.offset + 1 : node.offset;
+      if (std::max(left, right) != kInfinity) {
+        stack[stackSize++] = farChild;
+      }
+      if (std::min(left, right) != kInfinity) {
+        stack[stackSize++] = nearChild;
+      }
+      continue;
+    }
+
+    // Moeller-Trumbore against every ray of the packet at once
+    for (uint32_t i = node.offset; i < node.offset + node.count; ++i) {
+      const Triangle& tri = triangles_[i];
+      const PacketFloat px = dir.col(1) * tri.e2.z() - dir.col(2) * tri.e2.y();
+      const PacketFloat py = dir.col(2) * tri.e2.x() - dir.col(0) * tri.e2.z();
+      const PacketFloat pz = dir.col(0) * tri.e2.y() - dir.col(1) * tri.e2.x();
+      const PacketFloat det =
+          tri.e1.x() * px + tri.e1.y() * py + tri.e1.z() * pz;
+      const PacketFloat invDet = det.inverse();
+
+      const PacketFloat tx = origin.col(0) - tri.v0.x();
+      const PacketFloat ty = origin.col(1) - tri.v0.y();
+      const PacketFloat tz = origin.col(2) - tri.v0.z();
+      const PacketFloat u = (tx * px + ty * py + tz * pz) * invDet;
+
+      const PacketFloat qx = ty * tri.e1.z() - tz * tri.e1.y();
+      const PacketFloat qy = tz * tri.e1.x() - tx * tri.e1.z();
+      const PacketFloat qz = tx * tri.e1.y() - ty * tri.e1.x();
+      const PacketFloat v =
+          (dir.col(0) * qx + dir.col(1) * qy + dir.col(2) * qz) * invDet;
+      const PacketFloat t =
+          (tri.e2.x() * qx + tri.e2.y() * qy + tri.e2.z() * qz) * invDet;
+
+      const auto frontFacing =
+          cullBackFaces_ ? (det > kDetEpsilon).eval()
+                         : (det.abs() > kDetEpsilon).eval();
+      // evaluated now, the selects below update hit.t
+      const auto mask = (frontFacing && u >= 0.0f && v >= 0.0f &&
+                         (u + v) <= 1.0f && t >= packet.tMin && t < hit.t)
+                            .eval();
+      hit.t = mask.select(t, hit.t);
+      hit.triangle = mask.select(PacketInt::Constant(i), hit.triangle);
+    }
+  }
+}
+
+}  // namespace geo
+}  // namespace esp
@@ -0,0 +1,132 @@
+// Copyright (c) Facebook, Inc. and its affiliates.
+// This source code is licensed under the MIT license found in the
+// LICENSE file in the root directory of this source tree.
+
+#pragma once
+
+#include <limits>
+#include <vector>
+
+#include "esp/core/esp.h"
+
+namespace esp {
+namespace geo {
+
+//! Number of rays traced together by TriangleBVH::intersect(RayPacket&)
+constexpr int kRayPacketSize = 8;
+
+//! One float per ray of a packet
+typedef Eigen::Array<float, kRayPacketSize, 1> PacketFloat;
+//! One 3-vector per ray of a packet, stored as x, y and z columns so that
+//! every column operation maps onto SIMD lanes
+typedef Eigen::Array<float, kRayPacketSize, 3> PacketVec3;
+
+//! A packet of rays, each one valid for t in [tMin, tMax). Rays that should
+//! not be traced (e.g. pixels past the image border) get tMax <= tMin.
+struct RayPacket {
+  PacketVec3 origin;
+  PacketVec3 direction;
+  PacketFloat tMin;
+  PacketFloat tMax;
+};
+
+//! Closest hit of every ray of a packet. Rays that miss keep t = tMax and
+//! triangle = ID_UNDEFINED.
+struct PacketHit {
+  PacketFloat t;
+  Eigen::Array<int, kRayPacketSize, 1> triangle;
+};
+
+//! Closest hit of a single ray
+struct RayHit {
+  float t = std::numeric_limits<float>::infinity();
+  int triangle = ID_UNDEFINED;
+};
+
+/**
+ * @brief Bounding volume hierarchy over a static triangle soup.
+ *
+ * Triangles are added in world space together with the object id the GL
+ * renderer would write for them, then @ref build() constructs the tree with a
+ * binned surface area heuristic. Queries are either single rays or packets of
+ * @ref kRayPacketSize coherent rays (e.g. neighbouring camera pixels) which
+ * traverse the tree together and are intersected with each triangle using
+ * SIMD arithmetic on all rays at once.
+ *
+ * Like the GL renderer with face culling enabled, triangles are only hit from
+ * their front (counter-clockwise) side unless cullBackFaces is false.
+ */
+class TriangleBVH {
+ public:
+  explicit TriangleBVH(bool cullBackFaces = true);
+
+  void reserve(size_t numTriangles);
+
+  //! Add a triangle. Has no effect on queries until @ref build() is called.
+  void addTriangle(const vec3f& a,
+                   const vec3f& b,
+                   const vec3f& c,
+                   uint32_t objectId);
+
+  //! (Re)build the hierarchy over all added triangles
+  void build();
+
+  //! Move triangle i, counted in the order the triangles were added, e.g.
+  //! with the object it belongs to. Has no effect on queries until
+  //! @ref refit() is called.
+  void setTriangle(size_t i, const vec3f& a, const vec3f& b, const vec3f& c);
+
+  //! Update the bounds of the hierarchy to moved triangles, keeping its
+  //! structure. Much faster than @ref build(), but queries slow down as the
+  //! triangles move farther from where the hierarchy was built.
+  void refit();
+
+  size_t numTriangles() const { return triangles_.size(); }
+
+  //! Object id of a triangle index returned by a query
+  uint32_t objectId(int triangle) const { return objectIds_[triangle]; }
+
+  //! Closest hit of the ray origin + t * direction with t in [tMin, tMax)
+  RayHit intersect(const vec3f& origin,
+                   const vec3f& direction,
+                   float tMin = 0.0f,
+                   float tMax = std::numeric_limits<float>::infinity()) const;
+
+  //! Closest hits of all rays of a packet
+  void intersect(const RayPacket& packet, PacketHit& hit) const;
+
+ protected:
+  struct Node {
+    vec3f min;
+    vec3f max;
+    // index of the left child (right child is next to it) or first triangle
+    uint32_t offset;
+    // number of triangles, 0 for inner nodes
+    uint32_t count;
+  };
+
+  // precomputed for Moeller-Trumbore: v0, v1 - v0, v2 - v0
+  struct Triangle {
+    vec3f v0;
+    vec3f e1;
+    vec3f e2;
+  };
+
+  void subdivide(uint32_t nodeIndex,
+                 int depth,
+                 std::vector<uint32_t>& order,
+                 const std::vector<box3f>& bounds,
+                 const std::vector<vec3f>& centroids);
+
+  bool cullBackFaces_;
+  std::vector<Triangle> triangles_;
+  std::vector<uint32_t> objectIds_;
+  std::vector<Node> nodes_;
+  // index into triangles_ of each triangle in the order they were added
+  std::vector<uint32_t> leafIndices_;
+
+  ESP_SMART_POINTERS(TriangleBVH)
+};
+
+}  // namespace geo
+}  // namespace esp
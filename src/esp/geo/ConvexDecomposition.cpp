@@ -0,0 +1,735 @@
+// Copyright (c) Facebook, Inc. and its affiliates.
+// This source code is licensed under the MIT license found in the
+// LICENSE file in the root directory of this source tree.
+
+#include "ConvexDecomposition.h"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <queue>
+#include <unordered_map>
+#include <utility>
+
+namespace esp {
+namespace geo {
+
+namespace {
+
+// Triangle of a hull under construction, counter-clockwise seen from outside,
+// with the points outside of it that are not yet enclosed
+struct HullFace {
+  uint32_t v[3];
+  vec3d normal;
+  double offset;
+  std::vector<uint32_t> outside;
+  uint32_t farthest = 0;
+  double farthestDistance = 0.0;
+  bool removed = false;
+};
+
+class QuickHull {
+ public:
+  explicit QuickHull(const std::vector<vec3d>& points) : points_(points) {}
+
+  //! Returns false if the points do not span a volume
+  bool build(size_t maxVertices);
+
+  std::vector<uint32_t> vertices() const;
+  double volume() const;
+
+ private:
+  static uint64_t edgeKey(uint32_t a, uint32_t b) {
+    return (uint64_t(a) << 32) | b;
+  }
+
+  double distance(const HullFace& face, uint32_t p) const {
+    return face.normal.dot(points_[p]) - face.offset;
+  }
+
+  uint32_t addFace(uint32_t a, uint32_t b, uint32_t c);
+
+  // give each point to the face among faces it is farthest outside of
+  void assign(const std::vector<uint32_t>& candidates,
+              const std::vector<uint32_t>& faces);
+
+  const std::vector<vec3d>& points_;
+  std::vector<HullFace> faces_;
+  // faces with outside points, by the distance of the farthest one. Faces
+  // are assigned points only once, so entries only go stale by removal.
+  std::priority_queue<std::pair<double, uint32_t>> farthest_;
+  // iteration in which each face was last found visible
+  std::vector<size_t> visibleIn_;
+  // directed edge -> face it belongs to
+  std::unordered_map<uint64_t, uint32_t> edges_;
+  // a point inside of every hull of the construction
+  vec3d interior_;
+  double epsilon_ = 0.0;
+};
+
+uint32_t QuickHull::addFace(uint32_t a, uint32_t b, uint32_t c) {
+  HullFace face;
+  face.normal = (points_[b] - points_[a]).cross(points_[c] - points_[a]);
+  if (face.normal.dot(interior_ - points_[a]) > 0.0) {
+    std::swap(b, c);
+    face.normal = -face.normal;
+  }
+  const double norm = face.normal.norm();
+  if (norm > 0.0) {
+    face.normal /= norm;
+  }
+  face.offset = face.normal.dot(points_[a]);
+  face.v[0] = a;
+  face.v[1] = b;
+  face.v[2] = c;
+  const uint32_t id = faces_.size();
+  for (int i = 0; i < 3; ++i) {
+    edges_[edgeKey(face.v[i], face.v[(i + 1) % 3])] = id;
+  }
+  faces_.emplace_back(std::move(face));
+  return id;
+}
+
+void QuickHull::assign(const std::vector<uint32_t>& candidates,
+                       const std::vector<uint32_t>& faces) {
+  for (const uint32_t p : candidates) {
+    double best = epsilon_;
+    HullFace* bestFace = nullptr;
+    for (const uint32_t f : faces) {
+      const double d = distance(faces_[f], p);
+      if (d > best) {
+        best = d;
+        bestFace = &faces_[f];
+      }
+    }
+    if (bestFace != nullptr) {
+      bestFace->outside.push_back(p);
+      if (best > bestFace->farthestDistance) {
+        bestFace->farthestDistance = best;
+        bestFace->farthest = p;
+      }
+    }
+  }
+  for (const uint32_t f : faces) {
+    if (!faces_[f].outside.empty()) {
+      farthest_.emplace(faces_[f].farthestDistance, f);
+    }
+  }
+}
+
+bool QuickHull::build(size_t maxVertices) {
+  const uint32_t numPoints = points_.size();
+  if (numPoints < 4) {
+    return false;
+  }
+
+  // initial tetrahedron from the extreme points
+  uint32_t extremes[6] = {0, 0, 0, 0, 0, 0};
+  for (uint32_t p = 0; p < numPoints; ++p) {
+    for (int axis = 0; axis < 3; ++axis) {
+      if (points_[p][axis] < points_[extremes[2 * axis]][axis]) {
+        extremes[2 * axis] = p;
+      }
+      if (points_[p][axis] > points_[extremes[2 * axis + 1]][axis]) {
+        extremes[2 * axis + 1] = p;
+      }
+    }
+  }
+  double extent = 0.0;
+  uint32_t v0 = 0;
+  uint32_t v1 = 0;
+  for (int i = 0; i < 6; ++i) {
+    for (int j = i + 1; j < 6; ++j) {
+      const double d = (points_[extremes[i]] - points_[extremes[j]]).norm();
+      if (d > extent) {
+        extent = d;
+        v0 = extremes[i];
+        v1 = extremes[j];
+      }
+    }
+  }
+  epsilon_ = 1e-9 * extent;
+  if (extent <= 0.0) {
+    return false;
+  }
+
+  const vec3d axis = (points_[v1] - points_[v0]) / extent;
+  double lineDistance = epsilon_;
+  uint32_t v2 = v0;
+  for (uint32_t p = 0; p < numPoints; ++p) {
+    const vec3d offset = points_[p] - points_[v0];
+    const double d = (offset - offset.dot(axis) * axis).norm();
+    if (d > lineDistance) {
+      lineDistance = d;
+      v2 = p;
+    }
+  }
+  if (v2 == v0) {
+    return false;
+  }
+  const vec3d normal =
+      (points_[v1] - points_[v0]).cross(points_[v2] - points_[v0]).normalized();
+  double planeDistance = epsilon_;
+  uint32_t v3 = v0;
+  for (uint32_t p = 0; p < numPoints; ++p) {
+    const double d = std::abs(normal.dot(points_[p] - points_[v0]));
+    if (d > planeDistance) {
+      planeDistance = d;
+      v3 = p;
+    }
+  }
+  if (v3 == v0) {
+    return false;
+  }
+
+  interior_ = 0.25 * (points_[v0] + points_[v1] + points_[v2] + points_[v3]);
+  std::vector<uint32_t> newFaces{addFace(v0, v1, v2), addFace(v0, v1, v3),
+                                 addFace(v0, v2, v3), addFace(v1, v2, v3)};
+  std::vector<uint32_t> candidates;
+  for (uint32_t p = 0; p < numPoints; ++p) {
+    if (p != v0 && p != v1 && p != v2 && p != v3) {
+      candidates.push_back(p);
+    }
+  }
+  assign(candidates, newFaces);
+
+  std::vector<uint32_t> visible;
+  std::vector<std::pair<uint32_t, uint32_t>> horizon;
+  for (size_t numVertices = 4; numVertices < maxVertices; ++numVertices) {
+    // add the point farthest out next
+    while (!farthest_.empty() && faces_[farthest_.top().second].removed) {
+      farthest_.pop();
+    }
+    if (farthest_.empty()) {
+      break;
+    }
+    const uint32_t start = farthest_.top().second;
+    const uint32_t eye = faces_[start].farthest;
+
+    // faces the point sees, which are connected, and the edges around them
+    visibleIn_.resize(faces_.size(), 0);
+    auto isVisible = [&](uint32_t f) { return visibleIn_[f] == numVertices; };
+    visible.assign(1, start);
+    visibleIn_[start] = numVertices;
+    horizon.clear();
+    bool manifold = true;
+    for (size_t i = 0; i < visible.size() && manifold; ++i) {
+      const HullFace& face = faces_[visible[i]];
+      for (int j = 0; j < 3; ++j) {
+        const auto neighbor =
+            edges_.find(edgeKey(face.v[(j + 1) % 3], face.v[j]));
+        if (neighbor == edges_.end()) {
+          manifold = false;
+          break;
+        }
+        if (!isVisible(neighbor->second) &&
+            distance(faces_[neighbor->second], eye) > epsilon_) {
+          visibleIn_[neighbor->second] = numVertices;
+          visible.push_back(neighbor->second);
+        }
+      }
+    }
+    if (!manifold) {
+      // lost to rounding, keep the hull so far
+      break;
+    }
+    for (const uint32_t f : visible) {
+      const HullFace& face = faces_[f];
+      for (int j = 0; j < 3; ++j) {
+        const uint32_t a = face.v[j];
+        const uint32_t b = face.v[(j + 1) % 3];
+        if (!isVisible(edges_.at(edgeKey(b, a)))) {
+          horizon.emplace_back(a, b);
+        }
+      }
+    }
+
+    candidates.clear();
+    for (const uint32_t f : visible) {
+      HullFace& face = faces_[f];
+      for (const uint32_t p : face.outside) {
+        if (p != eye) {
+          candidates.push_back(p);
+        }
+      }
+      face.outside = {};
+      face.removed = true;
+      for (int j = 0; j < 3; ++j) {
+        edges_.erase(edgeKey(face.v[j], face.v[(j + 1) % 3]));
+      }
+    }
+    newFaces.clear();
+    for (const auto& edge : horizon) {
+      newFaces.push_back(addFace(edge.first, edge.second, eye));
+    }
+    assign(candidates, newFaces);
+  }
+  return true;
+}
+
+std::vector<uint32_t> QuickHull::vertices() const {
+  std::vector<uint32_t> vertices;
+  for (const HullFace& face : faces_) {
+    if (!face.removed) {
+      vertices.insert(vertices.end(), face.v, face.v + 3);
+    }
+  }
+  std::sort(vertices.begin(), vertices.end());
+  vertices.erase(std::unique(vertices.begin(), vertices.end()),
+                 vertices.end());
+  return vertices;
+}
+
+double QuickHull::volume() const {
+  double volume = 0.0;
+  for (const HullFace& face : faces_) {
+    if (!face.removed) {
+      const vec3d a = points_[face.v[0]] - interior_;
+      const vec3d b = points_[face.v[1]] - interior_;
+      const vec3d c = points_[face.v[2]] - interior_;
+      volume += a.dot(b.cross(c));
+    }
+  }
+  return volume / 6.0;
+}
+
+// Clip a convex polygon to the half space sign * (p[axis] - bound) <= 0
+void clipPolygon(std::vector<vec3f>& polygon,
+                 std::vector<vec3f>& clipped,
+                 int axis,
+                 float bound,
+                 float sign) {
+  clipped.clear();
+  for (size_t i = 0; i < polygon.size(); ++i) {
+    const vec3f& a = polygon[i];
+    const vec3f& b = polygon[(i + 1) % polygon.size()];
+    const float da = sign * (a[axis] - bound);
+    const float db = sign * (b[axis] - bound);
+    if (da <= 0.0f) {
+      clipped.push_back(a);
+    }
+    if ((da < 0.0f && db > 0.0f) || (da > 0.0f && db < 0.0f)) {
+      vec3f crossing = a + (b - a) * (da / (da - db));
+      // exactly on the bound, whatever the rounding
+      crossing[axis] = bound;
+      clipped.push_back(crossing);
+    }
+  }
+  std::swap(polygon, clipped);
+}
+
+// Solid voxels of a triangle mesh, split into parts that are close to convex
+class ConvexDecomposer {
+ public:
+  ConvexDecomposer(const std::vector<vec3f>& positions,
+                   const std::vector<uint32_t>& indices,
+                   const ConvexDecompositionSettings& settings);
+
+  std::vector<std::vector<vec3f>> decompose();
+
+ private:
+  struct Part {
+    std::vector<uint32_t> cells;
+    double hullVolume;
+    double concavity;
+  };
+
+  int cellIndex(int x, int y, int z) const {
+    return (z * dims_[1] + y) * dims_[0] + x;
+  }
+  vec3i cellCoordinates(uint32_t cell) const {
+    return vec3i(cell % dims_[0], (cell / dims_[0]) % dims_[1],
+                 cell / (dims_[0] * dims_[1]));
+  }
+
+  // mark the cells the surface passes through and keep the pieces of the
+  // surface within them
+  void voxelizeSurface(const std::vector<vec3f>& positions,
+                       const std::vector<uint32_t>& indices);
+  // mark the cells reachable from the border without crossing the surface
+  void fillExterior();
+
+  // corners of the cells that can be on their convex hull
+  std::vector<vec3f> cellCorners(const std::vector<uint32_t>& cells);
+  Part evaluate(std::vector<uint32_t> cells);
+  std::vector<std::vector<uint32_t>> connectedComponents(
+      const std::vector<uint32_t>& cells);
+  // split at the plane with the least empty space in the hulls of both sides
+  bool split(const Part& part,
+             std::vector<uint32_t>& left,
+             std::vector<uint32_t>& right);
+  std::vector<vec3f> partHull(const Part& part);
+
+  enum : uint8_t { Inside = 0, Surface = 1, Outside = 2 };
+
+  ConvexDecompositionSettings settings_;
+  vec3f origin_;
+  float cellSize_ = 0.0f;
+  int dims_[3] = {0, 0, 0};
+  std::vector<uint8_t> state_;
+  // surface points, grouped by cell in compressed rows
+  std::vector<vec3f> surfacePoints_;
+  std::vector<uint32_t> surfaceOffsets_;
+  // scratch marks, valid where equal to stamp_
+  std::vector<uint32_t> inSet_;
+  std::vector<uint32_t> visited_;
+  uint32_t stamp_ = 0;
+};
+
+ConvexDecomposer::ConvexDecomposer(const std::vector<vec3f>& positions,
+                                   const std::vector<uint32_t>& indices,
+                                   const ConvexDecompositionSettings& settings)
+    : settings_(settings) {
+  vec3f min = positions[indices[0]];
+  vec3f max = min;
+  for (const uint32_t v : indices) {
+    min = min.cwiseMin(positions[v]);
+    max = max.cwiseMax(positions[v]);
+  }
+  const vec3f extent = max - min;
+  cellSize_ = extent.maxCoeff() / std::max(settings.resolution, 1);
+  if (!(cellSize_ > 0.0f)) {
+    return;
+  }
+  // one cell of border around the mesh, for the exterior fill
+  origin_ = min - vec3f::Constant(cellSize_);
+  for (int axis = 0; axis < 3; ++axis) {
+    dims_[axis] = static_cast<int>(extent[axis] / cellSize_) + 3;
+  }
+  const size_t numCells = size_t(dims_[0]) * dims_[1] * dims_[2];
+  state_.assign(numCells, Inside);
+  inSet_.assign(numCells, 0);
+  visited_.assign(numCells, 0);
+
+  voxelizeSurface(positions, indices);
+  fillExterior();
+}
+
+void ConvexDecomposer::voxelizeSurface(const std::vector<vec3f>& positions,
+                                       const std::vector<uint32_t>& indices) {
+  std::vector<std::pair<uint32_t, vec3f>> pieces;
+  std::vector<vec3f> polygon;
+  std::vector<vec3f> clipped;
+  for (size_t t = 0; t + 2 < indices.size(); t += 3) {
+    const vec3f& a = positions[indices[t]];
+    const vec3f& b = positions[indices[t + 1]];
+    const vec3f& c = positions[indices[t + 2]];
+    vec3i lo;
+    vec3i hi;
+    for (int axis = 0; axis < 3; ++axis) {
+      const float tMin = std::min({a[axis], b[axis], c[axis]});
+      const float tMax = std::max({a[axis], b[axis], c[axis]});
+      lo[axis] = std::max(
+          1, static_cast<int>((tMin - origin_[axis]) / cellSize_));
+      hi[axis] = std::min(dims_[axis] - 2,
+                          static_cast<int>((tMax - origin_[axis]) / cellSize_));
+    }
+    for (int z = lo[2]; z <= hi[2]; ++z) {
+      for (int y = lo[1]; y <= hi[1]; ++y) {
+        for (int x = lo[0]; x <= hi[0]; ++x) {
+          const vec3f cellMin = origin_ + cellSize_ * vec3f(x, y, z);
+          polygon.assign({a, b, c});
+          for (int axis = 0; axis < 3 && !polygon.empty(); ++axis) {
+            clipPolygon(polygon, clipped, axis, cellMin[axis], -1.0f);
+            clipPolygon(polygon, clipped, axis, cellMin[axis] + cellSize_,
+                        1.0f);
+          }
+          if (polygon.empty()) {
+            continue;
+          }
+          const uint32_t cell = cellIndex(x, y, z);
+          state_[cell] = Surface;
+          for (const vec3f& p : polygon) {
+            pieces.emplace_back(cell, p);
+          }
+        }
+      }
+    }
+  }
+
+  surfaceOffsets_.assign(state_.size() + 1, 0);
+  for (const auto& piece : pieces) {
+    ++surfaceOffsets_[piece.first + 1];
+  }
+  for (size_t i = 1; i < surfaceOffsets_.size(); ++i) {
+    surfaceOffsets_[i] += surfaceOffsets_[i - 1];
+  }
+  surfacePoints_.resize(pieces.size());
+  std::vector<uint32_t> fill(surfaceOffsets_.begin(),
+                             surfaceOffsets_.end() - 1);
+  for (const auto& piece : pieces) {
+    surfacePoints_[fill[piece.first]++] = piece.second;
+  }
+}
+
+void ConvexDecomposer::fillExterior() {
+  std::vector<uint32_t> queue{0};
+  state_[0] = Outside;
+  for (size_t i = 0; i < queue.size(); ++i) {
+    const vec3i p = cellCoordinates(queue[i]);
+    for (int axis = 0; axis < 3; ++axis) {
+      for (const int step : {-1, 1}) {
+        vec3i q = p;
+        q[axis] += step;
+        if (q[axis] < 0 || q[axis] >= dims_[axis]) {
+          continue;
+        }
+        const uint32_t cell = cellIndex(q[0], q[1], q[2]);
+        if (state_[cell] == Inside) {
+          state_[cell] = Outside;
+          queue.push_back(cell);
+        }
+      }
+    }
+  }
+}
+
+std::vector<vec3f> ConvexDecomposer::cellCorners(
+    const std::vector<uint32_t>& cells) {
+  // only the lowest and highest cell of each column along z matter
+  std::unordered_map<uint32_t, std::pair<int, int>> columns;
+  for (const uint32_t cell : cells) {
+    const vec3i p = cellCoordinates(cell);
+    const uint32_t column = p[1] * dims_[0] + p[0];
+    auto inserted = columns.emplace(column, std::make_pair(p[2], p[2]));
+    if (!inserted.second) {
+      inserted.first->second.first =
+          std::min(inserted.first->second.first, p[2]);
+      inserted.first->second.second =
+          std::max(inserted.first->second.second, p[2]);
+    }
+  }
+  std::vector<vec3f> corners;
+  corners.reserve(8 * columns.size());
+  for (const auto& column : columns) {
+    const int x = column.first % dims_[0];
+    const int y = column.first / dims_[0];
+    for (const int z : {column.second.first, column.second.second + 1}) {
+      for (int dy = 0; dy < 2; ++dy) {
+        for (int dx = 0; dx < 2; ++dx) {
+          corners.emplace_back(origin_ + cellSize_ * vec3f(x + dx, y + dy, z));
+        }
+      }
+    }
+  }
+  return corners;
+}
+
+ConvexDecomposer::Part ConvexDecomposer::evaluate(
+    std::vector<uint32_t> cells) {
+  Part part;
+  part.cells = std::move(cells);
+  float hullVolume = 0.0f;
+  convexHull(cellCorners(part.cells), SIZE_MAX, &hullVolume);
+  const double cellsVolume =
+      part.cells.size() * double(cellSize_) * cellSize_ * cellSize_;
+  part.hullVolume = std::max<double>(hullVolume, cellsVolume);
+  part.concavity = (part.hullVolume - cellsVolume) / part.hullVolume;
+  return part;
+}
+
+std::vector<std::vector<uint32_t>> ConvexDecomposer::connectedComponents(
+    const std::vector<uint32_t>& cells) {
+  ++stamp_;
+  for (const uint32_t cell : cells) {
+    inSet_[cell] = stamp_;
+  }
+  std::vector<std::vector<uint32_t>> components;
+  for (const uint32_t seed : cells) {
+    if (visited_[seed] == stamp_) {
+      continue;
+    }
+    visited_[seed] = stamp_;
+    std::vector<uint32_t> component{seed};
+    for (size_t i = 0; i < component.size(); ++i) {
+      const vec3i p = cellCoordinates(component[i]);
+      for (int axis = 0; axis < 3; ++axis) {
+        for (const int step : {-1, 1}) {
+          // cells in parts are never on the border of the grid
+          vec3i q = p;
+          q[axis] += step;
+          const uint32_t cell = cellIndex(q[0], q[1], q[2]);
+          if (inSet_[cell] == stamp_ && visited_[cell] != stamp_) {
+            visited_[cell] = stamp_;
+            component.push_back(cell);
+          }
+        }
+      }
+    }
+    components.emplace_back(std::move(component));
+  }
+  return components;
+}
+
+bool ConvexDecomposer::split(const Part& part,
+                             std::vector<uint32_t>& left,
+                             std::vector<uint32_t>& right) {
+  vec3i lo = vec3i::Constant(std::numeric_limits<int>::max());
+  vec3i hi = vec3i::Constant(std::numeric_limits<int>::min());
+  for (const uint32_t cell : part.cells) {
+    const vec3i p = cellCoordinates(cell);
+    lo = lo.cwiseMin(p);
+    hi = hi.cwiseMax(p);
+  }
+
+  // a few evenly spaced planes between cells along each axis
+  constexpr int kPlanesPerAxis = 7;
+  double bestCost = std::numeric_limits<double>::infinity();
+  int bestAxis = -1;
+  int bestPlane = 0;
+  std::vector<uint32_t> sides[2];
+  for (int axis = 0; axis < 3; ++axis) {
+    const int numPlanes = hi[axis] - lo[axis];
+    int lastPlane = lo[axis];
+    for (int i = 0; i < std::min(numPlanes, kPlanesPerAxis); ++i) {
+      const int plane =
+          lo[axis] + 1 +
+          (numPlanes <= kPlanesPerAxis
+               ? i
+               : i * (numPlanes - 1) / (kPlanesPerAxis - 1));
+      if (plane == lastPlane) {
+        continue;
+      }
+      lastPlane = plane;
+      sides[0].clear();
+      sides[1].clear();
+      for (const uint32_t cell : part.cells) {
+        sides[cellCoordinates(cell)[axis] >= plane].push_back(cell);
+      }
+      double cost = 0.0;
+      for (const auto& side : sides) {
+        const Part half = evaluate(side);
+        cost += half.hullVolume * half.concavity;
+      }
+      if (cost < bestCost) {
+        bestCost = cost;
+        bestAxis = axis;
+        bestPlane = plane;
+      }
+    }
+  }
+  if (bestAxis < 0) {
+    return false;
+  }
+  left.clear();
+  right.clear();
+  for (const uint32_t cell : part.cells) {
+    (cellCoordinates(cell)[bestAxis] < bestPlane ? left : right)
+        .push_back(cell);
+  }
+  return true;
+}
+
+std::vector<vec3f> ConvexDecomposer::partHull(const Part& part) {
+  std::vector<vec3f> points;
+  for (const uint32_t cell : part.cells) {
+    points.insert(points.end(),
+                  surfacePoints_.begin() + surfaceOffsets_[cell],
+                  surfacePoints_.begin() + surfaceOffsets_[cell + 1]);
+  }
+  const size_t maxVertices = std::max(settings_.maxHullVertices, 4);
+  std::vector<vec3f> hull = convexHull(points, maxVertices);
+  if (hull.empty()) {
+    // the surface within the part is flat, or the part is all inside
+    hull = convexHull(cellCorners(part.cells), maxVertices);
+  }
+  return hull;
+}
+
+std::vector<std::vector<vec3f>> ConvexDecomposer::decompose() {
+  std::vector<std::vector<vec3f>> hulls;
+  if (!(cellSize_ > 0.0f)) {
+    return hulls;
+  }
+  std::vector<uint32_t> solid;
+  for (uint32_t cell = 0; cell < state_.size(); ++cell) {
+    if (state_[cell] != Outside) {
+      solid.push_back(cell);
+    }
+  }
+
+  // most concave part first
+  std::vector<Part> parts;
+  auto moreConcave = [&parts](size_t a, size_t b) {
+    return parts[a].concavity < parts[b].concavity;
+  };
+  std::priority_queue<size_t, std::vector<size_t>, decltype(moreConcave)>
+      pending(moreConcave);
+  for (auto& component : connectedComponents(solid)) {
+    parts.emplace_back(evaluate(std::move(component)));
+    pending.push(parts.size() - 1);
+  }
+
+  std::vector<uint32_t> left;
+  std::vector<uint32_t> right;
+  while (!pending.empty()) {
+    const size_t id = pending.top();
+    pending.pop();
+    const size_t numParts = hulls.size() + pending.size() + 1;
+    bool accept = parts[id].concavity <= settings_.maxConcavity ||
+                  numParts >= size_t(settings_.maxHulls) ||
+                  !split(parts[id], left, right);
+    std::vector<std::vector<uint32_t>> components;
+    if (!accept) {
+      components = connectedComponents(left);
+      for (auto& component : connectedComponents(right)) {
+        components.emplace_back(std::move(component));
+      }
+      accept = numParts - 1 + components.size() > size_t(settings_.maxHulls);
+    }
+    if (accept) {
+      std::vector<vec3f> hull = partHull(parts[id]);
+      if (!hull.empty()) {
+        hulls.emplace_back(std::move(hull));
+      }
+      continue;
+    }
+    parts[id].cells = {};
+    for (auto& component : components) {
+      parts.emplace_back(evaluate(std::move(component)));
+      pending.push(parts.size() - 1);
+    }
+  }
+  return hulls;
+}
+
+}  // namespace
+
+std::vector<vec3f> convexHull(const std::vector<vec3f>& points,
+                              size_t maxVertices /* = SIZE_MAX */,
+                              float* volume /* = nullptr */) {
+  std::vector<vec3d> pointsd;
+  pointsd.reserve(points.size());
+  for (const vec3f& p : points) {
+    pointsd.emplace_back(p.cast<double>());
+  }
+  QuickHull hull(pointsd);
+  std::vector<vec3f> vertices;
+  if (!hull.build(std::max<size_t>(maxVertices, 4))) {
+    if (volume != nullptr) {
+      *volume = 0.0f;
+    }
+    return vertices;
+  }
+  for (const uint32_t v : hull.vertices()) {
+    vertices.push_back(points[v]);
+  }
+  if (volume != nullptr) {
+    *volume = hull.volume();
+  }
+  return vertices;
+}
+
+std::vector<std::vector<vec3f>> decomposeConvex(
+    const std::vector<vec3f>& positions,
+    const std::vector<uint32_t>& indices,
+    const ConvexDecompositionSettings& settings /* = {} */) {
+  ASSERT(indices.size() % 3 == 0);
+  if (indices.empty()) {
+    return {};
+  }
+  return ConvexDecomposer{positions, indices, settings}.decompose();
+}
+
+}  // namespace geo
+}  // namespace esp
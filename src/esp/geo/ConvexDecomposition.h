@@ -0,0 +1,64 @@
+// Copyright (c) Facebook, Inc. and its affiliates.
+// This source code is licensed under the MIT license found in the
+// LICENSE file in the root directory of this source tree.
+
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+#include "esp/core/esp.h"
+
+namespace esp {
+namespace geo {
+
+/**
+ * @brief Convex hull of a point set, with quickhull.
+ *
+ * Points are added farthest first, so stopping at maxVertices gives a hull
+ * inside the full one that is close to it.
+ *
+ * @param points Points to enclose
+ * @param maxVertices Largest number of hull vertices, at least 4
+ * @param[out] volume If not null, receives the volume of the hull
+ * @return Vertices of the hull, empty if the points are all in one plane
+ */
+std::vector<vec3f> convexHull(const std::vector<vec3f>& points,
+                              size_t maxVertices = SIZE_MAX,
+                              float* volume = nullptr);
+
+struct ConvexDecompositionSettings {
+  //! Number of voxels along the longest side of the mesh bounds
+  int resolution = 32;
+  //! Largest fraction of the volume of a hull that may lie outside of the
+  //! mesh before its part is split further
+  float maxConcavity = 0.05f;
+  //! Largest number of hulls
+  int maxHulls = 16;
+  //! Largest number of vertices per hull
+  int maxHullVertices = 32;
+};
+
+/**
+ * @brief Approximate a triangle mesh by a few convex hulls.
+ *
+ * The mesh is voxelized, with everything not reachable from outside of it
+ * counting as inside, so small holes do not matter. Parts of the voxels are
+ * split at the axis aligned plane that leaves the least empty space in the
+ * hulls of both sides, most concave part first, until every part is close
+ * enough to its hull or maxHulls parts exist. The hull of each part is then
+ * taken over the mesh surface within it.
+ *
+ * @param positions Vertex positions
+ * @param indices Triangle list indices
+ * @param settings Resolution and limits of the decomposition
+ * @return Vertices of each hull
+ */
+std::vector<std::vector<vec3f>> decomposeConvex(
+    const std::vector<vec3f>& positions,
+    const std::vector<uint32_t>& indices,
+    const ConvexDecompositionSettings& settings =
+        ConvexDecompositionSettings{});
+
+}  // namespace geo
+}  // namespace esp
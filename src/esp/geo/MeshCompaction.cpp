@@ -0,0 +1,240 @@
+// Copyright (c) Facebook, Inc. and its affiliates.
+// This source code is licensed under the MIT license found in the
+// LICENSE file in the root directory of this source tree.
+
+#include "MeshCompaction.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <limits>
+#include <numeric>
+#include <unordered_map>
+
+namespace esp {
+namespace geo {
+
+namespace {
+
+constexpr uint32_t kNoVertex = std::numeric_limits<uint32_t>::max();
+
+// vertices are compared bitwise, padding included, which is always zero
+struct CompactVertexHash {
+  size_t operator()(const CompactVertex& vertex) const {
+    uint64_t position;
+    uint32_t color;
+    std::memcpy(&position, vertex.position, sizeof(position));
+    std::memcpy(&color, vertex.color, sizeof(color));
+    return std::hash<uint64_t>()(position * 0x9e3779b97f4a7c15ull ^ color);
+  }
+};
+
+struct CompactVertexEqual {
+  bool operator()(const CompactVertex& a, const CompactVertex& b) const {
+    return std::memcmp(&a, &b, sizeof(CompactVertex)) == 0;
+  }
+};
+
+int16_t quantize(float x, float offset, float scale) {
+  const float q = std::round((x - offset) / scale * kPositionQuantizationMax);
+  return static_cast<int16_t>(
+      std::max(-float(kPositionQuantizationMax),
+               std::min(float(kPositionQuantizationMax), q)));
+}
+
+// Tipsify: fan out triangles around one vertex at a time, moving on to a
+// neighbor that is still in the cache, else to a recently used vertex with
+// triangles left, else to the next such vertex in index order. Returns the
+// triangles in the order they are emitted.
+std::vector<uint32_t> tipsify(const std::vector<uint32_t>& indices,
+                              size_t numVertices,
+                              int cacheSize) {
+  const size_t numTriangles = indices.size() / 3;
+
+  // triangles of each vertex, in compressed rows
+  std::vector<uint32_t> offsets(numVertices + 1, 0);
+  for (const uint32_t v : indices) {
+    ++offsets[v + 1];
+  }
+  std::partial_sum(offsets.begin(), offsets.end(), offsets.begin());
+  std::vector<uint32_t> vertexTriangles(indices.size());
+  std::vector<uint32_t> fill(offsets.begin(), offsets.end() - 1);
+  for (size_t i = 0; i < indices.size(); ++i) {
+    vertexTriangles[fill[indices[i]]++] = i / 3;
+  }
+
+  // number of triangles left to emit per vertex
+  std::vector<int> live(numVertices);
+  for (size_t v = 0; v < numVertices; ++v) {
+    live[v] = offsets[v + 1] - offsets[v];
+  }
+  // time each vertex entered the simulated FIFO cache
+  std::vector<int> cacheTime(numVertices, 0);
+  int time = cacheSize + 1;
+  std::vector<bool> emitted(numTriangles, false);
+  std::vector<uint32_t> deadEnd;
+  std::vector<uint32_t> candidates;
+  std::vector<uint32_t> order;
+  order.reserve(numTriangles);
+
+  size_t cursor = 1;
+  uint32_t fanning = numVertices > 0 ? 0 : kNoVertex;
+  while (fanning != kNoVertex) {
+    candidates.clear();
+    for (uint32_t k = offsets[fanning]; k < offsets[fanning + 1]; ++k) {
+      const uint32_t t = vertexTriangles[k];
+      if (emitted[t]) {
+        continue;
+      }
+      emitted[t] = true;
+      order.push_back(t);
+      for (int j = 0; j < 3; ++j) {
+        const uint32_t v = indices[3 * t + j];
+        deadEnd.push_back(v);
+        candidates.push_back(v);
+        --live[v];
+        if (time - cacheTime[v] > cacheSize) {
+          cacheTime[v] = time++;
+        }
+      }
+    }
+
+    // prefer the candidate that stays in the cache the longest while all of
+    // its triangles are emitted
+    uint32_t next = kNoVertex;
+    int bestPriority = -1;
+    for (const uint32_t v : candidates) {
+      if (live[v] <= 0) {
+        continue;
+      }
+      int priority = 0;
+      if (time - cacheTime[v] + 2 * live[v] <= cacheSize) {
+        priority = time - cacheTime[v];
+      }
+      if (priority > bestPriority) {
+        bestPriority = priority;
+        next = v;
+      }
+    }
+    while (next == kNoVertex && !deadEnd.empty()) {
+      const uint32_t v = deadEnd.back();
+      deadEnd.pop_back();
+      if (live[v] > 0) {
+        next = v;
+      }
+    }
+    for (; next == kNoVertex && cursor < numVertices; ++cursor) {
+      if (live[cursor] > 0) {
+        next = cursor;
+      }
+    }
+    fanning = next;
+  }
+  return order;
+}
+
+}  // namespace
+
+CompactMesh compactMesh(Corrade::Containers::ArrayView<const vec3f> positions,
+                        Corrade::Containers::ArrayView<const vec3uc> colors,
+                        Corrade::Containers::ArrayView<const uint32_t> indices,
+                        int cacheSize /* = 16 */,
+                        uint32_t maxChunkVertices /* = kMaxChunkVertices */) {
+  ASSERT(positions.size() == colors.size());
+  ASSERT(indices.size() % 3 == 0);
+  ASSERT(maxChunkVertices >= 3 && maxChunkVertices <= kMaxChunkVertices);
+  CompactMesh mesh;
+
+  // quantize within the bounds of the vertices in use
+  if (!indices.empty()) {
+    vec3f min = positions[indices[0]];
+    vec3f max = min;
+    for (const uint32_t v : indices) {
+      ASSERT(v < positions.size());
+      min = min.cwiseMin(positions[v]);
+      max = max.cwiseMax(positions[v]);
+    }
+    mesh.positionOffset = 0.5f * (min + max);
+    mesh.positionScale = 0.5f * (max - min);
+    for (int i = 0; i < 3; ++i) {
+      if (!(mesh.positionScale[i] > 0.0f)) {
+        mesh.positionScale[i] = 1.0f;
+      }
+    }
+  }
+
+  // merge vertices that are equal once quantized
+  std::vector<CompactVertex> unique;
+  std::unordered_map<CompactVertex, uint32_t, CompactVertexHash,
+                     CompactVertexEqual>
+      uniqueIds;
+  std::vector<uint32_t> remap(positions.size(), kNoVertex);
+  std::vector<uint32_t> merged(indices.size());
+  for (size_t i = 0; i < indices.size(); ++i) {
+    const uint32_t v = indices[i];
+    if (remap[v] == kNoVertex) {
+      CompactVertex vertex{};
+      for (int j = 0; j < 3; ++j) {
+        vertex.position[j] = quantize(positions[v][j], mesh.positionOffset[j],
+                                      mesh.positionScale[j]);
+        vertex.color[j] = colors[v][j];
+      }
+      const auto inserted = uniqueIds.emplace(vertex, unique.size());
+      if (inserted.second) {
+        unique.push_back(vertex);
+      }
+      remap[v] = inserted.first->second;
+    }
+    merged[i] = remap[v];
+  }
+
+  // reorder the triangles, then the vertices of each chunk by first use. A
+  // triangle that would take its chunk over maxChunkVertices starts the next.
+  mesh.triangles = tipsify(merged, unique.size(), cacheSize);
+  mesh.indices.reserve(indices.size());
+  // index of each vertex in the chunk that last used it
+  std::vector<uint32_t> chunkIds(unique.size());
+  std::vector<uint32_t> lastChunk(unique.size(), kNoVertex);
+  CompactMeshChunk chunk;
+  for (const uint32_t t : mesh.triangles) {
+    // vertices repeated in a degenerate triangle count once
+    const uint32_t* triangle = &merged[3 * t];
+    const uint32_t chunkIndex = mesh.chunks.size();
+    const uint32_t newVertices =
+        (lastChunk[triangle[0]] != chunkIndex) +
+        (lastChunk[triangle[1]] != chunkIndex && triangle[1] != triangle[0]) +
+        (lastChunk[triangle[2]] != chunkIndex && triangle[2] != triangle[0] &&
+         triangle[2] != triangle[1]);
+    if (chunk.numVertices + newVertices > maxChunkVertices) {
+      mesh.chunks.push_back(chunk);
+      chunk.firstVertex = mesh.vertices.size();
+      chunk.numVertices = 0;
+      chunk.firstTriangle += chunk.numTriangles;
+      chunk.numTriangles = 0;
+    }
+    for (int j = 0; j < 3; ++j) {
+      const uint32_t v = triangle[j];
+      if (lastChunk[v] != mesh.chunks.size()) {
+        lastChunk[v] = mesh.chunks.size();
+        chunkIds[v] = chunk.numVertices++;
+        mesh.vertices.push_back(unique[v]);
+      }
+      mesh.indices.push_back(chunkIds[v]);
+    }
+    ++chunk.numTriangles;
+  }
+  if (chunk.numTriangles > 0) {
+    mesh.chunks.push_back(chunk);
+  }
+  return mesh;
+}
+
+vec3f decodePosition(const CompactMesh& mesh, const CompactVertex& vertex) {
+  const vec3f normalized =
+      vec3f(vertex.position[0], vertex.position[1], vertex.position[2]) /
+      kPositionQuantizationMax;
+  return mesh.positionOffset + mesh.positionScale.cwiseProduct(normalized);
+}
+
+}  // namespace geo
+}  // namespace esp
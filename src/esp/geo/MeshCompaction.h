@@ -0,0 +1,100 @@
+// Copyright (c) Facebook, Inc. and its affiliates.
+// This source code is licensed under the MIT license found in the
+// LICENSE file in the root directory of this source tree.
+
+#pragma once
+
+#include <vector>
+
+#include <Corrade/Containers/ArrayView.h>
+
+#include "esp/core/esp.h"
+
+namespace esp {
+namespace geo {
+
+//! Largest value of a quantized position coordinate, which decodes to 1.0
+constexpr int kPositionQuantizationMax = 32767;
+
+//! Most vertices a @ref CompactMeshChunk addresses with 16 bit indices
+constexpr uint32_t kMaxChunkVertices = 65536;
+
+/**
+ * @brief Vertex of a @ref CompactMesh, 12 bytes instead of the 24 of float
+ * positions and colors.
+ *
+ * The position is quantized to normalized 16 bit integers within the bounds
+ * of the mesh, see @ref CompactMesh::positionScale, and the color is kept at
+ * 8 bits per channel. Both are padded to 4 bytes for vertex fetch.
+ */
+struct CompactVertex {
+  int16_t position[3];
+  int16_t positionPadding;
+  uint8_t color[3];
+  uint8_t colorPadding;
+};
+
+/**
+ * @brief Consecutive triangles of a @ref CompactMesh drawn with one draw call.
+ *
+ * The triangles only use the vertices of the chunk, so their indices are
+ * relative to firstVertex and fit in 16 bits.
+ */
+struct CompactMeshChunk {
+  uint32_t firstVertex = 0;
+  uint32_t numVertices = 0;
+  uint32_t firstTriangle = 0;
+  uint32_t numTriangles = 0;
+};
+
+//! Mesh as produced by @ref compactMesh()
+struct CompactMesh {
+  //! Vertices of each chunk in turn, in the order its triangles first use
+  //! them. Vertices used by several chunks are repeated in each.
+  std::vector<CompactVertex> vertices;
+  //! Triangle list indices, relative to the first vertex of the chunk of the
+  //! triangle
+  std::vector<uint16_t> indices;
+  //! Chunks covering the triangles in order
+  std::vector<CompactMeshChunk> chunks;
+  //! Original index of each triangle, in the compacted order
+  std::vector<uint32_t> triangles;
+  //! A position decodes to positionOffset + positionScale * q, where q is the
+  //! normalized position in [-1, 1]
+  vec3f positionScale = vec3f::Ones();
+  vec3f positionOffset = vec3f::Zero();
+};
+
+/**
+ * @brief Compact an indexed, colored triangle mesh for rendering.
+ *
+ * Positions are quantized to 16 bits per coordinate and vertices whose
+ * quantized position and color are equal are merged. The triangles are then
+ * reordered for the post-transform vertex cache with Tipsify (Sander, Nehab
+ * and Barczak, "Fast Triangle Reordering for Vertex Locality and Reduced
+ * Overdraw", 2007), and the vertices for the order the triangles fetch them.
+ * Vertices no triangle uses are dropped. Triangles are never removed, so
+ * per-triangle data can be permuted with @ref CompactMesh::triangles.
+ *
+ * The reordered triangles are split into chunks of at most maxChunkVertices
+ * vertices, so that even large meshes are drawn with 16 bit indices.
+ *
+ * @param positions Vertex positions
+ * @param colors Vertex colors, as many as positions
+ * @param indices Triangle list indices
+ * @param cacheSize Number of vertices the post-transform cache is assumed
+ * to hold
+ * @param maxChunkVertices Most vertices of a chunk, at least 3 and at most
+ * @ref kMaxChunkVertices
+ */
+CompactMesh compactMesh(Corrade::Containers::ArrayView<const vec3f> positions,
+                        Corrade::Containers::ArrayView<const vec3uc> colors,
+                        Corrade::Containers::ArrayView<const uint32_t> indices,
+                        int cacheSize = 16,
+                        uint32_t maxChunkVertices = kMaxChunkVertices);
+
+//! Decode the position of a compacted vertex
+vec3f decodePosition(const CompactMesh& mesh, const CompactVertex& vertex);
+
+}  // namespace geo
+}  // namespace esp
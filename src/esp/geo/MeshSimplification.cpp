@@ -0,0 +1,221 @@
+// Copyright (c) Facebook, Inc. and its affiliates.
+// This source code is licensed under the MIT license found in the
+// LICENSE file in the root directory of this source tree.
+
+#include "MeshSimplification.h"
+
+#include <algorithm>
+#include <cmath>
+#include <queue>
+#include <unordered_map>
+
+namespace esp {
+namespace geo {
+
+namespace {
+
+// Area weighted sum of squared distances to a set of planes, as a symmetric
+// 4x4 matrix, together with the sum of the weights
+struct Quadric {
+  Eigen::Matrix4d q = Eigen::Matrix4d::Zero();
+  double weight = 0.0;
+
+  Quadric& operator+=(const Quadric& other) {
+    q += other.q;
+    weight += other.weight;
+    return *this;
+  }
+};
+
+// mean squared distance of p to the planes of a and b
+double quadricError(const Quadric& a, const Quadric& b, const vec3f& p) {
+  const double weight = a.weight + b.weight;
+  if (weight <= 0.0) {
+    return 0.0;
+  }
+  const Eigen::Vector4d x(p[0], p[1], p[2], 1.0);
+  return std::max(x.dot((a.q + b.q) * x) / weight, 0.0);
+}
+
+// Collapse of vertex from into vertex to. The versions of both vertices at
+// the time the cost was computed detect entries made stale by later
+// collapses.
+struct Collapse {
+  double cost;
+  uint32_t from;
+  uint32_t to;
+  uint32_t fromVersion;
+  uint32_t toVersion;
+
+  bool operator>(const Collapse& other) const { return cost > other.cost; }
+};
+
+uint64_t edgeKey(uint32_t a, uint32_t b) {
+  return (uint64_t(std::min(a, b)) << 32) | std::max(a, b);
+}
+
+}  // namespace
+
+std::vector<uint32_t> simplifyMesh(const std::vector<vec3f>& positions,
+                                   const std::vector<uint32_t>& indices,
+                                   size_t targetNumIndices,
+                                   float* error /* = nullptr */) {
+  ASSERT(indices.size() % 3 == 0);
+  const size_t numVertices = positions.size();
+  const size_t numTriangles = indices.size() / 3;
+
+  std::vector<uint32_t> triangles = indices;
+  std::vector<bool> triangleRemoved(numTriangles, false);
+  std::vector<std::vector<uint32_t>> vertexTriangles(numVertices);
+  std::vector<Quadric> quadrics(numVertices);
+  std::unordered_map<uint64_t, int> edgeUses;
+
+  for (uint32_t t = 0; t < numTriangles; ++t) {
+    const uint32_t* v = &triangles[3 * t];
+    const vec3f cross = (positions[v[1]] - positions[v[0]])
+                            .cross(positions[v[2]] - positions[v[0]]);
+    const vec3f normal = cross.normalized();
+    if (!normal.allFinite()) {
+      // degenerate triangles do not constrain anything
+      for (int i = 0; i < 3; ++i) {
+        vertexTriangles[v[i]].push_back(t);
+      }
+      continue;
+    }
+    const Eigen::Vector4d plane(normal[0], normal[1], normal[2],
+                                -normal.dot(positions[v[0]]));
+    Quadric q;
+    q.weight = 0.5 * cross.norm();
+    q.q = q.weight * plane * plane.transpose();
+    for (int i = 0; i < 3; ++i) {
+      quadrics[v[i]] += q;
+      vertexTriangles[v[i]].push_back(t);
+      ++edgeUses[edgeKey(v[i], v[(i + 1) % 3])];
+    }
+  }
+
+  // vertices on borders (and non-manifold edges) stay in place
+  std::vector<bool> locked(numVertices, false);
+  for (const auto& edge : edgeUses) {
+    if (edge.second != 2) {
+      locked[edge.first >> 32] = true;
+      locked[edge.first & 0xffffffff] = true;
+    }
+  }
+
+  std::vector<bool> vertexRemoved(numVertices, false);
+  std::vector<uint32_t> versions(numVertices, 0);
+  std::priority_queue<Collapse, std::vector<Collapse>, std::greater<Collapse>>
+      heap;
+  auto pushCollapse = [&](uint32_t from, uint32_t to) {
+    if (locked[from] || from == to) {
+      return;
+    }
+    const double cost =
+        quadricError(quadrics[from], quadrics[to], positions[to]);
+    heap.push({cost, from, to, versions[from], versions[to]});
+  };
+  for (uint32_t t = 0; t < numTriangles; ++t) {
+    for (int i = 0; i < 3; ++i) {
+      pushCollapse(triangles[3 * t + i], triangles[3 * t + (i + 1) % 3]);
+      pushCollapse(triangles[3 * t + (i + 1) % 3], triangles[3 * t + i]);
+    }
+  }
+
+  size_t numIndices = indices.size();
+  double maxCost = 0.0;
+  while (numIndices > targetNumIndices && !heap.empty()) {
+    const Collapse c = heap.top();
+    heap.pop();
+    if (vertexRemoved[c.from] || vertexRemoved[c.to] ||
+        versions[c.from] != c.fromVersion || versions[c.to] != c.toVersion) {
+      continue;
+    }
+
+    // the edge may be gone, and no remaining triangle may flip
+    bool connected = false;
+    bool flips = false;
+    for (uint32_t t : vertexTriangles[c.from]) {
+      if (triangleRemoved[t]) {
+        continue;
+      }
+      const uint32_t* v = &triangles[3 * t];
+      if (v[0] == c.to || v[1] == c.to || v[2] == c.to) {
+        connected = true;
+        continue;
+      }
+      vec3f p[3];
+      for (int i = 0; i < 3; ++i) {
+        p[i] = positions[v[i]];
+      }
+      const vec3f before = (p[1] - p[0]).cross(p[2] - p[0]);
+      for (int i = 0; i < 3; ++i) {
+        if (v[i] == c.from) {
+          p[i] = positions[c.to];
+        }
+      }
+      const vec3f after = (p[1] - p[0]).cross(p[2] - p[0]);
+      if (before.dot(after) <= 0.0f) {
+        flips = true;
+        break;
+      }
+    }
+    if (!connected || flips) {
+      continue;
+    }
+
+    maxCost = std::max(maxCost, c.cost);
+    for (uint32_t t : vertexTriangles[c.from]) {
+      if (triangleRemoved[t]) {
+        continue;
+      }
+      uint32_t* v = &triangles[3 * t];
+      if (v[0] == c.to || v[1] == c.to || v[2] == c.to) {
+        triangleRemoved[t] = true;
+        numIndices -= 3;
+        continue;
+      }
+      for (int i = 0; i < 3; ++i) {
+        if (v[i] == c.from) {
+          v[i] = c.to;
+        }
+      }
+      vertexTriangles[c.to].push_back(t);
+    }
+    vertexRemoved[c.from] = true;
+    vertexTriangles[c.from].clear();
+    quadrics[c.to] += quadrics[c.from];
+    ++versions[c.to];
+
+    auto& toTriangles = vertexTriangles[c.to];
+    toTriangles.erase(std::remove_if(toTriangles.begin(), toTriangles.end(),
+                                     [&](uint32_t t) {
+                                       return triangleRemoved[t];
+                                     }),
+                      toTriangles.end());
+    for (uint32_t t : toTriangles) {
+      for (int i = 0; i < 3; ++i) {
+        const uint32_t w = triangles[3 * t + i];
+        if (w != c.to) {
+          pushCollapse(c.to, w);
+          pushCollapse(w, c.to);
+        }
+      }
+    }
+  }
+
+  std::vector<uint32_t> result;
+  result.reserve(numIndices);
+  for (uint32_t t = 0; t < numTriangles; ++t) {
+    if (!triangleRemoved[t]) {
+      result.insert(result.end(), &triangles[3 * t], &triangles[3 * t + 3]);
+    }
+  }
+  if (error != nullptr) {
+    *error = static_cast<float>(std::sqrt(maxCost));
+  }
+  return result;
+}
+
+}  // namespace geo
+}  // namespace esp
@@ -0,0 +1,39 @@
+// Copyright (c) Facebook, Inc. and its affiliates.
+// This source code is licensed under the MIT license found in the
+// LICENSE file in the root directory of this source tree.
+
+#pragma once
+
+#include <vector>
+
+#include "esp/core/esp.h"
+
+namespace esp {
+namespace geo {
+
+/**
+ * @brief Simplify an indexed triangle mesh with quadric error metrics.
+ *
+ * Edges are collapsed into one of their end points, cheapest first, until at
+ * most targetNumIndices / 3 triangles remain or no valid collapse is left. The
+ * returned indices therefore refer to a subset of the original vertices and
+ * all other vertex attributes (normals, texture coordinates, ...) stay valid.
+ * Vertices on open borders, which includes seams where vertices are split
+ * for their attributes, are never moved, and collapses that would flip a
+ * triangle are rejected.
+ *
+ * @param positions Vertex positions
+ * @param indices Triangle list indices
+ * @param targetNumIndices Number of indices to simplify down to
+ * @param[out] error If not null, receives the largest area weighted root
+ * mean square distance between a collapsed region and the original surface,
+ * an estimate of the geometric error of the simplified mesh
+ * @return Triangle list indices of the simplified mesh
+ */
+std::vector<uint32_t> simplifyMesh(const std::vector<vec3f>& positions,
+                                   const std::vector<uint32_t>& indices,
+                                   size_t targetNumIndices,
+                                   float* error = nullptr);
+
+}  // namespace geo
+}  // namespace esp
@@ -3,6 +3,7 @@
 // LICENSE file in the root directory of this source tree.
 
 #include "Drawable.h"
+#include "DrawableGroup.h"
 
 #include "esp/scene/SceneNode.h"
 
@@ -16,7 +17,20 @@ Drawable::Drawable(scene::SceneNode& node,
     : Magnum::SceneGraph::Drawable3D{node, group},
       node_(node),
       shader_(shader),
-      mesh_(mesh) {}
+      mesh_(mesh) {
+  auto* drawableGroup = dynamic_cast<DrawableGroup*>(group);
+  if (drawableGroup != nullptr) {
+    drawableGroup->markChanged();
+  }
+}
+
+Drawable::~Drawable() {
+  // Magnum removes the drawable from its group after this
+  auto* group = dynamic_cast<DrawableGroup*>(drawables());
+  if (group != nullptr) {
+    group->markChanged();
+  }
+}
 
 }  // namespace gfx
 }  // namespace esp
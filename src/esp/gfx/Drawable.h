@@ -13,17 +13,44 @@ class SceneNode;
 }
 namespace gfx {
 
+class RenderQueue;
+
 class Drawable : public Magnum::SceneGraph::Drawable3D {
  public:
   Drawable(scene::SceneNode& node,
            Magnum::GL::AbstractShaderProgram& shader,
            Magnum::GL::Mesh& mesh,
            Magnum::SceneGraph::DrawableGroup3D* group = nullptr);
-  virtual ~Drawable() {}
+  virtual ~Drawable();
 
   virtual scene::SceneNode& getSceneNode() { return node_; }
 
+  Magnum::GL::AbstractShaderProgram& getShader() { return shader_; }
+
+  Magnum::GL::Mesh& getMesh() { return mesh_; }
+
+  //! Texture the drawable binds first, if any. Used to sort draws by state.
+  virtual Magnum::GL::Texture2D* getTexture() const { return nullptr; }
+
+  //! Set a sphere bounding the mesh in the space of the node, which lets
+  //! renderers skip the drawable when it is out of view
+  void setBoundingSphere(const Magnum::Vector3& center, float radius) {
+    boundingCenter_ = center;
+    boundingRadius_ = radius;
+  }
+
+  //! Whether a bounding sphere was set, drawables without one are always
+  //! drawn
+  bool hasBoundingSphere() const { return boundingRadius_ >= 0.0f; }
+
+  const Magnum::Vector3& getBoundingCenter() const { return boundingCenter_; }
+
+  float getBoundingRadius() const { return boundingRadius_; }
+
  protected:
+  // submits draws in its own order, like Camera3D::draw()
+  friend class RenderQueue;
+
   // Each derived drawable class needs to implement this draw() function. It's
   // nothing more than setting up shader parameters and drawing the mesh.
   virtual void draw(const Magnum::Matrix4& transformationMatrix,
@@ -32,6 +59,8 @@ class Drawable : public Magnum::SceneGraph::Drawable3D {
   scene::SceneNode& node_;
   Magnum::GL::AbstractShaderProgram& shader_;
   Magnum::GL::Mesh& mesh_;
+  Magnum::Vector3 boundingCenter_;
+  float boundingRadius_ = -1.0f;
 };
 
 }  // namespace gfx
@@ -0,0 +1,39 @@
+// Copyright (c) Facebook, Inc. and its affiliates.
+// This source code is licensed under the MIT license found in the
+// LICENSE file in the root directory of this source tree.
+
+#include "DrawableGroup.h"
+
+#include <atomic>
+
+namespace esp {
+namespace gfx {
+
+namespace {
+// shared by all groups, so no two states of any groups share a generation
+uint64_t nextGeneration() {
+  static std::atomic<uint64_t> generation{0};
+  return ++generation;
+}
+}  // namespace
+
+DrawableGroup::DrawableGroup() : generation_(nextGeneration()) {}
+
+void DrawableGroup::markChanged() {
+  generation_ = nextGeneration();
+}
+
+DrawableGroup& DrawableGroup::add(MagnumDrawable& drawable) {
+  Magnum::SceneGraph::DrawableGroup3D::add(drawable);
+  markChanged();
+  return *this;
+}
+
+DrawableGroup& DrawableGroup::remove(MagnumDrawable& drawable) {
+  Magnum::SceneGraph::DrawableGroup3D::remove(drawable);
+  markChanged();
+  return *this;
+}
+
+}  // namespace gfx
+}  // namespace esp
@@ -0,0 +1,46 @@
+// Copyright (c) Facebook, Inc. and its affiliates.
+// This source code is licensed under the MIT license found in the
+// LICENSE file in the root directory of this source tree.
+
+#pragma once
+
+#include <cstdint>
+
+#include "esp/core/esp.h"
+#include "magnum.h"
+
+namespace esp {
+namespace gfx {
+
+/**
+ * @brief Drawable group that tells whether its contents changed.
+ *
+ * The generation is replaced by a new, globally unique value whenever a
+ * drawable is added to or removed from the group, so caches such as the
+ * sorted queue of @ref RenderQueue stay valid exactly as long as the
+ * generation they were built for, even if a removed drawable is replaced by
+ * a new one at the same address or the group itself is.
+ *
+ * @ref Drawable "Drawables" update the generation of the group they join or
+ * leave on construction and destruction; other drawables have to be added
+ * and removed through this class rather than through its base.
+ */
+class DrawableGroup : public Magnum::SceneGraph::DrawableGroup3D {
+ public:
+  DrawableGroup();
+
+  //! Current generation, changes whenever the set of drawables changes
+  uint64_t getGeneration() const { return generation_; }
+
+  //! Record that the set of drawables changed
+  void markChanged();
+
+  DrawableGroup& add(MagnumDrawable& drawable);
+  DrawableGroup& remove(MagnumDrawable& drawable);
+
+ protected:
+  uint64_t generation_;
+};
+
+}  // namespace gfx
+}  // namespace esp
@@ -0,0 +1,84 @@
+// Copyright (c) Facebook, Inc. and its affiliates.
+// This source code is licensed under the MIT license found in the
+// LICENSE file in the root directory of this source tree.
+
+#include "EquirectangularShader.h"
+
+#include <Corrade/Containers/Reference.h>
+#include <Corrade/Utility/Resource.h>
+#include <Magnum/GL/Context.h>
+#include <Magnum/GL/CubeMapTexture.h>
+#include <Magnum/GL/Shader.h>
+#include <Magnum/GL/Version.h>
+
+// This is to import the "resources" at runtime.
+// When the resource is compiled into static library,
+// it must be explicitly initialized via this macro, and should be called
+// *outside* of any namespace.
+static void importShaderResources() {
+  CORRADE_RESOURCE_INITIALIZE(ShaderResources)
+}
+
+namespace esp {
+namespace gfx {
+
+namespace {
+enum { ColorLayer = 0, ObjectIdLayer = 1, DepthLayer = 2 };
+}
+
+EquirectangularShader::EquirectangularShader() {
+#ifndef MAGNUM_TARGET_WEBGL
+  MAGNUM_ASSERT_GL_VERSION_SUPPORTED(Magnum::GL::Version::GL410);
+#endif
+
+  if (!Corrade::Utility::Resource::hasGroup("default-shaders")) {
+    importShaderResources();
+  }
+
+  // this is not the file name, but the group name in the config file
+  const Corrade::Utility::Resource rs{"default-shaders"};
+
+#ifdef MAGNUM_TARGET_WEBGL
+  Magnum::GL::Version glVersion = Magnum::GL::Version::GLES300;
+#else
+  Magnum::GL::Version glVersion = Magnum::GL::Version::GL410;
+#endif
+
+  Magnum::GL::Shader vert{glVersion, Magnum::GL::Shader::Type::Vertex};
+  Magnum::GL::Shader frag{glVersion, Magnum::GL::Shader::Type::Fragment};
+
+  vert.addSource(rs.get("equirectangular-gl410.vert"));
+  frag.addSource(rs.get("equirectangular-gl410.frag"));
+
+  CORRADE_INTERNAL_ASSERT_OUTPUT(Magnum::GL::Shader::compile({vert, frag}));
+
+  attachShaders({vert, frag});
+
+  CORRADE_INTERNAL_ASSERT_OUTPUT(link());
+
+  depthUnprojectionUniform_ = uniformLocation("depthUnprojection");
+  setUniform(uniformLocation("colorTexture"), ColorLayer);
+  setUniform(uniformLocation("objectIdTexture"), ObjectIdLayer);
+  setUniform(uniformLocation("depthTexture"), DepthLayer);
+}
+
+EquirectangularShader& EquirectangularShader::setFaceProjectionMatrix(
+    const Magnum::Matrix4& matrix) {
+  // NDC z of face depth d is (-a d + b) / d for the a, b below
+  setUniform(depthUnprojectionUniform_,
+             Magnum::Vector2{matrix[2][2], matrix[3][2]});
+  return *this;
+}
+
+EquirectangularShader& EquirectangularShader::bindTextures(
+    Magnum::GL::CubeMapTexture& color,
+    Magnum::GL::CubeMapTexture& objectId,
+    Magnum::GL::CubeMapTexture& depth) {
+  color.bind(ColorLayer);
+  objectId.bind(ObjectIdLayer);
+  depth.bind(DepthLayer);
+  return *this;
+}
+
+}  // namespace gfx
+}  // namespace esp
@@ -0,0 +1,60 @@
+// Copyright (c) Facebook, Inc. and its affiliates.
+// This source code is licensed under the MIT license found in the
+// LICENSE file in the root directory of this source tree.
+
+#pragma once
+
+#include <Magnum/GL/AbstractShaderProgram.h>
+#include <Magnum/GL/GL.h>
+#include <Magnum/Math/Matrix4.h>
+
+#include "esp/core/esp.h"
+
+namespace esp {
+namespace gfx {
+
+/**
+ * @brief Resamples color, object id and depth cube maps rendered around a
+ * camera into an equirectangular panorama.
+ *
+ * Draws a single full screen triangle (a mesh with a count of 3 and no
+ * buffers), the whole viewport covering 360 degrees of longitude and 180
+ * degrees of latitude with the camera's forward direction in the center.
+ * Depth is output as the distance along the ray, 0 where nothing was hit.
+ */
+class EquirectangularShader : public Magnum::GL::AbstractShaderProgram {
+ public:
+  explicit EquirectangularShader();
+
+  //! Color attachment location per output type
+  enum : uint8_t {
+    //! color output
+    ColorOutput = 0,
+    //! object id output
+    ObjectIdOutput = 1,
+    //! depth output
+    DepthOutput = 2
+  };
+
+  /**
+   * @brief Set the projection matrix the cube faces were rendered with
+   * @return Reference to self (for method chaining)
+   */
+  EquirectangularShader& setFaceProjectionMatrix(
+      const Magnum::Matrix4& matrix);
+
+  /**
+   * @brief Bind the cube maps to resample
+   * @return Reference to self (for method chaining)
+   */
+  EquirectangularShader& bindTextures(
+      Magnum::GL::CubeMapTexture& color,
+      Magnum::GL::CubeMapTexture& objectId,
+      Magnum::GL::CubeMapTexture& depth);
+
+ protected:
+  int depthUnprojectionUniform_ = ID_UNDEFINED;
+};
+
+}  // namespace gfx
+}  // namespace esp
@@ -6,6 +6,7 @@
 
 #include <Magnum/Shaders/Flat.h>
 
+#include "esp/assets/GltfMeshData.h"
 #include "esp/scene/SceneNode.h"
 
 namespace esp {
@@ -40,6 +41,11 @@ void GenericDrawable::draw(const Magnum::Matrix4& transformationMatrix,
   }
 
   shader.setObjectId(node_.getId());
+  if (lodMeshData_ != nullptr) {
+    lodMeshData_->setLod(lodMeshData_->selectLod(transformationMatrix,
+                                                 camera.projectionMatrix(),
+                                                 camera.viewport().y()));
+  }
   mesh_.draw(shader_);
 }
 
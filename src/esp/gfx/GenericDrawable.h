@@ -9,6 +9,9 @@
 #include "Drawable.h"
 
 namespace esp {
+namespace assets {
+class GltfMeshData;
+}
 namespace gfx {
 
 class GenericDrawable : public Drawable {
@@ -24,6 +27,19 @@ class GenericDrawable : public Drawable {
                            int objectId = ID_UNDEFINED,
                            const Magnum::Color4& color = Magnum::Color4{1});
 
+  virtual Magnum::GL::Texture2D* getTexture() const override {
+    return texture_;
+  }
+
+  const Magnum::Color4& getColor() const { return color_; }
+
+  //! Draw the level of detail of meshData (which owns mesh) that suits the
+  //! projected size of the drawable, see assets::GltfMeshData::selectLod()
+  void setLodMeshData(assets::GltfMeshData* meshData) {
+    lodMeshData_ = meshData;
+  }
+  assets::GltfMeshData* getLodMeshData() const { return lodMeshData_; }
+
  protected:
   virtual void draw(const Magnum::Matrix4& transformationMatrix,
                     Magnum::SceneGraph::Camera3D& camera) override;
@@ -31,6 +47,7 @@ class GenericDrawable : public Drawable {
   Magnum::GL::Texture2D* texture_;
   int objectId_;
   Magnum::Color4 color_;
+  assets::GltfMeshData* lodMeshData_ = nullptr;
 };
 
 }  // namespace gfx
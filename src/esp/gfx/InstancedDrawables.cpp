@@ -0,0 +1,105 @@
+// Copyright (c) Facebook, Inc. and its affiliates.
+// This source code is licensed under the MIT license found in the
+// LICENSE file in the root directory of this source tree.
+
+#include "InstancedDrawables.h"
+
+#include <algorithm>
+
+#include <Corrade/Containers/ArrayViewStl.h>
+#include <Magnum/Shaders/Flat.h>
+
+#include "GenericDrawable.h"
+#include "esp/assets/GltfMeshData.h"
+#include "esp/scene/SceneNode.h"
+
+namespace esp {
+namespace gfx {
+
+void InstancedDrawables::draw(
+    const std::vector<GenericDrawable*>& drawables,
+    const std::vector<Magnum::Matrix4>& transformations,
+    MagnumCamera& camera) {
+  ASSERT(!drawables.empty() && drawables.size() == transformations.size());
+  GenericDrawable& first = *drawables.front();
+  Magnum::GL::Mesh& mesh = first.getMesh();
+  const auto& flatShader =
+      static_cast<const Magnum::Shaders::Flat3D&>(first.getShader());
+  Magnum::GL::Texture2D* texture = first.getTexture();
+
+  // same uniforms GenericDrawable::draw() sets, per instance
+  const bool vertexColored =
+      bool(flatShader.flags() & Magnum::Shaders::Flat3D::Flag::VertexColor);
+  instances_.clear();
+  for (size_t i = 0; i < drawables.size(); ++i) {
+    GenericDrawable& drawable = *drawables[i];
+    instances_.push_back(
+        {transformations[i],
+         static_cast<Magnum::UnsignedInt>(drawable.getSceneNode().getId()),
+         vertexColored ? Magnum::Color4{1} : drawable.getColor()});
+  }
+
+  // one buffer per instanced draw call of the frame, so that uploads do not
+  // wait for the previous draw call to finish reading
+  if (numDrawCalls_ == buffers_.size()) {
+    buffers_.emplace_back();
+  }
+  Magnum::GL::Buffer& buffer = buffers_[numDrawCalls_];
+  buffer.setData(instances_, Magnum::GL::BufferUsage::StreamDraw);
+
+  // all instances share the level of detail of the one needing the finest
+  assets::GltfMeshData* lodMeshData = first.getLodMeshData();
+  if (lodMeshData != nullptr) {
+    size_t lod = lodMeshData->getNumLods();
+    for (const Magnum::Matrix4& transformation : transformations) {
+      lod = std::min(lod, lodMeshData->selectLod(transformation,
+                                                 camera.projectionMatrix(),
+                                                 camera.viewport().y()));
+      if (lod == 0) {
+        break;
+      }
+    }
+    lodMeshData->setLod(lod);
+  }
+
+  // The instance attributes are (re)attached every draw since buffers are
+  // shared between meshes over frames
+  mesh.addVertexBufferInstanced(buffer, 1, 0,
+                                InstancedFlatShader::InstanceTransformation{},
+                                InstancedFlatShader::InstanceObjectId{},
+                                InstancedFlatShader::InstanceColor{});
+
+  InstancedFlatShader& shader = getShader(flatShader);
+  shader.setProjectionMatrix(camera.projectionMatrix());
+  if ((shader.flags() & InstancedFlatShader::Flag::Textured) && texture) {
+    shader.bindTexture(*texture);
+  }
+
+  mesh.setInstanceCount(instances_.size());
+  mesh.draw(shader);
+  mesh.setInstanceCount(1);
+  ++numDrawCalls_;
+}
+
+InstancedFlatShader& InstancedDrawables::getShader(
+    const Magnum::Shaders::Flat3D& flatShader) {
+  InstancedFlatShader::Flags flags;
+  if (flatShader.flags() & Magnum::Shaders::Flat3D::Flag::Textured) {
+    flags |= InstancedFlatShader::Flag::Textured;
+  }
+  if (flatShader.flags() & Magnum::Shaders::Flat3D::Flag::VertexColor) {
+    flags |= InstancedFlatShader::Flag::VertexColor;
+  }
+
+  const size_t index = InstancedFlatShader::Flags::UnderlyingType(flags);
+  if (index >= shaders_.size()) {
+    shaders_.resize(index + 1);
+  }
+  if (shaders_[index] == nullptr) {
+    shaders_[index] = std::make_unique<InstancedFlatShader>(flags);
+  }
+  return *shaders_[index];
+}
+
+}  // namespace gfx
+}  // namespace esp
@@ -0,0 +1,74 @@
+// Copyright (c) Facebook, Inc. and its affiliates.
+// This source code is licensed under the MIT license found in the
+// LICENSE file in the root directory of this source tree.
+
+#pragma once
+
+#include <memory>
+#include <vector>
+
+#include <Magnum/GL/Buffer.h>
+#include <Magnum/Shaders/Shaders.h>
+
+#include "InstancedFlatShader.h"
+#include "esp/core/esp.h"
+#include "magnum.h"
+
+namespace esp {
+namespace gfx {
+
+class GenericDrawable;
+
+/**
+ * @brief Draws batches of GenericDrawables with one instanced draw call each.
+ *
+ * All drawables of a batch share mesh, shader and texture, e.g. many copies
+ * of the same physics object; finding the batches is up to the caller, see
+ * @ref RenderQueue. Their camera space transformations, object ids and
+ * colors are uploaded to an instance buffer every frame, and the result is
+ * the same as drawing each of them with GenericDrawable::draw().
+ */
+class InstancedDrawables {
+ public:
+  //! Smallest number of drawables worth an instanced draw call
+  static constexpr size_t kMinInstances = 2;
+
+  InstancedDrawables() = default;
+
+  //! Start a new frame, reusing the instance buffers of the previous one
+  void newFrame() { numDrawCalls_ = 0; }
+
+  /**
+   * @brief Draw drawables with one instanced draw call
+   *
+   * transformations[i] is the camera space transformation of drawables[i].
+   */
+  void draw(const std::vector<GenericDrawable*>& drawables,
+            const std::vector<Magnum::Matrix4>& transformations,
+            MagnumCamera& camera);
+
+  //! Instanced draw calls since the last newFrame()
+  size_t getNumDrawCalls() const { return numDrawCalls_; }
+
+  //! Shader the drawables of a batch drawn with flatShader are drawn with
+  InstancedFlatShader& getShader(const Magnum::Shaders::Flat3D& flatShader);
+
+ protected:
+  // matches the per-instance attributes of InstancedFlatShader
+  struct Instance {
+    Magnum::Matrix4 transformation;
+    Magnum::UnsignedInt objectId;
+    Magnum::Color4 color;
+  };
+
+  std::vector<Instance> instances_;
+  // one buffer per instanced draw call of a frame
+  std::vector<Magnum::GL::Buffer> buffers_;
+  std::vector<std::unique_ptr<InstancedFlatShader>> shaders_;
+  size_t numDrawCalls_ = 0;
+
+  ESP_SMART_POINTERS(InstancedDrawables)
+};
+
+}  // namespace gfx
+}  // namespace esp
@@ -0,0 +1,87 @@
+// Copyright (c) Facebook, Inc. and its affiliates.
+// This source code is licensed under the MIT license found in the
+// LICENSE file in the root directory of this source tree.
+
+#pragma once
+
+#include <Corrade/Containers/EnumSet.h>
+
+#include <Magnum/GL/AbstractShaderProgram.h>
+#include <Magnum/Math/Color.h>
+#include <Magnum/Math/Matrix4.h>
+
+#include "esp/core/esp.h"
+
+namespace esp {
+namespace gfx {
+
+/**
+ * @brief Instanced counterpart of Magnum::Shaders::Flat3D with object id
+ * output.
+ *
+ * Mesh vertex attributes use the same locations as Flat3D, so any mesh drawn
+ * with Flat3D can be drawn with this shader once a buffer with the per
+ * instance attributes below is added to it.
+ */
+class InstancedFlatShader : public Magnum::GL::AbstractShaderProgram {
+ public:
+  enum class Flag : Magnum::UnsignedByte {
+    //! Multiply the color with a texture
+    Textured = 1 << 0,
+    //! Multiply the color with per-vertex colors
+    VertexColor = 1 << 1,
+  };
+  typedef Corrade::Containers::EnumSet<Flag> Flags;
+
+  explicit InstancedFlatShader(Flags flags = {});
+
+  //! @brief vertex positions
+  typedef Magnum::GL::Attribute<0, Magnum::Vector4> Position;
+  //! @brief vertex texture coordinates
+  typedef Magnum::GL::Attribute<1, Magnum::Vector2> TextureCoordinates;
+  //! @brief vertex colors
+  typedef Magnum::GL::Attribute<3, Magnum::Vector4> Color;
+
+  //! @brief per-instance camera space transformation
+  typedef Magnum::GL::Attribute<8, Magnum::Matrix4> InstanceTransformation;
+  //! @brief per-instance object id
+  typedef Magnum::GL::Attribute<12, Magnum::UnsignedInt> InstanceObjectId;
+  //! @brief per-instance color
+  typedef Magnum::GL::Attribute<13, Magnum::Vector4> InstanceColor;
+
+  //! Color attachment location per output type
+  enum : uint8_t {
+    //! color output
+    ColorOutput = 0,
+    //! object id output
+    ObjectIdOutput = 1
+  };
+
+  Flags flags() const { return flags_; }
+
+  /**
+   * @brief Set projection matrix
+   * @return Reference to self (for method chaining)
+   */
+  InstancedFlatShader& setProjectionMatrix(const Magnum::Matrix4& matrix) {
+    setUniform(projectionMatrixUniform_, matrix);
+    return *this;
+  }
+
+  /**
+   * @brief Bind a color texture
+   * @return Reference to self (for method chaining)
+   *
+   * Expects that the shader was created with @ref Flag::Textured enabled.
+   */
+  InstancedFlatShader& bindTexture(Magnum::GL::Texture2D& texture);
+
+ protected:
+  Flags flags_;
+  int projectionMatrixUniform_ = ID_UNDEFINED;
+};
+
+CORRADE_ENUMSET_OPERATORS(InstancedFlatShader::Flags)
+
+}  // namespace gfx
+}  // namespace esp
@@ -24,6 +24,8 @@ class PTexMeshDrawable : public Drawable {
       int submeshID,
       Magnum::SceneGraph::DrawableGroup3D* group = nullptr);
 
+  virtual Magnum::GL::Texture2D* getTexture() const override { return &tex_; }
+
  protected:
   virtual void draw(const Magnum::Matrix4& transformationMatrix,
                     Magnum::SceneGraph::Camera3D& camera) override;
@@ -55,6 +55,12 @@ PTexMeshShader::PTexMeshShader() {
   attachShaders({vert, geom, frag});
 
   CORRADE_INTERNAL_ASSERT_OUTPUT(link());
+
+  mvpUniform_ = uniformLocation("MVP");
+  tileSizeUniform_ = uniformLocation("tileSize");
+  widthInTilesUniform_ = uniformLocation("widthInTiles");
+  exposureUniform_ = uniformLocation("exposure");
+  setUniform(uniformLocation("atlasTex"), 0);
 }
 
 }  // namespace gfx
@@ -34,7 +34,7 @@ class PTexMeshShader : public Magnum::GL::AbstractShaderProgram {
   }
 
   PTexMeshShader& setMVPMatrix(const Magnum::Matrix4& matrix) {
-    setUniform(uniformLocation("MVP"), matrix);
+    setUniform(mvpUniform_, matrix);
     return *this;
   }
 
@@ -47,21 +47,42 @@ class PTexMeshShader : public Magnum::GL::AbstractShaderProgram {
     return *this;
   }
 
+  //! Uniforms are program state, so the ones already set for the same atlas
+  //! (e.g. by the previous draw of a sorted render queue) are not set again
   PTexMeshShader& setPTexUniforms(Magnum::GL::Texture2D& tex,
                                   uint32_t tileSize,
                                   float exposure) {
-    setUniform(uniformLocation("atlasTex"), 0);
-    setUniform(uniformLocation("tileSize"), static_cast<int>(tileSize));
+    if (&tex == uniformsTexture_ && tex.id() == uniformsTextureId_ &&
+        tileSize == uniformsTileSize_ && exposure == uniformsExposure_) {
+      return *this;
+    }
+    setUniform(tileSizeUniform_, static_cast<int>(tileSize));
     // Image size in given mip level 0
     {
       int mipLevel = 0;
       int widthEntry = 0;
       const auto width = tex.imageSize(mipLevel)[widthEntry];
-      setUniform(uniformLocation("widthInTiles"), int(width / tileSize));
+      setUniform(widthInTilesUniform_, int(width / tileSize));
     }
-    setUniform(uniformLocation("exposure"), exposure);
+    setUniform(exposureUniform_, exposure);
+    uniformsTexture_ = &tex;
+    uniformsTextureId_ = tex.id();
+    uniformsTileSize_ = tileSize;
+    uniformsExposure_ = exposure;
     return *this;
   }
+
+ protected:
+  int mvpUniform_ = ID_UNDEFINED;
+  int tileSizeUniform_ = ID_UNDEFINED;
+  int widthInTilesUniform_ = ID_UNDEFINED;
+  int exposureUniform_ = ID_UNDEFINED;
+
+  // atlas the per-atlas uniforms were last set for
+  Magnum::GL::Texture2D* uniformsTexture_ = nullptr;
+  Magnum::UnsignedInt uniformsTextureId_ = 0;
+  uint32_t uniformsTileSize_ = 0;
+  float uniformsExposure_ = 0.0f;
 };
 
 }  // namespace gfx
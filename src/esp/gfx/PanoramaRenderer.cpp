@@ -0,0 +1,285 @@
+// Copyright (c) Facebook, Inc. and its affiliates.
+// This source code is licensed under the MIT license found in the
+// LICENSE file in the root directory of this source tree.
+
+#include "PanoramaRenderer.h"
+
+#include <array>
+#include <cstring>
+#include <functional>
+
+#include <Magnum/GL/CubeMapTexture.h>
+#include <Magnum/GL/Framebuffer.h>
+#include <Magnum/GL/Mesh.h>
+#include <Magnum/GL/Renderbuffer.h>
+#include <Magnum/GL/RenderbufferFormat.h>
+#include <Magnum/GL/Renderer.h>
+#include <Magnum/GL/TextureFormat.h>
+#include <Magnum/Image.h>
+#include <Magnum/PixelFormat.h>
+
+#include "Drawable.h"
+#include "EquirectangularShader.h"
+
+using namespace Magnum;
+
+namespace esp {
+namespace gfx {
+
+namespace {
+
+struct CubeFace {
+  GL::CubeMapCoordinate coordinate;
+  // view direction and up vector in camera space, the usual cube map
+  // conventions so that faces can be sampled with the view direction
+  Vector3 direction;
+  Vector3 up;
+};
+
+const std::array<CubeFace, 6> kCubeFaces{{
+    {GL::CubeMapCoordinate::PositiveX, Vector3::xAxis(), -Vector3::yAxis()},
+    {GL::CubeMapCoordinate::NegativeX, -Vector3::xAxis(), -Vector3::yAxis()},
+    {GL::CubeMapCoordinate::PositiveY, Vector3::yAxis(), Vector3::zAxis()},
+    {GL::CubeMapCoordinate::NegativeY, -Vector3::yAxis(), -Vector3::zAxis()},
+    {GL::CubeMapCoordinate::PositiveZ, Vector3::zAxis(), -Vector3::yAxis()},
+    {GL::CubeMapCoordinate::NegativeZ, -Vector3::zAxis(), -Vector3::yAxis()},
+}};
+
+// Whether a camera space sphere intersects the 90 degree frustum looking
+// along axis (a coordinate axis) up to zfar. The side planes of the frustum
+// are axis . p = |other coordinate of p|, at 45 degrees to the axis.
+bool sphereInFace(const Vector3& center,
+                  float radius,
+                  const Vector3& axis,
+                  float zfar) {
+  const float depth = Math::dot(center, axis);
+  const Vector3 side = center - depth * axis;
+  const float sideRadius = radius * Constants::sqrt2();
+  return depth - radius <= zfar &&
+         depth - Math::abs(side.x()) >= -sideRadius &&
+         depth - Math::abs(side.y()) >= -sideRadius &&
+         depth - Math::abs(side.z()) >= -sideRadius;
+}
+
+}  // namespace
+
+struct PanoramaRenderer::Impl {
+  Impl(int faceSize, int width, int height) {
+    GL::Renderer::enable(GL::Renderer::Feature::DepthTest);
+    GL::Renderer::enable(GL::Renderer::Feature::FaceCulling);
+#ifndef MAGNUM_TARGET_GLES
+    // filter color across face edges
+    GL::Renderer::enable(GL::Renderer::Feature::SeamlessCubeMapTexture);
+#endif
+    fullscreenTriangle_.setCount(3);
+    setSize(faceSize, width, height);
+  }
+  ~Impl() { LOG(INFO) << "Deconstructing PanoramaRenderer"; }
+
+  void setSize(int faceSize, int width, int height) {
+    faceSize_ = faceSize;
+    panoramaSize_ = {width, height};
+    const Vector2i faceSize2{faceSize, faceSize};
+
+    colorCubeMap_ = GL::CubeMapTexture{};
+    colorCubeMap_.setMinificationFilter(GL::SamplerFilter::Linear)
+        .setMagnificationFilter(GL::SamplerFilter::Linear)
+        .setWrapping(GL::SamplerWrapping::ClampToEdge)
+        .setStorage(1, GL::TextureFormat::RGBA8, faceSize2);
+    objectIdCubeMap_ = GL::CubeMapTexture{};
+    objectIdCubeMap_.setMinificationFilter(GL::SamplerFilter::Nearest)
+        .setMagnificationFilter(GL::SamplerFilter::Nearest)
+        .setWrapping(GL::SamplerWrapping::ClampToEdge)
+        .setStorage(1, GL::TextureFormat::R32UI, faceSize2);
+    depthCubeMap_ = GL::CubeMapTexture{};
+    depthCubeMap_.setMinificationFilter(GL::SamplerFilter::Nearest)
+        .setMagnificationFilter(GL::SamplerFilter::Nearest)
+        .setWrapping(GL::SamplerWrapping::ClampToEdge)
+        .setStorage(1, GL::TextureFormat::DepthComponent32F, faceSize2);
+
+    for (size_t iFace = 0; iFace < kCubeFaces.size(); ++iFace) {
+      const GL::CubeMapCoordinate coordinate = kCubeFaces[iFace].coordinate;
+      GL::Framebuffer& framebuffer = faceFramebuffers_[iFace];
+      framebuffer = GL::Framebuffer{{{}, faceSize2}};
+      framebuffer
+          .attachCubeMapTexture(GL::Framebuffer::ColorAttachment{0},
+                                colorCubeMap_, coordinate, 0)
+          .attachCubeMapTexture(GL::Framebuffer::ColorAttachment{1},
+                                objectIdCubeMap_, coordinate, 0)
+          .attachCubeMapTexture(GL::Framebuffer::BufferAttachment::Depth,
+                                depthCubeMap_, coordinate, 0)
+          .mapForDraw({{0, GL::Framebuffer::ColorAttachment{0}},
+                       {1, GL::Framebuffer::ColorAttachment{1}}});
+      CORRADE_INTERNAL_ASSERT(
+          framebuffer.checkStatus(GL::FramebufferTarget::Draw) ==
+          GL::Framebuffer::Status::Complete);
+    }
+
+    colorBuffer_.setStorage(GL::RenderbufferFormat::RGBA8, panoramaSize_);
+    objectIdBuffer_.setStorage(GL::RenderbufferFormat::R32UI, panoramaSize_);
+    depthBuffer_.setStorage(GL::RenderbufferFormat::R32F, panoramaSize_);
+    panoramaFramebuffer_ = GL::Framebuffer{{{}, panoramaSize_}};
+    panoramaFramebuffer_
+        .attachRenderbuffer(GL::Framebuffer::ColorAttachment{0}, colorBuffer_)
+        .attachRenderbuffer(GL::Framebuffer::ColorAttachment{1},
+                            objectIdBuffer_)
+        .attachRenderbuffer(GL::Framebuffer::ColorAttachment{2}, depthBuffer_)
+        .mapForDraw({{EquirectangularShader::ColorOutput,
+                      GL::Framebuffer::ColorAttachment{0}},
+                     {EquirectangularShader::ObjectIdOutput,
+                      GL::Framebuffer::ColorAttachment{1}},
+                     {EquirectangularShader::DepthOutput,
+                      GL::Framebuffer::ColorAttachment{2}}});
+    CORRADE_INTERNAL_ASSERT(
+        panoramaFramebuffer_.checkStatus(GL::FramebufferTarget::Draw) ==
+        GL::Framebuffer::Status::Complete);
+  }
+
+  // classify all drawables against all six faces at once
+  void cull(RenderCamera& camera, MagnumDrawableGroup& drawables) {
+    MagnumCamera& magnumCamera = camera.getMagnumCamera();
+    const Matrix4 projection = magnumCamera.projectionMatrix();
+    // far plane of a perspective projection
+    const float zfar = projection[3][2] / (projection[2][2] + 1.0f);
+
+    objects_.clear();
+    for (size_t i = 0; i < drawables.size(); ++i) {
+      objects_.push_back(drawables[i].object());
+    }
+    const std::vector<Matrix4> transformations =
+        magnumCamera.object().scene()->transformationMatrices(
+            objects_, magnumCamera.cameraMatrix());
+
+    for (auto& visible : faceVisible_) {
+      visible.assign(drawables.size(), true);
+    }
+    numCulledFaces_ = 0;
+    for (size_t i = 0; i < drawables.size(); ++i) {
+      auto* drawable = dynamic_cast<Drawable*>(&drawables[i]);
+      if (drawable == nullptr || !drawable->hasBoundingSphere()) {
+        continue;
+      }
+      const Matrix4& transformation = transformations[i];
+      const Vector3 center =
+          transformation.transformPoint(drawable->getBoundingCenter());
+      const float radius =
+          drawable->getBoundingRadius() * transformation.scaling().max();
+      for (size_t iFace = 0; iFace < kCubeFaces.size(); ++iFace) {
+        const bool visible =
+            sphereInFace(center, radius, kCubeFaces[iFace].direction, zfar);
+        faceVisible_[iFace][i] = visible;
+        numCulledFaces_ += !visible;
+      }
+    }
+  }
+
+  void draw(RenderCamera& camera, MagnumDrawableGroup& drawables) {
+    cull(camera, drawables);
+
+    scene::SceneNode& node = camera.node();
+    const Matrix4 transformation = node.transformation();
+    camera.getMagnumCamera().setViewport({faceSize_, faceSize_});
+    for (size_t iFace = 0; iFace < kCubeFaces.size(); ++iFace) {
+      const CubeFace& face = kCubeFaces[iFace];
+      node.setTransformation(transformation *
+                             Matrix4::lookAt({}, face.direction, face.up));
+      GL::Framebuffer& framebuffer = faceFramebuffers_[iFace];
+      framebuffer.clearDepth(1.0);
+      framebuffer.clearColor(0, Color4{});
+      framebuffer.clearColor(1, Vector4ui{});
+      framebuffer.bind();
+      camera.draw(drawables, &faceVisible_[iFace]);
+    }
+    node.setTransformation(transformation);
+
+    // resample all faces in one pass
+    panoramaFramebuffer_.bind();
+    shader_.setFaceProjectionMatrix(camera.getMagnumCamera().projectionMatrix())
+        .bindTextures(colorCubeMap_, objectIdCubeMap_, depthCubeMap_);
+    fullscreenTriangle_.draw(shader_);
+  }
+
+  void draw(sensor::Sensor& visualSensor, scene::SceneGraph& sceneGraph) {
+    ASSERT(visualSensor.isVisualSensor());
+
+    // set the modelview matrix, projection matrix of the render camera;
+    sceneGraph.setDefaultRenderCamera(visualSensor);
+
+    draw(sceneGraph.getDefaultRenderCamera(), sceneGraph.getDrawables());
+  }
+
+  void read(GL::Framebuffer::ColorAttachment attachment,
+            PixelFormat format,
+            void* ptr) {
+    panoramaFramebuffer_.mapForRead(attachment);
+    Image2D image = panoramaFramebuffer_.read(
+        Range2Di::fromSize({0, 0}, panoramaSize_), {format});
+    std::memcpy(ptr, image.data(), image.data().size());
+  }
+
+  int faceSize_ = 0;
+  Vector2i panoramaSize_;
+
+  GL::CubeMapTexture colorCubeMap_{NoCreate};
+  GL::CubeMapTexture objectIdCubeMap_{NoCreate};
+  GL::CubeMapTexture depthCubeMap_{NoCreate};
+  std::array<GL::Framebuffer, 6> faceFramebuffers_{
+      {GL::Framebuffer{NoCreate}, GL::Framebuffer{NoCreate},
+       GL::Framebuffer{NoCreate}, GL::Framebuffer{NoCreate},
+       GL::Framebuffer{NoCreate}, GL::Framebuffer{NoCreate}}};
+
+  GL::Renderbuffer colorBuffer_;
+  GL::Renderbuffer objectIdBuffer_;
+  GL::Renderbuffer depthBuffer_;
+  GL::Framebuffer panoramaFramebuffer_{NoCreate};
+
+  EquirectangularShader shader_;
+  GL::Mesh fullscreenTriangle_;
+
+  // culling results of the current frame
+  std::vector<std::reference_wrapper<SceneGraph::AbstractObject3D>> objects_;
+  std::array<std::vector<bool>, 6> faceVisible_;
+  size_t numCulledFaces_ = 0;
+};
+
+PanoramaRenderer::PanoramaRenderer(int faceSize, int width, int height)
+    : pimpl_(spimpl::make_unique_impl<Impl>(faceSize, width, height)) {}
+
+void PanoramaRenderer::draw(RenderCamera& camera,
+                            scene::SceneGraph& sceneGraph) {
+  pimpl_->draw(camera, sceneGraph.getDrawables());
+}
+
+void PanoramaRenderer::draw(sensor::Sensor& visualSensor,
+                            scene::SceneGraph& sceneGraph) {
+  pimpl_->draw(visualSensor, sceneGraph);
+}
+
+void PanoramaRenderer::setSize(int faceSize, int width, int height) {
+  pimpl_->setSize(faceSize, width, height);
+}
+
+void PanoramaRenderer::readFrameRgba(uint8_t* ptr) {
+  pimpl_->read(GL::Framebuffer::ColorAttachment{0}, PixelFormat::RGBA8Unorm,
+               ptr);
+}
+
+void PanoramaRenderer::readFrameDepth(float* ptr) {
+  pimpl_->read(GL::Framebuffer::ColorAttachment{2}, PixelFormat::R32F, ptr);
+}
+
+void PanoramaRenderer::readFrameObjectId(uint32_t* ptr) {
+  pimpl_->read(GL::Framebuffer::ColorAttachment{1}, PixelFormat::R32UI, ptr);
+}
+
+vec3i PanoramaRenderer::getSize() {
+  return vec3i(pimpl_->faceSize_, pimpl_->panoramaSize_[0],
+               pimpl_->panoramaSize_[1]);
+}
+
+size_t PanoramaRenderer::getNumCulledFaces() const {
+  return pimpl_->numCulledFaces_;
+}
+
+}  // namespace gfx
+}  // namespace esp
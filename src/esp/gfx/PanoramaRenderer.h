@@ -0,0 +1,60 @@
+// Copyright (c) Facebook, Inc. and its affiliates.
+// This source code is licensed under the MIT license found in the
+// LICENSE file in the root directory of this source tree.
+
+#pragma once
+
+#include "esp/core/esp.h"
+#include "esp/gfx/RenderCamera.h"
+#include "esp/scene/SceneGraph.h"
+#include "esp/sensor/Sensor.h"
+
+namespace esp {
+namespace gfx {
+
+/**
+ * @brief Renders 360 degree panoramas.
+ *
+ * The scene is drawn into the six faces of color, object id and depth cube
+ * maps around the camera, then resampled into an equirectangular panorama in
+ * a single full screen pass, so that each observation is read back with one
+ * read. Drawables with a bounding sphere (see
+ * @ref Drawable::setBoundingSphere()) are classified against all six face
+ * frusta in one pass per frame and only drawn into the faces they touch.
+ *
+ * The camera has to have a 90 degree square projection; its orientation is
+ * the center of the panorama. Depth is the distance along the ray, not the
+ * z-depth of @ref Renderer.
+ */
+class PanoramaRenderer {
+ public:
+  //! faceSize x faceSize cube faces resampled into a width x height panorama
+  PanoramaRenderer(int faceSize, int width, int height);
+
+  //! Draw the scene graph around camera
+  void draw(RenderCamera& camera, scene::SceneGraph& sceneGraph);
+
+  //! Draw the scene graph around the visual sensor, which sets a cube face
+  //! projection in @ref sensor::Sensor::setProjectionMatrix()
+  void draw(sensor::Sensor& visualSensor, scene::SceneGraph& sceneGraph);
+
+  void readFrameRgba(uint8_t* ptr);
+
+  void readFrameDepth(float* ptr);
+
+  void readFrameObjectId(uint32_t* ptr);
+
+  void setSize(int faceSize, int width, int height);
+
+  //! Cube face size, panorama width and height
+  vec3i getSize();
+
+  //! Face draws skipped by culling in the last draw(), out of six per
+  //! drawable
+  size_t getNumCulledFaces() const;
+
+  ESP_SMART_POINTERS_WITH_UNIQUE_PIMPL(PanoramaRenderer)
+};
+
+}  // namespace gfx
+}  // namespace esp
@@ -23,8 +23,9 @@ void PrimitiveIDTexturedDrawable::draw(
   PrimitiveIDTexturedShader& shader =
       static_cast<PrimitiveIDTexturedShader&>(shader_);
   shader
-      .setTransformationProjectionMatrix(camera.projectionMatrix() *
-                                         transformationMatrix)
+      .setTransformationProjectionMatrix(
+          camera.projectionMatrix() * transformationMatrix * positionDecode_)
+      .setPrimitiveIdOffset(primitiveIdOffset_)
       .bindTexture(*texture_);
 
   mesh_.draw(shader_);
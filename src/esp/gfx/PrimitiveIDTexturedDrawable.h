@@ -24,11 +24,29 @@ class PrimitiveIDTexturedDrawable : public Drawable {
       Magnum::SceneGraph::DrawableGroup3D* group = nullptr,
       Magnum::GL::Texture2D* texture = nullptr);
 
+  virtual Magnum::GL::Texture2D* getTexture() const override {
+    return texture_;
+  }
+
+  //! Transformation from the vertex positions of mesh, which may be
+  //! quantized, to the space of the node
+  void setPositionDecode(const Magnum::Matrix4& positionDecode) {
+    positionDecode_ = positionDecode;
+  }
+
+  //! Index into the texture of the first primitive of mesh, for meshes
+  //! drawing a part of the primitives the texture is for
+  void setPrimitiveIdOffset(int primitiveIdOffset) {
+    primitiveIdOffset_ = primitiveIdOffset;
+  }
+
  protected:
   virtual void draw(const Magnum::Matrix4& transformationMatrix,
                     Magnum::SceneGraph::Camera3D& camera) override;
 
   Magnum::GL::Texture2D* texture_;
+  Magnum::Matrix4 positionDecode_;
+  int primitiveIdOffset_ = 0;
 };
 
 }  // namespace gfx
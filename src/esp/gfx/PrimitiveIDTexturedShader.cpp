@@ -57,6 +57,12 @@ PrimitiveIDTexturedShader::PrimitiveIDTexturedShader() {
   CORRADE_INTERNAL_ASSERT_OUTPUT(link());
 
   setUniform(uniformLocation("primTexture"), TextureLayer);
+  transformationProjectionMatrixUniform_ =
+      uniformLocation("transformationProjectionMatrix");
+  primitiveIdOffsetUniform_ = uniformLocation("primitiveIdOffset");
+#ifndef MAGNUM_TARGET_WEBGL
+  texSizeUniform_ = uniformLocation("texSize");
+#endif
 }
 
 PrimitiveIDTexturedShader& PrimitiveIDTexturedShader::bindTexture(
@@ -65,7 +71,12 @@ PrimitiveIDTexturedShader& PrimitiveIDTexturedShader::bindTexture(
 
 // TODO this is a hack and terrible! Properly set texSize for WebGL builds
 #ifndef MAGNUM_TARGET_WEBGL
-  setUniform(uniformLocation("texSize"), texture.imageSize(0).x());
+  // querying the size stalls, skip it when the uniform is already set
+  if (&texture != texSizeTexture_ || texture.id() != texSizeTextureId_) {
+    setUniform(texSizeUniform_, texture.imageSize(0).x());
+    texSizeTexture_ = &texture;
+    texSizeTextureId_ = texture.id();
+  }
 #endif
 
   return *this;
@@ -44,7 +44,19 @@ class PrimitiveIDTexturedShader : public Magnum::GL::AbstractShaderProgram {
    */
   PrimitiveIDTexturedShader& setTransformationProjectionMatrix(
       const Magnum::Matrix4& matrix) {
-    setUniform(uniformLocation("transformationProjectionMatrix"), matrix);
+    setUniform(transformationProjectionMatrixUniform_, matrix);
+    return *this;
+  }
+
+  /**
+   * @brief Set the texel of the first primitive drawn
+   * @return Reference to self (for method chaining)
+   *
+   * Primitive i of a draw call takes its object id from texel
+   * primitiveIdOffset + i of the texture.
+   */
+  PrimitiveIDTexturedShader& setPrimitiveIdOffset(int primitiveIdOffset) {
+    setUniform(primitiveIdOffsetUniform_, primitiveIdOffset);
     return *this;
   }
 
@@ -56,6 +68,15 @@ class PrimitiveIDTexturedShader : public Magnum::GL::AbstractShaderProgram {
    * @see @ref setColor()
    */
   PrimitiveIDTexturedShader& bindTexture(Magnum::GL::Texture2D& texture);
+
+ protected:
+  int transformationProjectionMatrixUniform_ = ID_UNDEFINED;
+  int texSizeUniform_ = ID_UNDEFINED;
+  int primitiveIdOffsetUniform_ = ID_UNDEFINED;
+
+  // texture the texSize uniform was last set for
+  Magnum::GL::Texture2D* texSizeTexture_ = nullptr;
+  Magnum::UnsignedInt texSizeTextureId_ = 0;
 };
 
 }  // namespace gfx
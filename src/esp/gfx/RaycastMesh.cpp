@@ -0,0 +1,50 @@
+// Copyright (c) Facebook, Inc. and its affiliates.
+// This source code is licensed under the MIT license found in the
+// LICENSE file in the root directory of this source tree.
+
+#include "RaycastMesh.h"
+
+#include "esp/scene/SceneNode.h"
+
+namespace esp {
+namespace gfx {
+
+RaycastMesh::RaycastMesh(
+    scene::SceneNode& node,
+    const assets::CollisionMeshData& meshData,
+    const Corrade::Containers::ArrayView<const uint32_t>*
+        primitiveObjectIds /* = nullptr */)
+    : Magnum::SceneGraph::AbstractFeature3D{node},
+      meshData_(meshData),
+      primitiveObjectIds_(primitiveObjectIds) {}
+
+scene::SceneNode& RaycastMesh::getSceneNode() {
+  return static_cast<scene::SceneNode&>(object());
+}
+
+size_t RaycastMesh::getNumTriangles() const {
+  if (meshData_.primitive != Magnum::MeshPrimitive::Triangles) {
+    return 0;
+  }
+  // non-indexed meshes store consecutive vertex triples
+  return meshData_.indices.empty() ? meshData_.positions.size() / 3
+                                   : meshData_.indices.size() / 3;
+}
+
+vec3ui RaycastMesh::getTriangle(size_t i) const {
+  if (meshData_.indices.empty()) {
+    return vec3ui(3 * i, 3 * i + 1, 3 * i + 2);
+  }
+  return vec3ui(meshData_.indices[3 * i], meshData_.indices[3 * i + 1],
+                meshData_.indices[3 * i + 2]);
+}
+
+uint32_t RaycastMesh::getObjectId(size_t i) const {
+  if (primitiveObjectIds_ == nullptr) {
+    return static_cast<const scene::SceneNode&>(object()).getId();
+  }
+  return i < primitiveObjectIds_->size() ? (*primitiveObjectIds_)[i] : 0;
+}
+
+}  // namespace gfx
+}  // namespace esp
@@ -0,0 +1,55 @@
+// Copyright (c) Facebook, Inc. and its affiliates.
+// This source code is licensed under the MIT license found in the
+// LICENSE file in the root directory of this source tree.
+
+#pragma once
+
+#include <Corrade/Containers/ArrayView.h>
+
+#include "esp/assets/CollisionMeshData.h"
+#include "esp/core/esp.h"
+#include "magnum.h"
+
+namespace esp {
+namespace scene {
+class SceneNode;
+}
+namespace gfx {
+
+/**
+ * @brief CPU-side counterpart of a @ref Drawable, used by sensors that ray
+ * cast the scene instead of rasterizing it.
+ *
+ * Attached to the same node as the drawable, it references the mesh data the
+ * asset keeps on the CPU and knows which object id the GL path writes for each
+ * triangle: the per-primitive ids of instance meshes, otherwise the id of the
+ * node itself (see @ref GenericDrawable).
+ */
+class RaycastMesh : public Magnum::SceneGraph::AbstractFeature3D {
+ public:
+  explicit RaycastMesh(
+      scene::SceneNode& node,
+      const assets::CollisionMeshData& meshData,
+      const Corrade::Containers::ArrayView<const uint32_t>*
+          primitiveObjectIds = nullptr);
+
+  scene::SceneNode& getSceneNode();
+
+  const assets::CollisionMeshData& getMeshData() const { return meshData_; }
+
+  //! Number of triangles, 0 if the mesh is not a triangle mesh
+  size_t getNumTriangles() const;
+
+  //! Vertex indices of triangle i
+  vec3ui getTriangle(size_t i) const;
+
+  //! Object id the GL path writes for triangle i
+  uint32_t getObjectId(size_t i) const;
+
+ protected:
+  const assets::CollisionMeshData& meshData_;
+  const Corrade::Containers::ArrayView<const uint32_t>* primitiveObjectIds_;
+};
+
+}  // namespace gfx
+}  // namespace esp
@@ -51,8 +51,15 @@ MagnumCamera& RenderCamera::getMagnumCamera() {
   return *camera_;
 }
 
-void RenderCamera::draw(MagnumDrawableGroup& drawables) {
-  camera_->draw(drawables);
+void RenderCamera::draw(MagnumDrawableGroup& drawables,
+                        const std::vector<bool>* visible /* = nullptr */) {
+  renderQueue_.draw(*camera_, drawables, visible);
+}
+
+void RenderCamera::drawViews(MagnumDrawableGroup& drawables,
+                             Magnum::GL::AbstractFramebuffer& framebuffer,
+                             const std::vector<RenderView>& views) {
+  renderQueue_.drawViews(*camera_, drawables, framebuffer, views);
 }
 
 }  // namespace gfx
@@ -6,6 +6,7 @@
 
 #include "magnum.h"
 
+#include "RenderQueue.h"
 #include "esp/core/esp.h"
 #include "esp/scene/SceneNode.h"
 
@@ -49,10 +50,26 @@ class RenderCamera : public Magnum::SceneGraph::AbstractFeature3D {
 
   MagnumCamera& getMagnumCamera();
 
-  void draw(MagnumDrawableGroup& drawables);
+  //! Draw drawables sorted by GL state, batching repeated GenericDrawables
+  //! into instanced draw calls (see @ref RenderQueue). If visible is given,
+  //! only drawables i of the group with visible[i] set are drawn.
+  void draw(MagnumDrawableGroup& drawables,
+            const std::vector<bool>* visible = nullptr);
+
+  //! Draw drawables into several co-located views of the bound framebuffer
+  //! in one pass (see @ref RenderQueue::drawViews())
+  void drawViews(MagnumDrawableGroup& drawables,
+                 Magnum::GL::AbstractFramebuffer& framebuffer,
+                 const std::vector<RenderView>& views);
+
+  //! Draw calls and state transitions of the last draw()
+  const RenderQueueStats& getRenderStats() const {
+    return renderQueue_.getStats();
+  }
 
  protected:
   MagnumCamera* camera_ = nullptr;
+  RenderQueue renderQueue_;
 
   ESP_SMART_POINTERS(RenderCamera)
 };
@@ -0,0 +1,201 @@
+// Copyright (c) Facebook, Inc. and its affiliates.
+// This source code is licensed under the MIT license found in the
+// LICENSE file in the root directory of this source tree.
+
+#include "RenderQueue.h"
+
+#include <algorithm>
+#include <tuple>
+
+#include <Magnum/Shaders/Flat.h>
+
+#include "DrawableGroup.h"
+#include "GenericDrawable.h"
+
+namespace esp {
+namespace gfx {
+
+void RenderQueue::draw(MagnumCamera& camera,
+                       MagnumDrawableGroup& drawables,
+                       const std::vector<bool>* visible /* = nullptr */) {
+  drawQueue(camera, drawables, visible, nullptr, nullptr);
+}
+
+void RenderQueue::drawViews(MagnumCamera& camera,
+                            MagnumDrawableGroup& drawables,
+                            Magnum::GL::AbstractFramebuffer& framebuffer,
+                            const std::vector<RenderView>& views) {
+  drawQueue(camera, drawables, nullptr, &framebuffer, &views);
+}
+
+void RenderQueue::drawQueue(MagnumCamera& camera,
+                            MagnumDrawableGroup& drawables,
+                            const std::vector<bool>* visible,
+                            Magnum::GL::AbstractFramebuffer* framebuffer,
+                            const std::vector<RenderView>* views) {
+  stats_ = RenderQueueStats{};
+  lastShader_ = nullptr;
+  lastTexture_ = nullptr;
+  lastMesh_ = nullptr;
+  instanced_.newFrame();
+  if (drawables.isEmpty()) {
+    return;
+  }
+  ASSERT(visible == nullptr || visible->size() == drawables.size());
+
+  const size_t numViews = views != nullptr ? views->size() : 1;
+  if (!isQueueValid(drawables) && !buildQueue(drawables)) {
+    // cannot draw foreign drawables ourselves, leave it all to Magnum
+    if (views == nullptr) {
+      camera.draw(drawables);
+      return;
+    }
+    std::vector<std::reference_wrapper<Magnum::SceneGraph::AbstractObject3D>>
+        objects;
+    for (size_t i = 0; i < drawables.size(); ++i) {
+      objects.push_back(drawables[i].object());
+    }
+    const std::vector<Magnum::Matrix4> transformations =
+        camera.object().scene()->transformationMatrices(objects,
+                                                        camera.cameraMatrix());
+    for (const RenderView& view : *views) {
+      framebuffer->setViewport(view.viewport);
+      for (size_t i = 0; i < drawables.size(); ++i) {
+        drawables[i].draw(view.viewMatrix * transformations[i], camera);
+      }
+    }
+    return;
+  }
+
+  // same as Magnum::SceneGraph::Camera::draw()
+  const std::vector<Magnum::Matrix4> transformations =
+      camera.object().scene()->transformationMatrices(objects_,
+                                                      camera.cameraMatrix());
+  if (views != nullptr) {
+    viewTransformations_.resize(numViews);
+    for (size_t v = 0; v < numViews; ++v) {
+      viewTransformations_[v].resize(transformations.size());
+      for (size_t i = 0; i < transformations.size(); ++i) {
+        viewTransformations_[v][i] =
+            (*views)[v].viewMatrix * transformations[i];
+      }
+    }
+  }
+
+  for (size_t begin = 0; begin < queue_.size();) {
+    const Entry& entry = queue_[begin];
+    size_t end = begin + 1;
+    if (entry.instanceable) {
+      while (end < queue_.size() && queue_[end].instanceable &&
+             queue_[end].shader == entry.shader &&
+             queue_[end].texture == entry.texture &&
+             queue_[end].mesh == entry.mesh) {
+        ++end;
+      }
+    }
+
+    batch_.clear();
+    for (size_t i = begin; i < end; ++i) {
+      if (visible == nullptr || (*visible)[queue_[i].index]) {
+        batch_.push_back(i);
+      }
+    }
+
+    for (size_t v = 0; v < numViews; ++v) {
+      const std::vector<Magnum::Matrix4>& viewTransformations =
+          views != nullptr ? viewTransformations_[v] : transformations;
+      if (views != nullptr) {
+        framebuffer->setViewport((*views)[v].viewport);
+      }
+      if (batch_.size() >= InstancedDrawables::kMinInstances) {
+        drawInstanced(viewTransformations, camera);
+      } else {
+        for (size_t i : batch_) {
+          countTransitions(queue_[i].shader, queue_[i].texture,
+                           queue_[i].mesh);
+          queue_[i].drawable->draw(viewTransformations[queue_[i].index],
+                                   camera);
+          ++stats_.drawCalls;
+        }
+      }
+    }
+    begin = end;
+  }
+}
+
+bool RenderQueue::isQueueValid(MagnumDrawableGroup& drawables) const {
+  // comparing the drawables themselves cannot tell a drawable from a new one
+  // allocated at the same address, the generation can. The size also catches
+  // drawables added through the Magnum base class.
+  const auto* group = dynamic_cast<const DrawableGroup*>(&drawables);
+  return group != nullptr && groupGeneration_ == group->getGeneration() &&
+         groupSize_ == drawables.size();
+}
+
+bool RenderQueue::buildQueue(MagnumDrawableGroup& drawables) {
+  groupGeneration_ = 0;
+  objects_.clear();
+  queue_.clear();
+
+  for (size_t i = 0; i < drawables.size(); ++i) {
+    auto* drawable = dynamic_cast<Drawable*>(&drawables[i]);
+    if (drawable == nullptr) {
+      queue_.clear();
+      return false;
+    }
+    queue_.push_back({drawable, i, &drawable->getShader(),
+                      drawable->getTexture(), &drawable->getMesh(),
+                      dynamic_cast<GenericDrawable*>(drawable) != nullptr});
+  }
+  std::stable_sort(queue_.begin(), queue_.end(),
+                   [](const Entry& a, const Entry& b) {
+                     return std::make_tuple(a.shader, a.texture, a.mesh) <
+                            std::make_tuple(b.shader, b.texture, b.mesh);
+                   });
+
+  const auto* group = dynamic_cast<const DrawableGroup*>(&drawables);
+  groupGeneration_ = group != nullptr ? group->getGeneration() : 0;
+  groupSize_ = drawables.size();
+  objects_.reserve(drawables.size());
+  for (size_t i = 0; i < drawables.size(); ++i) {
+    objects_.push_back(drawables[i].object());
+  }
+  return true;
+}
+
+void RenderQueue::drawInstanced(
+    const std::vector<Magnum::Matrix4>& transformations,
+    MagnumCamera& camera) {
+  instancedDrawables_.clear();
+  instanceTransformations_.clear();
+  for (size_t i : batch_) {
+    instancedDrawables_.push_back(
+        static_cast<GenericDrawable*>(queue_[i].drawable));
+    instanceTransformations_.push_back(transformations[queue_[i].index]);
+  }
+
+  const Entry& first = queue_[batch_.front()];
+  const auto& flatShader =
+      static_cast<const Magnum::Shaders::Flat3D&>(*first.shader);
+  countTransitions(&instanced_.getShader(flatShader), first.texture,
+                   first.mesh);
+  instanced_.draw(instancedDrawables_, instanceTransformations_, camera);
+  ++stats_.drawCalls;
+  ++stats_.instancedDrawCalls;
+}
+
+void RenderQueue::countTransitions(Magnum::GL::AbstractShaderProgram* shader,
+                                   Magnum::GL::Texture2D* texture,
+                                   Magnum::GL::Mesh* mesh) {
+  stats_.shaderTransitions += shader != lastShader_;
+  stats_.textureTransitions += texture != nullptr && texture != lastTexture_;
+  stats_.meshTransitions += mesh != lastMesh_;
+  lastShader_ = shader;
+  if (texture != nullptr) {
+    lastTexture_ = texture;
+  }
+  lastMesh_ = mesh;
+}
+
+}  // namespace gfx
+}  // namespace esp
@@ -0,0 +1,161 @@
+// Copyright (c) Facebook, Inc. and its affiliates.
+// This source code is licensed under the MIT license found in the
+// LICENSE file in the root directory of this source tree.
+
+#pragma once
+
+#include <functional>
+#include <vector>
+
+#include <Magnum/GL/AbstractFramebuffer.h>
+#include <Magnum/Math/Range.h>
+
+#include "InstancedDrawables.h"
+#include "esp/core/esp.h"
+#include "magnum.h"
+
+namespace esp {
+namespace gfx {
+
+class Drawable;
+class GenericDrawable;
+
+/**
+ * @brief Draw calls of the last RenderQueue::draw() and how well they are
+ * sorted
+ *
+ * The transitions count consecutive draw calls in submission order that
+ * differ in shader program, texture or mesh. They measure the sort order,
+ * not GL binds: they are an upper bound of the binds the draws cause, as
+ * Magnum skips binding a program or texture that is still bound, and
+ * drawables may bind more than their primary texture.
+ */
+struct RenderQueueStats {
+  //! Draw calls, instanced ones included
+  size_t drawCalls = 0;
+  //! Instanced draw calls
+  size_t instancedDrawCalls = 0;
+  //! Draw calls with a different shader program than the previous one
+  size_t shaderTransitions = 0;
+  //! Draw calls with a different (primary) texture than the previous
+  //! textured one
+  size_t textureTransitions = 0;
+  //! Draw calls with a different mesh than the previous one
+  size_t meshTransitions = 0;
+};
+
+//! One of several co-located views drawn by RenderQueue::drawViews()
+struct RenderView {
+  //! Transformation from camera space to the space of the view, e.g. the
+  //! inverse of an eye offset
+  Magnum::Matrix4 viewMatrix;
+  //! Part of the framebuffer the view is drawn into
+  Magnum::Range2Di viewport;
+};
+
+/**
+ * @brief Draws a drawable group sorted by GL state, with as few draw calls as
+ * possible.
+ *
+ * Behaves like Magnum::SceneGraph::Camera3D::draw(), except that drawables are
+ * submitted sorted by shader program, then texture, then mesh, so that
+ * consecutive draws share as much state as possible. For a
+ * @ref DrawableGroup the sorted queue is cached and only rebuilt when its
+ * generation changes, i.e. when drawables are added to or removed from it;
+ * other groups are sorted on every draw.
+ *
+ * Consecutive @ref GenericDrawable "GenericDrawables" sharing all three (e.g.
+ * many copies of the same physics object) are drawn with a single instanced
+ * draw call by @ref InstancedDrawables.
+ */
+class RenderQueue {
+ public:
+  RenderQueue() = default;
+
+  /**
+   * @brief Draw drawables with camera
+   *
+   * If visible is given, only drawables i of the group with visible[i] set
+   * are drawn, e.g. the ones left after culling.
+   */
+  void draw(MagnumCamera& camera,
+            MagnumDrawableGroup& drawables,
+            const std::vector<bool>* visible = nullptr);
+
+  /**
+   * @brief Draw drawables into several views sharing the projection of camera
+   *
+   * The group is traversed and sorted once; every run of drawables is then
+   * submitted to each view right after the other, so the views share all
+   * state changes. View i is drawn into views[i].viewport of framebuffer,
+   * which has to be bound, and the viewport is left at the last view.
+   */
+  void drawViews(MagnumCamera& camera,
+                 MagnumDrawableGroup& drawables,
+                 Magnum::GL::AbstractFramebuffer& framebuffer,
+                 const std::vector<RenderView>& views);
+
+  const RenderQueueStats& getStats() const { return stats_; }
+
+ protected:
+  struct Entry {
+    Drawable* drawable;
+    // index into the drawable group, i.e. into the transformations
+    size_t index;
+    Magnum::GL::AbstractShaderProgram* shader;
+    Magnum::GL::Texture2D* texture;
+    Magnum::GL::Mesh* mesh;
+    // drawable is a GenericDrawable
+    bool instanceable;
+  };
+
+  //! Draw into views of framebuffer if given, otherwise with camera alone
+  void drawQueue(MagnumCamera& camera,
+                 MagnumDrawableGroup& drawables,
+                 const std::vector<bool>* visible,
+                 Magnum::GL::AbstractFramebuffer* framebuffer,
+                 const std::vector<RenderView>* views);
+
+  //! Whether the cached queue is still valid for drawables
+  bool isQueueValid(MagnumDrawableGroup& drawables) const;
+
+  //! Rebuild the cached queue, false if drawables contains drawables that are
+  //! not gfx::Drawable
+  bool buildQueue(MagnumDrawableGroup& drawables);
+
+  //! Draw the queue entries in batch_ with one instanced draw call
+  void drawInstanced(const std::vector<Magnum::Matrix4>& transformations,
+                     MagnumCamera& camera);
+
+  //! Count the transitions of submitting a draw with the given state
+  void countTransitions(Magnum::GL::AbstractShaderProgram* shader,
+                        Magnum::GL::Texture2D* texture,
+                        Magnum::GL::Mesh* mesh);
+
+  // generation and size of the group the queue was built for, a generation
+  // of 0 if it is no DrawableGroup
+  uint64_t groupGeneration_ = 0;
+  size_t groupSize_ = 0;
+  std::vector<std::reference_wrapper<Magnum::SceneGraph::AbstractObject3D>>
+      objects_;
+  std::vector<Entry> queue_;
+  // queue entries drawn together, reused over frames
+  std::vector<size_t> batch_;
+  // transformations of the drawables in each view of drawViews()
+  std::vector<std::vector<Magnum::Matrix4>> viewTransformations_;
+
+  // drawables of batch_ and their transformations, reused over frames
+  std::vector<GenericDrawable*> instancedDrawables_;
+  std::vector<Magnum::Matrix4> instanceTransformations_;
+  InstancedDrawables instanced_;
+
+  RenderQueueStats stats_;
+  Magnum::GL::AbstractShaderProgram* lastShader_ = nullptr;
+  Magnum::GL::Texture2D* lastTexture_ = nullptr;
+  Magnum::GL::Mesh* lastMesh_ = nullptr;
+
+  ESP_SMART_POINTERS(RenderQueue)
+};
+
+}  // namespace gfx
+}  // namespace esp
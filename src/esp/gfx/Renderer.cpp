@@ -6,6 +6,7 @@
 
 #include "magnum.h"
 
+#include <Corrade/Containers/Optional.h>
 #include <Corrade/Containers/StridedArrayView.h>
 #include <Magnum/GL/Buffer.h>
 #include <Magnum/GL/DefaultFramebuffer.h>
@@ -16,8 +17,13 @@
 #include <Magnum/GL/Renderer.h>
 #include <Magnum/GL/Texture.h>
 #include <Magnum/GL/TextureFormat.h>
+#ifndef MAGNUM_TARGET_GLES
+#include <Magnum/GL/TimeQuery.h>
+#endif
 #include <Magnum/Image.h>
+#include <Magnum/Math/Packing.h>
 #include <Magnum/PixelFormat.h>
+#include <Magnum/PixelStorage.h>
 
 using namespace Magnum;
 
@@ -68,9 +74,19 @@ struct Renderer::Impl {
 
   inline void renderExit() {}
 
-  void draw(RenderCamera& camera, MagnumDrawableGroup& drawables) {
+  void draw(RenderCamera& camera,
+            MagnumDrawableGroup& drawables,
+            const std::string& profileName,
+            const std::vector<RenderView>* views = nullptr) {
+    // a draw that was never read back still has its GPU time pending
+    collectGpuTime();
+    profileName_ = profileName;
+    core::ProfilerScope scope{*profiler_, profileName_ + "/draw"};
+    beginGpuTime();
+
     renderEnter();
-    camera.getMagnumCamera().setViewport(framebufferSize_);
+    camera.getMagnumCamera().setViewport(
+        views != nullptr ? views->front().viewport.size() : framebufferSize_);
 
     /* Inverted projection matrix to unproject the depth value and chop the
        near plane off. We don't care about X/Y there and the corresponding
@@ -117,8 +133,14 @@ struct Renderer::Impl {
        negate just the first row. */
     depthUnprojection_.setRow(0, -depthUnprojection_.row(0));
 
-    camera.draw(drawables);
+    if (views != nullptr) {
+      camera.drawViews(drawables, framebuffer_, *views);
+      framebuffer_.setViewport({{}, framebufferSize_});
+    } else {
+      camera.draw(drawables);
+    }
     renderExit();
+    endGpuTime();
   }
 
   void draw(sensor::Sensor& visualSensor, scene::SceneGraph& sceneGraph) {
@@ -127,21 +149,74 @@ struct Renderer::Impl {
     // set the modelview matrix, projection matrix of the render camera;
     sceneGraph.setDefaultRenderCamera(visualSensor);
 
-    draw(sceneGraph.getDefaultRenderCamera(), sceneGraph.getDrawables());
+    draw(sceneGraph.getDefaultRenderCamera(), sceneGraph.getDrawables(),
+         visualSensor.specification()->uuid);
+  }
+
+  void drawViews(sensor::Sensor& visualSensor,
+                 scene::SceneGraph& sceneGraph,
+                 const std::vector<Matrix4>& viewMatrices) {
+    ASSERT(visualSensor.isVisualSensor());
+    const int numViews = viewMatrices.size();
+    ASSERT(numViews > 0 && framebufferSize_.y() % numViews == 0);
+
+    const Vector2i viewSize{framebufferSize_.x(),
+                            framebufferSize_.y() / numViews};
+    views_.clear();
+    for (int i = 0; i < numViews; ++i) {
+      views_.push_back({viewMatrices[i],
+                        Range2Di::fromSize({0, i * viewSize.y()}, viewSize)});
+    }
+
+    sceneGraph.setDefaultRenderCamera(visualSensor);
+    draw(sceneGraph.getDefaultRenderCamera(), sceneGraph.getDrawables(),
+         visualSensor.specification()->uuid, &views_);
   }
 
   void readFrameRgba(uint8_t* ptr) {
-    framebuffer_.mapForRead(GL::Framebuffer::ColorAttachment{0});
-    Image2D rgbaImage =
-        framebuffer_.read(Range2Di::fromSize({0, 0}, framebufferSize_),
-                          {PixelFormat::RGBA8Unorm});
-    std::memcpy(ptr, rgbaImage.data(), rgbaImage.data().size());
+    {
+      core::ProfilerScope scope{*profiler_, profileName_ + "/readback"};
+      framebuffer_.mapForRead(GL::Framebuffer::ColorAttachment{0});
+      Image2D rgbaImage =
+          framebuffer_.read(Range2Di::fromSize({0, 0}, framebufferSize_),
+                            {PixelFormat::RGBA8Unorm});
+      std::memcpy(ptr, rgbaImage.data(), rgbaImage.data().size());
+    }
+    collectGpuTime();
+  }
+
+  void readFrameRgb(uint8_t* ptr) {
+    {
+      core::ProfilerScope scope{*profiler_, profileName_ + "/readback"};
+      framebuffer_.mapForRead(GL::Framebuffer::ColorAttachment{0});
+      Image2D rgbImage = framebuffer_.read(
+          Range2Di::fromSize({0, 0}, framebufferSize_),
+          {PixelStorage{}.setAlignment(1), PixelFormat::RGB8Unorm});
+      std::memcpy(ptr, rgbImage.data(), rgbImage.data().size());
+    }
+    collectGpuTime();
   }
 
   void readFrameDepth(float* ptr) {
+    readFrameDepth([ptr](std::size_t i, Float depth) { ptr[i] = depth; });
+  }
+
+  void readFrameDepthHalf(uint16_t* ptr) {
+    readFrameDepth(
+        [ptr](std::size_t i, Float depth) { ptr[i] = Math::packHalf(depth); });
+  }
+
+  // unproject the depth buffer, passing each pixel's depth to store
+  template <class Store>
+  void readFrameDepth(Store store) {
+    const int64_t readbackStartNs = core::Profiler::now();
     Image2D depthImage = framebuffer_.read(
         Range2Di::fromSize({0, 0}, framebufferSize_),
         {GL::PixelFormat::DepthComponent, GL::PixelType::Float});
+    profiler_->record(profileName_ + "/readback", readbackStartNs,
+                      core::Profiler::now() - readbackStartNs);
+    collectGpuTime();
+    core::ProfilerScope scope{*profiler_, profileName_ + "/unproject"};
 
     /* Unproject the Z */
     Containers::ArrayView<const Float> data =
@@ -154,7 +229,7 @@ struct Renderer::Impl {
          We can afford using == for comparison as 1.0f has an exact
          representation and the depth is cleared to exactly this value. */
       if (z == 1.0f) {
-        ptr[i] = 0.0f;
+        store(i, 0.0f);
         continue;
       }
 
@@ -163,17 +238,58 @@ struct Renderer::Impl {
           (az + b) / (cz + d)
 
          See the comment in draw() above for details. */
-      ptr[i] =
-          Math::fma(depthUnprojection_[0][0], z, depthUnprojection_[1][0]) /
-          Math::fma(depthUnprojection_[0][1], z, depthUnprojection_[1][1]);
+      store(i,
+            Math::fma(depthUnprojection_[0][0], z, depthUnprojection_[1][0]) /
+                Math::fma(depthUnprojection_[0][1], z,
+                          depthUnprojection_[1][1]));
     }
   }
 
   void readFrameObjectId(uint32_t* ptr) {
-    framebuffer_.mapForRead(GL::Framebuffer::ColorAttachment{1});
-    Image2D objectImage = framebuffer_.read(
-        Range2Di::fromSize({0, 0}, framebufferSize_), {PixelFormat::R32UI});
-    std::memcpy(ptr, objectImage.data(), objectImage.data().size());
+    {
+      core::ProfilerScope scope{*profiler_, profileName_ + "/readback"};
+      framebuffer_.mapForRead(GL::Framebuffer::ColorAttachment{1});
+      Image2D objectImage = framebuffer_.read(
+          Range2Di::fromSize({0, 0}, framebufferSize_), {PixelFormat::R32UI});
+      std::memcpy(ptr, objectImage.data(), objectImage.data().size());
+    }
+    collectGpuTime();
+  }
+
+  // GPU time of a draw is measured with a time elapsed query and collected
+  // after the readback, when the result is available without stalling
+  void beginGpuTime() {
+#ifndef MAGNUM_TARGET_GLES
+    if (!profiler_->isEnabled()) {
+      return;
+    }
+    if (!gpuTimer_) {
+      gpuTimer_.emplace(GL::TimeQuery::Target::TimeElapsed);
+    }
+    gpuTimerStartNs_ = core::Profiler::now();
+    gpuTimer_->begin();
+    gpuTimerPending_ = true;
+#endif
+  }
+
+  void endGpuTime() {
+#ifndef MAGNUM_TARGET_GLES
+    if (gpuTimerPending_) {
+      gpuTimer_->end();
+    }
+#endif
+  }
+
+  void collectGpuTime() {
+#ifndef MAGNUM_TARGET_GLES
+    if (!gpuTimerPending_) {
+      return;
+    }
+    gpuTimerPending_ = false;
+    // the GPU time is placed at the draw submission on the trace
+    profiler_->record(profileName_ + "/gpu", gpuTimerStartNs_,
+                      gpuTimer_->result<UnsignedLong>(), "gpu");
+#endif
   }
 
   Magnum::Vector2i framebufferSize_;
@@ -183,13 +299,22 @@ struct Renderer::Impl {
   GL::Framebuffer framebuffer_;
 
   Matrix2x2 depthUnprojection_;
+  std::vector<RenderView> views_;
+
+  core::Profiler::ptr profiler_ = core::Profiler::create();
+  std::string profileName_ = "renderer";
+#ifndef MAGNUM_TARGET_GLES
+  Containers::Optional<GL::TimeQuery> gpuTimer_;
+  bool gpuTimerPending_ = false;
+  int64_t gpuTimerStartNs_ = 0;
+#endif
 };
 
 Renderer::Renderer(int width, int height)
     : pimpl_(spimpl::make_unique_impl<Impl>(width, height)) {}
 
 void Renderer::draw(RenderCamera& camera, scene::SceneGraph& sceneGraph) {
-  pimpl_->draw(camera, sceneGraph.getDrawables());
+  pimpl_->draw(camera, sceneGraph.getDrawables(), "renderer");
 }
 
 void Renderer::draw(sensor::Sensor& visualSensor,
@@ -197,6 +322,12 @@ void Renderer::draw(sensor::Sensor& visualSensor,
   pimpl_->draw(visualSensor, sceneGraph);
 }
 
+void Renderer::drawViews(sensor::Sensor& visualSensor,
+                         scene::SceneGraph& sceneGraph,
+                         const std::vector<Magnum::Matrix4>& viewMatrices) {
+  pimpl_->drawViews(visualSensor, sceneGraph, viewMatrices);
+}
+
 void Renderer::setSize(int width, int height) {
   pimpl_->setSize(width, height);
 }
@@ -205,14 +336,26 @@ void Renderer::readFrameRgba(uint8_t* ptr) {
   pimpl_->readFrameRgba(ptr);
 }
 
+void Renderer::readFrameRgb(uint8_t* ptr) {
+  pimpl_->readFrameRgb(ptr);
+}
+
 void Renderer::readFrameDepth(float* ptr) {
   pimpl_->readFrameDepth(ptr);
 }
 
+void Renderer::readFrameDepthHalf(uint16_t* ptr) {
+  pimpl_->readFrameDepthHalf(ptr);
+}
+
 void Renderer::readFrameObjectId(uint32_t* ptr) {
   pimpl_->readFrameObjectId(ptr);
 }
 
+core::Profiler& Renderer::getProfiler() {
+  return *pimpl_->profiler_;
+}
+
 vec3i Renderer::getSize() {
   return vec3i(pimpl_->framebufferSize_[0], pimpl_->framebufferSize_[1], 4);
 }
@@ -4,6 +4,7 @@
 
 #pragma once
 
+#include "esp/core/Profiler.h"
 #include "esp/core/esp.h"
 #include "esp/gfx/RenderCamera.h"
 #include "esp/scene/SceneGraph.h"
@@ -12,6 +13,15 @@
 namespace esp {
 namespace gfx {
 
+/**
+ * Draws scene graphs into an offscreen framebuffer and reads it back.
+ *
+ * When @ref getProfiler() is enabled, every draw records the CPU time of the
+ * draw submission ("<name>/draw"), the GPU time of the draw measured with a
+ * timer query where available ("<name>/gpu"), the readback
+ * ("<name>/readback") and the depth unprojection ("<name>/unproject"), where
+ * name is the uuid of the drawn sensor or "renderer" for a plain camera.
+ */
 class Renderer {
  public:
   Renderer(int width, int height);
@@ -22,6 +32,19 @@ class Renderer {
   // draw the scene graph with the visual sensor provided by user
   void draw(sensor::Sensor& visualSensor, scene::SceneGraph& sceneGraph);
 
+  /**
+   * @brief Draw the scene graph into several co-located views of the visual
+   * sensor in one pass, e.g. the two eyes of a stereo camera
+   *
+   * View i, seen through viewMatrices[i] applied after the camera matrix of
+   * the sensor, is drawn into rows [i * height, (i + 1) * height) of the
+   * framebuffer, whose height has to be a multiple of the number of views.
+   * A readback then holds all views one after the other.
+   */
+  void drawViews(sensor::Sensor& visualSensor,
+                 scene::SceneGraph& sceneGraph,
+                 const std::vector<Magnum::Matrix4>& viewMatrices);
+
   // draw the scene graph with the default camera in scene graph
   // user needs to set the default camera so that it has correct
   // modelview matrix, projection matrix to render the scene
@@ -30,14 +53,22 @@ class Renderer {
 
   void readFrameRgba(uint8_t* ptr);
 
+  //! Read color without alpha, 3 tightly packed bytes per pixel
+  void readFrameRgb(uint8_t* ptr);
+
   void readFrameDepth(float* ptr);
 
+  //! Read depth as IEEE 754 half floats
+  void readFrameDepthHalf(uint16_t* ptr);
+
   void readFrameObjectId(uint32_t* ptr);
 
   void setSize(int width, int height);
 
   vec3i getSize();
 
+  core::Profiler& getProfiler();
+
   ESP_SMART_POINTERS_WITH_UNIQUE_PIMPL(Renderer)
 };
 
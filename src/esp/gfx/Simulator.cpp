@@ -4,7 +4,9 @@
 
 #include "Simulator.h"
 
+#include <algorithm>
 #include <string>
+#include <vector>
 
 #include <Corrade/Containers/Pointer.h>
 #include <Corrade/Utility/String.h>
@@ -69,9 +71,21 @@ void Simulator::reconfigure(const SimulatorConfiguration& cfg) {
   const assets::AssetInfo sceneInfo =
       assets::AssetInfo::fromPath(sceneFilename);
 
+  // scene graphs of the previous scene, whose drawables are deleted and
+  // assets released once the new scene is loaded
+  std::vector<int> previousSceneIDs;
+  for (int sceneID : {activeSceneID_, activeSemanticSceneID_}) {
+    if (sceneID != ID_UNDEFINED &&
+        std::find(previousSceneIDs.begin(), previousSceneIDs.end(),
+                  sceneID) == previousSceneIDs.end()) {
+      previousSceneIDs.push_back(sceneID);
+    }
+  }
+
   // initalize scene graph
   // CAREFUL!
-  // previous scene graph is not deleted!
+  // previous scene graph is not deleted, only its drawables, as agents may
+  // still be attached to it!
   // TODO:
   // We need to make a design decision here:
   // when doing reconfigure, shall we delete all of the previous scene graphs
@@ -81,7 +95,9 @@ void Simulator::reconfigure(const SimulatorConfiguration& cfg) {
 
   if (cfg.createRenderer) {
     if (!context_) {
-      context_ = std::make_unique<gfx::WindowlessContext>(config_.gpuDeviceId);
+      context_ = std::make_unique<gfx::WindowlessContext>(
+          config_.gpuDeviceId, config_.softwareRendering,
+          config_.numRenderThreads);
     }
 
     // reinitalize members
@@ -93,6 +109,11 @@ void Simulator::reconfigure(const SimulatorConfiguration& cfg) {
     auto& rootNode = sceneGraph.getRootNode();
     auto& drawables = sceneGraph.getDrawables();
     resourceManager_.compressTextures(cfg.compressTextures);
+    resourceManager_.textureCacheDir(cfg.textureCacheDir);
+    resourceManager_.sceneCacheDir(cfg.sceneCacheDir);
+    resourceManager_.shareMeshMemory(cfg.shareMeshMemory);
+    resourceManager_.meshLodLevels(cfg.meshLodLevels);
+    resourceManager_.assetMemoryBudget(cfg.assetMemoryBudget);
 
     bool loadSuccess = false;
     if (config_.enablePhysics) {
@@ -136,6 +157,12 @@ void Simulator::reconfigure(const SimulatorConfiguration& cfg) {
         sceneInfo.type == assets::AssetType::INSTANCE_MESH) {
       activeSemanticSceneID_ = activeSceneID_;
     }
+
+    // after loading, so that assets shared with the new scene stay loaded
+    for (int sceneID : previousSceneIDs) {
+      resourceManager_.releaseScene(
+          sceneManager_.getSceneGraph(sceneID).getDrawables());
+    }
   }
 
   semanticScene_ = nullptr;
@@ -153,6 +180,28 @@ void Simulator::reconfigure(const SimulatorConfiguration& cfg) {
   reset();
 }
 
+std::shared_future<bool> Simulator::prefetchScene(
+    const scene::SceneConfiguration& cfg) {
+  // the same files reconfigure() loads for the scene
+  std::string sceneFilename = cfg.id;
+  if (cfg.filepaths.count("mesh")) {
+    sceneFilename = cfg.filepaths.at("mesh");
+  }
+  std::string houseFilename = io::changeExtension(sceneFilename, ".house");
+  if (cfg.filepaths.count("house")) {
+    houseFilename = cfg.filepaths.at("house");
+  }
+
+  std::vector<assets::AssetInfo> infos{
+      assets::AssetInfo::fromPath(sceneFilename)};
+  const std::string semanticMeshFilename =
+      io::removeExtension(houseFilename) + "_semantic.ply";
+  if (io::exists(houseFilename) && io::exists(semanticMeshFilename)) {
+    infos.emplace_back(assets::AssetInfo::fromPath(semanticMeshFilename));
+  }
+  return resourceManager_.prefetch(infos);
+}
+
 void Simulator::reset() {
   if (physicsManager_ != nullptr)
     physicsManager_
@@ -193,6 +242,11 @@ bool operator==(const SimulatorConfiguration& a,
   return a.scene == b.scene && a.defaultAgentId == b.defaultAgentId &&
          a.defaultCameraUuid == b.defaultCameraUuid &&
          a.compressTextures == b.compressTextures &&
+         a.textureCacheDir == b.textureCacheDir &&
+         a.sceneCacheDir == b.sceneCacheDir &&
+         a.shareMeshMemory == b.shareMeshMemory &&
+         a.meshLodLevels == b.meshLodLevels &&
+         a.assetMemoryBudget == b.assetMemoryBudget &&
          a.createRenderer == b.createRenderer &&
          a.enablePhysics == b.enablePhysics &&
          a.physicsConfigFile.compare(b.physicsConfigFile) == 0;
@@ -4,6 +4,8 @@
 
 #pragma once
 
+#include <future>
+
 #include "WindowlessContext.h"
 #include "esp/core/esp.h"
 #include "esp/core/random.h"
@@ -30,8 +32,27 @@ struct SimulatorConfiguration {
   scene::SceneConfiguration scene;
   int defaultAgentId = 0;
   int gpuDeviceId = 0;
+  // render on the CPU (Mesa llvmpipe) instead of gpuDeviceId
+  bool softwareRendering = false;
+  // rasterizer threads used by software rendering, 0 for one per core
+  int numRenderThreads = 0;
   std::string defaultCameraUuid = "rgba_camera";
   bool compressTextures = false;
+  // directory caching compressed textures between runs, empty disables it
+  std::string textureCacheDir = "";
+  // directory caching preprocessed PTex meshes between runs, empty disables
+  // it
+  std::string sceneCacheDir = "";
+  // map the CPU-side data of PTex and instance meshes read-only from their
+  // cache files in sceneCacheDir, shared by all processes on the node, instead
+  // of copying it; a sceneCacheDir in /dev/shm keeps it in shared memory
+  bool shareMeshMemory = false;
+  // coarser levels of detail generated (once, cached next to the asset) for
+  // glTF and other general meshes and picked by projected size at draw time
+  int meshLodLevels = 0;
+  // bytes of CPU and GPU memory assets may take before those of previous
+  // scenes are unloaded, least recently used first; 0 keeps all loaded
+  size_t assetMemoryBudget = 0;
   bool createRenderer = true;
   int width = 256, height = 256;
 
@@ -55,6 +76,11 @@ class Simulator {
 
   virtual void reconfigure(const SimulatorConfiguration& cfg);
 
+  //! Start importing the assets of the scene on a background thread, so that
+  //! a later reconfigure() to it only uploads them to the GPU. The future
+  //! becomes ready once they are imported.
+  std::shared_future<bool> prefetchScene(const scene::SceneConfiguration& cfg);
+
   virtual void reset();
 
   virtual void seed(uint32_t newSeed);
@@ -62,6 +88,7 @@ class Simulator {
   std::shared_ptr<Renderer> getRenderer();
   std::shared_ptr<physics::PhysicsManager> getPhysicsManager();
   std::shared_ptr<scene::SemanticScene> getSemanticScene();
+  assets::ResourceManager& getResourceManager() { return resourceManager_; }
 
   scene::SceneGraph& getActiveSceneGraph();
   scene::SceneGraph& getActiveSemanticSceneGraph();
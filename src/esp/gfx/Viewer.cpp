@@ -255,7 +255,7 @@ void Viewer::drawEvent() {
   int DEFAULT_SCENE = 0;
   int sceneID = sceneID_[DEFAULT_SCENE];
   auto& sceneGraph = sceneManager_.getSceneGraph(sceneID);
-  renderCamera_->getMagnumCamera().draw(sceneGraph.getDrawables());
+  renderCamera_->draw(sceneGraph.getDrawables());
 
   swapBuffers();
   timeline_.nextFrame();
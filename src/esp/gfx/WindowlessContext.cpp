@@ -22,6 +22,8 @@
 #include <fcntl.h>
 #include <sys/stat.h>
 #include <unistd.h>
+#include <cstdlib>
+#include <cstring>
 #elif defined(CORRADE_TARGET_WINDOWS)
 #include <Magnum/Platform/WindowlessWglApplication.h>
 #endif
@@ -41,6 +43,20 @@ namespace gfx {
 
 namespace {
 
+bool softwareRenderingForced() {
+  const char* value = std::getenv("HABITAT_SIM_SOFTWARE_RENDERING");
+  return value != nullptr && std::strcmp(value, "1") == 0;
+}
+
+// Mesa reads these when the driver is loaded, so they have to be set before
+// the display is initialized
+void configureSoftwareRendering(int numRenderThreads) {
+  setenv("LIBGL_ALWAYS_SOFTWARE", "1", 1);
+  if (numRenderThreads > 0) {
+    setenv("LP_NUM_THREADS", std::to_string(numRenderThreads).c_str(), 1);
+  }
+}
+
 struct ESPContext {
   virtual void makeCurrent() = 0;
   virtual bool isValid() = 0;
@@ -69,8 +85,51 @@ bool isNvidiaGpuReadable(int device) {
   return true;
 }
 
+int findCudaDevice(EGLDeviceEXT* eglDevices, int numDevices, int device) {
+  int eglDevId;
+  for (eglDevId = 0; eglDevId < numDevices; ++eglDevId) {
+    EGLAttrib cudaDevNumber;
+
+    if (eglQueryDeviceAttribEXT(eglDevices[eglDevId], EGL_CUDA_DEVICE_NV,
+                                &cudaDevNumber) == EGL_FALSE)
+      continue;
+
+    if (cudaDevNumber == device)
+      break;
+  }
+
+  CHECK(eglDevId < numDevices)
+      << "[EGL] Could not find an EGL device for CUDA device " << device;
+
+  CHECK(isNvidiaGpuReadable(eglDevId))
+      << "[EGL] EGL device " << eglDevId << ", CUDA device " << device
+      << " is not readable";
+
+  LOG(INFO) << "[EGL] Selected EGL device " << eglDevId << " for CUDA device "
+            << device;
+  return eglDevId;
+}
+
+// Mesa exposes its software rasterizer (llvmpipe, or softpipe without LLVM)
+// as an EGL device advertising EGL_MESA_device_software
+int findSoftwareDevice(EGLDeviceEXT* eglDevices, int numDevices) {
+  for (int eglDevId = 0; eglDevId < numDevices; ++eglDevId) {
+    const char* extensions =
+        eglQueryDeviceStringEXT(eglDevices[eglDevId], EGL_EXTENSIONS);
+    if (extensions != nullptr &&
+        std::strstr(extensions, "EGL_MESA_device_software") != nullptr) {
+      LOG(INFO) << "[EGL] Selected software EGL device " << eglDevId;
+      return eglDevId;
+    }
+  }
+  LOG(FATAL) << "[EGL] Could not find a software EGL device. Software "
+                "rendering needs Mesa's libEGL (llvmpipe), e.g. via glvnd";
+  return ID_UNDEFINED;
+}
+
 struct ESPEGLContext : ESPContext {
-  ESPEGLContext(int device) : magnumGlContext_{NoCreate} {
+  ESPEGLContext(int device, bool softwareRendering)
+      : magnumGlContext_{NoCreate} {
     CHECK(gladLoadEGL()) << "Failed to load EGL";
 
     static const EGLint configAttribs[] = {EGL_SURFACE_TYPE,
@@ -97,27 +156,10 @@ struct ESPEGLContext : ESPContext {
       CHECK(numDevices > 0) << "[EGL] No devices detected";
       LOG(INFO) << "[EGL] Detected " << numDevices << " EGL devices";
 
-      int eglDevId;
-      for (eglDevId = 0; eglDevId < numDevices; ++eglDevId) {
-        EGLAttrib cudaDevNumber;
-
-        if (eglQueryDeviceAttribEXT(eglDevices[eglDevId], EGL_CUDA_DEVICE_NV,
-                                    &cudaDevNumber) == EGL_FALSE)
-          continue;
-
-        if (cudaDevNumber == device)
-          break;
-      }
-
-      CHECK(eglDevId < numDevices)
-          << "[EGL] Could not find an EGL device for CUDA device " << device;
-
-      CHECK(isNvidiaGpuReadable(eglDevId))
-          << "[EGL] EGL device " << eglDevId << ", CUDA device " << device
-          << " is not readable";
+      const int eglDevId = softwareRendering
+                               ? findSoftwareDevice(eglDevices, numDevices)
+                               : findCudaDevice(eglDevices, numDevices, device);
 
-      LOG(INFO) << "[EGL] Selected EGL device " << eglDevId
-                << " for CUDA device " << device;
       display_ = eglGetPlatformDisplayEXT(EGL_PLATFORM_DEVICE_EXT,
                                           eglDevices[eglDevId], 0);
       CHECK_EGL_ERROR();
@@ -220,11 +262,15 @@ struct ESPGLXContext : ESPContext {
 };  // namespace
 
 struct WindowlessContext::Impl {
-  Impl(int device) {
+  Impl(int device, bool softwareRendering, int numRenderThreads)
+      : softwareRendering_(softwareRendering || softwareRenderingForced()) {
+    if (softwareRendering_) {
+      configureSoftwareRendering(numRenderThreads);
+    }
 #ifdef ESP_BUILD_EGL_SUPPORT
-    glContext_ = ESPEGLContext::create_unique(device);
+    glContext_ = ESPEGLContext::create_unique(device, softwareRendering_);
 #else
-    CHECK_EQ(device, 0)
+    CHECK(softwareRendering_ || device == 0)
         << "glX context does not support multiple GPUs. Please compile with "
            "BUILD_GUI_VIEWERS=0 for multi-gpu support via EGL";
     CHECK(std::getenv("DISPLAY") != nullptr)
@@ -235,6 +281,15 @@ struct WindowlessContext::Impl {
 #endif
 
     makeCurrent();
+
+    const std::string renderer = GL::Context::current().rendererString();
+    LOG(INFO) << "OpenGL renderer: " << renderer;
+    if (softwareRendering_ && renderer.find("llvmpipe") == std::string::npos &&
+        renderer.find("softpipe") == std::string::npos) {
+      LOG(WARNING) << "Software rendering was requested but the OpenGL "
+                      "renderer is "
+                   << renderer;
+    }
   }
 
   ~Impl() { LOG(INFO) << "Deconstructing GL context"; }
@@ -242,12 +297,18 @@ struct WindowlessContext::Impl {
   void makeCurrent() { glContext_->makeCurrent(); }
 
   ESPContext::uptr glContext_ = nullptr;
+  bool softwareRendering_ = false;
 };
 
 #else  // not defined(CORRADE_TARGET_UNIX) && !defined(CORRADE_TARGET_APPLE)
 
 struct WindowlessContext::Impl {
-  Impl(int device) : glContext_({}), magnumGlContext_(NoCreate) {
+  Impl(int device, bool softwareRendering, int numRenderThreads)
+      : glContext_({}), magnumGlContext_(NoCreate) {
+    if (softwareRendering) {
+      LOG(WARNING) << "Software rendering is only supported on Linux, using "
+                      "the default OpenGL driver";
+    }
     glContext_.makeCurrent();
     if (!magnumGlContext_.tryCreate()) {
       LOG(ERROR) << "Failed to create GL context";
@@ -260,12 +321,21 @@ struct WindowlessContext::Impl {
 
   Platform::WindowlessGLContext glContext_;
   Platform::GLContext magnumGlContext_;
+  bool softwareRendering_ = false;
 };
 
 #endif
 
-WindowlessContext::WindowlessContext(int device /* = 0 */)
-    : pimpl_(spimpl::make_unique_impl<Impl>(device)) {}
+WindowlessContext::WindowlessContext(int device /* = 0 */,
+                                     bool softwareRendering /* = false */,
+                                     int numRenderThreads /* = 0 */)
+    : pimpl_(spimpl::make_unique_impl<Impl>(device,
+                                            softwareRendering,
+                                            numRenderThreads)) {}
+
+bool WindowlessContext::isSoftwareRendering() const {
+  return pimpl_->softwareRendering_;
+}
 
 void WindowlessContext::makeCurrent() {
   pimpl_->makeCurrent();
@@ -9,9 +9,24 @@
 namespace esp {
 namespace gfx {
 
+/**
+ * @brief Headless OpenGL context.
+ *
+ * By default the context is created on the CUDA device gpuDevice. With
+ * softwareRendering the context is instead created on Mesa's llvmpipe
+ * rasterizer so rendering works on CPU-only machines; numRenderThreads then
+ * bounds the number of rasterizer threads (0 leaves it to the driver, which
+ * uses one thread per core). Software rendering can also be forced by setting
+ * the HABITAT_SIM_SOFTWARE_RENDERING environment variable to 1, e.g. to run
+ * the test suite on machines without a GPU.
+ */
 class WindowlessContext {
  public:
-  explicit WindowlessContext(int gpuDevice = 0);
+  explicit WindowlessContext(int gpuDevice = 0,
+                             bool softwareRendering = false,
+                             int numRenderThreads = 0);
+
+  bool isSoftwareRendering() const;
 
   void makeCurrent();
 
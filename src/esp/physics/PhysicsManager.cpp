@@ -67,7 +67,8 @@ int PhysicsManager::addObject(const int objectLibIndex,
   }
 
   //! Instantiate with mesh pointer
-  int nextObjectID_ = makeRigidObject(meshGroup, physicsObjectAttributes);
+  int nextObjectID_ =
+      makeRigidObject(configFile, meshGroup, physicsObjectAttributes);
   if (nextObjectID_ < 0) {
     LOG(ERROR) << "makeRigidObject unsuccessful";
     return -1;
@@ -134,6 +135,7 @@ int PhysicsManager::deallocateObjectID(int physObjectID) {
 
 //! Create and initialize rigid object
 int PhysicsManager::makeRigidObject(
+    const std::string& configFile,
     const std::vector<assets::CollisionMeshData>& meshGroup,
     assets::PhysicsObjectAttributes physicsObjectAttributes) {
   //! Create new physics object (child node of sceneNode_)
@@ -188,6 +188,7 @@ class PhysicsManager {
 
   //! Create and initialize rigid object
   virtual int makeRigidObject(
+      const std::string& configFile,
       const std::vector<assets::CollisionMeshData>& meshGroup,
       assets::PhysicsObjectAttributes physicsObjectAttributes);
 
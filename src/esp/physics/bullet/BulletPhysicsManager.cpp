@@ -65,8 +65,18 @@ bool BulletPhysicsManager::addScene(
 }
 
 int BulletPhysicsManager::makeRigidObject(
+    const std::string& configFile,
     const std::vector<assets::CollisionMeshData>& meshGroup,
     assets::PhysicsObjectAttributes physicsObjectAttributes) {
+  //! Build the collision shape with the first instance, from the convex
+  //! decomposition cached next to the config if there is one
+  BulletObjectShape::ptr& shape = objectShapes_[configFile];
+  if (!shape) {
+    shape = BulletRigidObject::createObjectShape(
+        meshGroup, resourceManager_->getCollisionHulls(configFile),
+        physicsObjectAttributes.getDouble("margin"));
+  }
+
   //! Create new physics object (child node of sceneNode_)
   int newObjectID = allocateObjectID();
   existingObjects_[newObjectID] = new BulletRigidObject(sceneNode_);
@@ -74,7 +84,7 @@ int BulletPhysicsManager::makeRigidObject(
   //! Instantiate with mesh pointer
   bool objectSuccess =
       static_cast<BulletRigidObject*>(existingObjects_.at(newObjectID))
-          ->initializeObject(physicsObjectAttributes, meshGroup, bWorld_);
+          ->initializeObject(physicsObjectAttributes, shape, bWorld_);
   if (!objectSuccess) {
     LOG(ERROR) << "Object load failed";
     deallocateObjectID(newObjectID);
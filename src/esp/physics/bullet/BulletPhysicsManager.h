@@ -74,9 +74,14 @@ class BulletPhysicsManager : public PhysicsManager {
   bool isMeshPrimitiveValid(const assets::CollisionMeshData& meshData);
 
   //! Create and initialize rigid object
-  int makeRigidObject(const std::vector<assets::CollisionMeshData>& meshGroup,
+  int makeRigidObject(const std::string& configFile,
+                      const std::vector<assets::CollisionMeshData>& meshGroup,
                       assets::PhysicsObjectAttributes physicsObjectAttributes);
 
+  //! Collision shape of each object config file instantiated so far, shared
+  //! by all of its instances
+  std::map<std::string, BulletObjectShape::ptr> objectShapes_;
+
   ESP_SMART_POINTERS(BulletPhysicsManager)
 
 };  // end class BulletPhysicsManager
@@ -107,6 +107,52 @@ bool BulletRigidObject::initializeObject(
     const assets::PhysicsObjectAttributes& physicsObjectAttributes,
     const std::vector<assets::CollisionMeshData>& meshGroup,
     std::shared_ptr<btDiscreteDynamicsWorld> bWorld) {
+  return initializeObject(
+      physicsObjectAttributes,
+      createObjectShape(meshGroup, {},
+                        physicsObjectAttributes.getDouble("margin")),
+      bWorld);
+}
+
+BulletObjectShape::ptr BulletRigidObject::createObjectShape(
+    const std::vector<assets::CollisionMeshData>& meshGroup,
+    const std::vector<assets::CollisionHull>& hulls,
+    double margin) {
+  auto shape = BulletObjectShape::create();
+  auto addConvexShape = [&](const Magnum::Vector3* points, size_t numPoints) {
+    btTransform t;  // position and rotation
+    t.setIdentity();
+    //! Create convex component
+    shape->convexShapes.emplace_back(std::make_unique<btConvexHullShape>(
+        static_cast<const btScalar*>(points->data()), numPoints,
+        sizeof(Magnum::Vector3)));
+    shape->convexShapes.back()->setMargin(margin);
+    //! Add to compound shape stucture
+    shape->compound.addChildShape(t, shape->convexShapes.back().get());
+  };
+
+  //! A few simplified hulls collide much faster than the hulls of all
+  //! vertices of each mesh component
+  if (!hulls.empty()) {
+    for (const assets::CollisionHull& hull : hulls) {
+      addConvexShape(hull.points.data(), hull.points.size());
+    }
+  } else {
+    //! Iterate through all mesh components for one object
+    //! The components are combined into a convex compound shape
+    for (const assets::CollisionMeshData& meshData : meshGroup) {
+      addConvexShape(meshData.positions.data(), meshData.positions.size());
+    }
+  }
+  //! Set properties
+  shape->compound.setMargin(margin);
+  return shape;
+}
+
+bool BulletRigidObject::initializeObject(
+    const assets::PhysicsObjectAttributes& physicsObjectAttributes,
+    BulletObjectShape::ptr shape,
+    std::shared_ptr<btDiscreteDynamicsWorld> bWorld) {
   // TODO (JH): Handling static/kinematic object type
   if (rigidObjectType_ != NONE) {
     LOG(ERROR) << "Cannot initialized a RigidObject more than once";
@@ -117,54 +163,15 @@ bool BulletRigidObject::initializeObject(
   rigidObjectType_ = OBJECT;
   objectMotionType_ = DYNAMIC;
 
-  //! Create Bullet Object
-  btIndexedMesh bulletMesh;
-
-  //! Physical parameters
-  double margin = physicsObjectAttributes.getDouble("margin");
-
-  //! Iterate through all mesh components for one object
-  //! The components are combined into a convex compound shape
-  bObjectShape_ = std::make_unique<btCompoundShape>();
-  for (const assets::CollisionMeshData& meshData : meshGroup) {
-    Corrade::Containers::ArrayView<Magnum::Vector3> v_data = meshData.positions;
-    Corrade::Containers::ArrayView<Magnum::UnsignedInt> ui_data =
-        meshData.indices;
-
-    //! Configure Bullet Mesh
-    //! This part is very likely to cause segfault, if done incorrectly
-    bulletMesh.m_numTriangles = ui_data.size() / 3;
-    bulletMesh.m_triangleIndexBase =
-        reinterpret_cast<const unsigned char*>(ui_data.data());
-    bulletMesh.m_triangleIndexStride = 3 * sizeof(Magnum::UnsignedInt);
-    bulletMesh.m_numVertices = v_data.size();
-    //! Get the pointer to the first float of the first triangle
-    bulletMesh.m_vertexBase =
-        reinterpret_cast<const unsigned char*>(v_data.data()->data());
-    bulletMesh.m_vertexStride = sizeof(Magnum::Vector3);
-    bulletMesh.m_indexType = PHY_INTEGER;
-    bulletMesh.m_vertexType = PHY_FLOAT;
-
-    btTransform t;  // position and rotation
-    t.setIdentity();
-    t.setOrigin(btVector3(0, 0, 0));
-    //! Create convex component
-    bObjectConvexShapes_.emplace_back(std::make_unique<btConvexHullShape>(
-        static_cast<const btScalar*>(meshData.positions.data()->data()),
-        meshData.positions.size(), sizeof(Magnum::Vector3)));
-    bObjectConvexShapes_.back()->setMargin(margin);
-    //! Add to compound shape stucture
-    bObjectShape_->addChildShape(t, bObjectConvexShapes_.back().get());
-  }
-  //! Set properties
-  bObjectShape_->setMargin(margin);
+  bObjectShape_ = std::move(shape);
+  btCompoundShape& compound = bObjectShape_->compound;
 
   btVector3 bInertia =
       btVector3(physicsObjectAttributes.getMagnumVec3("inertia"));
 
   if (bInertia[0] == 0. && bInertia[1] == 0. && bInertia[2] == 0.) {
     // allow bullet to compute the inertia tensor if we don't have one
-    bObjectShape_->calculateLocalInertia(
+    compound.calculateLocalInertia(
         physicsObjectAttributes.getDouble("mass"),
         bInertia);  // overrides bInertia
     LOG(INFO) << "Automatic object inertia computed: " << bInertia.x() << " "
@@ -176,8 +183,7 @@ bool BulletRigidObject::initializeObject(
   btRigidBody::btRigidBodyConstructionInfo info =
       btRigidBody::btRigidBodyConstructionInfo(
           physicsObjectAttributes.getDouble("mass"),
-          &(bObjectMotionState_->btMotionState()), bObjectShape_.get(),
-          bInertia);
+          &(bObjectMotionState_->btMotionState()), &compound, bInertia);
   info.m_friction = physicsObjectAttributes.getDouble("frictionCoefficient");
   info.m_restitution =
       physicsObjectAttributes.getDouble("restitutionCoefficient");
@@ -322,10 +328,24 @@ void BulletRigidObject::setMargin(const double margin) {
   if (rigidObjectType_ == SCENE) {
     return;
   } else {
-    for (int i = 0; i < bObjectConvexShapes_.size(); i++) {
-      bObjectConvexShapes_[i]->setMargin(margin);
+    //! Copy the shape shared with other instances before changing it
+    if (bObjectShape_.use_count() > 1) {
+      auto shape = BulletObjectShape::create();
+      for (const auto& convexShape : bObjectShape_->convexShapes) {
+        btTransform t;
+        t.setIdentity();
+        shape->convexShapes.emplace_back(std::make_unique<btConvexHullShape>(
+            convexShape->getUnscaledPoints()->m_floats,
+            convexShape->getNumPoints()));
+        shape->compound.addChildShape(t, shape->convexShapes.back().get());
+      }
+      bObjectRigidBody_->setCollisionShape(&shape->compound);
+      bObjectShape_ = std::move(shape);
+    }
+    for (auto& convexShape : bObjectShape_->convexShapes) {
+      convexShape->setMargin(margin);
     }
-    bObjectShape_->setMargin(margin);
+    bObjectShape_->compound.setMargin(margin);
   }
 }
 
@@ -402,7 +422,15 @@ const double BulletRigidObject::getMargin() {
   if (rigidObjectType_ == SCENE) {
     return -1.0;
   } else {
-    return bObjectShape_->getMargin();
+    return bObjectShape_->compound.getMargin();
+  }
+}
+
+const btCollisionShape* BulletRigidObject::getCollisionShape() const {
+  if (rigidObjectType_ != OBJECT) {
+    return nullptr;
+  } else {
+    return bObjectRigidBody_->getCollisionShape();
   }
 }
 
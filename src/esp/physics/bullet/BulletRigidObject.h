@@ -6,6 +6,7 @@
 
 #include <btBulletDynamicsCommon.h>
 #include "esp/assets/Asset.h"
+#include "esp/assets/CollisionHulls.h"
 #include "esp/core/esp.h"
 
 #include "esp/physics/RigidObject.h"
@@ -13,6 +14,14 @@
 namespace esp {
 namespace physics {
 
+//! Convex compound collision shape of an object, shared by its instances
+struct BulletObjectShape {
+  std::vector<std::unique_ptr<btConvexHullShape>> convexShapes;
+  btCompoundShape compound;
+
+  ESP_SMART_POINTERS(BulletObjectShape)
+};
+
 class BulletRigidObject : public RigidObject {
  public:
   BulletRigidObject(scene::SceneNode* parent);
@@ -29,6 +38,20 @@ class BulletRigidObject : public RigidObject {
       const std::vector<assets::CollisionMeshData>& meshGroup,
       std::shared_ptr<btDiscreteDynamicsWorld> bWorld);
 
+  //! Initialize an object with a collision shape, which may be shared with
+  //! other instances of it
+  bool initializeObject(
+      const assets::PhysicsObjectAttributes& physicsObjectAttributes,
+      BulletObjectShape::ptr shape,
+      std::shared_ptr<btDiscreteDynamicsWorld> bWorld);
+
+  //! Create the collision shape of an object: the hulls of its convex
+  //! decomposition if there are any, else the convex hull of each mesh
+  static BulletObjectShape::ptr createObjectShape(
+      const std::vector<assets::CollisionMeshData>& meshGroup,
+      const std::vector<assets::CollisionHull>& hulls,
+      double margin);
+
   //! Check whether object is being actively simulated, or sleeping
   bool isActive();
   void setActive();
@@ -73,6 +96,9 @@ class BulletRigidObject : public RigidObject {
   //! Set Margin only works for objects
   void setMargin(const double margin);
 
+  //! Shape the object collides with, nullptr unless it is an object
+  const btCollisionShape* getCollisionShape() const;
+
  protected:
   //! Needed after changing the pose from Magnum side
   //! Not exposed to end user
@@ -91,9 +117,9 @@ class BulletRigidObject : public RigidObject {
 
   // Physical object
   //! Object data: Composite convex collision shape
-  //! All components are wrapped into one rigidBody_
-  std::vector<std::unique_ptr<btConvexHullShape>> bObjectConvexShapes_;
-  std::unique_ptr<btCompoundShape> bObjectShape_;
+  //! All components are wrapped into one rigidBody_, the shape is shared
+  //! with the other instances of the object until its margin is changed
+  BulletObjectShape::ptr bObjectShape_;
   std::unique_ptr<btRigidBody> bObjectRigidBody_;
   Magnum::BulletIntegration::MotionState* bObjectMotionState_;
 
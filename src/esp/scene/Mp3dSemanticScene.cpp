@@ -258,6 +258,7 @@ bool SemanticScene::loadMp3dHouse(
     }
   }
 
+  scene.buildLookupTables();
   return true;
 }
 
@@ -5,6 +5,7 @@
 #pragma once
 
 #include "esp/core/esp.h"
+#include "esp/gfx/DrawableGroup.h"
 #include "esp/gfx/magnum.h"
 
 #include "SceneNode.h"
@@ -22,8 +23,8 @@ class SceneGraph {
   SceneNode& getRootNode() { return rootNode_; }
   const SceneNode& getRootNode() const { return rootNode_; }
 
-  Magnum::SceneGraph::DrawableGroup3D& getDrawables() { return drawables_; }
-  const Magnum::SceneGraph::DrawableGroup3D& getDrawables() const {
+  gfx::DrawableGroup& getDrawables() { return drawables_; }
+  const gfx::DrawableGroup& getDrawables() const {
     return drawables_;
   }
 
@@ -67,7 +68,7 @@ class SceneGraph {
 
   // drawable groups for each scene graph
   // each item is a group of drawables.
-  Magnum::SceneGraph::DrawableGroup3D drawables_;
+  gfx::DrawableGroup drawables_;
 };
 }  // namespace scene
 }  // namespace esp
@@ -0,0 +1,129 @@
+// Copyright (c) Facebook, Inc. and its affiliates.
+// This source code is licensed under the MIT license found in the
+// LICENSE file in the root directory of this source tree.
+
+#include "SemanticScene.h"
+
+#include <algorithm>
+
+namespace esp {
+namespace scene {
+
+namespace {
+// largest number of entries of the paged segment tables and their page
+// directory (16MB per table)
+constexpr size_t kMaxLookupTableSize = 1 << 22;
+// below this many ids threading costs more than it saves
+constexpr int64_t kMinParallelRemapSize = 1 << 16;
+}  // namespace
+
+void SemanticScene::buildLookupTables() {
+  objectToCategoryLut_.assign(objects_.size(), ID_UNDEFINED);
+  for (size_t iObject = 0; iObject < objects_.size(); ++iObject) {
+    const auto& object = objects_[iObject];
+    if (object != nullptr && object->category() != nullptr) {
+      objectToCategoryLut_[iObject] = object->category()->index();
+    }
+  }
+
+  segmentPages_.clear();
+  segmentToObjectLut_.clear();
+  segmentToCategoryLut_.clear();
+  if (segmentToObjectIndex_.empty()) {
+    return;
+  }
+
+  // page directory, with page 0 left empty for pages without segments
+  constexpr uint32_t kPageSize = 1 << kSegmentPageBits;
+  std::vector<uint32_t> pages;
+  uint32_t numPages = 1;
+  for (const auto& entry : segmentToObjectIndex_) {
+    if (entry.first < 0) {
+      LOG(WARNING) << "Negative semantic segment id " << entry.first
+                   << ", using a hash map";
+      return;
+    }
+    const uint32_t page = uint32_t(entry.first) >> kSegmentPageBits;
+    if (page >= pages.size()) {
+      pages.resize(page + 1, 0);
+    }
+    if (pages[page] == 0) {
+      pages[page] = numPages++ * kPageSize;
+    }
+  }
+  if (pages.size() + size_t(numPages) * kPageSize > kMaxLookupTableSize) {
+    LOG(WARNING) << "Semantic segment ids in " << numPages - 1
+                 << " pages are too sparse for a lookup table, using a hash "
+                    "map";
+    return;
+  }
+
+  segmentPages_ = std::move(pages);
+  segmentToObjectLut_.assign(size_t(numPages) * kPageSize, ID_UNDEFINED);
+  segmentToCategoryLut_.assign(size_t(numPages) * kPageSize, ID_UNDEFINED);
+  for (const auto& entry : segmentToObjectIndex_) {
+    const size_t index = segmentPages_[entry.first >> kSegmentPageBits] +
+                         (entry.first & kSegmentPageMask);
+    const int objectIndex = entry.second;
+    segmentToObjectLut_[index] = objectIndex;
+    if (objectIndex >= 0 && objectIndex < int(objectToCategoryLut_.size())) {
+      segmentToCategoryLut_[index] = objectToCategoryLut_[objectIndex];
+    }
+  }
+}
+
+void SemanticScene::remap(const uint32_t* src,
+                          uint32_t* dst,
+                          size_t count,
+                          SemanticRemap mapping) const {
+  const int64_t n = count;
+
+  if (mapping != SemanticRemap::OBJECT_TO_CATEGORY &&
+      segmentPages_.empty() && !segmentToObjectIndex_.empty()) {
+    // segment ids too sparse for a table
+    const bool toCategory = mapping == SemanticRemap::SEGMENT_TO_CATEGORY;
+    const uint32_t numObjects = objectToCategoryLut_.size();
+#pragma omp parallel for if (n >= kMinParallelRemapSize)
+    for (int64_t i = 0; i < n; ++i) {
+      const int objectIndex = semanticIndexToObjectIndex(int(src[i]));
+      if (toCategory) {
+        dst[i] = uint32_t(objectIndex) < numObjects
+                     ? uint32_t(objectToCategoryLut_[objectIndex])
+                     : uint32_t(ID_UNDEFINED);
+      } else {
+        dst[i] = uint32_t(objectIndex);
+      }
+    }
+    return;
+  }
+
+  // ID_UNDEFINED entries are stored as 0xffffffff already
+  if (mapping == SemanticRemap::OBJECT_TO_CATEGORY) {
+    const uint32_t* table =
+        reinterpret_cast<const uint32_t*>(objectToCategoryLut_.data());
+    const uint32_t tableSize = objectToCategoryLut_.size();
+#pragma omp parallel for if (n >= kMinParallelRemapSize)
+    for (int64_t i = 0; i < n; ++i) {
+      const uint32_t id = src[i];
+      dst[i] = id < tableSize ? table[id] : uint32_t(ID_UNDEFINED);
+    }
+    return;
+  }
+
+  const std::vector<int>& lut = mapping == SemanticRemap::SEGMENT_TO_OBJECT
+                                    ? segmentToObjectLut_
+                                    : segmentToCategoryLut_;
+  const uint32_t* table = reinterpret_cast<const uint32_t*>(lut.data());
+  const uint32_t* pages = segmentPages_.data();
+  const uint32_t numPages = segmentPages_.size();
+#pragma omp parallel for if (n >= kMinParallelRemapSize)
+  for (int64_t i = 0; i < n; ++i) {
+    const uint32_t id = src[i];
+    const uint32_t page = id >> kSegmentPageBits;
+    dst[i] = page < numPages ? table[pages[page] + (id & kSegmentPageMask)]
+                             : uint32_t(ID_UNDEFINED);
+  }
+}
+
+}  // namespace scene
+}  // namespace esp
@@ -28,6 +28,16 @@ class SemanticCategory {
   ESP_SMART_POINTERS(SemanticCategory);
 };
 
+//! Id conversions done by SemanticScene::remap
+enum class SemanticRemap {
+  //! semantic mesh mask (segment) index to object index
+  SEGMENT_TO_OBJECT = 0,
+  //! semantic mesh mask (segment) index to category index
+  SEGMENT_TO_CATEGORY = 1,
+  //! object index to category index
+  OBJECT_TO_CATEGORY = 2,
+};
+
 // forward declarations
 class SemanticObject;
 class SemanticRegion;
@@ -73,13 +83,29 @@ class SemanticScene {
   //! convert semantic mesh mask index to object index or ID_UNDEFINED if
   //! not mapped
   inline int semanticIndexToObjectIndex(int maskIndex) const {
-    if (segmentToObjectIndex_.count(maskIndex) > 0) {
-      return segmentToObjectIndex_.at(maskIndex);
-    } else {
+    const uint32_t page = uint32_t(maskIndex) >> kSegmentPageBits;
+    if (page < segmentPages_.size()) {
+      return segmentToObjectLut_[segmentPages_[page] +
+                                 (maskIndex & kSegmentPageMask)];
+    }
+    if (!segmentPages_.empty()) {
       return ID_UNDEFINED;
     }
+    const auto it = segmentToObjectIndex_.find(maskIndex);
+    return it != segmentToObjectIndex_.end() ? it->second : ID_UNDEFINED;
   }
 
+  /**
+   * @brief Convert a buffer of count ids as given by mapping, e.g. a semantic
+   * observation of object ids to category ids. Ids that are not mapped become
+   * ID_UNDEFINED (0xffffffff). src and dst may be the same buffer. Large
+   * buffers are converted by multiple threads.
+   */
+  void remap(const uint32_t* src,
+             uint32_t* dst,
+             size_t count,
+             SemanticRemap mapping) const;
+
   //! load SemanticScene from a Matterport3D House format filename
   static bool loadMp3dHouse(
       const std::string& filename,
@@ -104,6 +130,25 @@ class SemanticScene {
   //! map from combined region-segment id to objectIndex for semantic mesh
   std::unordered_map<int, int> segmentToObjectIndex_;
 
+  //! build the dense lookup tables below once the house is loaded
+  void buildLookupTables();
+
+  // Segment ids are sparse, e.g. regionIndex * 1000000 + k for MP3D, so the
+  // segment tables are paged: segment id s is at entry
+  // segmentPages_[s >> kSegmentPageBits] + (s & kSegmentPageMask). Pages
+  // without any segment share the first page, which is all ID_UNDEFINED.
+  // If even the paged tables would be too large, all three segment tables
+  // stay empty and segmentToObjectIndex_ is used instead.
+  static constexpr int kSegmentPageBits = 10;
+  static constexpr int kSegmentPageMask = (1 << kSegmentPageBits) - 1;
+  std::vector<uint32_t> segmentPages_;
+
+  // dense versions of segmentToObjectIndex_ and of the categories of
+  // objects_, ID_UNDEFINED where not mapped
+  std::vector<int> segmentToObjectLut_;
+  std::vector<int> segmentToCategoryLut_;
+  std::vector<int> objectToCategoryLut_;
+
   ESP_SMART_POINTERS(SemanticScene)
 };
 
@@ -226,6 +226,7 @@ bool SemanticScene::loadSuncgHouse(
 
     iLevel++;
   }  // for level
+  scene.buildLookupTables();
   return true;
 }
 
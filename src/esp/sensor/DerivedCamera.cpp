@@ -0,0 +1,139 @@
+// Copyright (c) Facebook, Inc. and its affiliates.
+// This source code is licensed under the MIT license found in the
+// LICENSE file in the root directory of this source tree.
+
+#include "DerivedCamera.h"
+
+#include <Magnum/Math/Packing.h>
+
+#include "Downsample.h"
+
+namespace esp {
+namespace sensor {
+
+DerivedCamera::DerivedCamera(scene::SceneNode& node,
+                             SensorSpec::ptr spec,
+                             Sensor::ptr parent)
+    : Sensor(node, spec), parent_(parent) {
+  CHECK(parent_ != nullptr) << "Sensor " << spec_->uuid
+                            << " has no parent sensor " << spec_->parentUuid;
+  const SensorSpec& parentSpec = *parent_->specification();
+  CHECK(parentSpec.sensorType == spec_->sensorType)
+      << "Sensor " << spec_->uuid << " has to have the type of its parent "
+      << parentSpec.uuid;
+
+  ObservationSpace parentSpace;
+  parent_->getObservationSpace(parentSpace);
+  CHECK_EQ(parentSpace.shape.size(), 3)
+      << "Sensor " << spec_->uuid << " cannot be derived from "
+      << parentSpec.uuid;
+
+  const vec2i& resolution = spec_->resolution;
+  CHECK(resolution[0] > 0 && resolution[1] > 0)
+      << "Invalid resolution of sensor " << spec_->uuid;
+  factor_ = parentSpace.shape[0] / resolution[0];
+  CHECK(factor_ > 0 && parentSpace.shape[0] == factor_ * resolution[0] &&
+        parentSpace.shape[1] == factor_ * resolution[1])
+      << "Resolution of sensor " << spec_->uuid
+      << " has to divide the resolution of " << parentSpec.uuid
+      << " by the same integer factor";
+
+  const bool semantic = spec_->sensorType == SensorType::SEMANTIC;
+  filter_ = semantic ? Filter::MODE : Filter::AREA;
+  const auto filter = spec_->parameters.find("downsample_filter");
+  if (filter != spec_->parameters.end()) {
+    if (filter->second == "nearest") {
+      filter_ = Filter::NEAREST;
+    } else if (filter->second == "area" && !semantic) {
+      filter_ = Filter::AREA;
+    } else if (filter->second == "mode" && semantic) {
+      filter_ = Filter::MODE;
+    } else {
+      LOG(ERROR) << "Unsupported downsample_filter " << filter->second
+                 << " of sensor " << spec_->uuid << ", using "
+                 << (semantic ? "mode" : "area");
+    }
+  }
+}
+
+bool DerivedCamera::getObservationSpace(ObservationSpace& space) {
+  parent_->getObservationSpace(space);
+  space.shape[0] = spec_->resolution[0];
+  space.shape[1] = spec_->resolution[1];
+  return true;
+}
+
+bool DerivedCamera::getObservation(gfx::Simulator& sim, Observation& obs) {
+  Observation parentObs;
+  if (!parent_->getObservation(sim, parentObs)) {
+    return false;
+  }
+  return deriveObservation(parentObs, obs);
+}
+
+bool DerivedCamera::deriveObservation(const Observation& parentObs,
+                                      Observation& obs) {
+  if (parentObs.buffer == nullptr) {
+    return false;
+  }
+  ObservationSpace space;
+  getObservationSpace(space);
+  if (obs.buffer == nullptr || obs.buffer->shape != space.shape ||
+      obs.buffer->dataType != space.dataType) {
+    if (buffer_ == nullptr) {
+      buffer_ = core::Buffer::create(space.shape, space.dataType);
+    }
+    obs.buffer = buffer_;
+  }
+  derive(*parentObs.buffer, *obs.buffer);
+  applyNoise(*obs.buffer);
+  return true;
+}
+
+void DerivedCamera::derive(const core::Buffer& parent, core::Buffer& out) {
+  CHECK_EQ(out.totalBytes * factor_ * factor_, parent.totalBytes)
+      << "Observation buffers of sensor " << spec_->uuid
+      << " do not match its parent";
+  const int srcWidth = parent.shape[1];
+  const int srcHeight = parent.shape[0];
+  const size_t numPixels = size_t(srcWidth) * srcHeight;
+  // depth and object ids have a single channel per pixel
+  size_t pixelSize = core::getDataTypeByteSize(parent.dataType);
+  if (spec_->sensorType == SensorType::COLOR && parent.shape.size() > 2) {
+    pixelSize *= parent.shape[2];
+  }
+
+  if (filter_ == Filter::NEAREST) {
+    downsampleNearest(parent.data, srcWidth, srcHeight, pixelSize, factor_,
+                      out.data);
+  } else if (filter_ == Filter::MODE) {
+    downsampleMode(static_cast<const uint32_t*>(parent.data), srcWidth,
+                   srcHeight, factor_, static_cast<uint32_t*>(out.data));
+  } else if (parent.dataType == core::DataType::DT_UINT8) {
+    downsampleArea(static_cast<const uint8_t*>(parent.data), srcWidth,
+                   srcHeight, pixelSize, factor_,
+                   static_cast<uint8_t*>(out.data));
+  } else if (parent.dataType == core::DataType::DT_FLOAT) {
+    downsampleArea(static_cast<const float*>(parent.data), srcWidth,
+                   srcHeight, factor_, static_cast<float*>(out.data));
+  } else if (parent.dataType == core::DataType::DT_FLOAT16) {
+    const uint16_t* src = static_cast<const uint16_t*>(parent.data);
+    unpackedParent_.resize(numPixels);
+    unpackedDerived_.resize(numPixels / (factor_ * factor_));
+    for (size_t i = 0; i < unpackedParent_.size(); ++i) {
+      unpackedParent_[i] = Magnum::Math::unpackHalf(src[i]);
+    }
+    downsampleArea(unpackedParent_.data(), srcWidth, srcHeight, factor_,
+                   unpackedDerived_.data());
+    uint16_t* dst = static_cast<uint16_t*>(out.data);
+    for (size_t i = 0; i < unpackedDerived_.size(); ++i) {
+      dst[i] = Magnum::Math::packHalf(unpackedDerived_[i]);
+    }
+  } else {
+    LOG(ERROR) << "Unsupported observation data type of sensor "
+               << spec_->uuid;
+  }
+}
+
+}  // namespace sensor
+}  // namespace esp
@@ -0,0 +1,68 @@
+// Copyright (c) Facebook, Inc. and its affiliates.
+// This source code is licensed under the MIT license found in the
+// LICENSE file in the root directory of this source tree.
+
+#pragma once
+
+#include "Sensor.h"
+#include "esp/core/esp.h"
+
+namespace esp {
+namespace sensor {
+
+/**
+ * @brief Sensor whose observations are downsampled from the render of
+ * another sensor of the agent, its parent, instead of drawing the scene
+ * again.
+ *
+ * Created for specs with a non-empty @ref SensorSpec::parentUuid. The
+ * resolution has to divide the resolution of the parent by the same integer
+ * factor in both dimensions; sensor type, channels and data type are those
+ * of the parent, and so is the pose. The "downsample_filter" spec parameter
+ * selects how blocks of parent pixels are reduced:
+ *  - "area" (default for color and depth): block average, of the non-zero
+ *    pixels only for depth
+ *  - "mode" (default for semantic): most frequent object id
+ *  - "nearest": center pixel of the block
+ *
+ * Observations are derived from the parent observation as returned, i.e.
+ * after its semantic remapping and noise; a noise model of the derived
+ * sensor itself is applied on top.
+ */
+class DerivedCamera : public Sensor {
+ public:
+  explicit DerivedCamera(scene::SceneNode& node,
+                         SensorSpec::ptr spec,
+                         Sensor::ptr parent);
+
+  virtual ~DerivedCamera() {}
+
+  //! Render an observation of the parent and derive ours from it. Prefer
+  //! @ref deriveObservation() when the parent observation is needed too.
+  virtual bool getObservation(gfx::Simulator& sim, Observation& obs) override;
+  virtual bool getObservationSpace(ObservationSpace& space) override;
+
+  //! Derive an observation from an observation of the parent
+  bool deriveObservation(const Observation& parentObs, Observation& obs);
+
+  //! Downsample parent, holding an observation of the parent, into out
+  void derive(const core::Buffer& parent, core::Buffer& out);
+
+  Sensor::ptr getParent() const { return parent_; }
+
+ protected:
+  enum class Filter { AREA, MODE, NEAREST };
+
+  Sensor::ptr parent_;
+  Filter filter_;
+  int factor_;
+
+  // float copies of half float depth observations
+  std::vector<float> unpackedParent_;
+  std::vector<float> unpackedDerived_;
+
+  ESP_SMART_POINTERS(DerivedCamera)
+};
+
+}  // namespace sensor
+}  // namespace esp
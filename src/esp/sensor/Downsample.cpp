@@ -0,0 +1,160 @@
+// Copyright (c) Facebook, Inc. and its affiliates.
+// This source code is licensed under the MIT license found in the
+// LICENSE file in the root directory of this source tree.
+
+#include "Downsample.h"
+
+#include <algorithm>
+#include <cstring>
+#include <vector>
+
+namespace esp {
+namespace sensor {
+
+// The area filters first sum the factor source rows of a block row into
+// per column sums, which is a plain vectorizable loop doing most of the
+// work, and then reduce factor adjacent columns into each output pixel.
+
+void downsampleArea(const uint8_t* src,
+                    int srcWidth,
+                    int srcHeight,
+                    int channels,
+                    int factor,
+                    uint8_t* dst) {
+  const int width = srcWidth / factor;
+  const int height = srcHeight / factor;
+  const int srcRowSize = srcWidth * channels;
+  const uint32_t area = factor * factor;
+#pragma omp parallel
+  {
+    std::vector<uint32_t> columnSums(srcRowSize);
+#pragma omp for
+    for (int y = 0; y < height; ++y) {
+      uint32_t* sums = columnSums.data();
+      std::fill(sums, sums + srcRowSize, 0);
+      for (int dy = 0; dy < factor; ++dy) {
+        const uint8_t* row = src + size_t(y * factor + dy) * srcRowSize;
+#pragma omp simd
+        for (int i = 0; i < srcRowSize; ++i) {
+          sums[i] += row[i];
+        }
+      }
+      uint8_t* dstRow = dst + size_t(y) * width * channels;
+      for (int x = 0; x < width; ++x) {
+        for (int c = 0; c < channels; ++c) {
+          uint32_t sum = 0;
+          for (int dx = 0; dx < factor; ++dx) {
+            sum += sums[(x * factor + dx) * channels + c];
+          }
+          dstRow[x * channels + c] = uint8_t((sum + area / 2) / area);
+        }
+      }
+    }
+  }
+}
+
+void downsampleArea(const float* src,
+                    int srcWidth,
+                    int srcHeight,
+                    int factor,
+                    float* dst) {
+  const int width = srcWidth / factor;
+  const int height = srcHeight / factor;
+#pragma omp parallel
+  {
+    // zero depth is no depth, only the other samples are counted
+    std::vector<float> columnSums(srcWidth);
+    std::vector<float> columnCounts(srcWidth);
+#pragma omp for
+    for (int y = 0; y < height; ++y) {
+      float* sums = columnSums.data();
+      float* counts = columnCounts.data();
+      std::fill(sums, sums + srcWidth, 0.0f);
+      std::fill(counts, counts + srcWidth, 0.0f);
+      for (int dy = 0; dy < factor; ++dy) {
+        const float* row = src + size_t(y * factor + dy) * srcWidth;
+#pragma omp simd
+        for (int i = 0; i < srcWidth; ++i) {
+          sums[i] += row[i];
+          counts[i] += row[i] > 0.0f ? 1.0f : 0.0f;
+        }
+      }
+      float* dstRow = dst + size_t(y) * width;
+      for (int x = 0; x < width; ++x) {
+        float sum = 0.0f;
+        float count = 0.0f;
+        for (int dx = 0; dx < factor; ++dx) {
+          sum += sums[x * factor + dx];
+          count += counts[x * factor + dx];
+        }
+        dstRow[x] = count > 0.0f ? sum / count : 0.0f;
+      }
+    }
+  }
+}
+
+void downsampleNearest(const void* src,
+                       int srcWidth,
+                       int srcHeight,
+                       size_t pixelSize,
+                       int factor,
+                       void* dst) {
+  const int width = srcWidth / factor;
+  const int height = srcHeight / factor;
+  const int center = factor / 2;
+  const char* srcData = static_cast<const char*>(src);
+  char* dstData = static_cast<char*>(dst);
+#pragma omp parallel for
+  for (int y = 0; y < height; ++y) {
+    const char* row =
+        srcData + (size_t(y * factor + center) * srcWidth + center) * pixelSize;
+    char* dstRow = dstData + size_t(y) * width * pixelSize;
+    for (int x = 0; x < width; ++x) {
+      std::memcpy(dstRow + x * pixelSize, row + size_t(x) * factor * pixelSize,
+                  pixelSize);
+    }
+  }
+}
+
+void downsampleMode(const uint32_t* src,
+                    int srcWidth,
+                    int srcHeight,
+                    int factor,
+                    uint32_t* dst) {
+  const int width = srcWidth / factor;
+  const int height = srcHeight / factor;
+#pragma omp parallel
+  {
+    std::vector<uint32_t> block(factor * factor);
+#pragma omp for
+    for (int y = 0; y < height; ++y) {
+      for (int x = 0; x < width; ++x) {
+        for (int dy = 0; dy < factor; ++dy) {
+          const uint32_t* row =
+              src + size_t(y * factor + dy) * srcWidth + x * factor;
+          std::copy(row, row + factor, block.begin() + dy * factor);
+        }
+        std::sort(block.begin(), block.end());
+
+        // the longest run of equal ids, the first (smallest) one on ties
+        uint32_t mode = block[0];
+        size_t modeCount = 0;
+        for (size_t begin = 0; begin < block.size();) {
+          size_t end = begin + 1;
+          while (end < block.size() && block[end] == block[begin]) {
+            ++end;
+          }
+          if (end - begin > modeCount) {
+            mode = block[begin];
+            modeCount = end - begin;
+          }
+          begin = end;
+        }
+        dst[size_t(y) * width + x] = mode;
+      }
+    }
+  }
+}
+
+}  // namespace sensor
+}  // namespace esp
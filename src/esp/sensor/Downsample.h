@@ -0,0 +1,57 @@
+// Copyright (c) Facebook, Inc. and its affiliates.
+// This source code is licensed under the MIT license found in the
+// LICENSE file in the root directory of this source tree.
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+namespace esp {
+namespace sensor {
+
+/**
+ * @brief CPU downsampling of observation images by an integer factor.
+ *
+ * All functions take a row-major srcWidth x srcHeight image whose size is a
+ * multiple of factor and write a (srcWidth / factor) x (srcHeight / factor)
+ * image to dst. Rows are split over OpenMP threads and the inner loops are
+ * written for the compiler to vectorize.
+ */
+
+//! Average each factor x factor block of an 8 bit image with channels
+//! interleaved channels, rounding to nearest
+void downsampleArea(const uint8_t* src,
+                    int srcWidth,
+                    int srcHeight,
+                    int channels,
+                    int factor,
+                    uint8_t* dst);
+
+//! Average the non-zero pixels of each factor x factor block of a depth
+//! image, a block without any is 0
+void downsampleArea(const float* src,
+                    int srcWidth,
+                    int srcHeight,
+                    int factor,
+                    float* dst);
+
+//! Pick the center pixel of each factor x factor block of an image with
+//! pixels of pixelSize bytes
+void downsampleNearest(const void* src,
+                       int srcWidth,
+                       int srcHeight,
+                       size_t pixelSize,
+                       int factor,
+                       void* dst);
+
+//! Pick the most frequent id of each factor x factor block of an object id
+//! image, the smallest one on ties
+void downsampleMode(const uint32_t* src,
+                    int srcWidth,
+                    int srcHeight,
+                    int factor,
+                    uint32_t* dst);
+
+}  // namespace sensor
+}  // namespace esp
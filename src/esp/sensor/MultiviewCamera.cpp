@@ -0,0 +1,124 @@
+// Copyright (c) Facebook, Inc. and its affiliates.
+// This source code is licensed under the MIT license found in the
+// LICENSE file in the root directory of this source tree.
+
+#include "MultiviewCamera.h"
+
+#include <cstdlib>
+
+#include <Corrade/Utility/String.h>
+
+#include "esp/gfx/Renderer.h"
+#include "esp/gfx/Simulator.h"
+#include "esp/scene/SceneGraph.h"
+
+namespace Cr = Corrade;
+
+namespace esp {
+namespace sensor {
+
+namespace {
+// interpupillary distance of an average adult in meters
+constexpr float kDefaultStereoBaseline = 0.065f;
+}  // namespace
+
+MultiviewCamera::MultiviewCamera(scene::SceneNode& cameraNode,
+                                 SensorSpec::ptr spec)
+    : PinholeCamera(cameraNode, spec) {
+  std::vector<Magnum::Vector3> offsets;
+  const auto viewOffsets = spec_->parameters.find("view_offsets");
+  const auto stereoBaseline = spec_->parameters.find("stereo_baseline");
+  if (viewOffsets != spec_->parameters.end()) {
+    for (const std::string& view :
+         Cr::Utility::String::splitWithoutEmptyParts(viewOffsets->second,
+                                                     ';')) {
+      const std::vector<std::string> coordinates =
+          Cr::Utility::String::split(view, ',');
+      CHECK_EQ(coordinates.size(), 3)
+          << "Invalid view_offsets of " << spec_->uuid << ": " << view;
+      offsets.emplace_back(std::atof(coordinates[0].c_str()),
+                           std::atof(coordinates[1].c_str()),
+                           std::atof(coordinates[2].c_str()));
+    }
+    CHECK(!offsets.empty()) << "Empty view_offsets of " << spec_->uuid;
+  } else {
+    const float baseline = stereoBaseline != spec_->parameters.end()
+                               ? std::atof(stereoBaseline->second.c_str())
+                               : kDefaultStereoBaseline;
+    offsets = {{-0.5f * baseline, 0.0f, 0.0f}, {0.5f * baseline, 0.0f, 0.0f}};
+  }
+
+  for (const Magnum::Vector3& offset : offsets) {
+    viewMatrices_.push_back(Magnum::Matrix4::translation(-offset));
+  }
+}
+
+bool MultiviewCamera::getObservationSpace(ObservationSpace& space) {
+  PinholeCamera::getObservationSpace(space);
+  space.shape.insert(space.shape.begin(), viewMatrices_.size());
+  return true;
+}
+
+size_t MultiviewCamera::getFrameBytes() {
+  ObservationSpace space;
+  getObservationSpace(space);
+  // depth and object ids have a single channel per pixel
+  const size_t channels =
+      spec_->sensorType == SensorType::COLOR ? space.shape.back() : 1;
+  return viewMatrices_.size() * width_ * height_ * channels *
+         core::getDataTypeByteSize(space.dataType);
+}
+
+bool MultiviewCamera::getObservation(gfx::Simulator& sim, Observation& obs) {
+  prepareObservationBuffer(obs);
+  if (spec_->sensorType == SensorType::SEMANTIC) {
+    render(*sim.getRenderer(), sim.getActiveSemanticSceneGraph(),
+           obs.buffer->data);
+    remapSemanticObservation(sim, static_cast<uint32_t*>(obs.buffer->data),
+                             viewMatrices_.size() * width_ * height_);
+  } else {
+    render(*sim.getRenderer(), sim.getActiveSceneGraph(), obs.buffer->data);
+  }
+  return true;
+}
+
+void MultiviewCamera::render(gfx::Renderer& renderer,
+                             scene::SceneGraph& sceneGraph,
+                             void* ptr) {
+  // the views are stacked in a framebuffer taller than any other sensor's,
+  // the renderer gets its size back for the sensors drawn after this one
+  const int framebufferHeight = height_ * viewMatrices_.size();
+  const vec3i size = renderer.getSize();
+  const bool resize = size[0] != width_ || size[1] != framebufferHeight;
+  if (resize) {
+    renderer.setSize(width_, framebufferHeight);
+  }
+  renderer.drawViews(*this, sceneGraph, viewMatrices_);
+  readFrame(renderer, ptr);
+  if (resize) {
+    renderer.setSize(size[0], size[1]);
+  }
+  applyNoisePerView(ptr);
+}
+
+void MultiviewCamera::applyNoisePerView(void* ptr) {
+  if (noiseModel_ == nullptr) {
+    return;
+  }
+  ObservationSpace space;
+  getObservationSpace(space);
+  // a single view, without the channel dimension for depth
+  std::vector<size_t> viewShape{space.shape.begin() + 1, space.shape.end()};
+  if (spec_->sensorType != SensorType::COLOR) {
+    viewShape.pop_back();
+  }
+  const size_t viewBytes = getFrameBytes() / viewMatrices_.size();
+  for (size_t i = 0; i < viewMatrices_.size(); ++i) {
+    core::Buffer view{viewShape, space.dataType,
+                      static_cast<char*>(ptr) + i * viewBytes};
+    applyNoise(view);
+  }
+}
+
+}  // namespace sensor
+}  // namespace esp
@@ -0,0 +1,65 @@
+// Copyright (c) Facebook, Inc. and its affiliates.
+// This source code is licensed under the MIT license found in the
+// LICENSE file in the root directory of this source tree.
+
+#pragma once
+
+#include <vector>
+
+#include "PinholeCamera.h"
+#include "esp/core/esp.h"
+
+namespace esp {
+namespace gfx {
+class Renderer;
+}
+namespace sensor {
+
+/**
+ * @brief Pinhole sensor observing several co-located views at once, e.g. the
+ * two eyes of a stereo camera.
+ *
+ * All views share the projection of the spec and are drawn in a single pass
+ * over the scene with @ref gfx::Renderer::drawViews(), into a framebuffer
+ * holding the views on top of each other, and read back with one call.
+ * Observations have shape [views, height, width, channels].
+ *
+ * Selected with sensorSubtype "multiview". The views are placed by the
+ * "view_offsets" spec parameter, a ";" separated list of "x,y,z" positions
+ * relative to the sensor, or by "stereo_baseline", which puts two views that
+ * far apart along the sensor's x axis (left view first). Without either, the
+ * views are a stereo pair with a 0.065 m baseline.
+ */
+class MultiviewCamera : public PinholeCamera {
+ public:
+  explicit MultiviewCamera(scene::SceneNode& cameraNode, SensorSpec::ptr spec);
+
+  virtual ~MultiviewCamera() {}
+
+  virtual bool getObservation(gfx::Simulator& sim, Observation& obs) override;
+  virtual bool getObservationSpace(ObservationSpace& space) override;
+
+  //! Render all views of sceneGraph with renderer into ptr, which has to
+  //! hold getFrameBytes() bytes, the views one after the other. The size of
+  //! the renderer is restored afterwards.
+  void render(gfx::Renderer& renderer,
+              scene::SceneGraph& sceneGraph,
+              void* ptr);
+
+  int getNumViews() const { return viewMatrices_.size(); }
+
+  //! Bytes of one frame of all views as written by render()
+  size_t getFrameBytes();
+
+ protected:
+  //! Apply the noise model, if any, to each view of a frame at ptr
+  void applyNoisePerView(void* ptr);
+
+  // camera to view transformations, i.e. inverse view offsets
+  std::vector<Magnum::Matrix4> viewMatrices_;
+
+  ESP_SMART_POINTERS(MultiviewCamera)
+};
+
+}  // namespace sensor
+}  // namespace esp
@@ -0,0 +1,238 @@
+// Copyright (c) Facebook, Inc. and its affiliates.
+// This source code is licensed under the MIT license found in the
+// LICENSE file in the root directory of this source tree.
+
+#include "NoiseModel.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <map>
+
+#include <Magnum/Math/Packing.h>
+
+#include "Sensor.h"
+
+namespace esp {
+namespace sensor {
+
+namespace {
+constexpr uint64_t kGoldenGamma = 0x9e3779b97f4a7c15ull;
+
+// SplitMix64 finalizer. Hashing a counter gives a random stream that can be
+// evaluated at any index, independent of the order pixels are visited in.
+inline uint64_t mix(uint64_t x) {
+  x += kGoldenGamma;
+  x = (x ^ (x >> 30)) * 0xbf58476d1ce4e5b9ull;
+  x = (x ^ (x >> 27)) * 0x94d049bb133111ebull;
+  return x ^ (x >> 31);
+}
+
+// Standard normal sample i of the stream with the given key, Box-Muller
+// transformed from two 24 bit uniforms
+inline float normal(uint64_t key, uint64_t i) {
+  const uint64_t bits = mix(key + i * kGoldenGamma);
+  const float u1 = (float(bits >> 40) + 0.5f) * (1.0f / 16777216.0f);
+  const float u2 = float(bits & 0xffffff) * (1.0f / 16777216.0f);
+  return std::sqrt(-2.0f * std::log(u1)) *
+         std::cos(6.28318530718f * u2);
+}
+
+// 64 bit FNV-1a of s, a default seed that is stable across runs
+uint64_t hashString(const std::string& s) {
+  uint64_t hash = 0xcbf29ce484222325ull;
+  for (const char c : s) {
+    hash = (hash ^ uint8_t(c)) * 0x100000001b3ull;
+  }
+  return hash;
+}
+
+float floatParameter(const SensorSpec& spec,
+                     const std::string& name,
+                     float defaultValue) {
+  const auto it = spec.parameters.find(name);
+  if (it == spec.parameters.end() || it->second.empty()) {
+    return defaultValue;
+  }
+  return std::atof(it->second.c_str());
+}
+
+std::map<std::string, NoiseModel::Factory>& registry() {
+  static std::map<std::string, NoiseModel::Factory> models = {
+      {"gaussian",
+       [](const SensorSpec& spec) -> NoiseModel::ptr {
+         return GaussianNoiseModel::create(spec);
+       }},
+      {"redwood",
+       [](const SensorSpec& spec) -> NoiseModel::ptr {
+         return RedwoodDepthNoiseModel::create(spec);
+       }},
+  };
+  return models;
+}
+}  // namespace
+
+NoiseModel::NoiseModel(const SensorSpec& spec) {
+  const auto it = spec.parameters.find("noise_seed");
+  if (it != spec.parameters.end() && !it->second.empty()) {
+    seed_ = std::strtoull(it->second.c_str(), nullptr, 10);
+  } else {
+    seed_ = hashString(spec.uuid);
+  }
+}
+
+NoiseModel::ptr NoiseModel::fromSpec(const SensorSpec& spec) {
+  const auto it = spec.parameters.find("noise_model");
+  if (it == spec.parameters.end() || it->second.empty() ||
+      it->second == "none") {
+    return nullptr;
+  }
+  const auto model = registry().find(it->second);
+  if (model == registry().end()) {
+    LOG(ERROR) << "Unknown noise_model " << it->second << " of sensor "
+               << spec.uuid << ", observations are left clean";
+    return nullptr;
+  }
+  return model->second(spec);
+}
+
+void NoiseModel::registerModel(const std::string& name, Factory factory) {
+  registry()[name] = std::move(factory);
+}
+
+void NoiseModel::apply(core::Buffer& buffer) {
+  if (buffer.data == nullptr || buffer.shape.size() < 2) {
+    return;
+  }
+  const uint64_t key = mix(seed_ + mix(frame_++));
+  if (buffer.dataType != core::DataType::DT_FLOAT16) {
+    applyFrame(buffer, key);
+    return;
+  }
+
+  // models work on float depth, half float depth goes through a copy
+  const size_t size = buffer.shape[0] * buffer.shape[1];
+  uint16_t* data = static_cast<uint16_t*>(buffer.data);
+  unpackedDepth_.resize(size);
+  for (size_t i = 0; i < size; ++i) {
+    unpackedDepth_[i] = Magnum::Math::unpackHalf(data[i]);
+  }
+  core::Buffer unpacked{{buffer.shape[0], buffer.shape[1]},
+                        core::DataType::DT_FLOAT,
+                        unpackedDepth_.data()};
+  applyFrame(unpacked, key);
+  for (size_t i = 0; i < size; ++i) {
+    data[i] = Magnum::Math::packHalf(unpackedDepth_[i]);
+  }
+}
+
+void NoiseModel::seed(uint64_t seed) {
+  seed_ = seed;
+  frame_ = 0;
+}
+
+GaussianNoiseModel::GaussianNoiseModel(const SensorSpec& spec)
+    : NoiseModel(spec), sigma_(floatParameter(spec, "noise_sigma", 0.05f)) {
+  if (spec.sensorType != SensorType::COLOR &&
+      spec.sensorType != SensorType::DEPTH) {
+    LOG(ERROR) << "Gaussian noise only applies to color and depth sensors, "
+               << spec.uuid << " is left clean";
+  }
+}
+
+void GaussianNoiseModel::applyFrame(core::Buffer& buffer, uint64_t key) {
+  const int64_t height = buffer.shape[0];
+  if (buffer.dataType == core::DataType::DT_UINT8) {
+    // color, leaving alpha alone
+    const int64_t rowSize = buffer.totalSize / height;
+    const int64_t channels = buffer.shape.size() > 2 ? buffer.shape[2] : 1;
+    const int64_t noisyChannels = channels == 4 ? 3 : channels;
+    const float sigma = sigma_ * 255.0f;
+    uint8_t* data = static_cast<uint8_t*>(buffer.data);
+#pragma omp parallel for
+    for (int64_t y = 0; y < height; ++y) {
+      uint8_t* row = data + y * rowSize;
+#pragma omp simd
+      for (int64_t i = 0; i < rowSize; ++i) {
+        const float noisy = row[i] + sigma * normal(key, y * rowSize + i);
+        const float clamped = std::min(std::max(noisy, 0.0f), 255.0f);
+        row[i] = i % channels < noisyChannels ? uint8_t(clamped + 0.5f)
+                                               : row[i];
+      }
+    }
+  } else if (buffer.dataType == core::DataType::DT_FLOAT) {
+    // depth, a single channel, keeping empty pixels empty
+    const int64_t width = buffer.shape[1];
+    float* data = static_cast<float*>(buffer.data);
+#pragma omp parallel for
+    for (int64_t y = 0; y < height; ++y) {
+      float* row = data + y * width;
+#pragma omp simd
+      for (int64_t i = 0; i < width; ++i) {
+        const float noisy = row[i] + sigma_ * normal(key, y * width + i);
+        row[i] = row[i] > 0.0f ? std::max(noisy, 0.0f) : 0.0f;
+      }
+    }
+  }
+}
+
+namespace {
+// baseline times focal length (m * px) of the Redwood sensor model
+constexpr float kBaselineFocal = 35.130f;
+// standard deviation of the disparity noise in pixels
+constexpr float kDisparitySigma = 0.027778f;
+// standard deviation of the projected pattern jitter in pixels
+constexpr float kJitterSigma = 0.25f;
+// the sensor sees nothing beyond this depth in meters
+constexpr float kMaxDepth = 10.0f;
+}  // namespace
+
+RedwoodDepthNoiseModel::RedwoodDepthNoiseModel(const SensorSpec& spec)
+    : NoiseModel(spec),
+      multiplier_(floatParameter(spec, "noise_multiplier", 1.0f)) {
+  if (spec.sensorType != SensorType::DEPTH) {
+    LOG(ERROR) << "Redwood noise only applies to depth sensors, " << spec.uuid
+               << " is left clean";
+  }
+}
+
+void RedwoodDepthNoiseModel::applyFrame(core::Buffer& buffer, uint64_t key) {
+  if (buffer.dataType != core::DataType::DT_FLOAT) {
+    return;
+  }
+  const int64_t height = buffer.shape[0];
+  const int64_t width = buffer.shape[1];
+  float* depth = static_cast<float*>(buffer.data);
+  source_.assign(depth, depth + height * width);
+  const float* source = source_.data();
+
+#pragma omp parallel for
+  for (int64_t y = 0; y < height; ++y) {
+    for (int64_t x = 0; x < width; ++x) {
+      const uint64_t i = 3 * uint64_t(y * width + x);
+      // pixels see the depth of a jittered point of the projected pattern
+      const int64_t sx = std::min<int64_t>(
+          std::max<int64_t>(std::lround(x + kJitterSigma * normal(key, i)), 0),
+          width - 1);
+      const int64_t sy = std::min<int64_t>(
+          std::max<int64_t>(
+              std::lround(y + kJitterSigma * normal(key, i + 1)), 0),
+          height - 1);
+      const float d = source[sy * width + sx];
+
+      // noisy disparity, quantized to 1/8 pixel
+      float noisy = 0.0f;
+      if (d > 0.0f && d < kMaxDepth) {
+        const float disparity = std::round(
+            (kBaselineFocal / d +
+             multiplier_ * kDisparitySigma * normal(key, i + 2)) *
+            8.0f);
+        noisy = disparity > 0.0f ? kBaselineFocal * 8.0f / disparity : 0.0f;
+      }
+      depth[y * width + x] = noisy;
+    }
+  }
+}
+
+}  // namespace sensor
+}  // namespace esp
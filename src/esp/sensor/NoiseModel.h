@@ -0,0 +1,100 @@
+// Copyright (c) Facebook, Inc. and its affiliates.
+// This source code is licensed under the MIT license found in the
+// LICENSE file in the root directory of this source tree.
+
+#pragma once
+
+#include <functional>
+#include <string>
+#include <vector>
+
+#include "esp/core/Buffer.h"
+#include "esp/core/esp.h"
+
+namespace esp {
+namespace sensor {
+
+struct SensorSpec;
+
+/**
+ * @brief Noise applied in place to the observation buffers of a sensor right
+ * after readback.
+ *
+ * Selected with the "noise_model" spec parameter; further parameters of the
+ * model are read from the spec as well. Built in are
+ *  - "gaussian": additive gaussian noise with standard deviation
+ *    "noise_sigma", in units of the full range (255) for color and in meters
+ *    for depth. Alpha and empty depth pixels are left alone.
+ *  - "redwood": the disparity noise of the Redwood depth sensor model, with
+ *    subpixel jitter and disparity quantization scaled by "noise_multiplier".
+ *    Depth only.
+ *
+ * Every observation draws from the next frame of a random stream seeded with
+ * "noise_seed", by default a hash of the sensor uuid. Noise is a pure
+ * function of seed, frame and pixel index, so results do not depend on the
+ * number of threads the rows are split over.
+ */
+class NoiseModel {
+ public:
+  using Factory =
+      std::function<std::shared_ptr<NoiseModel>(const SensorSpec& spec)>;
+
+  virtual ~NoiseModel() {}
+
+  //! Model selected by the "noise_model" parameter of spec, nullptr if none
+  static std::shared_ptr<NoiseModel> fromSpec(const SensorSpec& spec);
+
+  //! Make a model available to fromSpec() under name
+  static void registerModel(const std::string& name, Factory factory);
+
+  //! Apply the noise of the next frame in place to buffer, holding one
+  //! observation of the sensor. Half float depth is supported as well.
+  void apply(core::Buffer& buffer);
+
+  //! Restart the random stream from seed
+  void seed(uint64_t seed);
+
+ protected:
+  explicit NoiseModel(const SensorSpec& spec);
+
+  //! Apply noise drawn from the stream with the given key to buffer
+  virtual void applyFrame(core::Buffer& buffer, uint64_t key) = 0;
+
+  uint64_t seed_ = 0;
+  uint64_t frame_ = 0;
+  // float copy of half float depth observations
+  std::vector<float> unpackedDepth_;
+
+  ESP_SMART_POINTERS(NoiseModel)
+};
+
+//! Additive gaussian noise on color or depth observations
+class GaussianNoiseModel : public NoiseModel {
+ public:
+  explicit GaussianNoiseModel(const SensorSpec& spec);
+
+ protected:
+  virtual void applyFrame(core::Buffer& buffer, uint64_t key) override;
+
+  float sigma_;
+
+  ESP_SMART_POINTERS(GaussianNoiseModel)
+};
+
+//! Redwood disparity noise on depth observations
+class RedwoodDepthNoiseModel : public NoiseModel {
+ public:
+  explicit RedwoodDepthNoiseModel(const SensorSpec& spec);
+
+ protected:
+  virtual void applyFrame(core::Buffer& buffer, uint64_t key) override;
+
+  float multiplier_;
+  // copy of the clean depth, as jittered pixels read their neighbours
+  std::vector<float> source_;
+
+  ESP_SMART_POINTERS(RedwoodDepthNoiseModel)
+};
+
+}  // namespace sensor
+}  // namespace esp
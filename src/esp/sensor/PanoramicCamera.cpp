@@ -0,0 +1,65 @@
+// Copyright (c) Facebook, Inc. and its affiliates.
+// This source code is licensed under the MIT license found in the
+// LICENSE file in the root directory of this source tree.
+
+#include "PanoramicCamera.h"
+
+#include <algorithm>
+
+#include "esp/gfx/Simulator.h"
+#include "esp/scene/SceneGraph.h"
+
+namespace esp {
+namespace sensor {
+
+PanoramicCamera::PanoramicCamera(scene::SceneNode& cameraNode,
+                                 SensorSpec::ptr spec)
+    : PinholeCamera(cameraNode, spec) {
+  faceSize_ = std::max(width_ / 4, 1);
+  const auto cubemapSize = spec_->parameters.find("cubemap_size");
+  if (cubemapSize != spec_->parameters.end()) {
+    faceSize_ = std::atoi(cubemapSize->second.c_str());
+    CHECK_GT(faceSize_, 0) << "Invalid cubemap_size of " << spec_->uuid;
+  }
+  if (packedRgb_ || halfDepth_) {
+    LOG(WARNING) << "PanoramicCamera " << spec_->uuid << " ignores encoding "
+                 << spec_->encoding;
+    packedRgb_ = halfDepth_ = false;
+  }
+}
+
+void PanoramicCamera::setProjectionMatrix(gfx::RenderCamera& targetCamera) {
+  targetCamera.setProjectionMatrix(faceSize_, faceSize_, near_, far_, 90.0f);
+}
+
+bool PanoramicCamera::getObservation(gfx::Simulator& sim, Observation& obs) {
+  prepareObservationBuffer(obs);
+  if (spec_->sensorType == SensorType::SEMANTIC) {
+    render(sim.getActiveSemanticSceneGraph(), obs.buffer->data);
+    remapSemanticObservation(sim, (uint32_t*)obs.buffer->data,
+                             width_ * height_);
+  } else {
+    render(sim.getActiveSceneGraph(), obs.buffer->data);
+  }
+  applyNoise(*obs.buffer);
+  return true;
+}
+
+void PanoramicCamera::render(scene::SceneGraph& sceneGraph, void* ptr) {
+  if (renderer_ == nullptr) {
+    renderer_ =
+        gfx::PanoramaRenderer::create_unique(faceSize_, width_, height_);
+  }
+  renderer_->draw(*this, sceneGraph);
+
+  if (spec_->sensorType == SensorType::SEMANTIC) {
+    renderer_->readFrameObjectId(static_cast<uint32_t*>(ptr));
+  } else if (spec_->sensorType == SensorType::DEPTH) {
+    renderer_->readFrameDepth(static_cast<float*>(ptr));
+  } else {
+    renderer_->readFrameRgba(static_cast<uint8_t*>(ptr));
+  }
+}
+
+}  // namespace sensor
+}  // namespace esp
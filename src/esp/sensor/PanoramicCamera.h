@@ -0,0 +1,51 @@
+// Copyright (c) Facebook, Inc. and its affiliates.
+// This source code is licensed under the MIT license found in the
+// LICENSE file in the root directory of this source tree.
+
+#pragma once
+
+#include "PinholeCamera.h"
+#include "esp/core/esp.h"
+#include "esp/gfx/PanoramaRenderer.h"
+
+namespace esp {
+namespace sensor {
+
+/**
+ * @brief Color, depth or semantic sensor observing a 360 x 180 degree
+ * equirectangular panorama around its position.
+ *
+ * Renders a cube map with @ref gfx::PanoramaRenderer and resamples it into an
+ * observation of the spec's resolution, forward direction in the center and
+ * up at the top like pinhole observations. Depth observations hold the
+ * distance along each ray rather than z-depth.
+ *
+ * Selected with sensorSubtype "panoramic". The "cubemap_size" spec parameter
+ * sets the cube face resolution, by default a quarter of the panorama width
+ * so that the horizon keeps its resolution. "hfov" is ignored.
+ */
+class PanoramicCamera : public PinholeCamera {
+ public:
+  explicit PanoramicCamera(scene::SceneNode& cameraNode, SensorSpec::ptr spec);
+
+  virtual ~PanoramicCamera() {}
+
+  // set the 90 degree cube face projection to the given render camera
+  virtual void setProjectionMatrix(gfx::RenderCamera& targetCamera) override;
+
+  virtual bool getObservation(gfx::Simulator& sim, Observation& obs) override;
+
+  //! Render the panorama of sceneGraph into ptr, which holds width x height
+  //! RGBA pixels, floats for depth sensors or uint32_t object ids for
+  //! semantic sensors
+  void render(scene::SceneGraph& sceneGraph, void* ptr);
+
+ protected:
+  int faceSize_;
+  gfx::PanoramaRenderer::uptr renderer_ = nullptr;
+
+  ESP_SMART_POINTERS(PanoramicCamera)
+};
+
+}  // namespace sensor
+}  // namespace esp
@@ -5,6 +5,7 @@
 #include "PinholeCamera.h"
 #include "esp/gfx/Renderer.h"
 #include "esp/gfx/Simulator.h"
+#include "esp/scene/SemanticScene.h"
 
 namespace esp {
 namespace sensor {
@@ -22,6 +23,32 @@ void PinholeCamera::setProjectionParameters(SensorSpec::ptr spec) {
   near_ = std::atof(spec_->parameters.at("near").c_str());
   far_ = std::atof(spec_->parameters.at("far").c_str());
   hfov_ = std::atof(spec_->parameters.at("hfov").c_str());
+
+  // semantic observations hold object ids unless asked for categories
+  remapSemanticToCategory_ = false;
+  const auto remap = spec_->parameters.find("semantic_remap");
+  if (remap != spec_->parameters.end() && !remap->second.empty()) {
+    if (remap->second == "category") {
+      remapSemanticToCategory_ = true;
+    } else {
+      LOG(ERROR) << "Unknown semantic_remap " << remap->second
+                 << ", keeping object ids";
+    }
+  }
+
+  // compact observation encodings, anything else keeps RGBA / float32
+  packedRgb_ = spec_->encoding == "rgb_uint8";
+  halfDepth_ = spec_->encoding == "depth_float16";
+  if (packedRgb_ && spec_->sensorType != SensorType::COLOR) {
+    LOG(ERROR) << "Encoding rgb_uint8 needs a color sensor, ignored for "
+               << spec_->uuid;
+    packedRgb_ = false;
+  }
+  if (halfDepth_ && spec_->sensorType != SensorType::DEPTH) {
+    LOG(ERROR) << "Encoding depth_float16 needs a depth sensor, ignored for "
+               << spec_->uuid;
+    halfDepth_ = false;
+  }
 }
 
 void PinholeCamera::setProjectionMatrix(gfx::RenderCamera& targetCamera) {
@@ -32,31 +59,67 @@ bool PinholeCamera::getObservationSpace(ObservationSpace& space) {
   space.spaceType = ObservationSpaceType::TENSOR;
   space.shape = {static_cast<size_t>(spec_->resolution[0]),
                  static_cast<size_t>(spec_->resolution[1]),
-                 static_cast<size_t>(spec_->channels)};
+                 static_cast<size_t>(packedRgb_ ? 3 : spec_->channels)};
   space.dataType = core::DataType::DT_UINT8;
   if (spec_->sensorType == SensorType::SEMANTIC) {
     space.dataType = core::DataType::DT_UINT32;
   } else if (spec_->sensorType == SensorType::DEPTH) {
-    space.dataType = core::DataType::DT_FLOAT;
+    space.dataType =
+        halfDepth_ ? core::DataType::DT_FLOAT16 : core::DataType::DT_FLOAT;
   }
   return true;
 }
 
+void PinholeCamera::prepareObservationBuffer(Observation& obs) {
+  // Render straight into the caller's buffer (e.g. a slot of a shared memory
+  // observation ring) if it matches our observation space, otherwise make
+  // sure we have memory of our own
+  ObservationSpace space;
+  getObservationSpace(space);
+  if (obs.buffer == nullptr || obs.buffer->shape != space.shape ||
+      obs.buffer->dataType != space.dataType) {
+    if (buffer_ == nullptr) {
+      // TODO: check if our sensor was resized and resize our buffer if needed
+      buffer_ = core::Buffer::create(space.shape, space.dataType);
+    }
+    obs.buffer = buffer_;
+  }
+}
+
+void PinholeCamera::remapSemanticObservation(gfx::Simulator& sim,
+                                             uint32_t* ids,
+                                             size_t count) {
+  std::shared_ptr<scene::SemanticScene> semanticScene = sim.getSemanticScene();
+  if (remapSemanticToCategory_ && semanticScene != nullptr) {
+    semanticScene->remap(ids, ids, count,
+                         scene::SemanticRemap::OBJECT_TO_CATEGORY);
+  }
+}
+
+void PinholeCamera::readFrame(gfx::Renderer& renderer, void* ptr) {
+  if (spec_->sensorType == SensorType::SEMANTIC) {
+    renderer.readFrameObjectId(static_cast<uint32_t*>(ptr));
+  } else if (spec_->sensorType == SensorType::DEPTH && halfDepth_) {
+    renderer.readFrameDepthHalf(static_cast<uint16_t*>(ptr));
+  } else if (spec_->sensorType == SensorType::DEPTH) {
+    renderer.readFrameDepth(static_cast<float*>(ptr));
+  } else if (packedRgb_) {
+    renderer.readFrameRgb(static_cast<uint8_t*>(ptr));
+  } else {
+    renderer.readFrameRgba(static_cast<uint8_t*>(ptr));
+  }
+}
+
 bool PinholeCamera::getObservation(gfx::Simulator& sim, Observation& obs) {
   // TODO: check if sensor is valid?
   // TODO: have different classes for the different types of sensors
 
-  // Make sure we have memory
-  if (buffer_ == nullptr) {
-    // TODO: check if our sensor was resized and resize our buffer if needed
-    ObservationSpace space;
-    getObservationSpace(space);
-    buffer_ = core::Buffer::create(space.shape, space.dataType);
-  }
-  obs.buffer = buffer_;
+  prepareObservationBuffer(obs);
 
   // TODO: Get appropriate render with correct resolution
   std::shared_ptr<gfx::Renderer> renderer = sim.getRenderer();
+  core::Profiler& profiler = renderer->getProfiler();
+  core::ProfilerScope scope{profiler, spec_->uuid + "/observation"};
   vec3i resolution = renderer->getSize();
   if (resolution[0] != width_ || resolution[1] != height_) {
     renderer->setSize(width_, height_);
@@ -71,12 +134,15 @@ bool PinholeCamera::getObservation(gfx::Simulator& sim, Observation& obs) {
 
   // TODO: have different classes for the different types of sensors
   // TODO: do we need to flip axis?
+  readFrame(*renderer, obs.buffer->data);
   if (spec_->sensorType == SensorType::SEMANTIC) {
-    renderer->readFrameObjectId((uint32_t*)buffer_->data);
-  } else if (spec_->sensorType == SensorType::DEPTH) {
-    renderer->readFrameDepth((float*)buffer_->data);
-  } else {
-    renderer->readFrameRgba((uint8_t*)buffer_->data);
+    core::ProfilerScope remapScope{profiler, spec_->uuid + "/semantic_remap"};
+    remapSemanticObservation(sim, (uint32_t*)obs.buffer->data,
+                             width_ * height_);
+  }
+  if (noiseModel_ != nullptr) {
+    core::ProfilerScope noiseScope{profiler, spec_->uuid + "/noise"};
+    applyNoise(*obs.buffer);
   }
   return true;
 }
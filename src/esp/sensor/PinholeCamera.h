@@ -8,6 +8,9 @@
 #include "esp/core/esp.h"
 
 namespace esp {
+namespace gfx {
+class Renderer;
+}
 namespace sensor {
 
 // TODO:
@@ -38,7 +41,19 @@ class PinholeCamera : public Sensor {
   virtual bool getObservation(gfx::Simulator& sim, Observation& obs) override;
   virtual bool getObservationSpace(ObservationSpace& space) override;
 
+  // convert count object ids of a semantic observation if configured to by
+  // the "semantic_remap" spec parameter
+  void remapSemanticObservation(gfx::Simulator& sim,
+                                uint32_t* ids,
+                                size_t count);
+
  protected:
+  // point obs.buffer at memory matching our observation space
+  void prepareObservationBuffer(Observation& obs);
+
+  // read the last frame of renderer into ptr as our observation type
+  void readFrame(gfx::Renderer& renderer, void* ptr);
+
   // projection parameters
   int width_ = 640;      // canvas width
   int height_ = 480;     // canvas height
@@ -46,6 +61,15 @@ class PinholeCamera : public Sensor {
   float far_ = 1000.0f;  // far clipping plane
   float hfov_ = 35.0f;   // field of vision (in degrees)
 
+  // semantic observations are converted from object to category ids, set by
+  // the "semantic_remap": "category" spec parameter
+  bool remapSemanticToCategory_ = false;
+
+  // color observations drop alpha, set by the "rgb_uint8" encoding
+  bool packedRgb_ = false;
+  // depth observations are half floats, set by the "depth_float16" encoding
+  bool halfDepth_ = false;
+
   ESP_SMART_POINTERS(PinholeCamera)
 };
 
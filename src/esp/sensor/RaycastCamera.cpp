@@ -0,0 +1,222 @@
+// Copyright (c) Facebook, Inc. and its affiliates.
+// This source code is licensed under the MIT license found in the
+// LICENSE file in the root directory of this source tree.
+
+#include "RaycastCamera.h"
+
+#include <Magnum/Math/Algorithms/GramSchmidt.h>
+#include <Magnum/Math/Functions.h>
+
+#include "esp/gfx/RaycastMesh.h"
+#include "esp/gfx/Simulator.h"
+#include "esp/scene/SceneGraph.h"
+
+namespace esp {
+namespace sensor {
+
+namespace {
+// a packet covers kPacketWidth x kPacketHeight pixels
+constexpr int kPacketWidth = 4;
+constexpr int kPacketHeight = geo::kRayPacketSize / kPacketWidth;
+// threads work on tiles of kTileSize x kTileSize pixels
+constexpr int kTileSize = 16;
+
+void collectRaycastMeshes(scene::SceneNode& node,
+                          std::vector<gfx::RaycastMesh*>& meshes) {
+  for (auto& feature : node.features()) {
+    auto* mesh = dynamic_cast<gfx::RaycastMesh*>(&feature);
+    if (mesh != nullptr) {
+      meshes.push_back(mesh);
+    }
+  }
+  for (auto& child : node.children()) {
+    collectRaycastMeshes(static_cast<scene::SceneNode&>(child), meshes);
+  }
+}
+
+size_t countTriangles(const std::vector<gfx::RaycastMesh*>& meshes) {
+  size_t numTriangles = 0;
+  for (const auto* mesh : meshes) {
+    numTriangles += mesh->getNumTriangles();
+  }
+  return numTriangles;
+}
+
+// world space corners of triangle i of mesh placed with transform
+void worldTriangle(const gfx::RaycastMesh& mesh,
+                   const Magnum::Matrix4& transform,
+                   size_t i,
+                   vec3f corners[3]) {
+  const auto& positions = mesh.getMeshData().positions;
+  const vec3ui triangle = mesh.getTriangle(i);
+  for (int j = 0; j < 3; ++j) {
+    const Magnum::Vector3 p = transform.transformPoint(positions[triangle[j]]);
+    corners[j] = vec3f(p.x(), p.y(), p.z());
+  }
+}
+}  // namespace
+
+RaycastCamera::RaycastCamera(scene::SceneNode& cameraNode,
+                             SensorSpec::ptr spec)
+    : PinholeCamera(cameraNode, spec) {
+  if (spec_->sensorType != SensorType::DEPTH &&
+      spec_->sensorType != SensorType::SEMANTIC) {
+    LOG(ERROR) << "RaycastCamera " << spec_->uuid
+               << " only supports depth and semantic sensors";
+  }
+  if (halfDepth_) {
+    LOG(WARNING) << "RaycastCamera " << spec_->uuid << " ignores encoding "
+                 << spec_->encoding;
+    halfDepth_ = false;
+  }
+}
+
+bool RaycastCamera::getObservation(gfx::Simulator& sim, Observation& obs) {
+  if (spec_->sensorType != SensorType::DEPTH &&
+      spec_->sensorType != SensorType::SEMANTIC) {
+    return false;
+  }
+  prepareObservationBuffer(obs);
+  raycast(sim, obs.buffer->data);
+  if (spec_->sensorType == SensorType::SEMANTIC) {
+    remapSemanticObservation(sim, static_cast<uint32_t*>(obs.buffer->data),
+                             width_ * height_);
+  }
+  applyNoise(*obs.buffer);
+  return true;
+}
+
+void RaycastCamera::raycast(gfx::Simulator& sim, void* ptr) {
+  scene::SceneGraph* sceneGraph = &sim.getActiveSceneGraph();
+  if (spec_->sensorType == SensorType::SEMANTIC) {
+    sceneGraph = &sim.getActiveSemanticSceneGraph();
+  } else {
+    // PTex meshes keep no geometry on the CPU, but the semantic mesh of the
+    // same scene has the same shape
+    std::vector<gfx::RaycastMesh*> meshes;
+    collectRaycastMeshes(sceneGraph->getRootNode(), meshes);
+    if (countTriangles(meshes) == 0) {
+      sceneGraph = &sim.getActiveSemanticSceneGraph();
+    }
+  }
+  raycast(*sceneGraph, ptr);
+}
+
+void RaycastCamera::updateBVH(scene::SceneGraph& sceneGraph) {
+  std::vector<gfx::RaycastMesh*> meshes;
+  collectRaycastMeshes(sceneGraph.getRootNode(), meshes);
+  std::vector<size_t> meshTriangles;
+  std::vector<Magnum::Matrix4> transforms;
+  for (auto* mesh : meshes) {
+    meshTriangles.push_back(mesh->getNumTriangles());
+    transforms.push_back(mesh->getSceneNode().absoluteTransformationMatrix());
+  }
+
+  vec3f corners[3];
+  if (bvh_ != nullptr && bvhSceneGraph_ == &sceneGraph &&
+      bvhMeshes_ == meshes && bvhMeshTriangles_ == meshTriangles) {
+    // same geometry, move the triangles of meshes whose node moved
+    bool moved = false;
+    size_t firstTriangle = 0;
+    for (size_t m = 0; m < meshes.size(); ++m) {
+      if (transforms[m] != bvhTransforms_[m]) {
+        for (size_t i = 0; i < meshTriangles[m]; ++i) {
+          worldTriangle(*meshes[m], transforms[m], i, corners);
+          bvh_->setTriangle(firstTriangle + i, corners[0], corners[1],
+                            corners[2]);
+        }
+        moved = true;
+      }
+      firstTriangle += meshTriangles[m];
+    }
+    if (moved) {
+      bvh_->refit();
+      bvhTransforms_ = std::move(transforms);
+    }
+    return;
+  }
+
+  const size_t numTriangles = countTriangles(meshes);
+  bvh_ = geo::TriangleBVH::create();
+  bvh_->reserve(numTriangles);
+  for (size_t m = 0; m < meshes.size(); ++m) {
+    for (size_t i = 0; i < meshTriangles[m]; ++i) {
+      worldTriangle(*meshes[m], transforms[m], i, corners);
+      bvh_->addTriangle(corners[0], corners[1], corners[2],
+                        meshes[m]->getObjectId(i));
+    }
+  }
+  bvh_->build();
+  bvhSceneGraph_ = &sceneGraph;
+  bvhMeshes_ = std::move(meshes);
+  bvhMeshTriangles_ = std::move(meshTriangles);
+  bvhTransforms_ = std::move(transforms);
+  LOG(INFO) << "RaycastCamera " << spec_->uuid << ": built BVH over "
+            << numTriangles << " triangles";
+}
+
+void RaycastCamera::raycast(scene::SceneGraph& sceneGraph, void* ptr) {
+  updateBVH(sceneGraph);
+
+  // same camera frame as SceneGraph::setDefaultRenderCamera()
+  const Magnum::Matrix4 T = node().absoluteTransformation();
+  Magnum::Matrix3 R = T.rotationScaling();
+  Magnum::Math::Algorithms::gramSchmidtOrthonormalizeInPlace(R);
+  const vec3f origin(T.translation().x(), T.translation().y(),
+                     T.translation().z());
+  const mat3f rotation = Eigen::Map<const mat3f>(R.data());
+
+  // Camera space rays through pixel centers have z = -1, so the ray
+  // parameter t of a hit is its z-depth, which is what the GL path outputs
+  // and what its near / far planes clip
+  const float xScale = Magnum::Math::tan(Magnum::Deg{hfov_} * 0.5f);
+  const float yScale = xScale * height_ / width_;
+  const bool isDepth = spec_->sensorType == SensorType::DEPTH;
+  const int width = width_;
+  const int height = height_;
+  const int numTilesX = (width + kTileSize - 1) / kTileSize;
+  const int numTilesY = (height + kTileSize - 1) / kTileSize;
+
+#pragma omp parallel for schedule(dynamic)
+  for (int tile = 0; tile < numTilesX * numTilesY; ++tile) {
+    const int tileX = (tile % numTilesX) * kTileSize;
+    const int tileY = (tile / numTilesX) * kTileSize;
+    geo::RayPacket packet;
+    geo::PacketHit hit;
+    for (int py = tileY; py < tileY + kTileSize; py += kPacketHeight) {
+      for (int px = tileX; px < tileX + kTileSize; px += kPacketWidth) {
+        for (int k = 0; k < geo::kRayPacketSize; ++k) {
+          const int x = px + k % kPacketWidth;
+          const int y = py + k / kPacketWidth;
+          // row 0 is the bottom of the image, as read back from GL
+          const vec3f dir(xScale * (2.0f * (x + 0.5f) / width - 1.0f),
+                          yScale * (2.0f * (y + 0.5f) / height - 1.0f), -1.0f);
+          packet.origin.row(k) = origin.transpose();
+          packet.direction.row(k) = (rotation * dir).transpose();
+          packet.tMin[k] = near_;
+          // disable rays past the image border
+          packet.tMax[k] = (x < width && y < height) ? far_ : -1.0f;
+        }
+        bvh_->intersect(packet, hit);
+
+        for (int k = 0; k < geo::kRayPacketSize; ++k) {
+          const int x = px + k % kPacketWidth;
+          const int y = py + k / kPacketWidth;
+          if (x >= width || y >= height) {
+            continue;
+          }
+          const bool isHit = hit.triangle[k] != ID_UNDEFINED;
+          if (isDepth) {
+            static_cast<float*>(ptr)[y * width + x] = isHit ? hit.t[k] : 0.0f;
+          } else {
+            static_cast<uint32_t*>(ptr)[y * width + x] =
+                isHit ? bvh_->objectId(hit.triangle[k]) : 0;
+          }
+        }
+      }
+    }
+  }
+}
+
+}  // namespace sensor
+}  // namespace esp
@@ -0,0 +1,68 @@
+// Copyright (c) Facebook, Inc. and its affiliates.
+// This source code is licensed under the MIT license found in the
+// LICENSE file in the root directory of this source tree.
+
+#pragma once
+
+#include "PinholeCamera.h"
+#include "esp/core/esp.h"
+#include "esp/geo/BVH.h"
+
+namespace esp {
+namespace gfx {
+class RaycastMesh;
+}
+namespace scene {
+class SceneGraph;
+}
+namespace sensor {
+
+/**
+ * @brief Depth or semantic pinhole camera that ray casts the scene on the CPU
+ * instead of rendering it with OpenGL.
+ *
+ * Rays are traced through a @ref geo::TriangleBVH built from the
+ * @ref gfx::RaycastMesh features of the scene graph, in packets of
+ * neighbouring pixels and with image tiles spread over OpenMP threads. The
+ * hierarchy is rebuilt when meshes are added or removed and refitted when
+ * the nodes holding them move, so moved objects are seen at their new pose.
+ * The output matches @ref gfx::Renderer::readFrameDepth() and
+ * @ref gfx::Renderer::readFrameObjectId() for the same camera: z-depth with 0
+ * for no hit, object id with 0 for no hit, rows ordered bottom to top.
+ *
+ * Selected with sensorSubtype "raycast". Color sensors are not supported.
+ */
+class RaycastCamera : public PinholeCamera {
+ public:
+  explicit RaycastCamera(scene::SceneNode& cameraNode, SensorSpec::ptr spec);
+
+  virtual ~RaycastCamera() {}
+
+  virtual bool getObservation(gfx::Simulator& sim, Observation& obs) override;
+
+  //! Ray cast the scene graph sim renders for this sensor into ptr, which
+  //! holds width x height floats for depth sensors and uint32_t object ids for
+  //! semantic sensors
+  void raycast(gfx::Simulator& sim, void* ptr);
+
+  //! Ray cast the given scene graph into ptr
+  void raycast(scene::SceneGraph& sceneGraph, void* ptr);
+
+ protected:
+  // rebuild the BVH if sceneGraph or the meshes it contains changed, refit it
+  // if only their transformations changed
+  void updateBVH(scene::SceneGraph& sceneGraph);
+
+  geo::TriangleBVH::ptr bvh_ = nullptr;
+  const scene::SceneGraph* bvhSceneGraph_ = nullptr;
+  // meshes in bvh_ in the order their triangles were added, with their
+  // triangle counts and the transformations the triangles were placed with
+  std::vector<gfx::RaycastMesh*> bvhMeshes_;
+  std::vector<size_t> bvhMeshTriangles_;
+  std::vector<Magnum::Matrix4> bvhTransforms_;
+
+  ESP_SMART_POINTERS(RaycastCamera)
+};
+
+}  // namespace sensor
+}  // namespace esp
@@ -18,6 +18,7 @@ Sensor::Sensor(scene::SceneNode& node, SensorSpec::ptr spec)
   ASSERT(spec_ != nullptr);
 
   setTransformationFromSpec();
+  noiseModel_ = NoiseModel::fromSpec(*spec_);
 }
 
 bool Sensor::getObservation(gfx::Simulator& sim, Observation& obs) {
@@ -62,7 +63,8 @@ bool operator==(const SensorSpec& a, const SensorSpec& b) {
          a.sensorSubtype == b.sensorSubtype && a.parameters == b.parameters &&
          a.position == b.position && a.orientation == b.orientation &&
          a.resolution == b.resolution && a.channels == b.channels &&
-         a.encoding == b.encoding && a.observationSpace == b.observationSpace;
+         a.encoding == b.encoding && a.parentUuid == b.parentUuid &&
+         a.observationSpace == b.observationSpace;
 }
 bool operator!=(const SensorSpec& a, const SensorSpec& b) {
   return !(a == b);
@@ -9,6 +9,7 @@
 #include "esp/core/Buffer.h"
 #include "esp/gfx/RenderCamera.h"
 #include "esp/scene/SceneNode.h"
+#include "esp/sensor/NoiseModel.h"
 
 namespace esp {
 namespace gfx {
@@ -50,6 +51,9 @@ struct SensorSpec {
   vec2i resolution = {84, 84};
   int channels = 4;
   std::string encoding = "rgba_uint8";
+  // uuid of a sensor of the same agent whose render this sensor downsamples
+  // instead of drawing the scene itself, see DerivedCamera
+  std::string parentUuid = "";
   // description of Sensor observation space as gym.spaces.Dict()
   std::string observationSpace = "";
   ESP_SMART_POINTERS(SensorSpec)
@@ -106,9 +110,20 @@ class Sensor : public Magnum::SceneGraph::AbstractFeature3D {
   virtual bool getObservation(gfx::Simulator& sim, Observation& obs);
   virtual bool getObservationSpace(ObservationSpace& space);
 
+  //! Noise model of the "noise_model" spec parameter, nullptr if none
+  NoiseModel::ptr getNoiseModel() const { return noiseModel_; }
+
+  //! Apply the noise model, if any, in place to an observation buffer
+  void applyNoise(core::Buffer& buffer) {
+    if (noiseModel_ != nullptr) {
+      noiseModel_->apply(buffer);
+    }
+  }
+
  protected:
   SensorSpec::ptr spec_ = nullptr;
   core::Buffer::ptr buffer_ = nullptr;
+  NoiseModel::ptr noiseModel_ = nullptr;
 
   ESP_SMART_POINTERS(Sensor)
 };
@@ -4,6 +4,7 @@
 
 #include "SimulatorWithAgents.h"
 #include "esp/io/io.h"
+#include "esp/sensor/DerivedCamera.h"
 
 namespace esp {
 namespace sim {
@@ -134,12 +135,29 @@ int SimulatorWithAgents::getAgentObservations(
   if (ag != nullptr) {
     const std::map<std::string, sensor::Sensor::ptr>& sensors =
         ag->getSensorSuite().getSensors();
+    std::vector<std::shared_ptr<sensor::DerivedCamera>> derived;
     for (std::pair<std::string, sensor::Sensor::ptr> s : sensors) {
+      auto derivedSensor =
+          std::dynamic_pointer_cast<sensor::DerivedCamera>(s.second);
+      if (derivedSensor != nullptr) {
+        derived.push_back(derivedSensor);
+        continue;
+      }
       sensor::Observation obs;
       if (s.second->getObservation(*this, obs)) {
         observations[s.first] = obs;
       }
     }
+    // downsample the observations of the parents instead of rendering again
+    for (const auto& derivedSensor : derived) {
+      const auto parentObs =
+          observations.find(derivedSensor->getParent()->specification()->uuid);
+      sensor::Observation obs;
+      if (parentObs != observations.end() &&
+          derivedSensor->deriveObservation(parentObs->second, obs)) {
+        observations[derivedSensor->specification()->uuid] = obs;
+      }
+    }
   }
   return observations.size();
 }
@@ -0,0 +1,38 @@
+uniform lowp samplerCube colorTexture;
+uniform highp usamplerCube objectIdTexture;
+uniform highp samplerCube depthTexture;
+
+// (a, b) of the cube face projection, which maps face depth d to
+// NDC z = b / d - a
+uniform highp vec2 depthUnprojection;
+
+in highp vec2 v_position;
+
+layout(location = 0) out lowp vec4 color;
+layout(location = 1) out highp uint objectId;
+layout(location = 2) out highp float depth;
+
+const highp float PI = 3.141592653589793;
+
+void main() {
+  // longitude 0 looks straight ahead (-Z), latitude 0 is the horizon
+  highp float longitude = v_position.x * PI;
+  highp float latitude = v_position.y * 0.5 * PI;
+  highp vec3 direction =
+      vec3(sin(longitude) * cos(latitude), sin(latitude),
+           -cos(longitude) * cos(latitude));
+
+  color = texture(colorTexture, direction);
+  objectId = texture(objectIdTexture, direction).r;
+
+  // distance along the ray, 0 for holes in the mesh like Renderer does
+  highp float z = texture(depthTexture, direction).r;
+  if (z == 1.0) {
+    depth = 0.0;
+  } else {
+    highp float faceDepth =
+        depthUnprojection.y / (2.0 * z - 1.0 + depthUnprojection.x);
+    highp vec3 axis = abs(direction);
+    depth = faceDepth / max(axis.x, max(axis.y, axis.z));
+  }
+}
@@ -0,0 +1,8 @@
+// clip space position, interpolated to the pixel centers
+out highp vec2 v_position;
+
+void main() {
+  // a single triangle covering the whole viewport, no vertex buffer needed
+  v_position = vec2((gl_VertexID << 1) & 2, gl_VertexID & 2) * 2.0 - 1.0;
+  gl_Position = vec4(v_position, 0.0, 1.0);
+}
@@ -0,0 +1,24 @@
+#ifdef TEXTURED
+uniform lowp sampler2D textureData;
+in mediump vec2 v_textureCoordinates;
+#endif
+#ifdef VERTEX_COLOR
+in lowp vec4 v_vertexColor;
+#endif
+
+flat in highp uint v_objectId;
+flat in lowp vec4 v_color;
+
+layout(location = 0) out lowp vec4 color;
+layout(location = 1) out highp uint objectId;
+
+void main() {
+  color = v_color;
+#ifdef TEXTURED
+  color *= texture(textureData, v_textureCoordinates);
+#endif
+#ifdef VERTEX_COLOR
+  color *= v_vertexColor;
+#endif
+  objectId = v_objectId;
+}
@@ -0,0 +1,32 @@
+uniform highp mat4 projectionMatrix;
+
+layout(location = 0) in highp vec4 position;
+#ifdef TEXTURED
+layout(location = 1) in mediump vec2 textureCoordinates;
+out mediump vec2 v_textureCoordinates;
+#endif
+#ifdef VERTEX_COLOR
+layout(location = 3) in lowp vec4 color;
+out lowp vec4 v_vertexColor;
+#endif
+
+// per-instance attributes, the matrix occupies locations 8 to 11
+layout(location = 8) in highp mat4 instanceTransformation;
+layout(location = 12) in highp uint instanceObjectId;
+layout(location = 13) in lowp vec4 instanceColor;
+
+flat out highp uint v_objectId;
+flat out lowp vec4 v_color;
+
+void main() {
+  gl_Position = projectionMatrix * instanceTransformation *
+                vec4(position.xyz, 1.0);
+#ifdef TEXTURED
+  v_textureCoordinates = textureCoordinates;
+#endif
+#ifdef VERTEX_COLOR
+  v_vertexColor = color;
+#endif
+  v_objectId = instanceObjectId;
+  v_color = instanceColor;
+}
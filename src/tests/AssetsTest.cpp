@@ -0,0 +1,409 @@
+// Copyright (c) Facebook, Inc. and its affiliates.
+// This source code is licensed under the MIT license found in the
+// LICENSE file in the root directory of this source tree.
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <array>
+#include <cstring>
+#include <fstream>
+#include <limits>
+#include <random>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include <Corrade/Utility/Directory.h>
+
+#include "esp/assets/MeshCache.h"
+#include "esp/assets/PTexMeshData.h"
+#include "esp/core/esp.h"
+
+namespace Cr = Corrade;
+
+using esp::assets::PTexMeshData;
+
+namespace {
+
+// Write a binary PLY with numVertices vertices of the given properties, each
+// property value being its vertex index, and numFaces faces of faceSize
+// consecutive indices
+std::string writePLY(const std::string& name,
+                     const std::vector<std::string>& vertexProperties,
+                     uint32_t numVertices,
+                     uint32_t numFaces,
+                     uint8_t faceSize) {
+  const std::string filename =
+      Cr::Utility::Directory::join(Cr::Utility::Directory::tmp(), name);
+  std::ofstream file(filename, std::ios::binary);
+  file << "ply\nformat binary_little_endian 1.0\n"
+       << "comment written by AssetsTest\n"
+       << "element vertex " << numVertices << "\n";
+  for (const std::string& property : vertexProperties) {
+    file << "property " << property << "\n";
+  }
+  file << "element face " << numFaces << "\n"
+       << "property list uchar int vertex_indices\nend_header\n";
+
+  for (uint32_t i = 0; i < numVertices; ++i) {
+    for (const std::string& property : vertexProperties) {
+      if (property.compare(0, 5, "float") == 0) {
+        const float value = i;
+        file.write(reinterpret_cast<const char*>(&value), sizeof(value));
+      } else {
+        const uint8_t value = i % 256;
+        file.write(reinterpret_cast<const char*>(&value), sizeof(value));
+      }
+    }
+  }
+  for (uint32_t i = 0; i < numFaces; ++i) {
+    file.write(reinterpret_cast<const char*>(&faceSize), sizeof(faceSize));
+    for (uint32_t j = 0; j < faceSize; ++j) {
+      const uint32_t index = (i + j) % numVertices;
+      file.write(reinterpret_cast<const char*>(&index), sizeof(index));
+    }
+  }
+  return filename;
+}
+
+// The hash map based PTexMeshData::calculateAdjacency() the sort based one
+// has to match byte for byte
+void referenceAdjacency(const PTexMeshData::MeshData& mesh,
+                        std::vector<uint32_t>& adjFaces) {
+  struct EdgeData {
+    int face;
+    int edge;
+  };
+  std::unordered_map<uint64_t, std::vector<EdgeData>> edgeMap;
+  const int numFaces = mesh.ibo.size() / 4;
+  std::vector<uint64_t> edgeKeys(numFaces * 4);
+  for (int f = 0; f < numFaces; f++) {
+    for (int e = 0; e < 4; e++) {
+      const uint32_t i0 = mesh.ibo[f * 4 + e];
+      const uint32_t i1 = mesh.ibo[f * 4 + ((e + 1) % 4)];
+      const uint64_t key =
+          (uint64_t)std::min(i0, i1) << 32 | (uint32_t)std::max(i0, i1);
+      edgeMap[key].push_back({f, e});
+      edgeKeys[f * 4 + e] = key;
+    }
+  }
+
+  adjFaces.resize(numFaces * 4);
+  for (int f = 0; f < numFaces; f++) {
+    for (int e = 0; e < 4; e++) {
+      const std::vector<EdgeData>& adj = edgeMap[edgeKeys[f * 4 + e]];
+      int adjFace = -1;
+      for (size_t i = 0; i < adj.size(); i++) {
+        if (adj[i].face != f)
+          adjFace = adj[i].face;
+      }
+      int rot = 0;
+      if (adj.size() == 2) {
+        int edge0 = 0, edge1 = 0;
+        if (adj[0].edge == e) {
+          edge0 = adj[0].edge;
+          edge1 = adj[1].edge;
+        } else if (adj[1].edge == e) {
+          edge0 = adj[1].edge;
+          edge1 = adj[0].edge;
+        }
+        rot = (edge0 - edge1 + 2) & 3;
+      }
+      adjFaces[f * 4 + e] = (rot << 30) | (adjFace & 0x3FFFFFFF);
+    }
+  }
+}
+
+// The hash map based PTexMeshData::splitMesh() the sort based one has to
+// match submesh for submesh, vertex for vertex
+std::vector<PTexMeshData::MeshData> referenceSplitMesh(
+    const PTexMeshData::MeshData& mesh,
+    float splitSize) {
+  auto Part1By2 = [](uint64_t x) {
+    x &= 0x1fffff;
+    x = (x | (x << 32)) & 0x1f00000000ffff;
+    x = (x | (x << 16)) & 0x1f0000ff0000ff;
+    x = (x | (x << 8)) & 0x100f00f00f00f00f;
+    x = (x | (x << 4)) & 0x10c30c30c30c30c3;
+    x = (x | (x << 2)) & 0x1249249249249249;
+    return x;
+  };
+  esp::box3f boundingBox;
+  for (const esp::vec4f& position : mesh.vbo) {
+    boundingBox.extend(position.head<3>());
+  }
+  std::vector<uint32_t> verts(mesh.vbo.size());
+  for (size_t i = 0; i < mesh.vbo.size(); i++) {
+    const esp::vec3i pi =
+        ((mesh.vbo[i].head<3>() - boundingBox.min()) / splitSize).cast<int>();
+    verts[i] =
+        (Part1By2(pi(2)) << 2) + (Part1By2(pi(1)) << 1) + Part1By2(pi(0));
+  }
+
+  struct SortFace {
+    uint32_t index[4];
+    uint32_t code;
+    size_t originalFace;
+  };
+  std::vector<SortFace> faces(mesh.ibo.size() / 4);
+  for (size_t i = 0; i < faces.size(); i++) {
+    faces[i].originalFace = i;
+    faces[i].code = std::numeric_limits<uint32_t>::max();
+    for (int j = 0; j < 4; j++) {
+      faces[i].index[j] = mesh.ibo[i * 4 + j];
+      faces[i].code = std::min(faces[i].code, verts[faces[i].index[j]]);
+    }
+  }
+  std::sort(faces.begin(), faces.end(),
+            [](const SortFace& f1, const SortFace& f2) -> bool {
+              return (f1.code < f2.code);
+            });
+
+  std::vector<PTexMeshData::MeshData> subMeshes;
+  for (size_t begin = 0; begin < faces.size();) {
+    size_t end = begin + 1;
+    while (end < faces.size() && faces[end].code == faces[begin].code) {
+      ++end;
+    }
+    subMeshes.emplace_back();
+    PTexMeshData::MeshData& subMesh = subMeshes.back();
+    std::unordered_map<uint32_t, uint32_t> refdVertsMap;
+    for (size_t j = begin; j < end; j++) {
+      for (int k = 0; k < 4; k++) {
+        const uint32_t vertIndex = faces[j].index[k];
+        auto it = refdVertsMap.find(vertIndex);
+        if (it == refdVertsMap.end()) {
+          it = refdVertsMap.emplace(vertIndex, subMesh.vbo.size()).first;
+          subMesh.vbo.push_back(mesh.vbo[vertIndex]);
+          subMesh.nbo.push_back(mesh.nbo[vertIndex]);
+        }
+        subMesh.ibo.push_back(it->second);
+      }
+    }
+    begin = end;
+  }
+  return subMeshes;
+}
+
+}  // namespace
+
+TEST(AssetsTest, parsePLYInterleaved) {
+  const std::string filename = writePLY(
+      "AssetsTest-interleaved.ply",
+      {"float x", "float y", "float z", "float nx", "float ny", "float nz",
+       "uchar red", "uchar green", "uchar blue"},
+      300, 5, 3);
+
+  PTexMeshData::MeshData mesh;
+  PTexMeshData::parsePLY(filename, mesh);
+  ASSERT_EQ(mesh.vbo.size(), 300);
+  ASSERT_EQ(mesh.nbo.size(), 300);
+  ASSERT_EQ(mesh.cbo.size(), 300);
+  ASSERT_EQ(mesh.ibo.size(), 5 * 3);
+  for (uint32_t i = 0; i < 300; ++i) {
+    EXPECT_EQ(mesh.vbo[i], esp::vec4f(i, i, i, 1));
+    EXPECT_EQ(mesh.nbo[i], esp::vec4f(i, i, i, 1));
+    EXPECT_EQ(mesh.cbo[i], esp::vec4uc(i % 256, i % 256, i % 256, 255));
+  }
+  for (uint32_t i = 0; i < 5; ++i) {
+    for (uint32_t j = 0; j < 3; ++j) {
+      EXPECT_EQ(mesh.ibo[i * 3 + j], i + j);
+    }
+  }
+  Cr::Utility::Directory::rm(filename);
+}
+
+TEST(AssetsTest, parsePLYPositions) {
+  // packets laid out like the positions, copied in one go (see
+  // benchmarks/PTexPLYBenchmark for timings of a full size mesh)
+  const uint32_t numVertices = 4096;
+  const uint32_t numFaces = numVertices / 2;
+  const std::string filename =
+      writePLY("AssetsTest-positions.ply",
+               {"float x", "float y", "float z", "float w"}, numVertices,
+               numFaces, 4);
+
+  PTexMeshData::MeshData mesh;
+  PTexMeshData::parsePLY(filename, mesh);
+
+  ASSERT_EQ(mesh.vbo.size(), numVertices);
+  EXPECT_TRUE(mesh.nbo.empty());
+  EXPECT_TRUE(mesh.cbo.empty());
+  ASSERT_EQ(mesh.ibo.size(), numFaces * 4);
+  for (uint32_t i = 0; i < numVertices; ++i) {
+    EXPECT_EQ(mesh.vbo[i], esp::vec4f::Constant(i));
+  }
+  for (uint32_t i = 0; i < numFaces; ++i) {
+    for (uint32_t j = 0; j < 4; ++j) {
+      EXPECT_EQ(mesh.ibo[i * 4 + j], i + j);
+    }
+  }
+  Cr::Utility::Directory::rm(filename);
+}
+
+TEST(AssetsTest, ptexMeshCache) {
+  const std::string tmp = Cr::Utility::Directory::tmp();
+  const std::string meshFile = writePLY(
+      "AssetsTest-cache.ply", {"float x", "float y", "float z", "float w"},
+      4096, 1024, 4);
+  const std::string atlasDir =
+      Cr::Utility::Directory::join(tmp, "AssetsTest-textures");
+  const std::string cacheDir =
+      Cr::Utility::Directory::join(tmp, "AssetsTest-cache");
+  Cr::Utility::Directory::mkpath(atlasDir);
+  Cr::Utility::Directory::writeString(
+      Cr::Utility::Directory::join(atlasDir, "parameters.json"),
+      "{\"splitSize\": 512.0, \"tileSize\": 16}");
+  const std::string cacheFile =
+      PTexMeshData::cacheFilename(cacheDir, meshFile);
+  Cr::Utility::Directory::rm(cacheFile);
+
+  // the first load computes and writes the cache, the second one reads it
+  PTexMeshData computed, cached;
+  computed.load(meshFile, atlasDir, cacheDir);
+  ASSERT_TRUE(Cr::Utility::Directory::exists(cacheFile));
+  cached.load(meshFile, atlasDir, cacheDir);
+
+  ASSERT_EQ(cached.getSize(), computed.getSize());
+  for (int i = 0; i < computed.getSize(); ++i) {
+    EXPECT_EQ(cached.meshes()[i].vbo, computed.meshes()[i].vbo);
+    EXPECT_EQ(cached.meshes()[i].ibo, computed.meshes()[i].ibo);
+    EXPECT_TRUE(cached.getSubmeshBounds(i).isApprox(
+        computed.getSubmeshBounds(i)));
+  }
+
+  // a cache built with a different split size is outdated
+  PTexMeshData unsplit;
+  EXPECT_FALSE(unsplit.loadCache(cacheFile, meshFile));
+
+  Cr::Utility::Directory::rm(cacheFile);
+  Cr::Utility::Directory::rm(meshFile);
+}
+
+TEST(AssetsTest, ptexMeshSharedCache) {
+  const std::string tmp = Cr::Utility::Directory::tmp();
+  const std::string meshFile = writePLY(
+      "AssetsTest-shared.ply", {"float x", "float y", "float z", "float w"},
+      4096, 1024, 4);
+  const std::string atlasDir =
+      Cr::Utility::Directory::join(tmp, "AssetsTest-textures");
+  const std::string cacheDir =
+      Cr::Utility::Directory::join(tmp, "AssetsTest-cache");
+  Cr::Utility::Directory::mkpath(atlasDir);
+  Cr::Utility::Directory::writeString(
+      Cr::Utility::Directory::join(atlasDir, "parameters.json"),
+      "{\"splitSize\": 512.0, \"tileSize\": 16}");
+  const std::string cacheFile =
+      PTexMeshData::cacheFilename(cacheDir, meshFile);
+  Cr::Utility::Directory::rm(cacheFile);
+
+  // both the load writing the cache and the one reading it use it in place
+  PTexMeshData computed, writer, reader;
+  computed.load(meshFile, atlasDir);
+  writer.load(meshFile, atlasDir, cacheDir, true);
+  reader.load(meshFile, atlasDir, cacheDir, true);
+
+  for (const PTexMeshData* shared : {&writer, &reader}) {
+    EXPECT_TRUE(shared->meshes().empty());
+    ASSERT_EQ(shared->getSize(), computed.getSize());
+    for (int i = 0; i < computed.getSize(); ++i) {
+      const PTexMeshData::MeshData& expected = computed.meshes()[i];
+      const PTexMeshData::MeshView& mesh = shared->getSubmesh(i);
+      ASSERT_EQ(mesh.vbo.size(), expected.vbo.size());
+      ASSERT_EQ(mesh.ibo.size(), expected.ibo.size());
+      EXPECT_TRUE(std::equal(mesh.vbo.begin(), mesh.vbo.end(),
+                             expected.vbo.begin()));
+      EXPECT_TRUE(std::equal(mesh.ibo.begin(), mesh.ibo.end(),
+                             expected.ibo.begin()));
+      EXPECT_EQ(reinterpret_cast<uintptr_t>(mesh.vbo.data()) %
+                    esp::assets::kMeshCacheAlignment,
+                0);
+    }
+  }
+
+  Cr::Utility::Directory::rm(cacheFile);
+  Cr::Utility::Directory::rm(meshFile);
+}
+
+TEST(AssetsTest, ptexMeshAdjacency) {
+  // a grid of quads with random winding and starting vertex, some of them
+  // duplicated to make non-manifold edges and some degenerate
+  const int gridSize = 128;
+  std::mt19937 generator(5);
+  PTexMeshData::MeshData mesh;
+  for (int y = 0; y < gridSize; ++y) {
+    for (int x = 0; x < gridSize; ++x) {
+      uint32_t quad[] = {uint32_t(y * (gridSize + 1) + x),
+                         uint32_t(y * (gridSize + 1) + x + 1),
+                         uint32_t((y + 1) * (gridSize + 1) + x + 1),
+                         uint32_t((y + 1) * (gridSize + 1) + x)};
+      if (generator() % 2) {
+        std::reverse(quad, quad + 4);
+      }
+      const int start = generator() % 4;
+      for (int i = 0; i < 4; ++i) {
+        mesh.ibo.push_back(quad[(start + i) % 4]);
+      }
+      if (generator() % 50 == 0) {
+        for (int i = 0; i < 4; ++i) {
+          mesh.ibo.push_back(quad[(i + 1) % 4]);
+        }
+      }
+      if (generator() % 70 == 0) {
+        mesh.ibo.insert(mesh.ibo.end(), {quad[0], quad[0], quad[1], quad[2]});
+      }
+    }
+  }
+
+  std::vector<uint32_t> expected, adjacency;
+  referenceAdjacency(mesh, expected);
+  PTexMeshData::calculateAdjacency(mesh, adjacency);
+  ASSERT_EQ(adjacency.size(), expected.size());
+  EXPECT_EQ(0, std::memcmp(adjacency.data(), expected.data(),
+                           expected.size() * sizeof(uint32_t)));
+}
+
+TEST(AssetsTest, ptexMeshSplit) {
+  // a jittered grid of quads in random order and with random winding, about
+  // 16 x 16 quads to a grid cell, so many faces share a code and the order
+  // the face sort leaves them in matters
+  const int gridSize = 128;
+  std::mt19937 generator(7);
+  std::uniform_real_distribution<float> jitter(-0.25f, 0.25f);
+  PTexMeshData::MeshData mesh;
+  for (int y = 0; y <= gridSize; ++y) {
+    for (int x = 0; x <= gridSize; ++x) {
+      mesh.vbo.emplace_back(x + jitter(generator), y + jitter(generator),
+                            jitter(generator), 1);
+      mesh.nbo.emplace_back(x, y, 1, 0);
+    }
+  }
+  std::vector<std::array<uint32_t, 4>> quads;
+  for (int y = 0; y < gridSize; ++y) {
+    for (int x = 0; x < gridSize; ++x) {
+      std::array<uint32_t, 4> quad{uint32_t(y * (gridSize + 1) + x),
+                                   uint32_t(y * (gridSize + 1) + x + 1),
+                                   uint32_t((y + 1) * (gridSize + 1) + x + 1),
+                                   uint32_t((y + 1) * (gridSize + 1) + x)};
+      std::rotate(quad.begin(), quad.begin() + generator() % 4, quad.end());
+      quads.push_back(quad);
+    }
+  }
+  std::shuffle(quads.begin(), quads.end(), generator);
+  for (const std::array<uint32_t, 4>& quad : quads) {
+    mesh.ibo.insert(mesh.ibo.end(), quad.begin(), quad.end());
+  }
+
+  const std::vector<PTexMeshData::MeshData> expected =
+      referenceSplitMesh(mesh, 16.0f);
+  const std::vector<PTexMeshData::MeshData> subMeshes =
+      PTexMeshData::splitMesh(mesh, 16.0f);
+  ASSERT_GT(expected.size(), 1u);
+  ASSERT_EQ(subMeshes.size(), expected.size());
+  for (size_t i = 0; i < expected.size(); ++i) {
+    EXPECT_EQ(subMeshes[i].vbo, expected[i].vbo);
+    EXPECT_EQ(subMeshes[i].nbo, expected[i].nbo);
+    EXPECT_EQ(subMeshes[i].ibo, expected[i].ibo);
+  }
+}
@@ -2,9 +2,21 @@
 // This source code is licensed under the MIT license found in the
 // LICENSE file in the root directory of this source tree.
 
+#include <fcntl.h>
 #include <gtest/gtest.h>
+#include <sys/mman.h>
+#include <unistd.h>
+#include <cstdio>
+#include <algorithm>
+#include <cstring>
+#include <random>
+#include <utility>
+#include <vector>
 
 #include "esp/core/Configuration.h"
+#include "esp/core/ObservationRingBuffer.h"
+#include "esp/core/Profiler.h"
+#include "esp/core/RadixSort.h"
 #include "esp/core/esp.h"
 #include "esp/io/json.h"
 
@@ -28,3 +40,134 @@ TEST(CoreTest, JsonTest) {
   EXPECT_EQ(t[1], 2);
   EXPECT_EQ(esp::io::jsonToString(json), "{\"test\":[1,2,3,4]}");
 }
+
+TEST(CoreTest, ObservationRingBufferTest) {
+  const std::string name = "esp_core_test_ring_" + std::to_string(getpid());
+  std::vector<RingBufferField> fields = {
+      {"rgba", DataType::DT_UINT8, {4, 5, 4}},
+      {"depth", DataType::DT_FLOAT, {4, 5}}};
+  auto producer = ObservationRingBuffer::createRing(name, fields, 2);
+  ASSERT_NE(producer, nullptr);
+  auto consumer = ObservationRingBuffer::attachRing(name);
+  ASSERT_NE(consumer, nullptr);
+  ASSERT_EQ(consumer->numSlots(), 2);
+  ASSERT_EQ(consumer->fields().size(), 2);
+  EXPECT_EQ(consumer->fields()[1].name, "depth");
+  EXPECT_EQ(consumer->fields()[1].shape, fields[1].shape);
+
+  // nothing published yet
+  EXPECT_EQ(consumer->acquireReadSlot(0), esp::ID_UNDEFINED);
+  EXPECT_EQ(consumer->pendingReadSlot(), esp::ID_UNDEFINED);
+  EXPECT_EQ(producer->pendingWriteSlot(), 0);
+
+  for (int step = 0; step < 2; ++step) {
+    const int slot = producer->acquireWriteSlot(0);
+    ASSERT_EQ(slot, step);
+    Buffer::ptr depth = producer->slotField(slot, "depth");
+    ASSERT_EQ(depth->totalBytes, 4 * 5 * sizeof(float));
+    static_cast<float*>(depth->data)[0] = step + 0.5f;
+    producer->commitWriteSlot(slot);
+  }
+  // ring is full until the consumer releases a slot
+  EXPECT_EQ(producer->acquireWriteSlot(0), esp::ID_UNDEFINED);
+  EXPECT_EQ(producer->pendingWriteSlot(), esp::ID_UNDEFINED);
+  EXPECT_EQ(consumer->pendingReadSlot(), 0);
+  EXPECT_EQ(consumer->numReadySlots(), 2);
+
+  for (int step = 0; step < 2; ++step) {
+    const int slot = consumer->acquireReadSlot(0);
+    ASSERT_EQ(slot, step);
+    Buffer::ptr depth = consumer->slotField(slot, 1);
+    EXPECT_EQ(static_cast<float*>(depth->data)[0], step + 0.5f);
+    consumer->releaseReadSlot(slot);
+  }
+  EXPECT_EQ(consumer->numReadySlots(), 0);
+  EXPECT_EQ(producer->acquireWriteSlot(0), 0);
+}
+
+TEST(CoreTest, ObservationRingBufferReplacesStaleSegment) {
+  const std::string name = "esp_core_test_stale_" + std::to_string(getpid());
+  std::vector<RingBufferField> fields = {{"depth", DataType::DT_FLOAT, {4}}};
+
+  // a segment of a producer that crashed mid-episode, with slots in flight
+  const std::string shmName = "/" + name;
+  const int fd = shm_open(shmName.c_str(), O_CREAT | O_RDWR, 0600);
+  ASSERT_NE(fd, -1);
+  std::vector<char> garbage(1 << 16, char(0x5a));
+  ASSERT_EQ(write(fd, garbage.data(), garbage.size()),
+            ssize_t(garbage.size()));
+  close(fd);
+
+  auto producer = ObservationRingBuffer::createRing(name, fields, 2);
+  ASSERT_NE(producer, nullptr);
+  auto consumer = ObservationRingBuffer::attachRing(name);
+  ASSERT_NE(consumer, nullptr);
+  EXPECT_EQ(consumer->numReadySlots(), 0);
+  EXPECT_EQ(consumer->pendingReadSlot(), esp::ID_UNDEFINED);
+  EXPECT_EQ(producer->acquireWriteSlot(0), 0);
+  EXPECT_EQ(static_cast<float*>(producer->slotField(0, 0)->data)[0], 0.0f);
+}
+
+TEST(CoreTest, ProfilerTest) {
+  Profiler profiler(100);
+  // disabled by default
+  profiler.record("draw", 0, 1000000);
+  EXPECT_TRUE(profiler.sectionNames().empty());
+
+  profiler.setEnabled(true);
+  for (int i = 1; i <= 200; ++i) {
+    profiler.record("draw", i * 10000000, i * 1000000);
+  }
+  profiler.record("gpu", 0, 2000000, "gpu");
+  { ProfilerScope scope{profiler, "scope"}; }
+
+  EXPECT_EQ(profiler.sectionNames(),
+            (std::vector<std::string>{"draw", "gpu", "scope"}));
+  // only the last 100 samples, 101..200 ms, are kept
+  ProfilerStats draw = profiler.stats("draw");
+  EXPECT_EQ(draw.count, 100);
+  EXPECT_DOUBLE_EQ(draw.mean, 150.5);
+  EXPECT_DOUBLE_EQ(draw.p50, 150.0);
+  EXPECT_DOUBLE_EQ(draw.p99, 199.0);
+  EXPECT_EQ(profiler.stats("scope").count, 1);
+  EXPECT_EQ(profiler.stats("missing").count, 0);
+
+  const std::string trace =
+      "/tmp/esp_core_test_trace_" + std::to_string(getpid()) + ".json";
+  ASSERT_TRUE(profiler.writeChromeTrace(trace));
+  const auto& json = esp::io::parseJsonFile(trace);
+  EXPECT_EQ(json["traceEvents"].Size(), 2 + 100 + 1 + 1);
+  std::remove(trace.c_str());
+
+  profiler.reset();
+  EXPECT_TRUE(profiler.sectionNames().empty());
+}
+
+TEST(CoreTest, RadixSortTest) {
+  std::mt19937_64 generator(7);
+  for (size_t size : {0, 1, 1000, 100000}) {
+    // few distinct keys with varying high and low halves, so that stability
+    // matters and some bytes are skipped
+    std::vector<uint64_t> keys(size);
+    std::vector<uint32_t> values(size);
+    std::vector<std::pair<uint64_t, uint32_t>> expected(size);
+    for (size_t i = 0; i < size; ++i) {
+      keys[i] = (generator() % 300) << 32 | (generator() % 300);
+      values[i] = i;
+      expected[i] = {keys[i], values[i]};
+    }
+    std::stable_sort(expected.begin(), expected.end(),
+                     [](const std::pair<uint64_t, uint32_t>& a,
+                        const std::pair<uint64_t, uint32_t>& b) {
+                       return a.first < b.first;
+                     });
+
+    radixSortPairs(keys, values);
+    ASSERT_EQ(keys.size(), size);
+    ASSERT_EQ(values.size(), size);
+    for (size_t i = 0; i < size; ++i) {
+      EXPECT_EQ(keys[i], expected[i].first);
+      EXPECT_EQ(values[i], expected[i].second);
+    }
+  }
+}
@@ -3,7 +3,14 @@
 // LICENSE file in the root directory of this source tree.
 
 #include <gtest/gtest.h>
+#include <algorithm>
+#include <deque>
+#include "esp/core/random.h"
+#include "esp/geo/BVH.h"
+#include "esp/geo/ConvexDecomposition.h"
 #include "esp/geo/CoordinateFrame.h"
+#include "esp/geo/MeshCompaction.h"
+#include "esp/geo/MeshSimplification.h"
 #include "esp/geo/OBB.h"
 #include "esp/geo/geo.h"
 
@@ -98,3 +105,413 @@ TEST(GeoTest, CoordinateFrame) {
   c4.fromJson(j);
   EXPECT_EQ(c3, c4);
 }
+
+TEST(GeoTest, TriangleBVH) {
+  core::Random random(1);
+  std::vector<vec3f> vertices;
+  TriangleBVH bvh;
+  for (int i = 0; i < 500; ++i) {
+    const vec3f center(random.uniform_float(-5, 5), random.uniform_float(-5, 5),
+                       random.uniform_float(-5, 5));
+    vec3f tri[3];
+    for (int j = 0; j < 3; ++j) {
+      tri[j] = center + vec3f(random.uniform_float(-0.5, 0.5),
+                              random.uniform_float(-0.5, 0.5),
+                              random.uniform_float(-0.5, 0.5));
+      vertices.push_back(tri[j]);
+    }
+    bvh.addTriangle(tri[0], tri[1], tri[2], i);
+  }
+  bvh.build();
+  EXPECT_EQ(bvh.numTriangles(), 500);
+
+  // brute force reference, also culling back faces
+  auto bruteForce = [&](const vec3f& origin, const vec3f& dir) {
+    RayHit best;
+    for (int i = 0; i < 500; ++i) {
+      const vec3f& a = vertices[3 * i];
+      const vec3f e1 = vertices[3 * i + 1] - a;
+      const vec3f e2 = vertices[3 * i + 2] - a;
+      const vec3f n = e1.cross(e2);
+      const float denom = n.dot(dir);
+      if (denom >= 0) {
+        continue;
+      }
+      const float t = n.dot(a - origin) / denom;
+      const vec3f p = origin + t * dir - a;
+      // barycentric coordinates of p
+      const float d00 = e1.dot(e1), d01 = e1.dot(e2), d11 = e2.dot(e2);
+      const float d20 = p.dot(e1), d21 = p.dot(e2);
+      const float det = d00 * d11 - d01 * d01;
+      const float v = (d11 * d20 - d01 * d21) / det;
+      const float w = (d00 * d21 - d01 * d20) / det;
+      if (t >= 0 && v >= 0 && w >= 0 && v + w <= 1 && t < best.t) {
+        best.t = t;
+        best.triangle = i;
+      }
+    }
+    return best;
+  };
+
+  const vec3f origin(0, 0, 12);
+  int numHits = 0;
+  for (int y = 0; y < 32; ++y) {
+    RayPacket packet;
+    for (int x = 0; x < kRayPacketSize; ++x) {
+      const vec3f dir(0.05f * (x - 4), 0.05f * (y - 16), -1.0f);
+      packet.origin.row(x) = origin.transpose();
+      packet.direction.row(x) = dir.transpose();
+    }
+    packet.tMin.setZero();
+    packet.tMax.setConstant(std::numeric_limits<float>::infinity());
+    PacketHit packetHit;
+    bvh.intersect(packet, packetHit);
+
+    for (int x = 0; x < kRayPacketSize; ++x) {
+      const vec3f dir = packet.direction.row(x).transpose();
+      const RayHit expected = bruteForce(origin, dir);
+      const RayHit single = bvh.intersect(origin, dir);
+      ASSERT_EQ(single.triangle == ID_UNDEFINED,
+                expected.triangle == ID_UNDEFINED);
+      ASSERT_EQ(packetHit.triangle[x] == ID_UNDEFINED,
+                expected.triangle == ID_UNDEFINED);
+      if (expected.triangle != ID_UNDEFINED) {
+        ++numHits;
+        EXPECT_NEAR(single.t, expected.t, 1e-4);
+        EXPECT_NEAR(packetHit.t[x], expected.t, 1e-4);
+        EXPECT_EQ(bvh.objectId(single.triangle), expected.triangle);
+        EXPECT_EQ(bvh.objectId(packetHit.triangle[x]), expected.triangle);
+      }
+    }
+  }
+  EXPECT_GT(numHits, 0);
+
+  // tMax limits the query
+  const RayHit clipped = bvh.intersect(origin, vec3f(0, 0, -1), 0.0f, 1.0f);
+  EXPECT_EQ(clipped.triangle, ID_UNDEFINED);
+}
+
+TEST(GeoTest, TriangleBVHRefit) {
+  core::Random random(2);
+  std::vector<vec3f> vertices;
+  TriangleBVH refitted;
+  for (int i = 0; i < 300; ++i) {
+    const vec3f center(random.uniform_float(-5, 5), random.uniform_float(-5, 5),
+                       random.uniform_float(-5, 5));
+    for (int j = 0; j < 3; ++j) {
+      vertices.push_back(center + vec3f(random.uniform_float(-0.5, 0.5),
+                                        random.uniform_float(-0.5, 0.5),
+                                        random.uniform_float(-0.5, 0.5)));
+    }
+    refitted.addTriangle(vertices[3 * i], vertices[3 * i + 1],
+                         vertices[3 * i + 2], i);
+  }
+  refitted.build();
+
+  // move every third triangle, as if the objects they belong to moved
+  for (int i = 0; i < 300; i += 3) {
+    for (int j = 0; j < 3; ++j) {
+      vertices[3 * i + j] += vec3f(2.0f, -1.0f, 4.0f);
+    }
+    refitted.setTriangle(i, vertices[3 * i], vertices[3 * i + 1],
+                         vertices[3 * i + 2]);
+  }
+  refitted.refit();
+
+  // the refitted hierarchy finds the same hits as one built from scratch
+  TriangleBVH rebuilt;
+  for (int i = 0; i < 300; ++i) {
+    rebuilt.addTriangle(vertices[3 * i], vertices[3 * i + 1],
+                        vertices[3 * i + 2], i);
+  }
+  rebuilt.build();
+  const vec3f origin(0, 0, 12);
+  int numHits = 0;
+  for (int y = 0; y < 64; ++y) {
+    for (int x = 0; x < 64; ++x) {
+      const vec3f dir(0.02f * (x - 32), 0.02f * (y - 32), -1.0f);
+      const RayHit expected = rebuilt.intersect(origin, dir);
+      const RayHit hit = refitted.intersect(origin, dir);
+      ASSERT_EQ(hit.triangle == ID_UNDEFINED,
+                expected.triangle == ID_UNDEFINED);
+      if (expected.triangle != ID_UNDEFINED) {
+        ++numHits;
+        EXPECT_NEAR(hit.t, expected.t, 1e-4);
+        EXPECT_EQ(refitted.objectId(hit.triangle),
+                  rebuilt.objectId(expected.triangle));
+      }
+    }
+  }
+  EXPECT_GT(numHits, 0);
+}
+
+TEST(GeoTest, SimplifyMesh) {
+  // n x n quad grid on the xz-plane with a bump in the middle
+  const int n = 20;
+  std::vector<vec3f> positions;
+  std::vector<uint32_t> indices;
+  for (int z = 0; z <= n; ++z) {
+    for (int x = 0; x <= n; ++x) {
+      const float r2 = (x - n / 2) * (x - n / 2) + (z - n / 2) * (z - n / 2);
+      positions.emplace_back(x, r2 < 9 ? 0.5f : 0.0f, z);
+    }
+  }
+  for (uint32_t z = 0; z < n; ++z) {
+    for (uint32_t x = 0; x < n; ++x) {
+      const uint32_t i = z * (n + 1) + x;
+      indices.insert(indices.end(), {i, i + n + 1, i + 1});
+      indices.insert(indices.end(), {i + 1, i + n + 1, i + n + 2});
+    }
+  }
+  auto area = [&](const std::vector<uint32_t>& mesh) {
+    float sum = 0;
+    for (size_t i = 0; i < mesh.size(); i += 3) {
+      const vec3f e1 = positions[mesh[i + 1]] - positions[mesh[i]];
+      const vec3f e2 = positions[mesh[i + 2]] - positions[mesh[i]];
+      // projected onto the grid plane, so that the bump does not count
+      sum += 0.5f * std::abs(e1[2] * e2[0] - e1[0] * e2[2]);
+    }
+    return sum;
+  };
+
+  float error = -1;
+  const std::vector<uint32_t> simplified =
+      simplifyMesh(positions, indices, indices.size() / 4, &error);
+  EXPECT_EQ(simplified.size() % 3, 0);
+  EXPECT_LE(simplified.size(), indices.size() / 4);
+  EXPECT_GT(simplified.size(), 0);
+  for (uint32_t index : simplified) {
+    EXPECT_LT(index, positions.size());
+  }
+  // borders are locked and no triangle flips, so the grid stays covered
+  EXPECT_NEAR(area(simplified), n * n, 1e-3);
+  // flat parts collapse for free, the bump does not
+  EXPECT_GE(error, 0.0f);
+
+  // nothing to simplify away in a single triangle with locked borders
+  const std::vector<uint32_t> triangle{0, 1, 2};
+  EXPECT_EQ(simplifyMesh(positions, triangle, 0), triangle);
+
+  // coarser targets give larger errors
+  float coarseError = -1;
+  simplifyMesh(positions, indices, 60, &coarseError);
+  EXPECT_GT(coarseError, 0.0f);
+  EXPECT_GE(coarseError, error);
+}
+
+namespace {
+
+// n x n quad grid as a triangle soup, three vertices per triangle, with the
+// triangles in no particular order
+void createScatteredGrid(int n,
+                         std::vector<uint32_t>& grid,
+                         std::vector<vec3f>& positions,
+                         std::vector<vec3uc>& colors,
+                         std::vector<uint32_t>& indices) {
+  for (uint32_t z = 0; z < n; ++z) {
+    for (uint32_t x = 0; x < n; ++x) {
+      const uint32_t i = z * (n + 1) + x;
+      grid.insert(grid.end(), {i, i + n + 1, i + 1});
+      grid.insert(grid.end(), {i + 1, i + n + 1, i + n + 2});
+    }
+  }
+  const size_t numTriangles = grid.size() / 3;
+  for (size_t k = 0; k < numTriangles; ++k) {
+    const size_t t = (k * 7919) % numTriangles;
+    for (int j = 0; j < 3; ++j) {
+      const int x = grid[3 * t + j] % (n + 1);
+      const int z = grid[3 * t + j] / (n + 1);
+      positions.emplace_back(0.1f * x - 3.0f, std::sin(0.3f * x), 0.2f * z);
+      colors.emplace_back(x, z, 7);
+      indices.push_back(positions.size() - 1);
+    }
+  }
+}
+
+// Every triangle of mesh is kept, in one of the chunks covering the triangles
+// in order, and maps back to its original
+void expectCompactMeshMatches(const CompactMesh& mesh,
+                              const std::vector<vec3f>& positions,
+                              const std::vector<vec3uc>& colors,
+                              const std::vector<uint32_t>& indices) {
+  const size_t numTriangles = indices.size() / 3;
+  ASSERT_EQ(mesh.indices.size(), indices.size());
+  ASSERT_EQ(mesh.triangles.size(), numTriangles);
+  uint32_t firstVertex = 0, firstTriangle = 0;
+  for (const CompactMeshChunk& chunk : mesh.chunks) {
+    EXPECT_EQ(chunk.firstVertex, firstVertex);
+    EXPECT_EQ(chunk.firstTriangle, firstTriangle);
+    EXPECT_LE(chunk.numVertices, kMaxChunkVertices);
+    firstVertex += chunk.numVertices;
+    firstTriangle += chunk.numTriangles;
+  }
+  EXPECT_EQ(firstVertex, mesh.vertices.size());
+  ASSERT_EQ(firstTriangle, numTriangles);
+
+  std::vector<bool> seen(numTriangles, false);
+  const vec3f step = mesh.positionScale / kPositionQuantizationMax;
+  for (const CompactMeshChunk& chunk : mesh.chunks) {
+    for (size_t k = chunk.firstTriangle;
+         k < chunk.firstTriangle + chunk.numTriangles; ++k) {
+      const uint32_t t = mesh.triangles[k];
+      ASSERT_LT(t, numTriangles);
+      EXPECT_FALSE(seen[t]);
+      seen[t] = true;
+      for (int j = 0; j < 3; ++j) {
+        ASSERT_LT(mesh.indices[3 * k + j], chunk.numVertices);
+        const CompactVertex& vertex =
+            mesh.vertices[chunk.firstVertex + mesh.indices[3 * k + j]];
+        const uint32_t original = indices[3 * t + j];
+        const vec3f error =
+            (decodePosition(mesh, vertex) - positions[original]).cwiseAbs();
+        EXPECT_TRUE((error.array() <= 0.5f * step.array() + 1e-6f).all());
+        for (int c = 0; c < 3; ++c) {
+          EXPECT_EQ(vertex.color[c], colors[original][c]);
+        }
+      }
+    }
+  }
+}
+
+}  // namespace
+
+TEST(GeoTest, CompactMesh) {
+  const int n = 50;
+  std::vector<uint32_t> grid;
+  std::vector<vec3f> positions;
+  std::vector<vec3uc> colors;
+  std::vector<uint32_t> indices;
+  createScatteredGrid(n, grid, positions, colors, indices);
+  const size_t numTriangles = grid.size() / 3;
+  // unused vertices do not widen the quantization bounds
+  positions.emplace_back(1e4f, 1e4f, 1e4f);
+  colors.emplace_back(0, 0, 0);
+
+  const CompactMesh mesh =
+      compactMesh({positions.data(), positions.size()},
+                  {colors.data(), colors.size()},
+                  {indices.data(), indices.size()});
+
+  // shared vertices are merged, and few enough for a single chunk
+  EXPECT_EQ(mesh.vertices.size(), (n + 1) * (n + 1));
+  EXPECT_EQ(mesh.chunks.size(), 1);
+  expectCompactMeshMatches(mesh, positions, colors, indices);
+
+  // the reordered triangles miss a FIFO vertex cache far less often than the
+  // scattered ones sharing the same vertices
+  auto missesPerTriangle = [](const std::vector<uint32_t>& triangleIndices) {
+    std::deque<uint32_t> cache;
+    size_t misses = 0;
+    for (const uint32_t v : triangleIndices) {
+      if (std::find(cache.begin(), cache.end(), v) == cache.end()) {
+        ++misses;
+        cache.push_back(v);
+        if (cache.size() > 16) {
+          cache.pop_front();
+        }
+      }
+    }
+    return float(misses) / (triangleIndices.size() / 3);
+  };
+  std::vector<uint32_t> scattered;
+  for (size_t k = 0; k < numTriangles; ++k) {
+    const size_t t = (k * 7919) % numTriangles;
+    scattered.insert(scattered.end(), &grid[3 * t], &grid[3 * t + 3]);
+  }
+  const std::vector<uint32_t> compacted(mesh.indices.begin(),
+                                        mesh.indices.end());
+  EXPECT_LT(missesPerTriangle(compacted), 0.8f);
+  EXPECT_GT(missesPerTriangle(scattered), 2.0f);
+}
+
+TEST(GeoTest, CompactMeshChunks) {
+  // more vertices than 16 bit indices address
+  const int n = 300;
+  std::vector<uint32_t> grid;
+  std::vector<vec3f> positions;
+  std::vector<vec3uc> colors;
+  std::vector<uint32_t> indices;
+  createScatteredGrid(n, grid, positions, colors, indices);
+
+  const CompactMesh mesh =
+      compactMesh({positions.data(), positions.size()},
+                  {colors.data(), colors.size()},
+                  {indices.data(), indices.size()});
+
+  // split into as few chunks as fit, repeating only the vertices they share
+  ASSERT_GT((n + 1) * (n + 1), kMaxChunkVertices);
+  EXPECT_EQ(mesh.chunks.size(), 2);
+  EXPECT_GE(mesh.vertices.size(), (n + 1) * (n + 1));
+  EXPECT_LT(mesh.vertices.size(), 1.1 * (n + 1) * (n + 1));
+  expectCompactMeshMatches(mesh, positions, colors, indices);
+
+  // smaller chunks, with degenerate triangles whose repeated vertex is added
+  // to the chunk once
+  const uint32_t last = positions.size() - 1;
+  indices.insert(indices.end(), {last, last, last, 0, last, last});
+  const CompactMesh small =
+      compactMesh({positions.data(), positions.size()},
+                  {colors.data(), colors.size()},
+                  {indices.data(), indices.size()}, 16, 3);
+  for (const CompactMeshChunk& chunk : small.chunks) {
+    EXPECT_LE(chunk.numVertices, 3);
+  }
+  EXPECT_GT(small.chunks.size(), indices.size() / 9);
+  expectCompactMeshMatches(small, positions, colors, indices);
+}
+
+TEST(GeoTest, ConvexDecomposition) {
+  // the hull of a cube filled with points is its corners
+  core::Random random(5);
+  std::vector<vec3f> points;
+  for (int i = 0; i < 8; ++i) {
+    points.emplace_back(i & 1, (i >> 1) & 1, (i >> 2) & 1);
+  }
+  for (int i = 0; i < 1000; ++i) {
+    points.emplace_back(random.uniform_float_01(), random.uniform_float_01(),
+                        random.uniform_float_01());
+  }
+  float volume = 0;
+  EXPECT_EQ(convexHull(points, SIZE_MAX, &volume).size(), 8);
+  EXPECT_NEAR(volume, 1.0f, 1e-4f);
+  EXPECT_TRUE(convexHull({{0, 0, 0}, {1, 0, 0}, {0, 1, 0}, {1, 1, 0}}).empty());
+
+  // an L shape of two boxes, whose inner faces touch, needs two hulls
+  std::vector<vec3f> positions;
+  std::vector<uint32_t> indices;
+  auto addBox = [&](const vec3f& min, const vec3f& max) {
+    const uint32_t first = positions.size();
+    for (int i = 0; i < 8; ++i) {
+      positions.emplace_back(i & 1 ? max[0] : min[0], i & 2 ? max[1] : min[1],
+                             i & 4 ? max[2] : min[2]);
+    }
+    const uint32_t quads[6][4] = {{0, 2, 3, 1}, {4, 5, 7, 6}, {0, 1, 5, 4},
+                                  {2, 6, 7, 3}, {0, 4, 6, 2}, {1, 3, 7, 5}};
+    for (const auto& quad : quads) {
+      for (const uint32_t j : {quad[0], quad[1], quad[2], quad[0], quad[2],
+                               quad[3]}) {
+        indices.push_back(first + j);
+      }
+    }
+  };
+  addBox({0, 0, 0}, {3, 1, 1});
+  addBox({0, 1, 0}, {1, 3, 1});
+
+  const std::vector<std::vector<vec3f>> hulls =
+      decomposeConvex(positions, indices);
+  EXPECT_GE(hulls.size(), 2);
+  float totalVolume = 0;
+  for (const std::vector<vec3f>& hull : hulls) {
+    EXPECT_LE(hull.size(), ConvexDecompositionSettings{}.maxHullVertices);
+    for (const vec3f& point : hull) {
+      EXPECT_TRUE((point.array() >= -1e-4f).all());
+      EXPECT_TRUE((point.array() <= 3.0001f).all());
+    }
+    float hullVolume = 0;
+    convexHull(hull, SIZE_MAX, &hullVolume);
+    totalVolume += hullVolume;
+  }
+  // the hulls cover the shape without much empty space
+  EXPECT_GT(totalVolume, 4.9f);
+  EXPECT_LT(totalVolume, 5.5f);
+}
@@ -0,0 +1,465 @@
+// Copyright (c) Facebook, Inc. and its affiliates.
+// This source code is licensed under the MIT license found in the
+// LICENSE file in the root directory of this source tree.
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <set>
+#include <string>
+#include <tuple>
+#include <vector>
+
+#include <Corrade/Containers/ArrayViewStl.h>
+#include <Corrade/Utility/Directory.h>
+#include <Magnum/GL/Buffer.h>
+#include <Magnum/GL/Mesh.h>
+#include <Magnum/GL/Texture.h>
+#include <Magnum/GL/TextureFormat.h>
+#include <Magnum/Image.h>
+#include <Magnum/ImageView.h>
+#include <Magnum/Math/Color.h>
+#include <Magnum/PixelFormat.h>
+#include <Magnum/Shaders/Flat.h>
+
+#include "esp/assets/GenericInstanceMeshData.h"
+#include "esp/assets/TextureCache.h"
+#include "esp/geo/MeshCompaction.h"
+#include "esp/gfx/GenericDrawable.h"
+#include "esp/gfx/DrawableGroup.h"
+#include "esp/gfx/PrimitiveIDTexturedDrawable.h"
+#include "esp/gfx/PrimitiveIDTexturedShader.h"
+#include "esp/gfx/RenderCamera.h"
+#include "esp/gfx/RenderQueue.h"
+#include "esp/gfx/Renderer.h"
+#include "esp/gfx/WindowlessContext.h"
+#include "esp/scene/SceneGraph.h"
+
+namespace Cr = Corrade;
+
+using namespace esp;
+using esp::assets::TextureCache;
+
+namespace {
+
+constexpr int kSize = 64;
+// quads per row and column
+constexpr int kGrid = 4;
+
+struct Frame {
+  std::vector<uint8_t> rgba;
+  std::vector<uint32_t> objectIds;
+  gfx::RenderQueueStats stats;
+};
+
+// A quad facing the camera, 0.8 units wide
+Magnum::GL::Mesh createQuad(Magnum::GL::Buffer& vertices) {
+  Magnum::GL::Mesh mesh;
+  mesh.setCount(6).addVertexBuffer(vertices, 0,
+                                   Magnum::Shaders::Flat3D::Position{});
+  return mesh;
+}
+
+// Draw a grid of quads with distinct object ids and colors, quad i with
+// meshes[i % meshes.size()]
+Frame drawQuads(gfx::Renderer& renderer,
+                Magnum::Shaders::Flat3D& shader,
+                std::vector<Magnum::GL::Mesh>& meshes) {
+  scene::SceneGraph sceneGraph;
+  for (int i = 0; i < kGrid * kGrid; ++i) {
+    scene::SceneNode& node = sceneGraph.getRootNode().createChild();
+    node.setId(i + 1);
+    node.setTranslation(
+        {i % kGrid - (kGrid - 1) * 0.5f, i / kGrid - (kGrid - 1) * 0.5f, -3});
+    new gfx::GenericDrawable(node, shader, meshes[i % meshes.size()],
+                             &sceneGraph.getDrawables(), nullptr, i + 1,
+                             Magnum::Color4{i / 16.0f, 0.5f, 1.0f});
+  }
+
+  gfx::RenderCamera& camera = sceneGraph.getDefaultRenderCamera();
+  camera.setProjectionMatrix(kSize, kSize, 0.1f, 100.0f, 90.0f);
+  renderer.draw(camera, sceneGraph);
+
+  Frame frame;
+  frame.rgba.resize(kSize * kSize * 4);
+  frame.objectIds.resize(kSize * kSize);
+  renderer.readFrameRgba(frame.rgba.data());
+  renderer.readFrameObjectId(frame.objectIds.data());
+  frame.stats = camera.getRenderStats();
+  return frame;
+}
+
+// Records the order it is drawn in instead of drawing
+class RecordingDrawable : public gfx::Drawable {
+ public:
+  RecordingDrawable(scene::SceneNode& node,
+                    Magnum::GL::AbstractShaderProgram& shader,
+                    Magnum::GL::Mesh& mesh,
+                    Magnum::GL::Texture2D& texture,
+                    gfx::DrawableGroup& group,
+                    std::vector<RecordingDrawable*>& drawn)
+      : gfx::Drawable{node, shader, mesh, &group},
+        texture_(texture),
+        drawn_(drawn) {}
+
+  Magnum::GL::Texture2D* getTexture() const override { return &texture_; }
+
+  std::tuple<Magnum::GL::AbstractShaderProgram*,
+             Magnum::GL::Texture2D*,
+             Magnum::GL::Mesh*>
+  getState() {
+    return std::make_tuple(&getShader(), getTexture(), &getMesh());
+  }
+
+ protected:
+  void draw(const Magnum::Matrix4&, Magnum::SceneGraph::Camera3D&) override {
+    drawn_.push_back(this);
+  }
+
+  Magnum::GL::Texture2D& texture_;
+  std::vector<RecordingDrawable*>& drawn_;
+};
+
+void writeFile(const std::string& filename, const std::string& contents) {
+  std::ofstream file(filename, std::ios::binary | std::ios::trunc);
+  file << contents;
+}
+
+// Uploads a mesh given in memory
+class InstanceMesh : public assets::GenericInstanceMeshData {
+ public:
+  void upload(const std::vector<vec3f>& positions,
+              const std::vector<vec3uc>& colors,
+              const std::vector<uint32_t>& indices,
+              const std::vector<float>& objectIds) {
+    uploadCompactMesh(positions, colors, indices, objectIds);
+  }
+};
+
+bool isSortedByState(const std::vector<RecordingDrawable*>& drawn) {
+  return std::is_sorted(drawn.begin(), drawn.end(),
+                        [](RecordingDrawable* a, RecordingDrawable* b) {
+                          return a->getState() < b->getState();
+                        });
+}
+
+}  // namespace
+
+TEST(GfxTest, RenderQueueSortsByState) {
+  gfx::WindowlessContext context;
+  Magnum::Shaders::Flat3D shaders[2];
+  Magnum::GL::Texture2D textures[2];
+  Magnum::GL::Mesh meshes[2];
+  scene::SceneGraph sceneGraph;
+  std::vector<RecordingDrawable*> drawn;
+
+  // every combination of states, added with the shader changing fastest
+  for (int i = 0; i < 8; ++i) {
+    new RecordingDrawable(sceneGraph.getRootNode().createChild(),
+                          shaders[i % 2], meshes[i / 4], textures[i / 2 % 2],
+                          sceneGraph.getDrawables(), drawn);
+  }
+
+  gfx::RenderQueue queue;
+  queue.draw(sceneGraph.getDefaultRenderCamera().getMagnumCamera(),
+             sceneGraph.getDrawables());
+  ASSERT_EQ(drawn.size(), 8u);
+  EXPECT_TRUE(isSortedByState(drawn));
+
+  const gfx::RenderQueueStats& stats = queue.getStats();
+  EXPECT_EQ(stats.drawCalls, 8u);
+  EXPECT_EQ(stats.instancedDrawCalls, 0u);
+  EXPECT_EQ(stats.shaderTransitions, 2u);
+  EXPECT_EQ(stats.textureTransitions, 4u);
+  EXPECT_EQ(stats.meshTransitions, 8u);
+
+  // only the visible drawables are drawn, in the same order
+  std::vector<bool> visible(8);
+  for (size_t i = 0; i < visible.size(); i += 3) {
+    visible[i] = true;
+  }
+  const std::vector<RecordingDrawable*> allDrawn = drawn;
+  drawn.clear();
+  queue.draw(sceneGraph.getDefaultRenderCamera().getMagnumCamera(),
+             sceneGraph.getDrawables(), &visible);
+  ASSERT_EQ(drawn.size(), 3u);
+  EXPECT_TRUE(isSortedByState(drawn));
+  EXPECT_EQ(queue.getStats().drawCalls, 3u);
+  for (RecordingDrawable* drawable : drawn) {
+    EXPECT_NE(std::find(allDrawn.begin(), allDrawn.end(), drawable),
+              allDrawn.end());
+  }
+}
+
+TEST(GfxTest, RenderQueueFollowsGroupChanges) {
+  gfx::WindowlessContext context;
+  Magnum::Shaders::Flat3D shaders[2];
+  Magnum::GL::Texture2D textures[2];
+  Magnum::GL::Mesh meshes[2];
+  scene::SceneGraph sceneGraph;
+  gfx::DrawableGroup& drawables = sceneGraph.getDrawables();
+  MagnumCamera& camera = sceneGraph.getDefaultRenderCamera().getMagnumCamera();
+  std::vector<RecordingDrawable*> drawn;
+  auto addDrawable = [&](int state) {
+    return new RecordingDrawable(sceneGraph.getRootNode().createChild(),
+                                 shaders[state], meshes[state],
+                                 textures[state], drawables, drawn);
+  };
+
+  RecordingDrawable* first = addDrawable(0);
+  addDrawable(1);
+  gfx::RenderQueue queue;
+  queue.draw(camera, drawables);
+  ASSERT_EQ(drawn.size(), 2u);
+  EXPECT_EQ(drawn.front(), first);
+
+  // an added drawable is drawn from the next frame on
+  const uint64_t generation = drawables.getGeneration();
+  RecordingDrawable* added = addDrawable(0);
+  EXPECT_NE(drawables.getGeneration(), generation);
+  drawn.clear();
+  queue.draw(camera, drawables);
+  ASSERT_EQ(drawn.size(), 3u);
+  EXPECT_TRUE(isSortedByState(drawn));
+  EXPECT_NE(std::find(drawn.begin(), drawn.end(), added), drawn.end());
+
+  // a removed drawable is not, even if a drawable with other state takes its
+  // place in memory
+  delete first;
+  RecordingDrawable* replacement = addDrawable(1);
+  drawn.clear();
+  queue.draw(camera, drawables);
+  ASSERT_EQ(drawn.size(), 3u);
+  EXPECT_TRUE(isSortedByState(drawn));
+  EXPECT_EQ(drawn.front(), added);
+  EXPECT_NE(std::find(drawn.begin(), drawn.end(), replacement), drawn.end());
+
+  // and an unchanged group draws the same
+  const std::vector<RecordingDrawable*> previous = drawn;
+  drawn.clear();
+  queue.draw(camera, drawables);
+  EXPECT_EQ(drawn, previous);
+}
+
+TEST(GfxTest, InstancedDrawables) {
+  gfx::WindowlessContext context;
+  gfx::Renderer renderer{kSize, kSize};
+  Magnum::Shaders::Flat3D shader{Magnum::Shaders::Flat3D::Flag::ObjectId};
+
+  Magnum::GL::Buffer vertices;
+  vertices.setData(std::vector<Magnum::Vector3>{{-0.4f, -0.4f, 0.0f},
+                                                {0.4f, -0.4f, 0.0f},
+                                                {0.4f, 0.4f, 0.0f},
+                                                {-0.4f, -0.4f, 0.0f},
+                                                {0.4f, 0.4f, 0.0f},
+                                                {-0.4f, 0.4f, 0.0f}});
+
+  // all quads share one mesh and are drawn with one instanced draw call
+  std::vector<Magnum::GL::Mesh> sharedMesh;
+  sharedMesh.push_back(createQuad(vertices));
+  const Frame instanced = drawQuads(renderer, shader, sharedMesh);
+  EXPECT_EQ(instanced.stats.drawCalls, 1u);
+  EXPECT_EQ(instanced.stats.instancedDrawCalls, 1u);
+
+  // with a mesh each they are drawn one by one
+  std::vector<Magnum::GL::Mesh> ownMeshes;
+  for (int i = 0; i < kGrid * kGrid; ++i) {
+    ownMeshes.push_back(createQuad(vertices));
+  }
+  const Frame individual = drawQuads(renderer, shader, ownMeshes);
+  EXPECT_EQ(individual.stats.drawCalls, kGrid * kGrid * 1u);
+  EXPECT_EQ(individual.stats.instancedDrawCalls, 0u);
+
+  // every quad is visible, and both give the same image
+  const std::set<uint32_t> ids{individual.objectIds.begin(),
+                               individual.objectIds.end()};
+  EXPECT_EQ(ids.size(), kGrid * kGrid + 1u);
+  EXPECT_EQ(instanced.objectIds, individual.objectIds);
+  EXPECT_EQ(instanced.rgba, individual.rgba);
+}
+
+TEST(GfxTest, InstanceMeshChunks) {
+  gfx::WindowlessContext context;
+  gfx::Renderer renderer{kSize, kSize};
+  gfx::PrimitiveIDTexturedShader shader;
+
+  // an n x n quad grid filling the view, too many vertices for 16 bit
+  // indices, whose rows of quads are in kGrid bands of object ids
+  const int n = 256;
+  std::vector<vec3f> positions;
+  std::vector<vec3uc> colors;
+  for (int y = 0; y <= n; ++y) {
+    for (int x = 0; x <= n; ++x) {
+      positions.emplace_back(2.0f * x / n - 1, 2.0f * y / n - 1, 0);
+      colors.emplace_back(x, y, 0);
+    }
+  }
+  std::vector<uint32_t> indices;
+  std::vector<float> objectIds;
+  for (uint32_t y = 0; y < n; ++y) {
+    for (uint32_t x = 0; x < n; ++x) {
+      const uint32_t i = y * (n + 1) + x;
+      indices.insert(indices.end(),
+                     {i, i + 1, i + n + 2, i, i + n + 2, i + n + 1});
+      objectIds.insert(objectIds.end(), 2, 1 + y * kGrid / n);
+    }
+  }
+  ASSERT_GT(positions.size(), geo::kMaxChunkVertices);
+  InstanceMesh mesh;
+  mesh.upload(positions, colors, indices, objectIds);
+  ASSERT_GT(mesh.getNumChunks(), 1);
+
+  // each chunk looks up the ids of its triangles from its own offset
+  scene::SceneGraph sceneGraph;
+  scene::SceneNode& node = sceneGraph.getRootNode().createChild();
+  node.setTranslation({0, 0, -1});
+  for (int i = 0; i < mesh.getNumChunks(); ++i) {
+    const assets::GenericInstanceMeshData::RenderingBuffer& renderingBuffer =
+        *mesh.getRenderingBuffer();
+    auto* drawable = new gfx::PrimitiveIDTexturedDrawable{
+        node, shader, *mesh.getMagnumGLMesh(i), &sceneGraph.getDrawables(),
+        mesh.getSemanticTexture()};
+    drawable->setPositionDecode(renderingBuffer.positionDecode);
+    drawable->setPrimitiveIdOffset(renderingBuffer.chunks[i].primitiveIdOffset);
+  }
+  gfx::RenderCamera& camera = sceneGraph.getDefaultRenderCamera();
+  camera.setProjectionMatrix(kSize, kSize, 0.1f, 100.0f, 90.0f);
+  renderer.draw(camera, sceneGraph);
+  std::vector<uint32_t> ids(kSize * kSize);
+  renderer.readFrameObjectId(ids.data());
+
+  // the grid is seen from 1 unit away with a 90 degree field of view, so it
+  // covers the frame exactly, kSize / kGrid rows of pixels per band
+  for (int row = 0; row < kSize; ++row) {
+    for (int column = 0; column < kSize; ++column) {
+      ASSERT_EQ(ids[row * kSize + column], 1 + row * kGrid / kSize)
+          << "at row " << row << ", column " << column;
+    }
+  }
+}
+
+TEST(GfxTest, TextureCacheRoundTrip) {
+  gfx::WindowlessContext context;
+  const std::string directory = Cr::Utility::Directory::join(
+      Cr::Utility::Directory::tmp(), "GfxTest-texture-cache");
+  TextureCache cache{directory};
+
+  // a gradient, compressed on upload like ResourceManager does
+  std::vector<Magnum::Color4ub> pixels(64 * 64);
+  for (size_t i = 0; i < pixels.size(); ++i) {
+    pixels[i] = {uint8_t(i % 64 * 4), uint8_t(i / 64 * 4), 128, 255};
+  }
+  const Magnum::ImageView2D image{Magnum::PixelFormat::RGBA8Unorm,
+                                  {64, 64},
+                                  Cr::Containers::arrayView(pixels)};
+  const auto format = Magnum::GL::TextureFormat::CompressedRGBAS3tcDxt1;
+  const int numLevels = 7;
+  Magnum::GL::Texture2D texture;
+  texture.setStorage(numLevels, format, image.size())
+      .setSubImage(0, {}, image)
+      .generateMipmap();
+  const uint64_t key = 0x2a;
+  ASSERT_TRUE(cache.store(key, format, texture));
+
+  // other keys miss, the stored one gives back the same blocks
+  Magnum::GL::Texture2D loaded;
+  Magnum::Vector2i size;
+  EXPECT_FALSE(cache.load(key + 1, loaded, size));
+  ASSERT_TRUE(cache.load(key, loaded, size));
+  EXPECT_EQ(size, image.size());
+  for (int level = 0; level < numLevels; ++level) {
+    const Magnum::CompressedImage2D expected =
+        texture.compressedImage(level, {});
+    const Magnum::CompressedImage2D actual = loaded.compressedImage(level, {});
+    EXPECT_EQ(actual.size(), expected.size());
+    ASSERT_EQ(actual.data().size(), expected.data().size());
+    EXPECT_EQ(std::memcmp(actual.data().data(), expected.data().data(),
+                          expected.data().size()),
+              0);
+  }
+
+  // a truncated entry is ignored
+  const std::string file =
+      Cr::Utility::Directory::join(directory, "000000000000002a.tex");
+  const std::string contents = Cr::Utility::Directory::readString(file);
+  ASSERT_FALSE(contents.empty());
+  writeFile(file, contents.substr(0, contents.size() / 2));
+  Magnum::GL::Texture2D truncated;
+  EXPECT_FALSE(cache.load(key, truncated, size));
+
+  Cr::Utility::Directory::rm(file);
+  Cr::Utility::Directory::rm(directory);
+}
+
+TEST(GfxTest, TextureCacheKey) {
+  const std::string directory = Cr::Utility::Directory::join(
+      Cr::Utility::Directory::tmp(), "GfxTest-texture-keys");
+  ASSERT_TRUE(Cr::Utility::Directory::mkpath(directory));
+  auto path = [&](const std::string& name) {
+    return Cr::Utility::Directory::join(directory, name);
+  };
+
+  // an image file of its own, one in a data URI and one in a buffer
+  const std::string gltf = R"({
+    "images": [
+      {"uri": "texture%20file.png"},
+      {"uri": "data:image/png;base64,AAAA"},
+      {"bufferView": 0}
+    ],
+    "bufferViews": [{"buffer": 0, "byteOffset": 16, "byteLength": 32}],
+    "buffers": [{"uri": "scene.bin", "byteLength": 64}]
+  })";
+  writeFile(path("scene.gltf"), gltf);
+  writeFile(path("copy.gltf"), gltf);
+  writeFile(path("texture file.png"), "first image");
+  writeFile(path("scene.bin"), std::string(64, 'b'));
+
+  uint64_t image = 0, embedded = 0, buffered = 0, key = 0;
+  ASSERT_TRUE(TextureCache::key(path("scene.gltf"), 0, image));
+  ASSERT_TRUE(TextureCache::key(path("scene.gltf"), 1, embedded));
+  ASSERT_TRUE(TextureCache::key(path("scene.gltf"), 2, buffered));
+  EXPECT_NE(image, embedded);
+  EXPECT_NE(image, buffered);
+  EXPECT_NE(embedded, buffered);
+
+  // an image file has the same key in every asset using it
+  ASSERT_TRUE(TextureCache::key(path("copy.gltf"), 0, key));
+  EXPECT_EQ(key, image);
+
+  // and a new one as soon as its contents change, even if its size and
+  // modification time do not
+  writeFile(path("texture file.png"), "other image");
+  ASSERT_TRUE(TextureCache::key(path("scene.gltf"), 0, key));
+  EXPECT_NE(key, image);
+  writeFile(path("texture file.png"), "first image");
+  ASSERT_TRUE(TextureCache::key(path("scene.gltf"), 0, key));
+  EXPECT_EQ(key, image);
+
+  // images in the asset change with it, images in a buffer with the buffer
+  writeFile(path("scene.gltf"), gltf + "\n");
+  ASSERT_TRUE(TextureCache::key(path("scene.gltf"), 1, key));
+  EXPECT_NE(key, embedded);
+  ASSERT_TRUE(TextureCache::key(path("scene.gltf"), 0, key));
+  EXPECT_EQ(key, image);
+  writeFile(path("scene.bin"), std::string(64, 'c'));
+  ASSERT_TRUE(TextureCache::key(path("scene.gltf"), 2, key));
+  EXPECT_NE(key, buffered);
+
+  // files are hashed once per FileHashes
+  TextureCache::FileHashes fileHashes;
+  ASSERT_TRUE(TextureCache::key(path("scene.gltf"), 0, key, &fileHashes));
+  EXPECT_EQ(fileHashes.size(), 1u);
+  EXPECT_EQ(key, image);
+
+  // there is no key without the file
+  EXPECT_FALSE(TextureCache::key(path("missing.glb"), 0, key));
+
+  for (const char* name :
+       {"scene.gltf", "copy.gltf", "texture file.png", "scene.bin"}) {
+    Cr::Utility::Directory::rm(path(name));
+  }
+  Cr::Utility::Directory::rm(directory);
+}
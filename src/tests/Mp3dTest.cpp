@@ -5,6 +5,11 @@
 #include <Corrade/Utility/Directory.h>
 #include <gtest/gtest.h>
 
+#include <fstream>
+#include <string>
+#include <vector>
+
+#include "esp/assets/Mp3dInstanceMeshData.h"
 #include "esp/scene/SemanticScene.h"
 
 #include "configure.h"
@@ -15,6 +20,82 @@ using namespace esp;
 using namespace esp::geo;
 using namespace esp::scene;
 
+namespace {
+
+// exposes what Mp3dInstanceMeshData parses
+class Mp3dMesh : public esp::assets::Mp3dInstanceMeshData {
+ public:
+  const std::vector<vec3f>& positions() const { return cpu_vbo_; }
+  const std::vector<vec3uc>& colors() const { return cpu_cbo_; }
+  const std::vector<vec3ui>& indices() const { return cpu_ibo_; }
+  const std::vector<int>& materialIds() const { return materialIds_; }
+  const std::vector<int>& segmentIds() const { return segmentIds_; }
+  const std::vector<int>& categoryIds() const { return categoryIds_; }
+};
+
+// Write a binary PLY in the layout of MP3D house segmentations, with values
+// derived from the vertex and face indices
+std::string writeMp3dPLY(const std::string& name,
+                         uint32_t numVertices,
+                         uint32_t numFaces) {
+  const std::string filename =
+      Cr::Utility::Directory::join(Cr::Utility::Directory::tmp(), name);
+  std::ofstream file(filename, std::ios::binary);
+  file << "ply\nformat binary_little_endian 1.0\n"
+       << "element vertex " << numVertices << "\n"
+       << "property float x\nproperty float y\nproperty float z\n"
+       << "property float nx\nproperty float ny\nproperty float nz\n"
+       << "property float tex_u\nproperty float tex_v\n"
+       << "property uchar red\nproperty uchar green\nproperty uchar blue\n"
+       << "element face " << numFaces << "\n"
+       << "property list uchar int vertex_indices\n"
+       << "property int material_id\nproperty int segment_id\n"
+       << "property int category_id\nend_header\n";
+  for (uint32_t i = 0; i < numVertices; ++i) {
+    const float floats[] = {float(i), i + 0.5f, -float(i), 0, 0, 1, 0, 0};
+    const uint8_t rgb[] = {uint8_t(i), uint8_t(i >> 8), 7};
+    file.write(reinterpret_cast<const char*>(floats), sizeof(floats));
+    file.write(reinterpret_cast<const char*>(rgb), sizeof(rgb));
+  }
+  for (uint32_t i = 0; i < numFaces; ++i) {
+    const uint8_t numIndices = 3;
+    const uint32_t indices[] = {i % numVertices, (i + 1) % numVertices,
+                                (i + 2) % numVertices};
+    const int32_t ids[] = {int32_t(i % 97) - 1, int32_t(i % 1013),
+                           int32_t(i % 41)};
+    file.write(reinterpret_cast<const char*>(&numIndices), 1);
+    file.write(reinterpret_cast<const char*>(indices), sizeof(indices));
+    file.write(reinterpret_cast<const char*>(ids), sizeof(ids));
+  }
+  return filename;
+}
+
+// Write an MP3D house with objects alternating between two categories and
+// segment segmentIds[i] belonging to object i % numObjects
+std::string writeMp3dHouse(const std::string& name,
+                           const std::vector<int>& segmentIds,
+                           int numObjects) {
+  const std::string filename =
+      Cr::Utility::Directory::join(Cr::Utility::Directory::tmp(), name);
+  std::ofstream file(filename);
+  file << "ASCII 1.1\n"
+       << "H test - 0 0 0 0 " << segmentIds.size() << " " << numObjects
+       << " 2 0 0 0  0 0 0 0 0  -1 -1 -1 1 1 1  0 0 0 0 0\n"
+       << "C 0 1 chair 3 chair 0 0 0 0 0\n"
+       << "C 1 2 table 5 table 0 0 0 0 0\n";
+  for (int i = 0; i < numObjects; ++i) {
+    file << "O " << i << " -1 " << i % 2
+         << " 0 0 0  1 0 0  0 1 0  1 1 1  0 0 0 0 0 0 0 0\n";
+  }
+  for (size_t i = 0; i < segmentIds.size(); ++i) {
+    file << "E " << i << " " << i % numObjects << " " << segmentIds[i]
+         << " 1 0 0 0 -1 -1 -1 1 1 1 0 0 0 0 0\n";
+  }
+  return filename;
+}
+
+}  // namespace
+
 TEST(Mp3dTest, Load) {
   const std::string filename = Cr::Utility::Directory::join(
       SCENE_DATASETS, "mp3d/1LXtFkjw3qL/1LXtFkjw3qL.house");
@@ -48,3 +129,121 @@ TEST(Mp3dTest, Load) {
     }
   }
 }
+
+TEST(Mp3dTest, Remap) {
+  const std::string filename = Cr::Utility::Directory::join(
+      SCENE_DATASETS, "mp3d/1LXtFkjw3qL/1LXtFkjw3qL.house");
+  if (!Cr::Utility::Directory::exists(filename))
+    GTEST_SKIP_("MP3D dataset not found.");
+
+  SemanticScene house;
+  SemanticScene::loadMp3dHouse(filename, house);
+
+  std::vector<uint32_t> ids;
+  for (const auto& entry : house.getSemanticIndexMap()) {
+    ids.push_back(entry.first);
+  }
+  // unmapped ids
+  ids.push_back(ID_UNDEFINED);
+  ids.push_back(1 << 30);
+  // enough ids to be remapped by multiple threads
+  while (ids.size() < (1 << 17)) {
+    ids.insert(ids.end(), ids.begin(), ids.end());
+  }
+
+  std::vector<uint32_t> objects(ids.size());
+  house.remap(ids.data(), objects.data(), ids.size(),
+              SemanticRemap::SEGMENT_TO_OBJECT);
+  std::vector<uint32_t> categories(ids.size());
+  house.remap(ids.data(), categories.data(), ids.size(),
+              SemanticRemap::SEGMENT_TO_CATEGORY);
+  std::vector<uint32_t> objectCategories = objects;
+  house.remap(objectCategories.data(), objectCategories.data(),
+              objectCategories.size(), SemanticRemap::OBJECT_TO_CATEGORY);
+
+  for (size_t i = 0; i < ids.size(); ++i) {
+    const int objectIndex = house.semanticIndexToObjectIndex(ids[i]);
+    EXPECT_EQ(objects[i], uint32_t(objectIndex));
+    int categoryIndex = ID_UNDEFINED;
+    if (objectIndex != ID_UNDEFINED) {
+      categoryIndex = house.objects()[objectIndex]->category()->index();
+    }
+    EXPECT_EQ(categories[i], uint32_t(categoryIndex));
+    EXPECT_EQ(objectCategories[i], uint32_t(categoryIndex));
+  }
+}
+
+TEST(Mp3dTest, RemapSparseSegments) {
+  // MP3D segment ids are regionIndex * 1000000 + k, which the paged lookup
+  // tables hold. Ids spread over too many pages fall back to the hash map.
+  std::vector<int> regionSegmentIds;
+  for (int region = 0; region < 30; ++region) {
+    for (int k = 0; k < 50; ++k) {
+      regionSegmentIds.push_back(region * 1000000 + k);
+    }
+  }
+  std::vector<int> scatteredSegmentIds;
+  for (int i = 0; i < 5000; ++i) {
+    scatteredSegmentIds.push_back(i * 100003);
+  }
+
+  const int numObjects = 7;
+  for (const auto& segmentIds : {regionSegmentIds, scatteredSegmentIds}) {
+    SemanticScene house;
+    ASSERT_TRUE(SemanticScene::loadMp3dHouse(
+        writeMp3dHouse("Mp3dTestRemap.house", segmentIds, numObjects), house));
+
+    std::vector<uint32_t> ids(segmentIds.begin(), segmentIds.end());
+    // unmapped ids, next to mapped ones and past all of them
+    ids.push_back(ID_UNDEFINED);
+    ids.push_back(segmentIds.back() + 1);
+    ids.push_back(1 << 30);
+    std::vector<uint32_t> objects(ids.size());
+    house.remap(ids.data(), objects.data(), ids.size(),
+                SemanticRemap::SEGMENT_TO_OBJECT);
+    std::vector<uint32_t> categories(ids.size());
+    house.remap(ids.data(), categories.data(), ids.size(),
+                SemanticRemap::SEGMENT_TO_CATEGORY);
+
+    for (size_t i = 0; i < ids.size(); ++i) {
+      const bool mapped = i < segmentIds.size();
+      const int objectIndex = mapped ? int(i % numObjects) : ID_UNDEFINED;
+      EXPECT_EQ(house.semanticIndexToObjectIndex(ids[i]), objectIndex);
+      EXPECT_EQ(objects[i], uint32_t(objectIndex));
+      const int categoryIndex =
+          mapped ? house.objects()[objectIndex]->category()->index()
+                 : ID_UNDEFINED;
+      EXPECT_EQ(categories[i], uint32_t(categoryIndex));
+    }
+  }
+}
+
+TEST(Mp3dTest, LoadPLY) {
+  // still split over the OpenMP threads (see benchmarks/Mp3dPLYBenchmark for
+  // timings of a full size house)
+  const uint32_t numVertices = 5000;
+  const uint32_t numFaces = 2 * numVertices;
+  const std::string filename =
+      writeMp3dPLY("Mp3dTest-house.ply", numVertices, numFaces);
+
+  Mp3dMesh mesh;
+  ASSERT_TRUE(mesh.loadMp3dPLY(filename));
+
+  ASSERT_EQ(mesh.positions().size(), numVertices);
+  ASSERT_EQ(mesh.colors().size(), numVertices);
+  for (uint32_t i = 0; i < numVertices; ++i) {
+    ASSERT_EQ(mesh.positions()[i], vec3f(i, i + 0.5f, -float(i)));
+    ASSERT_EQ(mesh.colors()[i], vec3uc(uint8_t(i), uint8_t(i >> 8), 7));
+  }
+  ASSERT_EQ(mesh.indices().size(), numFaces);
+  ASSERT_EQ(mesh.categoryIds().size(), numFaces);
+  for (uint32_t i = 0; i < numFaces; ++i) {
+    ASSERT_EQ(mesh.indices()[i],
+              vec3ui(i % numVertices, (i + 1) % numVertices,
+                     (i + 2) % numVertices));
+    ASSERT_EQ(mesh.materialIds()[i], int(i % 97) - 1);
+    ASSERT_EQ(mesh.segmentIds()[i], int(i % 1013));
+    ASSERT_EQ(mesh.categoryIds()[i], int(i % 41));
+  }
+  Cr::Utility::Directory::rm(filename);
+}
@@ -0,0 +1,157 @@
+// Copyright (c) Facebook, Inc. and its affiliates.
+// This source code is licensed under the MIT license found in the
+// LICENSE file in the root directory of this source tree.
+
+#include <gtest/gtest.h>
+
+#include <fstream>
+#include <string>
+#include <vector>
+
+#include <Corrade/Utility/Directory.h>
+
+#include "esp/assets/CollisionHulls.h"
+#include "esp/assets/ResourceManager.h"
+#include "esp/gfx/WindowlessContext.h"
+#include "esp/scene/SceneGraph.h"
+
+#ifdef PHYSICS_WITH_BULLET
+#include "esp/physics/bullet/BulletPhysicsManager.h"
+#endif
+
+namespace Cr = Corrade;
+
+using namespace esp;
+
+namespace {
+
+std::string writeTmpFile(const std::string& name,
+                         const std::string& contents) {
+  const std::string filename =
+      Cr::Utility::Directory::join(Cr::Utility::Directory::tmp(), name);
+  std::ofstream file(filename, std::ios::binary | std::ios::trunc);
+  file << contents;
+  return filename;
+}
+
+#ifdef PHYSICS_WITH_BULLET
+// Exposes the collision shapes of the objects
+class ShapesPhysicsManager : public physics::BulletPhysicsManager {
+ public:
+  explicit ShapesPhysicsManager(assets::ResourceManager* resourceManager)
+      : physics::BulletPhysicsManager(resourceManager) {}
+
+  const btCollisionShape* getCollisionShape(int physObjectID) {
+    return static_cast<physics::BulletRigidObject*>(
+               existingObjects_.at(physObjectID))
+        ->getCollisionShape();
+  }
+};
+#endif
+
+}  // namespace
+
+TEST(PhysicsTest, collisionHulls) {
+  EXPECT_EQ(assets::collisionHullsFilename(
+                "data/objects/cheezit.phys_properties.json"),
+            "data/objects/cheezit.collision_hulls");
+
+  const std::string meshFile =
+      writeTmpFile("PhysicsTest-hulls.ply", "a collision mesh");
+  const std::string hullsFile = Cr::Utility::Directory::join(
+      Cr::Utility::Directory::tmp(), "PhysicsTest.collision_hulls");
+  std::vector<assets::CollisionHull> hulls(3);
+  for (uint32_t i = 0; i < hulls.size(); ++i) {
+    hulls[i].meshIndex = i / 2;
+    for (uint32_t j = 0; j < 4 + i; ++j) {
+      hulls[i].points.emplace_back(i, j, i * j);
+    }
+  }
+  ASSERT_TRUE(assets::saveCollisionHulls(hullsFile, meshFile, hulls));
+
+  std::vector<assets::CollisionHull> loaded;
+  ASSERT_TRUE(assets::loadCollisionHulls(hullsFile, meshFile, loaded));
+  ASSERT_EQ(loaded.size(), hulls.size());
+  for (size_t i = 0; i < hulls.size(); ++i) {
+    EXPECT_EQ(loaded[i].meshIndex, hulls[i].meshIndex);
+    EXPECT_EQ(loaded[i].points, hulls[i].points);
+  }
+
+  // hulls of the mesh as it was before it changed are outdated
+  writeTmpFile("PhysicsTest-hulls.ply", "a larger collision mesh");
+  EXPECT_FALSE(assets::loadCollisionHulls(hullsFile, meshFile, loaded));
+
+  Cr::Utility::Directory::rm(hullsFile);
+  Cr::Utility::Directory::rm(meshFile);
+}
+
+#ifdef PHYSICS_WITH_BULLET
+TEST(PhysicsTest, sharedObjectShape) {
+  gfx::WindowlessContext context;
+  assets::ResourceManager resourceManager;
+
+  // a tetrahedron object
+  const std::string meshFile = writeTmpFile("PhysicsTest.gltf", R"({
+    "asset": {"version": "2.0"},
+    "buffers": [{"byteLength": 72, "uri":
+      "data:application/octet-stream;base64,AAAAAAAAAAAAAAAAAACAPwAAAAAAAAAAAAAAAAAAgD8AAAAAAAAAAAAAAAAAAIA/AAACAAEAAAABAAMAAAADAAIAAQACAAMA"}],
+    "bufferViews": [{"buffer": 0, "byteLength": 48},
+                    {"buffer": 0, "byteOffset": 48, "byteLength": 24}],
+    "accessors": [{"bufferView": 0, "componentType": 5126, "count": 4,
+                   "type": "VEC3", "min": [0, 0, 0], "max": [1, 1, 1]},
+                  {"bufferView": 1, "componentType": 5123, "count": 12,
+                   "type": "SCALAR"}],
+    "meshes": [{"primitives": [{"attributes": {"POSITION": 0},
+                                "indices": 1}]}],
+    "nodes": [{"mesh": 0}],
+    "scenes": [{"nodes": [0]}],
+    "scene": 0
+  })");
+  const std::string configFile =
+      writeTmpFile("PhysicsTest.phys_properties.json",
+                   R"({"render mesh": "PhysicsTest.gltf", "mass": 2.0})");
+  ASSERT_NE(resourceManager.loadObject(configFile), ID_UNDEFINED);
+
+  scene::SceneGraph sceneGraph;
+  ShapesPhysicsManager physicsManager(&resourceManager);
+  assets::PhysicsManagerAttributes physicsManagerAttributes;
+  physicsManagerAttributes.setMagnumVec3("gravity", {0, -9.8f, 0});
+  ASSERT_TRUE(physicsManager.initPhysics(&sceneGraph.getRootNode(),
+                                         physicsManagerAttributes));
+
+  // instances of a config share its shape
+  std::vector<int> objectIDs;
+  for (int i = 0; i < 3; ++i) {
+    objectIDs.push_back(physicsManager.addObject(configFile, nullptr));
+    ASSERT_GE(objectIDs.back(), 0);
+  }
+  const btCollisionShape* shared =
+      physicsManager.getCollisionShape(objectIDs[0]);
+  ASSERT_NE(shared, nullptr);
+  for (const int objectID : objectIDs) {
+    EXPECT_EQ(physicsManager.getCollisionShape(objectID), shared);
+  }
+
+  // changing the margin of one copies the shape first, the others keep
+  // theirs
+  const double margin = physicsManager.getMargin(objectIDs[0]);
+  physicsManager.setMargin(objectIDs[1], 2 * margin);
+  const btCollisionShape* copied =
+      physicsManager.getCollisionShape(objectIDs[1]);
+  ASSERT_NE(copied, shared);
+  EXPECT_EQ(static_cast<const btCompoundShape*>(copied)->getNumChildShapes(),
+            static_cast<const btCompoundShape*>(shared)->getNumChildShapes());
+  EXPECT_DOUBLE_EQ(physicsManager.getMargin(objectIDs[1]), 2 * margin);
+  for (const int objectID : {objectIDs[0], objectIDs[2]}) {
+    EXPECT_EQ(physicsManager.getCollisionShape(objectID), shared);
+    EXPECT_DOUBLE_EQ(physicsManager.getMargin(objectID), margin);
+  }
+
+  // and new instances still share the shape of the config
+  const int added = physicsManager.addObject(configFile, nullptr);
+  EXPECT_EQ(physicsManager.getCollisionShape(added), shared);
+
+  Cr::Utility::Directory::rm(configFile);
+  Cr::Utility::Directory::rm(meshFile);
+}
+#endif
@@ -0,0 +1,413 @@
+// Copyright (c) Facebook, Inc. and its affiliates.
+// This source code is licensed under the MIT license found in the
+// LICENSE file in the root directory of this source tree.
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <map>
+#include <string>
+#include <vector>
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+#include "esp/core/esp.h"
+#include "esp/gfx/RaycastMesh.h"
+#include "esp/scene/SceneGraph.h"
+#include "esp/sensor/Downsample.h"
+#include "esp/sensor/MultiviewCamera.h"
+#include "esp/sensor/NoiseModel.h"
+#include "esp/sensor/PanoramicCamera.h"
+#include "esp/sensor/PinholeCamera.h"
+#include "esp/sensor/RaycastCamera.h"
+
+using namespace esp;
+using namespace esp::sensor;
+
+namespace {
+
+SensorSpec::ptr makeSpec(SensorType type, int width, int height) {
+  auto spec = SensorSpec::create();
+  spec->uuid = "test_sensor";
+  spec->sensorType = type;
+  spec->resolution = vec2i(height, width);
+  spec->position = vec3f(0, 0, 0);
+  spec->parameters["near"] = "0.01";
+  spec->parameters["far"] = "100";
+  return spec;
+}
+
+SensorSpec::ptr makeNoiseSpec(SensorType type,
+                              const std::string& model,
+                              const std::string& seed) {
+  auto spec = makeSpec(type, 64, 64);
+  spec->parameters["noise_model"] = model;
+  spec->parameters["noise_seed"] = seed;
+  return spec;
+}
+
+// noise of one frame applied to a copy of data
+template <class T>
+std::vector<T> applyNoise(NoiseModel& model,
+                          std::vector<T> data,
+                          const std::vector<size_t>& shape,
+                          core::DataType dataType) {
+  core::Buffer buffer{shape, dataType, data.data()};
+  model.apply(buffer);
+  return data;
+}
+
+// mean and standard deviation of a - b
+template <class T>
+std::pair<double, double> differenceStats(const std::vector<T>& a,
+                                          const std::vector<T>& b) {
+  double sum = 0, sumSquares = 0;
+  for (size_t i = 0; i < a.size(); ++i) {
+    const double d = double(a[i]) - double(b[i]);
+    sum += d;
+    sumSquares += d * d;
+  }
+  const double mean = sum / a.size();
+  return {mean, std::sqrt(sumSquares / a.size() - mean * mean)};
+}
+
+// correlation of the noise a - clean and b - clean
+double noiseCorrelation(const std::vector<float>& a,
+                        const std::vector<float>& b,
+                        const std::vector<float>& clean) {
+  double ab = 0, aa = 0, bb = 0;
+  for (size_t i = 0; i < clean.size(); ++i) {
+    const double na = a[i] - clean[i];
+    const double nb = b[i] - clean[i];
+    ab += na * nb;
+    aa += na * na;
+    bb += nb * nb;
+  }
+  return ab / std::sqrt(aa * bb);
+}
+
+}  // namespace
+
+TEST(SensorTest, RaycastCameraSeesMovedObject) {
+  // a square facing the camera, which looks down -z from the origin, large
+  // enough to fill its 90 degree field of view
+  std::vector<Magnum::Vector3> positions = {
+      {-10, -10, 0}, {10, -10, 0}, {10, 10, 0}, {-10, 10, 0}};
+  std::vector<Magnum::UnsignedInt> indices = {0, 1, 2, 0, 2, 3};
+  assets::CollisionMeshData meshData;
+  meshData.primitive = Magnum::MeshPrimitive::Triangles;
+  meshData.positions = Corrade::Containers::arrayView(positions);
+  meshData.indices = Corrade::Containers::arrayView(indices);
+
+  scene::SceneGraph sceneGraph;
+  scene::SceneNode& root = sceneGraph.getRootNode();
+  scene::SceneNode& objectNode = root.createChild();
+  new gfx::RaycastMesh{objectNode, meshData};
+  objectNode.setTranslation(Magnum::Vector3{0, 0, -5});
+
+  scene::SceneNode& cameraNode = root.createChild();
+  auto camera =
+      RaycastCamera::create(cameraNode, makeSpec(SensorType::DEPTH, 8, 8));
+
+  std::vector<float> depth(8 * 8);
+  camera->raycast(sceneGraph, depth.data());
+  for (float d : depth) {
+    EXPECT_NEAR(d, 5.0f, 1e-4);
+  }
+
+  // moving the object between two casts moves its hits as well
+  objectNode.setTranslation(Magnum::Vector3{0, 0, -3});
+  camera->raycast(sceneGraph, depth.data());
+  for (float d : depth) {
+    EXPECT_NEAR(d, 3.0f, 1e-4);
+  }
+
+  // moved out of view, nothing is hit
+  objectNode.setTranslation(Magnum::Vector3{50, 0, -3});
+  camera->raycast(sceneGraph, depth.data());
+  for (float d : depth) {
+    EXPECT_EQ(d, 0.0f);
+  }
+}
+
+TEST(SensorTest, PinholeCameraEncodings) {
+  scene::SceneGraph sceneGraph;
+  auto observationSpace = [&](SensorType type, const std::string& encoding) {
+    auto spec = makeSpec(type, 32, 24);
+    spec->encoding = encoding;
+    auto camera =
+        PinholeCamera::create(sceneGraph.getRootNode().createChild(), spec);
+    ObservationSpace space;
+    camera->getObservationSpace(space);
+    return space;
+  };
+
+  ObservationSpace space = observationSpace(SensorType::COLOR, "rgba_uint8");
+  EXPECT_EQ(space.shape, (std::vector<size_t>{24, 32, 4}));
+  EXPECT_EQ(space.dataType, core::DataType::DT_UINT8);
+  space = observationSpace(SensorType::COLOR, "rgb_uint8");
+  EXPECT_EQ(space.shape, (std::vector<size_t>{24, 32, 3}));
+  EXPECT_EQ(space.dataType, core::DataType::DT_UINT8);
+  space = observationSpace(SensorType::DEPTH, "depth_float16");
+  EXPECT_EQ(space.dataType, core::DataType::DT_FLOAT16);
+  space = observationSpace(SensorType::DEPTH, "rgba_uint8");
+  EXPECT_EQ(space.dataType, core::DataType::DT_FLOAT);
+
+  // encodings of another sensor type are ignored
+  space = observationSpace(SensorType::DEPTH, "rgb_uint8");
+  EXPECT_EQ(space.dataType, core::DataType::DT_FLOAT);
+  space = observationSpace(SensorType::COLOR, "depth_float16");
+  EXPECT_EQ(space.shape, (std::vector<size_t>{24, 32, 4}));
+  EXPECT_EQ(space.dataType, core::DataType::DT_UINT8);
+}
+
+TEST(SensorTest, PanoramicCameraShape) {
+  scene::SceneGraph sceneGraph;
+  auto spec = makeSpec(SensorType::COLOR, 512, 256);
+  spec->sensorSubtype = "panoramic";
+  spec->parameters["hfov"] = "60";
+  // compact encodings are not supported and fall back to RGBA
+  spec->encoding = "rgb_uint8";
+  auto camera =
+      PanoramicCamera::create(sceneGraph.getRootNode().createChild(), spec);
+
+  ObservationSpace space;
+  ASSERT_TRUE(camera->getObservationSpace(space));
+  EXPECT_EQ(space.shape, (std::vector<size_t>{256, 512, 4}));
+  EXPECT_EQ(space.dataType, core::DataType::DT_UINT8);
+
+  // cube faces are rendered with a square 90 degree projection, whatever
+  // hfov and the panorama aspect ratio are
+  gfx::RenderCamera& renderCamera = sceneGraph.getDefaultRenderCamera();
+  camera->setProjectionMatrix(renderCamera);
+  const mat4f projection = renderCamera.getProjectionMatrix();
+  EXPECT_NEAR(projection(0, 0), 1.0f, 1e-5);
+  EXPECT_NEAR(projection(1, 1), 1.0f, 1e-5);
+}
+
+TEST(SensorTest, MultiviewCameraViews) {
+  scene::SceneGraph sceneGraph;
+  auto createCamera = [&](SensorType type,
+                          const std::map<std::string, std::string>& views) {
+    auto spec = makeSpec(type, 32, 24);
+    spec->sensorSubtype = "multiview";
+    spec->parameters.insert(views.begin(), views.end());
+    return MultiviewCamera::create(sceneGraph.getRootNode().createChild(),
+                                   spec);
+  };
+
+  // a stereo pair by default
+  auto camera = createCamera(SensorType::COLOR, {});
+  ObservationSpace space;
+  ASSERT_TRUE(camera->getObservationSpace(space));
+  EXPECT_EQ(camera->getNumViews(), 2);
+  EXPECT_EQ(space.shape, (std::vector<size_t>{2, 24, 32, 4}));
+  EXPECT_EQ(camera->getFrameBytes(), 2u * 24 * 32 * 4);
+
+  camera = createCamera(SensorType::COLOR, {{"stereo_baseline", "0.2"}});
+  EXPECT_EQ(camera->getNumViews(), 2);
+
+  // views stacked one after the other, a single channel for depth
+  camera = createCamera(SensorType::DEPTH,
+                        {{"view_offsets", "0,0,0;0.1,0,0;0,0.1,0;"}});
+  ASSERT_TRUE(camera->getObservationSpace(space));
+  EXPECT_EQ(camera->getNumViews(), 3);
+  EXPECT_EQ(space.shape.front(), 3u);
+  EXPECT_EQ(space.dataType, core::DataType::DT_FLOAT);
+  EXPECT_EQ(camera->getFrameBytes(), 3 * 24 * 32 * sizeof(float));
+
+  camera = createCamera(SensorType::SEMANTIC, {{"view_offsets", "0,0,0"}});
+  EXPECT_EQ(camera->getNumViews(), 1);
+  EXPECT_EQ(camera->getFrameBytes(), 24 * 32 * sizeof(uint32_t));
+}
+
+TEST(SensorTest, NoiseModelDeterministic) {
+  const std::vector<size_t> shape = {64, 64};
+  const std::vector<float> depth(64 * 64, 2.0f);
+  auto noisyDepth = [&](NoiseModel& model) {
+    return applyNoise(model, depth, shape, core::DataType::DT_FLOAT);
+  };
+  for (const std::string& name : {"gaussian", "redwood"}) {
+    auto first =
+        NoiseModel::fromSpec(*makeNoiseSpec(SensorType::DEPTH, name, "7"));
+    auto second =
+        NoiseModel::fromSpec(*makeNoiseSpec(SensorType::DEPTH, name, "7"));
+    ASSERT_NE(first, nullptr);
+    ASSERT_NE(second, nullptr);
+
+    // the same seed gives the same stream of frames
+    const std::vector<float> frame0 = noisyDepth(*first);
+    const std::vector<float> frame1 = noisyDepth(*first);
+    EXPECT_EQ(noisyDepth(*second), frame0);
+    EXPECT_EQ(noisyDepth(*second), frame1);
+    EXPECT_NE(frame0, frame1);
+
+    // reseeding restarts the stream
+    first->seed(7);
+    EXPECT_EQ(noisyDepth(*first), frame0);
+  }
+}
+
+TEST(SensorTest, NoiseModelStreamsIndependent) {
+  const std::vector<size_t> shape = {128, 128};
+  std::vector<float> depth(128 * 128);
+  for (size_t i = 0; i < depth.size(); ++i) {
+    depth[i] = 1.0f + 0.001f * (i % 1000);
+  }
+  auto noisyDepth = [&](NoiseModel& model) {
+    return applyNoise(model, depth, shape, core::DataType::DT_FLOAT);
+  };
+  auto model = NoiseModel::fromSpec(
+      *makeNoiseSpec(SensorType::DEPTH, "gaussian", "11"));
+  auto other = NoiseModel::fromSpec(
+      *makeNoiseSpec(SensorType::DEPTH, "gaussian", "12"));
+  const std::vector<float> frame0 = noisyDepth(*model);
+  const std::vector<float> frame1 = noisyDepth(*model);
+  const std::vector<float> otherFrame0 = noisyDepth(*other);
+
+  // successive frames and sensors with different seeds draw uncorrelated
+  // noise
+  EXPECT_LT(std::abs(noiseCorrelation(frame0, frame1, depth)), 0.05);
+  EXPECT_LT(std::abs(noiseCorrelation(frame0, otherFrame0, depth)), 0.05);
+
+#ifdef _OPENMP
+  // rows split over any number of threads see the same noise
+  const int numThreads = omp_get_max_threads();
+  omp_set_num_threads(1);
+  model->seed(11);
+  const std::vector<float> serialFrame0 = noisyDepth(*model);
+  omp_set_num_threads(std::max(numThreads, 4));
+  const std::vector<float> parallelFrame1 = noisyDepth(*model);
+  omp_set_num_threads(numThreads);
+  EXPECT_EQ(serialFrame0, frame0);
+  EXPECT_EQ(parallelFrame1, frame1);
+#endif
+}
+
+TEST(SensorTest, NoiseModelKeepsAlpha) {
+  const std::vector<size_t> shape = {64, 64, 4};
+  std::vector<uint8_t> rgba(64 * 64 * 4);
+  for (size_t i = 0; i < rgba.size(); ++i) {
+    rgba[i] = uint8_t(i * 7);
+  }
+  auto model = NoiseModel::fromSpec(
+      *makeNoiseSpec(SensorType::COLOR, "gaussian", "3"));
+  const auto noisy =
+      applyNoise(*model, rgba, shape, core::DataType::DT_UINT8);
+
+  size_t changed = 0;
+  for (size_t i = 0; i < rgba.size(); ++i) {
+    if (i % 4 == 3) {
+      EXPECT_EQ(noisy[i], rgba[i]);
+    } else {
+      changed += noisy[i] != rgba[i];
+    }
+  }
+  // sigma is 0.05 * 255, so nearly every color channel changes
+  EXPECT_GT(changed, rgba.size() / 2);
+}
+
+TEST(SensorTest, NoiseModelStatistics) {
+  // gaussian color noise, away from the clamped ends of the range
+  {
+    auto spec = makeNoiseSpec(SensorType::COLOR, "gaussian", "5");
+    spec->parameters["noise_sigma"] = "0.02";
+    auto model = NoiseModel::fromSpec(*spec);
+    const std::vector<uint8_t> rgb(256 * 256 * 3, 128);
+    const auto noisy =
+        applyNoise(*model, rgb, {256, 256, 3}, core::DataType::DT_UINT8);
+    const auto stats = differenceStats(noisy, rgb);
+    EXPECT_NEAR(stats.first, 0.0, 0.1);
+    EXPECT_NEAR(stats.second, 0.02 * 255, 0.02 * 255 * 0.05);
+  }
+
+  // gaussian depth noise, keeping empty pixels empty and depth positive
+  {
+    auto spec = makeNoiseSpec(SensorType::DEPTH, "gaussian", "5");
+    spec->parameters["noise_sigma"] = "0.01";
+    auto model = NoiseModel::fromSpec(*spec);
+    std::vector<float> depth(256 * 256, 2.0f);
+    for (size_t i = 0; i < depth.size(); i += 17) {
+      depth[i] = 0.0f;
+    }
+    const auto noisy =
+        applyNoise(*model, depth, {256, 256}, core::DataType::DT_FLOAT);
+    std::vector<float> valid, validNoisy;
+    for (size_t i = 0; i < depth.size(); ++i) {
+      if (depth[i] == 0.0f) {
+        EXPECT_EQ(noisy[i], 0.0f);
+      } else {
+        EXPECT_GT(noisy[i], 0.0f);
+        valid.push_back(depth[i]);
+        validNoisy.push_back(noisy[i]);
+      }
+    }
+    const auto stats = differenceStats(validNoisy, valid);
+    EXPECT_NEAR(stats.first, 0.0, 1e-3);
+    EXPECT_NEAR(stats.second, 0.01, 0.01 * 0.05);
+  }
+
+  // redwood noise stays within the range of the sensor model and close to
+  // the clean depth, and drops what the sensor cannot see
+  {
+    auto model = NoiseModel::fromSpec(
+        *makeNoiseSpec(SensorType::DEPTH, "redwood", "5"));
+    std::vector<float> depth(256 * 256, 2.0f);
+    std::fill(depth.begin(), depth.begin() + 8 * 256, 20.0f);
+    const auto noisy =
+        applyNoise(*model, depth, {256, 256}, core::DataType::DT_FLOAT);
+    for (size_t i = 0; i < 4 * 256; ++i) {
+      ASSERT_EQ(noisy[i], 0.0f);
+    }
+    double sum = 0;
+    for (size_t i = 12 * 256; i < depth.size(); ++i) {
+      ASSERT_GT(noisy[i], 0.0f);
+      ASSERT_LT(noisy[i], 10.0f);
+      sum += noisy[i];
+    }
+    EXPECT_NEAR(sum / (depth.size() - 12 * 256), 2.0, 0.02);
+  }
+}
+
+TEST(SensorTest, DownsampleAreaColor) {
+  // two 2x2 blocks of RGBA pixels, the left one with mixed values
+  const std::vector<uint8_t> src{
+      0, 10, 255, 255, 1, 20, 255, 255, 7, 7, 7, 7, 7, 7, 7, 7,
+      100, 30, 0, 255, 2, 40, 254, 255, 7, 7, 7, 7, 7, 7, 7, 7,
+  };
+  std::vector<uint8_t> dst(2 * 4);
+  downsampleArea(src.data(), 4, 2, 4, 2, dst.data());
+  // block averages rounded to nearest, (0 + 1 + 100 + 2) / 4 = 25.75
+  EXPECT_EQ(dst, (std::vector<uint8_t>{26, 25, 191, 255, 7, 7, 7, 7}));
+}
+
+TEST(SensorTest, DownsampleAreaDepth) {
+  const std::vector<float> src{
+      1.0f, 3.0f, 0.0f, 0.0f, 2.0f, 0.0f,
+      2.0f, 2.0f, 0.0f, 0.0f, 0.0f, 0.0f,
+  };
+  std::vector<float> dst(3, -1.0f);
+  downsampleArea(src.data(), 6, 2, 2, dst.data());
+  EXPECT_FLOAT_EQ(dst[0], 2.0f);
+  // holes without any depth stay holes and do not pull the average down
+  EXPECT_EQ(dst[1], 0.0f);
+  EXPECT_FLOAT_EQ(dst[2], 2.0f);
+}
+
+TEST(SensorTest, DownsampleNearestAndMode) {
+  const std::vector<uint32_t> src{
+      1, 2, 3, 4, 4, 5,
+      2, 9, 3, 6, 6, 5,
+      2, 1, 1, 7, 8, 9,
+  };
+  std::vector<uint32_t> dst(2);
+  downsampleNearest(src.data(), 6, 3, sizeof(uint32_t), 3, dst.data());
+  EXPECT_EQ(dst, (std::vector<uint32_t>{9, 6}));
+  // the most frequent id, the smallest one on ties
+  downsampleMode(src.data(), 6, 3, 3, dst.data());
+  EXPECT_EQ(dst, (std::vector<uint32_t>{1, 4}));
+}
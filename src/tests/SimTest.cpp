@@ -4,6 +4,7 @@
 
 #include <Corrade/Utility/Directory.h>
 #include <gtest/gtest.h>
+#include <future>
 #include <string>
 
 #include "esp/sim/SimulatorWithAgents.h"
@@ -12,6 +13,8 @@
 
 namespace Cr = Corrade;
 
+using esp::assets::AssetInfo;
+using esp::assets::ResourceManager;
 using esp::gfx::SimulatorConfiguration;
 using esp::nav::PathFinder;
 using esp::scene::SceneConfiguration;
@@ -53,3 +56,113 @@ TEST(SimTest, Reset) {
   simulator.reset();
   ASSERT_EQ(pathfinder, simulator.getPathFinder());
 }
+
+TEST(SimTest, ReconfigureWithAssetMemoryBudget) {
+  // a budget too small to keep the assets of any previous scene
+  SimulatorConfiguration cfg;
+  cfg.scene.id = vangogh;
+  cfg.assetMemoryBudget = 1;
+  SimulatorWithAgents simulator(cfg);
+  esp::scene::SceneGraph& vangoghSceneGraph = simulator.getActiveSceneGraph();
+  const size_t numDrawables = vangoghSceneGraph.getDrawables().size();
+  ASSERT_GT(numDrawables, 0);
+
+  // the drawables of the previous scene go with its assets
+  SimulatorConfiguration cfg2 = cfg;
+  cfg2.scene.id = skokloster;
+  simulator.reconfigure(cfg2);
+  EXPECT_EQ(vangoghSceneGraph.getDrawables().size(), 0);
+  EXPECT_GT(simulator.getActiveSceneGraph().getDrawables().size(), 0);
+
+  // and the scene is loaded again when coming back to it
+  simulator.reconfigure(cfg);
+  EXPECT_EQ(simulator.getActiveSceneGraph().getDrawables().size(),
+            numDrawables);
+}
+
+TEST(SimTest, PrefetchScene) {
+  SimulatorConfiguration cfg;
+  cfg.scene.id = vangogh;
+  SimulatorWithAgents simulator(cfg);
+
+  ResourceManager& resourceManager = simulator.getResourceManager();
+  const size_t numPrefetchedLoads = resourceManager.getNumPrefetchedLoads();
+
+  // the next scene loads in the background, reconfiguring to it uses that
+  SceneConfiguration sceneCfg;
+  sceneCfg.id = skokloster;
+  std::shared_future<bool> prefetched = simulator.prefetchScene(sceneCfg);
+  EXPECT_TRUE(prefetched.get());
+  SimulatorConfiguration cfg2 = cfg;
+  cfg2.scene = sceneCfg;
+  simulator.reconfigure(cfg2);
+  EXPECT_GT(simulator.getActiveSceneGraph().getDrawables().size(), 0);
+  EXPECT_EQ(resourceManager.getNumPrefetchedLoads(), numPrefetchedLoads + 1);
+
+  // loaded scenes are not prefetched again
+  sceneCfg.id = vangogh;
+  EXPECT_TRUE(simulator.prefetchScene(sceneCfg).get());
+
+  // a failed prefetch is not used, the scene is imported when loaded instead
+  sceneCfg.id = Cr::Utility::Directory::join(Cr::Utility::Directory::tmp(),
+                                             "SimTestMissing.glb");
+  EXPECT_FALSE(simulator.prefetchScene(sceneCfg).get());
+  esp::scene::SceneGraph& sceneGraph = simulator.getActiveSceneGraph();
+  EXPECT_FALSE(resourceManager.loadScene(AssetInfo::fromPath(sceneCfg.id),
+                                         &sceneGraph.getRootNode(),
+                                         &sceneGraph.getDrawables()));
+  EXPECT_EQ(resourceManager.getNumPrefetchedLoads(), numPrefetchedLoads + 1);
+}
+
+TEST(SimTest, LoadUndecodableTexture) {
+  SimulatorConfiguration cfg;
+  cfg.scene.id = vangogh;
+  SimulatorWithAgents simulator(cfg);
+  ResourceManager& resourceManager = simulator.getResourceManager();
+  esp::scene::SceneGraph& sceneGraph = simulator.getActiveSceneGraph();
+
+  // a triangle whose texture is not an image
+  const std::string tmp = Cr::Utility::Directory::tmp();
+  const std::string gltf = R"({
+    "asset": {"version": "2.0"},
+    "buffers": [{"byteLength": 36, "uri":
+      "data:application/octet-stream;base64,AAAAAAAAAAAAAAAAAACAPwAAAAAAAAAAAAAAAAAAgD8AAAAA"}],
+    "bufferViews": [{"buffer": 0, "byteLength": 36}],
+    "accessors": [{"bufferView": 0, "componentType": 5126, "count": 3,
+      "type": "VEC3", "min": [0, 0, 0], "max": [1, 1, 0]}],
+    "images": [{"uri": "SimTestBroken.png"}],
+    "textures": [{"source": 0}],
+    "materials": [{"pbrMetallicRoughness":
+      {"baseColorTexture": {"index": 0}}}],
+    "meshes": [{"primitives":
+      [{"attributes": {"POSITION": 0}, "material": 0}]}],
+    "nodes": [{"mesh": 0}],
+    "scenes": [{"nodes": [0]}],
+    "scene": 0
+  })";
+  ASSERT_TRUE(Cr::Utility::Directory::writeString(
+      Cr::Utility::Directory::join(tmp, "SimTestBroken.png"), "not a png"));
+  const std::string loaded =
+      Cr::Utility::Directory::join(tmp, "SimTestBroken.gltf");
+  const std::string prefetched =
+      Cr::Utility::Directory::join(tmp, "SimTestBrokenPrefetched.gltf");
+  ASSERT_TRUE(Cr::Utility::Directory::writeString(loaded, gltf));
+  ASSERT_TRUE(Cr::Utility::Directory::writeString(prefetched, gltf));
+
+  // the texture is skipped, whether the image is decoded when loading or
+  // beforehand by a prefetch
+  const size_t numDrawables = sceneGraph.getDrawables().size();
+  EXPECT_TRUE(resourceManager.loadScene(AssetInfo::fromPath(loaded),
+                                        &sceneGraph.getRootNode(),
+                                        &sceneGraph.getDrawables()));
+  EXPECT_EQ(sceneGraph.getDrawables().size(), numDrawables + 1);
+
+  const size_t numPrefetchedLoads = resourceManager.getNumPrefetchedLoads();
+  EXPECT_TRUE(
+      resourceManager.prefetch({AssetInfo::fromPath(prefetched)}).get());
+  EXPECT_TRUE(resourceManager.loadScene(AssetInfo::fromPath(prefetched),
+                                        &sceneGraph.getRootNode(),
+                                        &sceneGraph.getDrawables()));
+  EXPECT_EQ(resourceManager.getNumPrefetchedLoads(), numPrefetchedLoads + 1);
+  EXPECT_EQ(sceneGraph.getDrawables().size(), numDrawables + 2);
+}
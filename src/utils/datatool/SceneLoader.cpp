@@ -62,7 +62,7 @@ MeshData SceneLoader::load(const AssetInfo& info) {
     const auto& vbo = instanceMeshData.getVertexBufferObjectCPU();
     const auto& cbo = instanceMeshData.getColorBufferObjectCPU();
     const auto& ibo = instanceMeshData.getIndexBufferObjectCPU();
-    mesh.vbo = vbo;
+    mesh.vbo.assign(vbo.begin(), vbo.end());
     for (const auto& c : cbo) {
       mesh.cbo.emplace_back(c.cast<float>() / 255.0f);
     }
@@ -6,10 +6,19 @@
 #include <string>
 #include <unordered_map>
 
+#include <Corrade/PluginManager/Manager.h>
+#include <Corrade/Utility/String.h>
+#include <Magnum/Trade/AbstractImporter.h>
+
 #include "SceneLoader.h"
 
+#include "esp/assets/CollisionHulls.h"
 #include "esp/assets/Mp3dInstanceMeshData.h"
 #include "esp/core/esp.h"
+#ifdef ESP_BUILD_PTEX_SUPPORT
+#include "esp/assets/PTexMeshData.h"
+#endif
+#include "esp/io/json.h"
 #include "esp/nav/PathFinder.h"
 #include "esp/scene/SemanticScene.h"
 
@@ -64,6 +73,60 @@ int createMp3dSemanticMesh(const std::string& plyFile,
   return 0;
 }
 
+int createPTexCache(const std::string& meshFile, const std::string& cacheDir) {
+#ifdef ESP_BUILD_PTEX_SUPPORT
+  // the atlas parameters next to the mesh give the split size
+  const std::string atlasDir =
+      Corrade::Utility::String::stripSuffix(meshFile, "ptex_quad_mesh.ply") +
+      "ptex_textures";
+  PTexMeshData mesh;
+  mesh.load(meshFile, atlasDir);
+  const std::string cacheFile = PTexMeshData::cacheFilename(cacheDir, meshFile);
+  if (!mesh.saveCache(cacheFile, meshFile)) {
+    LOG(ERROR) << "Failed saving mesh cache " << cacheFile;
+    return 1;
+  }
+  return 0;
+#else
+  LOG(ERROR) << "PTex support not enabled. Enable the BUILD_PTEX_SUPPORT CMake "
+                "option when building.";
+  return 1;
+#endif
+}
+
+int createCollisionHulls(const std::string& objPhysConfigFile,
+                         const std::string& hullsFile) {
+  // decompose the mesh the object collides with, relative to its config
+  const esp::io::JsonDocument config =
+      esp::io::parseJsonFile(objPhysConfigFile);
+  const char* meshKey =
+      config.HasMember("collision mesh") ? "collision mesh" : "render mesh";
+  if (!config.HasMember(meshKey) || !config[meshKey].IsString()) {
+    LOG(ERROR) << "No mesh in object physics config " << objPhysConfigFile;
+    return 1;
+  }
+  const std::string meshFile =
+      objPhysConfigFile.substr(0, objPhysConfigFile.find_last_of("/")) + "/" +
+      config[meshKey].GetString();
+
+  Corrade::PluginManager::Manager<Magnum::Trade::AbstractImporter> manager;
+  std::unique_ptr<Magnum::Trade::AbstractImporter> importer =
+      manager.loadAndInstantiate("AnySceneImporter");
+  manager.setPreferredPlugins("GltfImporter", {"TinyGltfImporter"});
+  if (!importer || !importer->openFile(meshFile)) {
+    LOG(ERROR) << "Failed opening collision mesh " << meshFile;
+    return 1;
+  }
+  const std::vector<CollisionHull> hulls = computeCollisionHulls(*importer);
+  if (!saveCollisionHulls(hullsFile, meshFile, hulls)) {
+    LOG(ERROR) << "Failed saving collision hulls " << hullsFile;
+    return 1;
+  }
+  LOG(INFO) << "Decomposed " << meshFile << " into " << hulls.size()
+            << " convex hulls";
+  return 0;
+}
+
 int main(int argc, char** argv) {
   if (argc < 4) {
     std::cout << "Usage: datatool task input_file output_file" << std::endl;
@@ -80,6 +143,13 @@ int main(int argc, char** argv) {
       return 64;
     }
     createMp3dSemanticMesh(argv[2], argv[3], argv[4]);
+  } else if (task == "create_ptex_cache") {
+    // input_file is the PTex mesh, output_file the scene cache directory
+    createPTexCache(argv[2], argv[3]);
+  } else if (task == "create_collision_hulls") {
+    // input_file is the .phys_properties.json of an object, output_file
+    // normally its esp::assets::collisionHullsFilename()
+    createCollisionHulls(argv[2], argv[3]);
   } else {
     LOG(ERROR) << "Unrecognized task " << task;
     return 1;
@@ -0,0 +1,81 @@
+#!/usr/bin/env python3
+
+# Copyright (c) Facebook, Inc. and its affiliates.
+# This source code is licensed under the MIT license found in the
+# LICENSE file in the root directory of this source tree.
+
+import os
+import os.path as osp
+
+import numpy as np
+import pytest
+
+import habitat_sim.bindings as hsim
+
+
+def _make_ring(suffix, fields, num_slots=2):
+    name = f"habitat_test_ring_{suffix}_{os.getpid()}"
+    ring = hsim.ObservationRingBuffer.create(name, fields, num_slots)
+    assert ring is not None
+    return ring
+
+
+def test_ring_slot_validation():
+    ring = _make_ring(
+        "slots", [hsim.RingBufferField("depth", hsim.DataType.FLOAT, [4, 5])]
+    )
+
+    # nothing acquired or published yet, and -1 is what a timeout returns
+    with pytest.raises(ValueError):
+        ring.commit_write_slot(1)
+    with pytest.raises(ValueError):
+        ring.release_read_slot(0)
+    with pytest.raises(IndexError):
+        ring.release_read_slot(-1)
+    with pytest.raises(IndexError):
+        ring.field(2, "depth")
+    with pytest.raises(KeyError):
+        ring.field(0, "rgba")
+
+    slot = ring.acquire_write_slot(0)
+    assert slot == 0
+    ring.field(slot, "depth")[:] = 1.5
+    ring.commit_write_slot(slot)
+    assert ring.acquire_read_slot(0) == 0
+    np.testing.assert_array_equal(ring.field(0, "depth"), 1.5)
+    with pytest.raises(ValueError):
+        ring.release_read_slot(1)
+    ring.release_read_slot(0)
+    assert ring.num_ready_slots == 0
+
+
+@pytest.mark.gfxtest
+def test_sensor_ring_field(sim, make_cfg_settings):
+    if not osp.exists(make_cfg_settings["scene"]):
+        pytest.skip("Skipping {}".format(make_cfg_settings["scene"]))
+
+    sensor = sim.get_sensor("depth_sensor")
+    space = sensor._sensor_object.get_observation_space()
+    ring = _make_ring(
+        "sensor", [hsim.RingBufferField("depth", space.data_type, list(space.shape))]
+    )
+    with pytest.raises(ValueError):
+        sensor.set_ring_field(
+            _make_ring(
+                "mismatch", [hsim.RingBufferField("depth", space.data_type, [1])]
+            ),
+            "depth",
+        )
+    sensor.set_ring_field(ring, "depth")
+
+    expected = sim.get_sensor_observations()["depth_sensor"]
+    slot = ring.acquire_write_slot(0)
+    obs = sim.get_sensor_observations(ring_slot=slot)["depth_sensor"]
+    ring.commit_write_slot(slot)
+
+    # the observation is the field itself, bottom row first
+    field = ring.field(slot, "depth")
+    assert np.shares_memory(obs, field)
+    np.testing.assert_array_equal(
+        np.flip(field.reshape(expected.shape), axis=0), expected
+    )
@@ -113,3 +113,167 @@ def test_smoke_no_sensors(make_cfg_settings):
         cfg = make_cfg(make_cfg_settings)
         cfg.agents[0].sensor_specifications = []
         sims.append(habitat_sim.Simulator(cfg))
+
+
+@pytest.mark.gfxtest
+def test_semantic_remap(make_cfg_settings):
+    scene = _test_scenes[0]
+    if not osp.exists(scene):
+        pytest.skip("Skipping {}".format(scene))
+
+    make_cfg_settings = {k: v for k, v in make_cfg_settings.items()}
+    make_cfg_settings["scene"] = scene
+    cfg = make_cfg(make_cfg_settings)
+    category_spec = hsim.SensorSpec()
+    category_spec.uuid = "category_sensor"
+    category_spec.sensor_type = hsim.SensorType.SEMANTIC
+    category_spec.resolution = [
+        make_cfg_settings["height"],
+        make_cfg_settings["width"],
+    ]
+    category_spec.position = [0.0, make_cfg_settings["sensor_height"], 0.0]
+    category_spec.parameters["semantic_remap"] = "category"
+    cfg.agents[0].sensor_specifications.append(category_spec)
+
+    sim = habitat_sim.Simulator(cfg)
+    try:
+        obs = sim.get_sensor_observations()
+        # the same view as the semantic sensor, with its object ids converted
+        expected = obs["semantic_sensor"].copy()
+        sim.semantic_scene.remap(expected, hsim.SemanticRemap.OBJECT_TO_CATEGORY)
+        np.testing.assert_array_equal(obs["category_sensor"], expected)
+    finally:
+        sim.close()
+
+
+@pytest.mark.gfxtest
+@pytest.mark.parametrize("sensor_type", ["color_sensor", "depth_sensor"])
+def test_panoramic_sensor(sensor_type, make_cfg_settings):
+    scene = _test_scenes[1]
+    if not osp.exists(scene):
+        pytest.skip("Skipping {}".format(scene))
+
+    make_cfg_settings = {k: v for k, v in make_cfg_settings.items()}
+    make_cfg_settings["scene"] = scene
+    make_cfg_settings["semantic_sensor"] = False
+    make_cfg_settings["height"] = 128
+    make_cfg_settings["width"] = 256
+    cfg = make_cfg(make_cfg_settings)
+    for spec in cfg.agents[0].sensor_specifications:
+        spec.sensor_subtype = "panoramic"
+
+    sim = habitat_sim.Simulator(cfg)
+    try:
+        obs = sim.get_sensor_observations()[sensor_type]
+    finally:
+        sim.close()
+
+    # an equirectangular panorama of the requested resolution
+    if sensor_type == "color_sensor":
+        assert obs.shape == (128, 256, 4)
+        assert obs.dtype == np.uint8
+    else:
+        assert obs.shape == (128, 256)
+        assert obs.dtype == np.float32
+        # distances all around the agent, not only in front of it
+        assert np.count_nonzero(obs[:, :64]) > 0
+        assert np.count_nonzero(obs[:, -64:]) > 0
+    assert obs.any()
+
+
+@pytest.mark.gfxtest
+@pytest.mark.parametrize("sensor_type", ["color_sensor", "depth_sensor"])
+def test_multiview_sensor(sensor_type, make_cfg_settings):
+    scene = _test_scenes[1]
+    if not osp.exists(scene):
+        pytest.skip("Skipping {}".format(scene))
+
+    make_cfg_settings = {k: v for k, v in make_cfg_settings.items()}
+    make_cfg_settings["scene"] = scene
+    make_cfg_settings["semantic_sensor"] = False
+    cfg = make_cfg(make_cfg_settings)
+    spec = next(
+        s for s in cfg.agents[0].sensor_specifications if s.uuid == sensor_type
+    )
+    # three views where the plain sensor is, and one off to the side
+    multiview_spec = hsim.SensorSpec()
+    multiview_spec.uuid = "multiview_sensor"
+    multiview_spec.sensor_type = spec.sensor_type
+    multiview_spec.sensor_subtype = "multiview"
+    multiview_spec.resolution = spec.resolution
+    multiview_spec.position = spec.position
+    multiview_spec.parameters["view_offsets"] = "0,0,0;0,0,0;0.5,0,0;0,0,0"
+    cfg.agents[0].sensor_specifications.append(multiview_spec)
+
+    sim = habitat_sim.Simulator(cfg)
+    try:
+        assert sim.get_sensor("multiview_sensor")._sensor_object.num_views == 4
+        sim.get_sensor_observations()
+        # the single view sensor is drawn after the multiview one left the
+        # renderer at its own size
+        obs = sim.get_sensor_observations()
+    finally:
+        sim.close()
+
+    single = obs[sensor_type]
+    views = obs["multiview_sensor"]
+    assert views.shape == (4,) + single.shape
+    assert views.dtype == single.dtype
+    # each view is its own tile of the framebuffer, upright like the sensor
+    for i in (0, 1, 3):
+        np.testing.assert_allclose(views[i], single, atol=1e-5)
+    assert not np.allclose(views[2], single)
+
+
+@pytest.mark.gfxtest
+def test_compact_encodings(make_cfg_settings):
+    scene = _test_scenes[1]
+    if not osp.exists(scene):
+        pytest.skip("Skipping {}".format(scene))
+
+    make_cfg_settings = {k: v for k, v in make_cfg_settings.items()}
+    make_cfg_settings["scene"] = scene
+    make_cfg_settings["semantic_sensor"] = False
+    cfg = make_cfg(make_cfg_settings)
+    # compact copies of the color and depth sensors, at the same pose
+    for spec, encoding in zip(
+        list(cfg.agents[0].sensor_specifications), ["rgb_uint8", "depth_float16"]
+    ):
+        compact_spec = hsim.SensorSpec()
+        compact_spec.uuid = spec.uuid + "_" + encoding
+        compact_spec.sensor_type = spec.sensor_type
+        compact_spec.resolution = spec.resolution
+        compact_spec.position = spec.position
+        compact_spec.encoding = encoding
+        if encoding == "rgb_uint8":
+            compact_spec.parameters["noise_model"] = "gaussian"
+            compact_spec.parameters["noise_sigma"] = "0.05"
+        cfg.agents[0].sensor_specifications.append(compact_spec)
+
+    sim = habitat_sim.Simulator(cfg)
+    try:
+        obs = sim.get_sensor_observations()
+        rgb_sensor = sim.get_sensor("color_sensor_rgb_uint8")._sensor_object
+        noise_input = np.full((4, 5 * 3), 128, dtype=np.uint8)
+        rgb_sensor.apply_noise(noise_input)
+    finally:
+        sim.close()
+
+    rgba = obs["color_sensor"]
+    rgb = obs["color_sensor_rgb_uint8"]
+    assert rgb.shape == rgba.shape[:2] + (3,)
+    assert rgb.dtype == np.uint8
+    # the same view with alpha dropped, up to the (clamped) noise of the compact
+    # sensor
+    difference = rgb.astype(np.float32) - rgba[..., :3]
+    assert abs(difference.mean()) < 5.0
+
+    depth = obs["depth_sensor"]
+    half_depth = obs["depth_sensor_depth_float16"]
+    assert half_depth.shape == depth.shape
+    assert half_depth.dtype == np.float16
+    assert np.abs(half_depth.astype(np.float32) - depth).mean() < 0.1
+
+    # noise reaches all three channels of packed RGB, none is taken for alpha
+    changed = noise_input.reshape(4, 5, 3) != 128
+    assert changed.mean(axis=(0, 1)).min() > 0.5